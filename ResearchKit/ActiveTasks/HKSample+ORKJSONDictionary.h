@@ -34,6 +34,8 @@
 
 NS_ASSUME_NONNULL_BEGIN
 
+@class ORKJSONStreamWriter;
+
 typedef NS_OPTIONS(NSInteger, ORKSampleJSONOptions) {
     ORKSampleIncludeMetadata = 0x1,
     ORKSampleIncludeSource = 0x2,
@@ -47,6 +49,9 @@ typedef NS_OPTIONS(NSInteger, ORKSampleJSONOptions) {
 
 - (NSDictionary *)ork_JSONDictionaryWithOptions:(ORKSampleJSONOptions)options unit:(nullable HKUnit *)unit;
 
+// Writes the same JSON object as `ork_JSONDictionaryWithOptions:unit:`, without building the dictionary.
+- (void)ork_writeJSONWithOptions:(ORKSampleJSONOptions)options unit:(nullable HKUnit *)unit writer:(ORKJSONStreamWriter *)writer;
+
 @end
 
 
@@ -57,6 +62,8 @@ typedef NS_OPTIONS(NSInteger, ORKSampleJSONOptions) {
 
 - (NSDictionary *)ork_JSONDictionaryWithOptions:(ORKSampleJSONOptions)options sampleTypes:(NSArray *)sampleTypes units:(NSArray *)units;
 
+- (void)ork_writeJSONWithOptions:(ORKSampleJSONOptions)options sampleTypes:(NSArray *)sampleTypes units:(NSArray *)units writer:(ORKJSONStreamWriter *)writer;
+
 @end
 
 NS_ASSUME_NONNULL_END
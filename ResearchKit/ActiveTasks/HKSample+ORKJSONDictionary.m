@@ -32,6 +32,7 @@
 #import "HKSample+ORKJSONDictionary.h"
 
 #import "ORKHelpers_Internal.h"
+#import "ORKJSONStreamWriter.h"
 
 
 static NSString *const HKSampleIdentifierKey = @"type"; // For compatibility with Health XML export
@@ -103,6 +104,52 @@ static NSString *const HKCorrelatedObjectsKey = @"objects";
     return [self ork_JSONMutableDictionaryWithOptions:options unit:unit];
 }
 
+// Writes the keys shared by all samples, leaving the object open for subclasses to add their value.
+- (void)ork_writeJSONKeysWithOptions:(ORKSampleJSONOptions)options unit:(HKUnit *)unit writer:(ORKJSONStreamWriter *)writer {
+    [writer writeKey:HKSampleIdentifierKey];
+    [writer writeString:[[self sampleType] identifier]];
+    
+    NSDate *startDate = [self startDate];
+    if (startDate) {
+        [writer writeKey:HKSampleStartDateKey];
+        [writer writeDate:startDate];
+    }
+    NSDate *endDate = [self endDate];
+    if (endDate) {
+        [writer writeKey:HKSampleEndDateKey];
+        [writer writeDate:endDate];
+    }
+    if (unit) {
+        [writer writeKey:HKUnitKey];
+        [writer writeString:[unit unitString]];
+    }
+    if ((options & ORKSampleIncludeUUID)) {
+        NSUUID *uuid = [self UUID];
+        if (uuid) {
+            [writer writeKey:HKUUIDKey];
+            [writer writeString:uuid.UUIDString];
+        }
+    }
+    if ((options & ORKSampleIncludeMetadata) && self.metadata.count > 0) {
+        // The writer formats dates in metadata the same way as the dictionary does.
+        [writer writeKey:HKMetadataKey];
+        [writer writeJSONObject:self.metadata];
+    }
+    if (options & ORKSampleIncludeSource) {
+        HKSource *source = [[self sourceRevision] source];
+        if (source.name) {
+            [writer writeKey:HKSourceKey];
+            [writer writeString:source.name];
+        }
+    }
+}
+
+- (void)ork_writeJSONWithOptions:(ORKSampleJSONOptions)options unit:(HKUnit *)unit writer:(ORKJSONStreamWriter *)writer {
+    [writer beginObject];
+    [self ork_writeJSONKeysWithOptions:options unit:unit writer:writer];
+    [writer endObject];
+}
+
 @end
 
 
@@ -122,6 +169,14 @@ static NSString *const HKCorrelatedObjectsKey = @"objects";
     return dictionary;
 }
 
+- (void)ork_writeJSONWithOptions:(ORKSampleJSONOptions)options unit:(HKUnit *)unit writer:(ORKJSONStreamWriter *)writer {
+    [writer beginObject];
+    [self ork_writeJSONKeysWithOptions:options unit:unit writer:writer];
+    [writer writeKey:HKSampleValue];
+    [writer writeInteger:self.value];
+    [writer endObject];
+}
+
 @end
 
 
@@ -143,6 +198,14 @@ static NSString *const HKCorrelatedObjectsKey = @"objects";
     return dictionary;
 }
 
+- (void)ork_writeJSONWithOptions:(ORKSampleJSONOptions)options unit:(HKUnit *)unit writer:(ORKJSONStreamWriter *)writer {
+    [writer beginObject];
+    [self ork_writeJSONKeysWithOptions:options unit:unit writer:writer];
+    [writer writeKey:HKSampleValue];
+    [writer writeDouble:[[self quantity] doubleValueForUnit:unit]];
+    [writer endObject];
+}
+
 @end
 
 
@@ -166,4 +229,23 @@ static NSString *const HKCorrelatedObjectsKey = @"objects";
     return mutableDictionary;
 }
 
+- (void)ork_writeJSONWithOptions:(ORKSampleJSONOptions)options sampleTypes:(NSArray *)sampleTypes units:(NSArray *)units writer:(ORKJSONStreamWriter *)writer {
+    [writer beginObject];
+    [self ork_writeJSONKeysWithOptions:options unit:nil writer:writer];
+    
+    [writer writeKey:HKCorrelatedObjectsKey];
+    [writer beginArray];
+    for (HKSample *sample in self.objects) {
+        NSUInteger idx = [sampleTypes indexOfObject:sample.sampleType];
+        if (idx == NSNotFound) {
+            continue;
+        }
+        
+        [sample ork_writeJSONWithOptions:options unit:units[idx] writer:writer];
+    }
+    [writer endArray];
+    
+    [writer endObject];
+}
+
 @end
@@ -40,6 +40,12 @@ NS_ASSUME_NONNULL_BEGIN
  
  The accelerometer recorder continues to record when the application enters the
  background by using the background task support provided by UIApplication.
+ 
+ Samples are written from a dedicated serial queue through a bounded buffer. Samples that
+ arrive while the buffer is full, or whose timestamp is earlier than the previous sample, are
+ dropped. The `userInfo` dictionary of the file result reports the number of samples written
+ (`capturedSampleCount`), dropped because the buffer was full (`overflowCount`), and dropped
+ because they were out of order (`outOfOrderCount`).
  */
 ORK_CLASS_AVAILABLE
 @interface ORKAccelerometerRecorder : ORKRecorder
@@ -49,6 +55,16 @@ ORK_CLASS_AVAILABLE
  */
 @property (nonatomic, readonly) double frequency;
 
+/**
+ A Boolean value indicating whether the recorder runs the accelerometer samples through an on-device
+ gait analysis stage.
+ 
+ When the value of this property is `YES`, the recorder reports an `ORKGaitSummaryResult` object,
+ whose identifier is the recorder identifier followed by `_gait`, through the delegate's
+ `recorder:didReportAdditionalResult:` method, just before it completes with its `ORKFileResult` object.
+ */
+@property (nonatomic, assign) BOOL includesGaitSummary;
+
 /**
  Returns an initialized accelerometer recorder using the specified frequency.
  
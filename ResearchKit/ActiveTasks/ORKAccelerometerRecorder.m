@@ -31,7 +31,11 @@
 
 #import "ORKAccelerometerRecorder.h"
 
-#import "ORKDataLogger.h"
+#import "ORKDataLogger_Internal.h"
+#import "ORKGaitAnalyzer.h"
+#import "ORKRecorderCaptureQueue.h"
+#import "ORKRecorderMetrics.h"
+#import "ORKSensorHub.h"
 
 #import "ORKRecorder_Internal.h"
 
@@ -43,10 +47,13 @@
 
 @interface ORKAccelerometerRecorder () {
     ORKDataLogger *_logger;
+    ORKGaitAnalyzer *_gaitAnalyzer;
+    ORKRecorderCaptureQueue *_captureQueue;
+    id _sensorConsumer;
     NSError *_recordingError;
 }
 
-@property (nonatomic, strong) CMMotionManager *motionManager;
+@property (nonatomic, strong) ORKSensorHub *sensorHub;
 
 @property (nonatomic) NSTimeInterval uptime;
 
@@ -80,14 +87,17 @@
     }
 }
 
+// Returns `nil` to share the motion manager of `[ORKSensorHub sharedHub]`; overridden by tests.
 - (CMMotionManager *)createMotionManager {
-    return [[CMMotionManager alloc] init];
+    id<ORKRecorderSampleSource> sampleSource = self.sampleSource;
+    return [sampleSource respondsToSelector:@selector(motionManagerForRecorder:)] ? [sampleSource motionManagerForRecorder:self] : nil;
 }
 
 - (void)start {
     [super start];
     
-    self.motionManager = [self createMotionManager];
+    CMMotionManager *motionManager = [self createMotionManager];
+    self.sensorHub = motionManager ? [[ORKSensorHub alloc] initWithMotionManager:motionManager] : [ORKSensorHub sharedHub];
     
     if (!_logger) {
         NSError *error = nil;
@@ -98,40 +108,72 @@
         }
     }
     
-    if (!self.motionManager || !self.motionManager.accelerometerAvailable) {
-        NSError *error = [NSError errorWithDomain:NSCocoaErrorDomain
-                                             code:NSFeatureUnsupportedError
-                                         userInfo:@{@"recorder": self}];
-        [self finishRecordingWithError:error];
-        return;
-    }
+    self.uptime = [NSProcessInfo processInfo].systemUptime;
     
-    self.motionManager.accelerometerUpdateInterval = 1.0 / _frequency;
+    [self doStopRecording];
     
-    self.uptime = [NSProcessInfo processInfo].systemUptime;
+    _gaitAnalyzer = self.includesGaitSummary ? [[ORKGaitAnalyzer alloc] initWithFrequency:_frequency] : nil;
+    ORKGaitAnalyzer *gaitAnalyzer = _gaitAnalyzer;
+    ORKRecorderMetrics *metrics = self.metrics;
+    [metrics reset];
+    ORKDataLogger *logger = _logger;
+    logger.metrics = metrics;
+    __weak typeof(self) weakSelf = self;
     
-    [self.motionManager stopAccelerometerUpdates];
+    // The capture queue hands over samples in timestamp order, as the gait analyzer expects.
+    ORKRecorderCaptureQueue *captureQueue = [[ORKRecorderCaptureQueue alloc] initWithLabel:@"org.researchkit.recorder.accel"
+                                                                                  capacity:[ORKRecorderCaptureQueue capacityForFrequency:_frequency]
+                                                                                   handler:^(NSArray *samples) {
+        NSMutableArray *dictionaries = [NSMutableArray arrayWithCapacity:samples.count];
+        for (CMAccelerometerData *data in samples) {
+            [dictionaries addObject:[data ork_JSONDictionary]];
+            CMAcceleration acceleration = data.acceleration;
+            [gaitAnalyzer appendAccelerationX:acceleration.x y:acceleration.y z:acceleration.z timestamp:data.timestamp];
+        }
+        NSError *error = nil;
+        if (![logger appendObjects:dictionaries error:&error]) {
+            [weakSelf stopWithErrorOnMainQueue:error];
+        }
+    }];
+    _captureQueue = captureQueue;
     
-    [self.motionManager startAccelerometerUpdatesToQueue:[[NSOperationQueue alloc] init] withHandler:^(CMAccelerometerData *data, NSError *error) {
-         BOOL success = NO;
+    _sensorConsumer = [self.sensorHub addAccelerometerConsumerWithFrequency:_frequency handler:^(CMAccelerometerData *data, NSError *error) {
          if (data) {
-             success = [_logger append:[data ork_JSONDictionary] error:&error];
-         }
-         if (!success) {
-             dispatch_async(dispatch_get_main_queue(), ^{
-                 _recordingError = error;
-                 [self stop];
-             });
+             [metrics recordSampleWithTimestamp:data.timestamp];
+             if (![captureQueue enqueueSample:data timestamp:data.timestamp]) {
+                 [metrics incrementCounter:ORKRecorderCounterSamplesDropped by:1];
+             }
+         } else {
+             [weakSelf stopWithErrorOnMainQueue:error];
          }
      }];
+    
+    if (!_sensorConsumer) {
+        NSError *error = [NSError errorWithDomain:NSCocoaErrorDomain
+                                             code:NSFeatureUnsupportedError
+                                         userInfo:@{@"recorder": self}];
+        [self finishRecordingWithError:error];
+    }
+}
+
+- (void)stopWithErrorOnMainQueue:(NSError *)error {
+    dispatch_async(dispatch_get_main_queue(), ^{
+        if (self.isRecording) {
+            _recordingError = error;
+            [self stop];
+        }
+    });
 }
 
 - (NSDictionary *)userInfo {
-    return  @{ @"frequency": @(self.frequency) };
+    NSMutableDictionary *userInfo = [NSMutableDictionary dictionaryWithDictionary:[_captureQueue statistics]];
+    userInfo[@"frequency"] = @(self.frequency);
+    return [userInfo copy];
 }
 
 - (void)stop {
     [self doStopRecording];
+    [_captureQueue flush];
     [_logger finishCurrentLog];
     
     NSError *error = _recordingError;
@@ -141,6 +183,13 @@
         fileUrl = logFileUrl;
     } error:&error];
     
+    ORKGaitAnalyzer *gaitAnalyzer = _gaitAnalyzer;
+    _gaitAnalyzer = nil;
+    
+    // Reported ahead of the file result, which completes the recording.
+    if (fileUrl && !error && gaitAnalyzer) {
+        [self reportAdditionalResult:[gaitAnalyzer summaryResultWithIdentifier:[self.identifier stringByAppendingString:@"_gait"]]];
+    }
     [self reportFileResultWithFile:fileUrl error:error];
     
     [super stop];
@@ -148,8 +197,9 @@
 
 - (void)doStopRecording {
     if (self.isRecording) {
-        [self.motionManager stopAccelerometerUpdates];
-        self.motionManager = nil;
+        // Waits for samples already being delivered to reach the logger and the gait analyzer.
+        [self.sensorHub removeConsumer:_sensorConsumer];
+        _sensorConsumer = nil;
     }
 }
 
@@ -165,7 +215,7 @@
 }
 
 - (BOOL)isRecording {
-    return self.motionManager.accelerometerActive;
+    return (_sensorConsumer != nil);
 }
 
 - (NSString *)mimeType {
@@ -193,16 +243,19 @@
 #pragma clang diagnostic pop
 
 - (ORKRecorder *)recorderForStep:(ORKStep *)step outputDirectory:(NSURL *)outputDirectory {
-    return [[ORKAccelerometerRecorder alloc] initWithIdentifier:self.identifier
-                                                      frequency:self.frequency
-                                                           step:step
-                                                outputDirectory:outputDirectory];
+    ORKAccelerometerRecorder *recorder = [[ORKAccelerometerRecorder alloc] initWithIdentifier:self.identifier
+                                                                                    frequency:self.frequency
+                                                                                         step:step
+                                                                              outputDirectory:outputDirectory];
+    recorder.includesGaitSummary = self.includesGaitSummary;
+    return recorder;
 }
 
 - (instancetype)initWithCoder:(NSCoder *)aDecoder {
     self = [super initWithCoder:aDecoder];
     if (self) {
         ORK_DECODE_DOUBLE(aDecoder, frequency);
+        ORK_DECODE_BOOL(aDecoder, includesGaitSummary);
     }
     return self;
 }
@@ -210,6 +263,7 @@
 - (void)encodeWithCoder:(NSCoder *)aCoder {
     [super encodeWithCoder:aCoder];
     ORK_ENCODE_DOUBLE(aCoder, frequency);
+    ORK_ENCODE_BOOL(aCoder, includesGaitSummary);
 }
 
 + (BOOL)supportsSecureCoding {
@@ -221,7 +275,8 @@
     
     __typeof(self) castObject = object;
     return (isParentSame &&
-            (self.frequency == castObject.frequency));
+            (self.frequency == castObject.frequency) &&
+            (self.includesGaitSummary == castObject.includesGaitSummary));
 }
 
 - (ORKPermissionMask)requestedPermissionMask {
@@ -31,29 +31,41 @@
 
 #import "ORKActiveStepTimer.h"
 
+#import "ORKActiveTaskClock.h"
+
 #import "ORKHelpers_Internal.h"
 
 @import UIKit;
-#include <mach/mach.h>
 #include <mach/mach_time.h>
+#include <pthread.h>
+#include <stdatomic.h>
 
 
-static NSTimeInterval timeIntervalFromMachTime(uint64_t delta) {
-    static mach_timebase_info_data_t    sTimebaseInfo;
-    if ( sTimebaseInfo.denom == 0 ) {
-        (void) mach_timebase_info(&sTimebaseInfo);
-    }
-    uint64_t elapsedNano = delta * sTimebaseInfo.numer / sTimebaseInfo.denom;
-    return elapsedNano * 1.0 / NSEC_PER_SEC;
+static uint64_t ORKBitsFromTimeInterval(NSTimeInterval timeInterval) {
+    uint64_t bits;
+    memcpy(&bits, &timeInterval, sizeof(bits));
+    return bits;
+}
+
+static NSTimeInterval ORKTimeIntervalFromBits(uint64_t bits) {
+    NSTimeInterval timeInterval;
+    memcpy(&timeInterval, &bits, sizeof(timeInterval));
+    return timeInterval;
 }
 
 @implementation ORKActiveStepTimer {
-    uint64_t _startTime;
-    NSTimeInterval _preExistingRuntime;
-    dispatch_queue_t _queue;
-    dispatch_source_t _timer;
+    // The runtime is published with a sequence lock, so reading it never blocks: a writer makes the
+    // sequence odd while it updates the start time and pre-existing runtime, and readers retry
+    // until they see the same even sequence before and after reading both.
+    _Atomic(uint32_t) _sequence;
+    _Atomic(uint64_t) _startTime;
+    _Atomic(uint64_t) _preExistingRuntimeBits;
+    _Atomic(uint64_t) _durationBits;
+    
+    // Serializes the writers, and guards everything below.
+    pthread_mutex_t _lock;
+    ORKActiveTaskClockTimer *_clockTimer;
     UIBackgroundTaskIdentifier _backgroundTaskIdentifier;
-    uint32_t _isRunning;
 }
 
 - (instancetype)initWithDuration:(NSTimeInterval)duration interval:(NSTimeInterval)interval runtime:(NSTimeInterval)runtime handler:(ORKActiveStepTimerHandler)handler {
@@ -63,99 +75,100 @@ static NSTimeInterval timeIntervalFromMachTime(uint64_t delta) {
             @throw [NSException exceptionWithName:NSInvalidArgumentException reason:@"Handler is required" userInfo:nil];
         }
         
-        _duration = duration;
         _interval = interval;
         _handler = [handler copy];
-        _preExistingRuntime = runtime;
         _backgroundTaskIdentifier = UIBackgroundTaskInvalid;
-        
-        _queue = dispatch_queue_create("active_step", DISPATCH_QUEUE_SERIAL);
-        
+        atomic_init(&_durationBits, ORKBitsFromTimeInterval(duration));
+        atomic_init(&_preExistingRuntimeBits, ORKBitsFromTimeInterval(runtime));
+        pthread_mutex_init(&_lock, NULL);
     }
     return self;
 }
 
 - (void)dealloc {
-    [self queue_pauseAtFinish:NO];
+    [_clockTimer cancel];
+    [self locked_releaseBackgroundTask];
+    pthread_mutex_destroy(&_lock);
 }
 
-- (NSTimeInterval)runtime {
-    __block NSTimeInterval runtime = 0;
-    dispatch_sync(_queue, ^{
-        runtime = [self queue_runtime];
-    });
-    return MIN(runtime,_duration);
+- (NSTimeInterval)duration {
+    return ORKTimeIntervalFromBits(atomic_load_explicit(&_durationBits, memory_order_relaxed));
 }
 
-- (void)pause {
-    dispatch_sync(_queue, ^{
-        [self queue_pauseAtFinish:NO];
-    });
+- (void)setDuration:(NSTimeInterval)duration {
+    atomic_store_explicit(&_durationBits, ORKBitsFromTimeInterval(duration), memory_order_relaxed);
 }
 
-- (void)resume {
-    dispatch_sync(_queue, ^{
-        [self queue_resume];
-    });
+- (NSTimeInterval)runtime {
+    return MIN([self unclampedRuntime], self.duration);
+}
+
+- (NSTimeInterval)unclampedRuntime {
+    uint32_t sequence;
+    uint64_t startTime;
+    NSTimeInterval preExistingRuntime;
+    do {
+        sequence = atomic_load_explicit(&_sequence, memory_order_acquire);
+        startTime = atomic_load_explicit(&_startTime, memory_order_relaxed);
+        preExistingRuntime = ORKTimeIntervalFromBits(atomic_load_explicit(&_preExistingRuntimeBits, memory_order_relaxed));
+        atomic_thread_fence(memory_order_acquire);
+    } while ((sequence & 1) || sequence != atomic_load_explicit(&_sequence, memory_order_relaxed));
+    
+    if (startTime != 0) {
+        preExistingRuntime += ORKTimeIntervalFromMachTime(mach_absolute_time() - startTime);
+    }
+    return preExistingRuntime;
 }
 
-- (void)reset {
-    dispatch_sync(_queue, ^{
-        [self queue_reset];
-    });
+- (void)locked_publishStartTime:(uint64_t)startTime preExistingRuntime:(NSTimeInterval)preExistingRuntime {
+    uint32_t sequence = atomic_load_explicit(&_sequence, memory_order_relaxed);
+    atomic_store_explicit(&_sequence, sequence + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    atomic_store_explicit(&_startTime, startTime, memory_order_relaxed);
+    atomic_store_explicit(&_preExistingRuntimeBits, ORKBitsFromTimeInterval(preExistingRuntime), memory_order_relaxed);
+    atomic_store_explicit(&_sequence, sequence + 2, memory_order_release);
 }
 
-- (NSTimeInterval)queue_runtime {
-    NSTimeInterval runtime = _preExistingRuntime;
-    if (_timer != NULL) {
-        uint64_t now = mach_absolute_time();
-        runtime += timeIntervalFromMachTime(now - _startTime);
-    }
-    return runtime;
+- (void)pause {
+    pthread_mutex_lock(&_lock);
+    [self locked_pauseAtFinish:NO];
+    pthread_mutex_unlock(&_lock);
 }
 
-- (void)setDuration:(NSTimeInterval)duration {
-    dispatch_sync(_queue, ^{
-        _duration = duration;
-    });
+- (void)resume {
+    pthread_mutex_lock(&_lock);
+    [self locked_resume];
+    pthread_mutex_unlock(&_lock);
 }
 
-- (void)hiqueue_event {
-    dispatch_sync(_queue, ^{
-        [self queue_event];
-    });
+- (void)reset {
+    pthread_mutex_lock(&_lock);
+    [self locked_reset];
+    pthread_mutex_unlock(&_lock);
 }
 
-- (void)queue_event {
-    [self queue_assertBackgroundTask];
+// Called on the main queue, by the shared clock.
+- (void)event {
+    pthread_mutex_lock(&_lock);
+    [self locked_assertBackgroundTask];
     
-    NSTimeInterval runtime = [self queue_runtime];
-    BOOL finished = (runtime >= _duration);
+    BOOL finished = ([self unclampedRuntime] >= self.duration);
     if (finished) {
-        [self queue_pauseAtFinish:YES];
+        [self locked_pauseAtFinish:YES];
     }
+    pthread_mutex_unlock(&_lock);
     
-    dispatch_async(dispatch_get_main_queue(), ^{
-        _handler(self, finished);
-        dispatch_sync(_queue, ^{
-            
-            // If the timer is still NULL here, we can safely release the background task.
-            if (_timer == NULL) {
-                [self queue_releaseBackgroundTask];
-            }
-        });
-    });
-}
-
-- (void)queue_clearTimer {
-    if (_timer != NULL) {
-        
-        dispatch_source_cancel(_timer);
-        _timer = NULL;
+    _handler(self, finished);
+    
+    pthread_mutex_lock(&_lock);
+    // If the timer is still stopped here, we can safely release the background task.
+    if (_clockTimer == nil) {
+        [self locked_releaseBackgroundTask];
     }
+    pthread_mutex_unlock(&_lock);
 }
 
-- (void)queue_releaseBackgroundTask {
+- (void)locked_releaseBackgroundTask {
     if (_backgroundTaskIdentifier == UIBackgroundTaskInvalid) {
         return;
     }
@@ -166,77 +179,72 @@ static NSTimeInterval timeIntervalFromMachTime(uint64_t delta) {
     });
 }
 
-- (void)queue_assertBackgroundTask {
+- (void)locked_assertBackgroundTask {
     if (_backgroundTaskIdentifier != UIBackgroundTaskInvalid) {
         return;
     }
+    ORKWeakTypeOf(self) weakSelf = self;
     _backgroundTaskIdentifier = [[UIApplication sharedApplication] beginBackgroundTaskWithExpirationHandler:^{
-        // This is guaranteed to be called synchronously on the main queue, switch to our queue to invalidate the identifier
-        dispatch_sync(_queue, ^{
-            _backgroundTaskIdentifier = UIBackgroundTaskInvalid;
-        });
+        // This is called on the main queue, when the identifier is no longer valid
+        ORKStrongTypeOf(self) strongSelf = weakSelf;
+        if (strongSelf) {
+            pthread_mutex_lock(&strongSelf->_lock);
+            strongSelf->_backgroundTaskIdentifier = UIBackgroundTaskInvalid;
+            pthread_mutex_unlock(&strongSelf->_lock);
+        }
     }];
 }
 
-- (void)queue_resume {
-    if (_timer != NULL) {
+- (void)locked_resume {
+    if (_clockTimer != nil) {
         // Already resumed
         return;
     }
-    if ([self queue_runtime] >= _duration) {
+    
+    NSTimeInterval preExistingRuntime = [self unclampedRuntime];
+    ORKWeakTypeOf(self) weakSelf = self;
+    if (preExistingRuntime >= self.duration) {
         // Already finished. Fire one event to indicate.
-        [self queue_event];
+        dispatch_async(dispatch_get_main_queue(), ^{
+            [weakSelf event];
+        });
         return;
     }
     
     // We want to run in the background if we can, so voice can be played, etc.
-    assert(_backgroundTaskIdentifier == UIBackgroundTaskInvalid);
-    
-    [self queue_assertBackgroundTask];
-    
-    _timer = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER,
-                                    0, 0, dispatch_get_global_queue(QOS_CLASS_USER_INTERACTIVE, 0));
-    if (_timer == NULL) {
-        assert(0);
-        return;
-    }
-    ORKWeakTypeOf(self) weakSelf = self;
-    dispatch_source_set_event_handler(_timer, ^{
-        ORKStrongTypeOf(self) strongSelf = weakSelf;
-        [strongSelf hiqueue_event];
-    });
+    [self locked_assertBackgroundTask];
     
-    NSTimeInterval timeUntilNextFire = (floor(_preExistingRuntime / _interval) + 1)*_interval -  _preExistingRuntime;
-    
-    _startTime = mach_absolute_time();
-    dispatch_source_set_timer(_timer,
-                              dispatch_time(DISPATCH_TIME_NOW, timeUntilNextFire * NSEC_PER_SEC),
-                              _interval * NSEC_PER_SEC,
-                              0.05 * NSEC_PER_SEC);
-    dispatch_resume(_timer);
-}
-
-- (void)queue_pauseAtFinish:(BOOL)atFinish {
-    if (_timer == NULL) {
+    NSTimeInterval timeUntilNextFire = (floor(preExistingRuntime / _interval) + 1) * _interval - preExistingRuntime;
+    [self locked_publishStartTime:mach_absolute_time() preExistingRuntime:preExistingRuntime];
+    _clockTimer = [[ORKActiveTaskClock sharedClock] scheduleTimerWithDelay:timeUntilNextFire
+                                                                  interval:_interval
+                                                                     queue:dispatch_get_main_queue()
+                                                                   handler:^{
+                                                                       [weakSelf event];
+                                                                   }];
+}
+
+- (void)locked_pauseAtFinish:(BOOL)atFinish {
+    if (_clockTimer == nil) {
         // Not running
         return;
     }
     
-    uint64_t now = mach_absolute_time();
-    [self queue_clearTimer];
-    _preExistingRuntime += timeIntervalFromMachTime(now - _startTime);
-    _startTime = 0;
+    [_clockTimer cancel];
+    _clockTimer = nil;
+    [self locked_publishStartTime:0 preExistingRuntime:[self unclampedRuntime]];
     
     if (!atFinish) {
         // If we are atFinish, the task will be released after the handler completes
-        [self queue_releaseBackgroundTask];
+        [self locked_releaseBackgroundTask];
     }
 }
 
-- (void)queue_reset {
-    [self queue_clearTimer];
-    _preExistingRuntime = 0;
-    [self queue_releaseBackgroundTask];
+- (void)locked_reset {
+    [_clockTimer cancel];
+    _clockTimer = nil;
+    [self locked_publishStartTime:0 preExistingRuntime:0];
+    [self locked_releaseBackgroundTask];
 }
 
 @end
@@ -467,6 +467,11 @@
     [self notifyDelegateOnResultChange];
 }
 
+- (void)recorder:(ORKRecorder *)recorder didReportAdditionalResult:(ORKResult *)result {
+    // The delegate is notified when the recorder completes, just after this.
+    _recorderResults = [_recorderResults arrayByAddingObject:result];
+}
+
 - (void)recorder:(ORKRecorder *)recorder didFailWithError:(NSError *)error {
     if (error) {
         ORKStrongTypeOf(self.delegate) strongDelegate = self.delegate;
@@ -0,0 +1,102 @@
+/*
+ Copyright (c) 2016, Apple Inc. All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+ 
+ 1.  Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ 2.  Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation and/or
+ other materials provided with the distribution.
+ 
+ 3.  Neither the name of the copyright holder(s) nor the names of any contributors
+ may be used to endorse or promote products derived from this software without
+ specific prior written permission. No license is granted to the trademarks of
+ the copyright holders even if such marks are included in this software.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+@import Foundation;
+#import "ORKDefines.h"
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*
+ Conversions for the clock shared by active steps and recorders. Times are seconds on the host's
+ monotonic clock (`mach_absolute_time`), which is also the time base of `UITouch`, `UIEvent`, and
+ CoreMotion timestamps, so values from all of them can be compared directly.
+ */
+ORK_EXTERN NSTimeInterval ORKTimeIntervalFromMachTime(uint64_t machTime);
+ORK_EXTERN uint64_t ORKMachTimeFromTimeInterval(NSTimeInterval timeInterval);
+
+/// The current time on the shared clock.
+ORK_EXTERN NSTimeInterval ORKActiveTaskClockNow(void);
+
+
+/// A timer scheduled on an `ORKActiveTaskClock` object.
+@interface ORKActiveTaskClockTimer : NSObject
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/**
+ Stops the timer. When called on the timer's queue, the handler is not called again after this
+ method returns.
+ */
+- (void)cancel;
+
+@property (readonly, getter=isCancelled) BOOL cancelled;
+
+@end
+
+
+/**
+ The `ORKActiveTaskClock` class drives the timers of active steps from a single timer source.
+ 
+ Pending timers are kept in a heap ordered by deadline, so scheduling and cancelling take
+ logarithmic time. The source is programmed to fire once, at the earliest deadline, and is
+ re-armed after each expiry and whenever a timer is scheduled or cancelled. It is stopped while
+ no timer is pending, so an idle clock never wakes the device. A repeating timer's deadlines do
+ not drift.
+ */
+@interface ORKActiveTaskClock : NSObject
+
++ (ORKActiveTaskClock *)sharedClock;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/// The number of timers waiting to fire. Cancelled timers are not counted.
+@property (readonly) NSUInteger pendingTimerCount;
+
+/// Whether the timer source is stopped because no timer is pending.
+@property (readonly, getter=isIdle) BOOL idle;
+
+/**
+ Schedules a timer.
+ 
+ @param delay       The time from now to the first firing, in seconds.
+ @param interval    The time between firings, in seconds, or 0 to fire once.
+ @param queue       The queue on which to call the handler.
+ @param handler     The block to call each time the timer fires.
+ */
+- (ORKActiveTaskClockTimer *)scheduleTimerWithDelay:(NSTimeInterval)delay
+                                           interval:(NSTimeInterval)interval
+                                              queue:(dispatch_queue_t)queue
+                                            handler:(dispatch_block_t)handler;
+
+@end
+
+NS_ASSUME_NONNULL_END
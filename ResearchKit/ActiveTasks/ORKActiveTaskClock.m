@@ -0,0 +1,358 @@
+/*
+ Copyright (c) 2016, Apple Inc. All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+ 
+ 1.  Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ 2.  Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation and/or
+ other materials provided with the distribution.
+ 
+ 3.  Neither the name of the copyright holder(s) nor the names of any contributors
+ may be used to endorse or promote products derived from this software without
+ specific prior written permission. No license is granted to the trademarks of
+ the copyright holders even if such marks are included in this software.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#import "ORKActiveTaskClock.h"
+
+#import "ORKHelpers_Internal.h"
+
+#include <mach/mach_time.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+
+// How late the timer source may fire, letting the system coalesce its wake-ups.
+static const NSTimeInterval ORKActiveTaskClockLeeway = 0.001;
+
+static mach_timebase_info_data_t ORKMachTimebase(void) {
+    static mach_timebase_info_data_t timebase;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        mach_timebase_info(&timebase);
+    });
+    return timebase;
+}
+
+NSTimeInterval ORKTimeIntervalFromMachTime(uint64_t machTime) {
+    mach_timebase_info_data_t timebase = ORKMachTimebase();
+    return ((double)machTime * timebase.numer / timebase.denom) / NSEC_PER_SEC;
+}
+
+uint64_t ORKMachTimeFromTimeInterval(NSTimeInterval timeInterval) {
+    if (timeInterval <= 0) {
+        return 0;
+    }
+    mach_timebase_info_data_t timebase = ORKMachTimebase();
+    return (uint64_t)(timeInterval * NSEC_PER_SEC * timebase.denom / timebase.numer);
+}
+
+NSTimeInterval ORKActiveTaskClockNow(void) {
+    return ORKTimeIntervalFromMachTime(mach_absolute_time());
+}
+
+
+@interface ORKActiveTaskClock ()
+
+- (void)removeTimer:(ORKActiveTaskClockTimer *)timer;
+
+@end
+
+
+@interface ORKActiveTaskClockTimer ()
+
+- (instancetype)initWithClock:(ORKActiveTaskClock *)clock
+                     deadline:(uint64_t)deadline
+                     interval:(uint64_t)interval
+                        queue:(dispatch_queue_t)queue
+                      handler:(dispatch_block_t)handler NS_DESIGNATED_INITIALIZER;
+
+// Mach times. The deadline and the heap index are only touched with the clock's lock held.
+@property (nonatomic) uint64_t deadline;
+@property (nonatomic, readonly) uint64_t interval;
+
+// The timer's position in the clock's heap, or NSNotFound when it is not scheduled.
+@property (nonatomic) NSUInteger heapIndex;
+
+@end
+
+
+@implementation ORKActiveTaskClockTimer {
+    __weak ORKActiveTaskClock *_clock;
+    dispatch_queue_t _queue;
+    dispatch_block_t _handler;
+    _Atomic(bool) _cancelled;
+}
+
+- (instancetype)init {
+    ORKThrowMethodUnavailableException();
+}
+
+- (instancetype)initWithClock:(ORKActiveTaskClock *)clock
+                     deadline:(uint64_t)deadline
+                     interval:(uint64_t)interval
+                        queue:(dispatch_queue_t)queue
+                      handler:(dispatch_block_t)handler {
+    self = [super init];
+    if (self) {
+        _clock = clock;
+        _deadline = deadline;
+        _interval = interval;
+        _queue = queue;
+        _handler = [handler copy];
+        _heapIndex = NSNotFound;
+    }
+    return self;
+}
+
+- (void)cancel {
+    if (atomic_exchange_explicit(&_cancelled, true, memory_order_acq_rel)) {
+        return;
+    }
+    [_clock removeTimer:self];
+}
+
+- (BOOL)isCancelled {
+    return atomic_load_explicit(&_cancelled, memory_order_acquire);
+}
+
+- (void)fire {
+    dispatch_async(_queue, ^{
+        // Checked again here, so cancelling on the handler's queue always wins
+        if (!self.cancelled) {
+            _handler();
+        }
+    });
+}
+
+@end
+
+
+@implementation ORKActiveTaskClock {
+    dispatch_queue_t _queue;
+    dispatch_source_t _source;
+    uint64_t _leeway;
+    
+    // Everything below is guarded by the lock.
+    pthread_mutex_t _lock;
+    BOOL _sourceRunning;
+    uint64_t _armedDeadline;
+    NSMutableArray<ORKActiveTaskClockTimer *> *_timers;     // A binary min-heap on deadline
+}
+
++ (ORKActiveTaskClock *)sharedClock {
+    static ORKActiveTaskClock *sharedClock;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        sharedClock = [[ORKActiveTaskClock alloc] initWithLeeway:ORKActiveTaskClockLeeway];
+    });
+    return sharedClock;
+}
+
+- (instancetype)init {
+    ORKThrowMethodUnavailableException();
+}
+
+- (instancetype)initWithLeeway:(NSTimeInterval)leeway {
+    self = [super init];
+    if (self) {
+        _leeway = (uint64_t)(leeway * NSEC_PER_SEC);
+        _timers = [NSMutableArray array];
+        pthread_mutex_init(&_lock, NULL);
+        
+        _queue = dispatch_queue_create("org.researchkit.activetaskclock",
+                                       dispatch_queue_attr_make_with_qos_class(DISPATCH_QUEUE_SERIAL, QOS_CLASS_USER_INTERACTIVE, 0));
+        _source = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, _queue);
+        ORKWeakTypeOf(self) weakSelf = self;
+        dispatch_source_set_event_handler(_source, ^{
+            ORKStrongTypeOf(self) strongSelf = weakSelf;
+            [strongSelf expire];
+        });
+    }
+    return self;
+}
+
+- (void)dealloc {
+    pthread_mutex_destroy(&_lock);
+}
+
+- (NSUInteger)pendingTimerCount {
+    pthread_mutex_lock(&_lock);
+    NSUInteger count = _timers.count;
+    pthread_mutex_unlock(&_lock);
+    return count;
+}
+
+- (BOOL)isIdle {
+    pthread_mutex_lock(&_lock);
+    BOOL idle = !_sourceRunning;
+    pthread_mutex_unlock(&_lock);
+    return idle;
+}
+
+- (ORKActiveTaskClockTimer *)scheduleTimerWithDelay:(NSTimeInterval)delay
+                                           interval:(NSTimeInterval)interval
+                                              queue:(dispatch_queue_t)queue
+                                            handler:(dispatch_block_t)handler {
+    ORKThrowInvalidArgumentExceptionIfNil(queue);
+    ORKThrowInvalidArgumentExceptionIfNil(handler);
+    
+    ORKActiveTaskClockTimer *timer = [[ORKActiveTaskClockTimer alloc] initWithClock:self
+                                                                           deadline:mach_absolute_time() + ORKMachTimeFromTimeInterval(delay)
+                                                                           interval:ORKMachTimeFromTimeInterval(interval)
+                                                                              queue:queue
+                                                                            handler:handler];
+    pthread_mutex_lock(&_lock);
+    [self locked_insertTimer:timer];
+    [self locked_arm];
+    pthread_mutex_unlock(&_lock);
+    
+    return timer;
+}
+
+- (void)removeTimer:(ORKActiveTaskClockTimer *)timer {
+    pthread_mutex_lock(&_lock);
+    if (timer.heapIndex != NSNotFound) {
+        [self locked_removeTimerAtIndex:timer.heapIndex];
+        [self locked_arm];
+    }
+    pthread_mutex_unlock(&_lock);
+}
+
+#pragma mark Heap
+
+- (void)locked_swapTimerAtIndex:(NSUInteger)index withTimerAtIndex:(NSUInteger)otherIndex {
+    [_timers exchangeObjectAtIndex:index withObjectAtIndex:otherIndex];
+    _timers[index].heapIndex = index;
+    _timers[otherIndex].heapIndex = otherIndex;
+}
+
+- (void)locked_siftUpFromIndex:(NSUInteger)index {
+    while (index > 0) {
+        NSUInteger parent = (index - 1) / 2;
+        if (_timers[parent].deadline <= _timers[index].deadline) {
+            break;
+        }
+        [self locked_swapTimerAtIndex:index withTimerAtIndex:parent];
+        index = parent;
+    }
+}
+
+- (void)locked_siftDownFromIndex:(NSUInteger)index {
+    NSUInteger count = _timers.count;
+    for (;;) {
+        NSUInteger smallest = index;
+        NSUInteger left = 2 * index + 1;
+        NSUInteger right = left + 1;
+        if (left < count && _timers[left].deadline < _timers[smallest].deadline) {
+            smallest = left;
+        }
+        if (right < count && _timers[right].deadline < _timers[smallest].deadline) {
+            smallest = right;
+        }
+        if (smallest == index) {
+            break;
+        }
+        [self locked_swapTimerAtIndex:index withTimerAtIndex:smallest];
+        index = smallest;
+    }
+}
+
+- (void)locked_insertTimer:(ORKActiveTaskClockTimer *)timer {
+    timer.heapIndex = _timers.count;
+    [_timers addObject:timer];
+    [self locked_siftUpFromIndex:timer.heapIndex];
+}
+
+- (void)locked_removeTimerAtIndex:(NSUInteger)index {
+    ORKActiveTaskClockTimer *timer = _timers[index];
+    NSUInteger lastIndex = _timers.count - 1;
+    if (index != lastIndex) {
+        [self locked_swapTimerAtIndex:index withTimerAtIndex:lastIndex];
+    }
+    [_timers removeLastObject];
+    timer.heapIndex = NSNotFound;
+    if (index < _timers.count) {
+        [self locked_siftDownFromIndex:index];
+        [self locked_siftUpFromIndex:index];
+    }
+}
+
+#pragma mark Timer source
+
+// Programs the source to fire once, at the earliest deadline, or stops it when nothing is pending.
+- (void)locked_arm {
+    ORKActiveTaskClockTimer *earliest = _timers.firstObject;
+    if (earliest == nil) {
+        if (_sourceRunning) {
+            dispatch_suspend(_source);
+            _sourceRunning = NO;
+        }
+        _armedDeadline = 0;
+        return;
+    }
+    if (_sourceRunning && earliest.deadline == _armedDeadline) {
+        return;
+    }
+    
+    uint64_t now = mach_absolute_time();
+    NSTimeInterval delay = (earliest.deadline > now) ? ORKTimeIntervalFromMachTime(earliest.deadline - now) : 0;
+    dispatch_source_set_timer(_source, dispatch_time(DISPATCH_TIME_NOW, (int64_t)(delay * NSEC_PER_SEC)), DISPATCH_TIME_FOREVER, _leeway);
+    _armedDeadline = earliest.deadline;
+    if (!_sourceRunning) {
+        dispatch_resume(_source);
+        _sourceRunning = YES;
+    }
+}
+
+- (void)expire {
+    NSMutableArray<ORKActiveTaskClockTimer *> *dueTimers = [NSMutableArray array];
+    
+    pthread_mutex_lock(&_lock);
+    // The one-shot source has fired, so it must be programmed again.
+    _armedDeadline = 0;
+    uint64_t now = mach_absolute_time();
+    
+    ORKActiveTaskClockTimer *timer = nil;
+    while ((timer = _timers.firstObject) && timer.deadline <= now) {
+        [self locked_removeTimerAtIndex:0];
+        if (timer.cancelled) {
+            continue;
+        }
+        [dueTimers addObject:timer];
+        
+        if (timer.interval > 0) {
+            // Keep to the original schedule, skipping any firings that were missed entirely
+            uint64_t deadline = timer.deadline + timer.interval;
+            if (deadline <= now) {
+                deadline += ((now - deadline) / timer.interval + 1) * timer.interval;
+            }
+            timer.deadline = deadline;
+            [self locked_insertTimer:timer];
+        }
+    }
+    [self locked_arm];
+    pthread_mutex_unlock(&_lock);
+    
+    for (ORKActiveTaskClockTimer *dueTimer in dueTimers) {
+        [dueTimer fire];
+    }
+}
+
+@end
@@ -29,9 +29,11 @@
  */
 
 
-#import "ORKDataLogger.h"
+#import "ORKDataLogger_Internal.h"
 
+#import "ORKRecorderMetrics.h"
 #import "ORKHelpers_Internal.h"
+#import "ORKJSONStreamWriter.h"
 #import "CMMotionActivity+ORKJSONDictionary.h"
 #import "HKSample+ORKJSONDictionary.h"
 
@@ -390,21 +392,15 @@ static NSInteger _ORKJSON_terminatorLength = 0;
         [outputData appendData:separatorData];
     }
     
-    // Serialize each object separately to the buffer, pending a single write, so the
-    // objects form part of a single array.
-    __block BOOL success = YES;
-    [objects enumerateObjectsUsingBlock:^(id obj, NSUInteger idx, BOOL *stop) {
-        NSData *data = [NSJSONSerialization dataWithJSONObject:obj options:(NSJSONWritingOptions)0 error:error];
-        if (!data) {
-            success = NO;
-            *stop = YES;
-        } else {
-            [outputData appendData:data];
-            if (idx + 1 < numObjects) {
-                [outputData appendData:separatorData];
-            }
+    // Stream the objects into the buffer, pending a single write; the writer separates
+    // top-level values with commas, so the objects form part of a single array.
+    ORKJSONStreamWriter *writer = [[ORKJSONStreamWriter alloc] initWithMutableData:outputData];
+    for (id object in objects) {
+        if (![writer writeJSONObject:object]) {
+            break;
         }
-    }];
+    }
+    BOOL success = [writer finishWithError:error];
     if (!success) {
         return success;
     }
@@ -900,6 +896,7 @@ static NSInteger _ORKJSON_terminatorLength = 0;
     BOOL exceededAgeThreshold = (self.maximumCurrentLogFileLifetime > 0) && creationDate && ( [earliestAcceptableCreationDate earlierDate:creationDate] == creationDate );
     
     if (exceededAgeThreshold || exceededSizeThreshold) {
+        [self.metrics incrementCounter:ORKRecorderCounterLogRollovers by:1];
         [self queue_rollover];
     }
 }
@@ -909,37 +906,40 @@ static NSInteger _ORKJSON_terminatorLength = 0;
 }
 
 - (BOOL)queue_append:(id)object error:(NSError **)error {
-    [self queue_rolloverIfNeeded];
-    
-    NSFileHandle *fileHandle = [self queue_fileHandleWithError:error];
-    if (!fileHandle) {
-        return NO;
-    }
-    
-    BOOL result = [self.logFormatter appendObject:object fileHandle:_currentFileHandle error:error];
-    
-    // Quick check to see if we've run over the maximum log file size
-    if ((self.maximumCurrentLogFileSize > 0) && ([_currentFileHandle offsetInFile] >= self.maximumCurrentLogFileSize)) {
-        [self queue_rollover];
-    }
-    
-    return result;
+    return [self queue_appendObjects:@[object] error:error];
 }
 
 - (BOOL)queue_appendObjects:(NSArray *)objects error:(NSError **)error {
+    ORKRecorderMetrics *metrics = self.metrics;
+    ORKRecorderIntervalToken interval = [metrics beginInterval];
+    
     [self queue_rolloverIfNeeded];
     
     NSFileHandle *fileHandle = [self queue_fileHandleWithError:error];
     if (!fileHandle) {
+        [metrics incrementCounter:ORKRecorderCounterAppendErrors by:1];
         return NO;
     }
     
-    BOOL result = [self.logFormatter appendObjects:objects fileHandle:_currentFileHandle error:error];
+    unsigned long long startOffset = metrics ? [fileHandle seekToEndOfFile] : 0;
+    BOOL result = (objects.count == 1) ? [self.logFormatter appendObject:objects[0] fileHandle:fileHandle error:error]
+                                       : [self.logFormatter appendObjects:objects fileHandle:fileHandle error:error];
+    unsigned long long endOffset = [_currentFileHandle offsetInFile];
+    if (metrics) {
+        if (result) {
+            [metrics incrementCounter:ORKRecorderCounterBytesWritten by:(int64_t)(endOffset - startOffset)];
+        } else {
+            [metrics incrementCounter:ORKRecorderCounterAppendErrors by:1];
+        }
+    }
     
     // Quick check to see if we've run over the maximum log file size
-    if ((self.maximumCurrentLogFileSize > 0) && ([_currentFileHandle offsetInFile] >= self.maximumCurrentLogFileSize)) {
+    if ((self.maximumCurrentLogFileSize > 0) && (endOffset >= self.maximumCurrentLogFileSize)) {
+        [metrics incrementCounter:ORKRecorderCounterLogRollovers by:1];
         [self queue_rollover];
     }
+    
+    [metrics endInterval:interval inHistogram:ORKRecorderHistogramAppendLatency];
     return result;
 }
 
@@ -36,6 +36,7 @@
 NS_ASSUME_NONNULL_BEGIN
 
 @class CMDeviceMotion;
+@class ORKDeviceMotionRecorder;
 
 @protocol ORKDeviceMotionRecorderDelegate <ORKRecorderDelegate>
 
@@ -43,6 +44,19 @@ NS_ASSUME_NONNULL_BEGIN
 
 - (void)deviceMotionRecorderDidUpdateWithMotion:(CMDeviceMotion *)motion;
 
+/**
+ Tells the delegate that the recorder has written a batch of samples.
+ 
+ This method is called on the recorder's capture queue, not on the main queue, with the samples
+ in timestamp order. Implement it instead of `deviceMotionRecorderDidUpdateWithMotion:` to
+ process every sample without a main queue dispatch per sample. The recorder waits for it to
+ return before handling the next batch, and before `stop` returns.
+ 
+ @param recorder    The recorder that captured the samples.
+ @param samples     The captured samples.
+ */
+- (void)deviceMotionRecorder:(ORKDeviceMotionRecorder *)recorder didCaptureMotionSamples:(NSArray<CMDeviceMotion *> *)samples;
+
 @end
 
 /**
@@ -50,6 +64,12 @@ NS_ASSUME_NONNULL_BEGIN
  
  To ensure that the motion recorder continues to record when the app enters the
  background, use the background task support provided by `UIApplication`.
+ 
+ Samples are written from a dedicated serial queue through a bounded buffer, as described for
+ `ORKAccelerometerRecorder`, and the file result's `userInfo` dictionary reports the same counters.
+ The `deviceMotionRecorderDidUpdateWithMotion:` delegate method is called on the main queue, and
+ the `deviceMotionRecorder:didCaptureMotionSamples:` delegate method on the capture queue. Neither
+ is called for samples dropped because the buffer was full or out of order.
  */
 ORK_CLASS_AVAILABLE
 @interface ORKDeviceMotionRecorder : ORKRecorder
@@ -59,6 +79,16 @@ ORK_CLASS_AVAILABLE
  */
 @property (nonatomic, readonly) double frequency;
 
+/**
+ A Boolean value indicating whether the recorder runs the device motion samples through an on-device
+ gait analysis stage.
+ 
+ When the value of this property is `YES`, the recorder reports an `ORKGaitSummaryResult` object,
+ whose identifier is the recorder identifier followed by `_gait`, through the delegate's
+ `recorder:didReportAdditionalResult:` method, just before it completes with its `ORKFileResult` object.
+ */
+@property (nonatomic, assign) BOOL includesGaitSummary;
+
 /**
  Returns an initialized device motion recorder using the specified frequency.
  
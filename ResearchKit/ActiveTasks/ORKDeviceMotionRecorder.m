@@ -31,7 +31,11 @@
 
 #import "ORKDeviceMotionRecorder.h"
 
-#import "ORKDataLogger.h"
+#import "ORKDataLogger_Internal.h"
+#import "ORKGaitAnalyzer.h"
+#import "ORKRecorderCaptureQueue.h"
+#import "ORKRecorderMetrics.h"
+#import "ORKSensorHub.h"
 
 #import "ORKRecorder_Internal.h"
 
@@ -43,9 +47,12 @@
 
 @interface ORKDeviceMotionRecorder () {
     ORKDataLogger *_logger;
+    ORKGaitAnalyzer *_gaitAnalyzer;
+    ORKRecorderCaptureQueue *_captureQueue;
+    id _sensorConsumer;
 }
 
-@property (nonatomic, strong) CMMotionManager *motionManager;
+@property (nonatomic, strong) ORKSensorHub *sensorHub;
 
 @property (nonatomic) NSTimeInterval uptime;
 
@@ -80,8 +87,10 @@
     }
 }
 
+// Returns `nil` to share the motion manager of `[ORKSensorHub sharedHub]`; overridden by tests.
 - (CMMotionManager *)createMotionManager {
-    return [[CMMotionManager alloc] init];
+    id<ORKRecorderSampleSource> sampleSource = self.sampleSource;
+    return [sampleSource respondsToSelector:@selector(motionManagerForRecorder:)] ? [sampleSource motionManagerForRecorder:self] : nil;
 }
 
 - (void)start {
@@ -96,36 +105,99 @@
         }
     }
     
-    self.motionManager = [self createMotionManager];
-    self.motionManager.deviceMotionUpdateInterval = 1.0 / _frequency;
+    CMMotionManager *motionManager = [self createMotionManager];
+    self.sensorHub = motionManager ? [[ORKSensorHub alloc] initWithMotionManager:motionManager] : [ORKSensorHub sharedHub];
     
     self.uptime = [NSProcessInfo processInfo].systemUptime;
     
-    [self.motionManager stopDeviceMotionUpdates];
+    [self doStopRecording];
+    
+    _gaitAnalyzer = self.includesGaitSummary ? [[ORKGaitAnalyzer alloc] initWithFrequency:_frequency] : nil;
+    ORKGaitAnalyzer *gaitAnalyzer = _gaitAnalyzer;
+    ORKRecorderMetrics *metrics = self.metrics;
+    [metrics reset];
+    ORKDataLogger *logger = _logger;
+    logger.metrics = metrics;
+    __weak typeof(self) weakSelf = self;
+    
+    // The capture queue hands over samples in timestamp order, as the gait analyzer expects.
+    ORKRecorderCaptureQueue *captureQueue = [[ORKRecorderCaptureQueue alloc] initWithLabel:@"org.researchkit.recorder.deviceMotion"
+                                                                                  capacity:[ORKRecorderCaptureQueue capacityForFrequency:_frequency]
+                                                                                   handler:^(NSArray *samples) {
+        NSMutableArray *dictionaries = [NSMutableArray arrayWithCapacity:samples.count];
+        for (CMDeviceMotion *data in samples) {
+            [dictionaries addObject:[data ork_JSONDictionary]];
+            CMAcceleration gravity = data.gravity;
+            CMAcceleration userAcceleration = data.userAcceleration;
+            [gaitAnalyzer appendAccelerationX:gravity.x + userAcceleration.x
+                                            y:gravity.y + userAcceleration.y
+                                            z:gravity.z + userAcceleration.z
+                                    timestamp:data.timestamp];
+        }
+        NSError *error = nil;
+        if (![logger appendObjects:dictionaries error:&error]) {
+            [weakSelf finishRecordingWithErrorOnMainQueue:error];
+        }
+        
+        __strong typeof(self) strongSelf = weakSelf;
+        id delegate = strongSelf.delegate;
+        if ([delegate respondsToSelector:@selector(deviceMotionRecorder:didCaptureMotionSamples:)]) {
+            [delegate deviceMotionRecorder:strongSelf didCaptureMotionSamples:samples];
+        }
+    }];
+    _captureQueue = captureQueue;
     
-    [self.motionManager startDeviceMotionUpdatesToQueue:[NSOperationQueue mainQueue] withHandler:^(CMDeviceMotion *data, NSError *error) {
-         BOOL success = NO;
+    // Only the live delegate callback goes to the main queue.
+    _sensorConsumer = [self.sensorHub addDeviceMotionConsumerWithFrequency:_frequency handler:^(CMDeviceMotion *data, NSError *error) {
          if (data) {
-             success = [_logger append:[data ork_JSONDictionary] error:&error];
-             id delegate = self.delegate;
-             if ([delegate respondsToSelector:@selector(deviceMotionRecorderDidUpdateWithMotion:)]) {
-                 [delegate deviceMotionRecorderDidUpdateWithMotion:data];
+             [metrics recordSampleWithTimestamp:data.timestamp];
+             if (![captureQueue enqueueSample:data timestamp:data.timestamp]) {
+                 // Dropped samples are not passed on either, so the delegate sees what the file contains.
+                 [metrics incrementCounter:ORKRecorderCounterSamplesDropped by:1];
+                 return;
              }
-         }
-         if (!success) {
-             dispatch_async(dispatch_get_main_queue(), ^{
-                 [self finishRecordingWithError:error];
-             });
+             
+             __strong typeof(self) strongSelf = weakSelf;
+             if ([strongSelf.delegate respondsToSelector:@selector(deviceMotionRecorderDidUpdateWithMotion:)]) {
+                 dispatch_async(dispatch_get_main_queue(), ^{
+                     id delegate = strongSelf.delegate;
+                     if (strongSelf.isRecording && [delegate respondsToSelector:@selector(deviceMotionRecorderDidUpdateWithMotion:)]) {
+                         [delegate deviceMotionRecorderDidUpdateWithMotion:data];
+                     }
+                 });
+             }
+         } else {
+             [weakSelf finishRecordingWithErrorOnMainQueue:error];
          }
      }];
+    
+    if (!_sensorConsumer) {
+        NSError *error = [NSError errorWithDomain:NSCocoaErrorDomain
+                                             code:NSFeatureUnsupportedError
+                                         userInfo:@{@"recorder": self}];
+        [self finishRecordingWithError:error];
+    }
 }
 
 - (NSString *)recorderType {
     return @"deviceMotion";
 }
 
+- (void)finishRecordingWithErrorOnMainQueue:(NSError *)error {
+    dispatch_async(dispatch_get_main_queue(), ^{
+        if (self.isRecording) {
+            [self finishRecordingWithError:error];
+        }
+    });
+}
+
+- (NSDictionary *)userInfo {
+    return [_captureQueue statistics];
+}
+
 - (void)stop {
     [self doStopRecording];
+    [_captureQueue flush];
     [_logger finishCurrentLog];
     
     NSError *error = nil;
@@ -134,6 +206,13 @@
         fileUrl = logFileUrl;
     } error:&error];
     
+    ORKGaitAnalyzer *gaitAnalyzer = _gaitAnalyzer;
+    _gaitAnalyzer = nil;
+    
+    // Reported ahead of the file result, which completes the recording.
+    if (fileUrl && !error && gaitAnalyzer) {
+        [self reportAdditionalResult:[gaitAnalyzer summaryResultWithIdentifier:[self.identifier stringByAppendingString:@"_gait"]]];
+    }
     [self reportFileResultWithFile:fileUrl error:error];
     
     [super stop];
@@ -141,8 +220,9 @@
 
 - (void)doStopRecording {
     if (self.isRecording) {
-        [self.motionManager stopDeviceMotionUpdates];
-        self.motionManager = nil;
+        // Waits for samples already being delivered to reach the logger and the gait analyzer.
+        [self.sensorHub removeConsumer:_sensorConsumer];
+        _sensorConsumer = nil;
     }
 }
 
@@ -152,7 +232,7 @@
 }
 
 - (BOOL)isRecording {
-    return self.motionManager.deviceMotionActive;
+    return (_sensorConsumer != nil);
 }
 
 - (NSString *)mimeType {
@@ -186,16 +266,19 @@
 #pragma clang diagnostic pop
 
 - (ORKRecorder *)recorderForStep:(ORKStep *)step outputDirectory:(NSURL *)outputDirectory {
-    return [[ORKDeviceMotionRecorder alloc] initWithIdentifier:self.identifier
-                                                     frequency:self.frequency
-                                                          step:step
-                                               outputDirectory:outputDirectory];
+    ORKDeviceMotionRecorder *recorder = [[ORKDeviceMotionRecorder alloc] initWithIdentifier:self.identifier
+                                                                                  frequency:self.frequency
+                                                                                       step:step
+                                                                            outputDirectory:outputDirectory];
+    recorder.includesGaitSummary = self.includesGaitSummary;
+    return recorder;
 }
 
 - (instancetype)initWithCoder:(NSCoder *)aDecoder {
     self = [super initWithCoder:aDecoder];
     if (self) {
         ORK_DECODE_DOUBLE(aDecoder, frequency);
+        ORK_DECODE_BOOL(aDecoder, includesGaitSummary);
     }
     return self;
 }
@@ -203,6 +286,7 @@
 - (void)encodeWithCoder:(NSCoder *)aCoder {
     [super encodeWithCoder:aCoder];
     ORK_ENCODE_DOUBLE(aCoder, frequency);
+    ORK_ENCODE_BOOL(aCoder, includesGaitSummary);
 }
 
 + (BOOL)supportsSecureCoding {
@@ -214,7 +298,8 @@
     
     __typeof(self) castObject = object;
     return (isParentSame &&
-            (self.frequency == castObject.frequency));
+            (self.frequency == castObject.frequency) &&
+            (self.includesGaitSummary == castObject.includesGaitSummary));
 }
 
 - (ORKPermissionMask)requestedPermissionMask {
@@ -0,0 +1,77 @@
+/*
+ Copyright (c) 2016, Apple Inc. All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+ 
+ 1.  Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ 2.  Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation and/or
+ other materials provided with the distribution.
+ 
+ 3.  Neither the name of the copyright holder(s) nor the names of any contributors
+ may be used to endorse or promote products derived from this software without
+ specific prior written permission. No license is granted to the trademarks of
+ the copyright holders even if such marks are included in this software.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+@import Foundation;
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+@class ORKGaitSummaryResult;
+
+/**
+ The `ORKGaitAnalyzer` class incrementally extracts gait features from a stream of
+ acceleration samples (in g, including gravity).
+
+ Samples are buffered into fixed-size blocks and run through vectorized biquad filters:
+ a low-pass filter tracks the gravity vector, the dynamic acceleration is projected
+ onto it to obtain the vertical component, and the vertical component is smoothed
+ before step peaks are detected. Only running sums are kept between blocks, so memory
+ use does not grow with the length of the recording.
+
+ An analyzer is not thread-safe; all samples must be appended from the same serial queue.
+ */
+@interface ORKGaitAnalyzer : NSObject
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/**
+ Returns an initialized analyzer for samples arriving at the given frequency.
+
+ @param frequency   The sampling frequency, in hertz (Hz).
+
+ @return An initialized gait analyzer.
+ */
+- (instancetype)initWithFrequency:(double)frequency NS_DESIGNATED_INITIALIZER;
+
+@property (nonatomic, readonly) double frequency;
+
+// Appends a single acceleration sample. The timestamp is in seconds, in the time base of CoreMotion.
+- (void)appendAccelerationX:(double)x y:(double)y z:(double)z timestamp:(NSTimeInterval)timestamp;
+
+// Processes any buffered samples and returns the features extracted so far.
+- (ORKGaitSummaryResult *)summaryResultWithIdentifier:(NSString *)identifier;
+
+// Discards all buffered samples and accumulated features.
+- (void)reset;
+
+@end
+
+NS_ASSUME_NONNULL_END
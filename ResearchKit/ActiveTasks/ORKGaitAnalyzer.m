@@ -0,0 +1,289 @@
+/*
+ Copyright (c) 2016, Apple Inc. All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+ 
+ 1.  Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ 2.  Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation and/or
+ other materials provided with the distribution.
+ 
+ 3.  Neither the name of the copyright holder(s) nor the names of any contributors
+ may be used to endorse or promote products derived from this software without
+ specific prior written permission. No license is granted to the trademarks of
+ the copyright holders even if such marks are included in this software.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#import "ORKGaitAnalyzer.h"
+
+#import "ORKResult.h"
+
+#import "ORKHelpers_Internal.h"
+
+@import Accelerate;
+
+
+// Number of samples processed per vectorized pass.
+#define ORKGaitBlockLength 128
+
+static const double ORKGaitGravityCutoffFrequency = 0.3;
+static const double ORKGaitStepCutoffFrequency = 3.0;
+
+// Minimum smoothed vertical acceleration (in g) for a peak to count as a step.
+static const double ORKGaitStepThreshold = 0.08;
+
+// Peaks closer together than this are treated as part of the same step (240 steps/min).
+static const NSTimeInterval ORKGaitMinimumStepInterval = 0.25;
+
+// Strides longer than this span a pause or a turn and are left out of the variability estimate.
+static const NSTimeInterval ORKGaitMaximumStrideDuration = 2.5;
+
+/*
+ Second order Butterworth low-pass section in the layout expected by vDSP_deq22D.
+ The first two elements of `input` and `output` carry the filter history between blocks.
+ */
+typedef struct {
+    double coefficients[5];
+    double input[ORKGaitBlockLength + 2];
+    double output[ORKGaitBlockLength + 2];
+} ORKBiquadFilter;
+
+static void ORKBiquadFilterInitialize(ORKBiquadFilter *filter, double cutoff, double frequency) {
+    cutoff = MIN(cutoff, 0.45 * frequency);
+    double w0 = 2 * M_PI * cutoff / frequency;
+    double cosw0 = cos(w0);
+    double alpha = sin(w0) / M_SQRT2;
+    double a0 = 1 + alpha;
+
+    filter->coefficients[0] = (1 - cosw0) / 2 / a0;
+    filter->coefficients[1] = (1 - cosw0) / a0;
+    filter->coefficients[2] = (1 - cosw0) / 2 / a0;
+    filter->coefficients[3] = -2 * cosw0 / a0;
+    filter->coefficients[4] = (1 - alpha) / a0;
+
+    memset(filter->input, 0, sizeof(filter->input));
+    memset(filter->output, 0, sizeof(filter->output));
+}
+
+// Seeds the history so that a constant input produces no start-up transient.
+static void ORKBiquadFilterPrime(ORKBiquadFilter *filter, double value) {
+    filter->input[0] = filter->input[1] = value;
+    filter->output[0] = filter->output[1] = value;
+}
+
+static void ORKBiquadFilterRun(ORKBiquadFilter *filter, vDSP_Length count) {
+    vDSP_deq22D(filter->input, 1, filter->coefficients, filter->output, 1, count);
+
+    filter->input[0] = filter->input[count];
+    filter->input[1] = filter->input[count + 1];
+    filter->output[0] = filter->output[count];
+    filter->output[1] = filter->output[count + 1];
+}
+
+
+@implementation ORKGaitAnalyzer {
+    ORKBiquadFilter _gravityFilters[3];
+    ORKBiquadFilter _stepFilter;
+    double _dynamic[3][ORKGaitBlockLength];
+    double _scratch[2][ORKGaitBlockLength];
+    NSTimeInterval _timestamps[ORKGaitBlockLength];
+    NSUInteger _bufferedCount;
+
+    NSUInteger _sampleCount;
+    NSTimeInterval _firstTimestamp;
+    NSTimeInterval _lastTimestamp;
+    double _verticalSumOfSquares;
+    double _horizontalSumOfSquares;
+
+    // Peak detection state, carried across blocks.
+    NSUInteger _smoothedCount;
+    double _smoothed[2];
+    NSTimeInterval _smoothedTimestamp;
+
+    NSInteger _numberOfSteps;
+    NSTimeInterval _firstStepTime;
+    NSTimeInterval _recentStepTimes[2];
+
+    // Welford accumulators for stride duration.
+    NSUInteger _strideCount;
+    double _strideMean;
+    double _strideM2;
+}
+
+- (instancetype)init {
+    ORKThrowMethodUnavailableException();
+}
+
+- (instancetype)initWithFrequency:(double)frequency {
+    self = [super init];
+    if (self) {
+        _frequency = (frequency > 0) ? frequency : 1;
+        [self reset];
+    }
+    return self;
+}
+
+- (void)reset {
+    for (NSUInteger axis = 0; axis < 3; axis++) {
+        ORKBiquadFilterInitialize(&_gravityFilters[axis], ORKGaitGravityCutoffFrequency, _frequency);
+    }
+    ORKBiquadFilterInitialize(&_stepFilter, ORKGaitStepCutoffFrequency, _frequency);
+
+    _bufferedCount = 0;
+    _sampleCount = 0;
+    _firstTimestamp = 0;
+    _lastTimestamp = 0;
+    _verticalSumOfSquares = 0;
+    _horizontalSumOfSquares = 0;
+    _smoothedCount = 0;
+    _numberOfSteps = 0;
+    _firstStepTime = 0;
+    _strideCount = 0;
+    _strideMean = 0;
+    _strideM2 = 0;
+}
+
+- (void)appendAccelerationX:(double)x y:(double)y z:(double)z timestamp:(NSTimeInterval)timestamp {
+    if (_sampleCount == 0) {
+        ORKBiquadFilterPrime(&_gravityFilters[0], x);
+        ORKBiquadFilterPrime(&_gravityFilters[1], y);
+        ORKBiquadFilterPrime(&_gravityFilters[2], z);
+        _firstTimestamp = timestamp;
+    }
+    _sampleCount++;
+    _lastTimestamp = timestamp;
+
+    NSUInteger index = _bufferedCount + 2;
+    _gravityFilters[0].input[index] = x;
+    _gravityFilters[1].input[index] = y;
+    _gravityFilters[2].input[index] = z;
+    _timestamps[_bufferedCount] = timestamp;
+    _bufferedCount++;
+
+    if (_bufferedCount == ORKGaitBlockLength) {
+        [self processBufferedSamples];
+    }
+}
+
+- (void)processBufferedSamples {
+    vDSP_Length n = _bufferedCount;
+    if (n == 0) {
+        return;
+    }
+
+    // Separate gravity from the dynamic (user) acceleration.
+    for (NSUInteger axis = 0; axis < 3; axis++) {
+        ORKBiquadFilterRun(&_gravityFilters[axis], n);
+        vDSP_vsubD(_gravityFilters[axis].output + 2, 1, _gravityFilters[axis].input + 2, 1, _dynamic[axis], 1, n);
+    }
+    const double *gx = _gravityFilters[0].output + 2;
+    const double *gy = _gravityFilters[1].output + 2;
+    const double *gz = _gravityFilters[2].output + 2;
+
+    // Vertical component: (d . g) / |g|
+    double *dot = _scratch[0];
+    double *norm = _scratch[1];
+    vDSP_vmmaD(_dynamic[0], 1, gx, 1, _dynamic[1], 1, gy, 1, dot, 1, n);
+    vDSP_vmaD(_dynamic[2], 1, gz, 1, dot, 1, dot, 1, n);
+    vDSP_vmmaD(gx, 1, gx, 1, gy, 1, gy, 1, norm, 1, n);
+    vDSP_vmaD(gz, 1, gz, 1, norm, 1, norm, 1, n);
+    int count = (int)n;
+    vvsqrt(norm, norm, &count);
+    const double minimumNorm = 1e-3;
+    vDSP_vthrD(norm, 1, &minimumNorm, norm, 1, n);
+    double *vertical = _stepFilter.input + 2;
+    vDSP_vdivD(norm, 1, dot, 1, vertical, 1, n);
+
+    // Sway: whatever dynamic energy is not vertical is horizontal.
+    double *magnitudeSquared = _scratch[0];
+    vDSP_vmmaD(_dynamic[0], 1, _dynamic[0], 1, _dynamic[1], 1, _dynamic[1], 1, magnitudeSquared, 1, n);
+    vDSP_vmaD(_dynamic[2], 1, _dynamic[2], 1, magnitudeSquared, 1, magnitudeSquared, 1, n);
+    double dynamicSum = 0;
+    double verticalSum = 0;
+    vDSP_sveD(magnitudeSquared, 1, &dynamicSum, n);
+    vDSP_svesqD(vertical, 1, &verticalSum, n);
+    _verticalSumOfSquares += verticalSum;
+    _horizontalSumOfSquares += MAX(dynamicSum - verticalSum, 0);
+
+    // Smooth the vertical component and look for peaks.
+    ORKBiquadFilterRun(&_stepFilter, n);
+    const double *smoothed = _stepFilter.output + 2;
+    for (vDSP_Length i = 0; i < n; i++) {
+        if (_smoothedCount >= 2 &&
+            _smoothed[1] > _smoothed[0] &&
+            _smoothed[1] >= smoothed[i] &&
+            _smoothed[1] > ORKGaitStepThreshold) {
+            [self registerStepAtTime:_smoothedTimestamp];
+        }
+        _smoothed[0] = _smoothed[1];
+        _smoothed[1] = smoothed[i];
+        _smoothedTimestamp = _timestamps[i];
+        _smoothedCount++;
+    }
+
+    _bufferedCount = 0;
+}
+
+- (void)registerStepAtTime:(NSTimeInterval)time {
+    if (_numberOfSteps > 0 && (time - _recentStepTimes[1]) < ORKGaitMinimumStepInterval) {
+        return;
+    }
+
+    if (_numberOfSteps == 0) {
+        _firstStepTime = time;
+    }
+    if (_numberOfSteps >= 2) {
+        // A stride spans two steps, from one foot strike to the next strike of the same foot.
+        NSTimeInterval stride = time - _recentStepTimes[0];
+        if (stride <= ORKGaitMaximumStrideDuration) {
+            _strideCount++;
+            double delta = stride - _strideMean;
+            _strideMean += delta / _strideCount;
+            _strideM2 += delta * (stride - _strideMean);
+        }
+    }
+    _recentStepTimes[0] = _recentStepTimes[1];
+    _recentStepTimes[1] = time;
+    _numberOfSteps++;
+}
+
+- (ORKGaitSummaryResult *)summaryResultWithIdentifier:(NSString *)identifier {
+    [self processBufferedSamples];
+
+    ORKGaitSummaryResult *result = [[ORKGaitSummaryResult alloc] initWithIdentifier:identifier];
+    result.numberOfSteps = _numberOfSteps;
+    result.duration = _lastTimestamp - _firstTimestamp;
+
+    NSTimeInterval walkingDuration = _recentStepTimes[1] - _firstStepTime;
+    if (_numberOfSteps >= 2 && walkingDuration > 0) {
+        result.cadence = (_numberOfSteps - 1) * 60.0 / walkingDuration;
+    }
+    if (_strideCount > 0) {
+        result.meanStrideDuration = _strideMean;
+    }
+    if (_strideCount > 1 && _strideMean > 0) {
+        result.strideDurationVariability = sqrt(_strideM2 / (_strideCount - 1)) / _strideMean;
+    }
+    if (_sampleCount > 0) {
+        result.verticalAccelerationRMS = sqrt(_verticalSumOfSquares / _sampleCount);
+        result.horizontalAccelerationRMS = sqrt(_horizontalSumOfSquares / _sampleCount);
+    }
+    return result;
+}
+
+@end
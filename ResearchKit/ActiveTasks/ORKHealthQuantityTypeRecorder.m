@@ -35,6 +35,9 @@
 #import "ORKRecorder_Private.h"
 #import "ORKRecorder_Internal.h"
 #import "HKSample+ORKJSONDictionary.h"
+#import "ORKQueryPageSizer.h"
+
+#include <stdatomic.h>
 
 
 @interface ORKHealthQuantityTypeRecorder () {
@@ -43,11 +46,22 @@
     HKHealthStore *_healthStore;
     NSPredicate *_samplePredicate;
     HKObserverQuery *_observerQuery;
+    HKQuantitySample *_lastSample;
+    ORKQueryPageSizer *_pageSizer;
+    
+    // Logging, and the anchor it advances, happen on this queue, keeping file writes off the main thread.
+    dispatch_queue_t _loggingQueue;
+    
+    // Only accessed on the logging queue.
+    BOOL _loggingEnabled;
     /// Either the HKQueryAnchor object *or* NSUInteger value are tracked since the initializer for
     /// iOS 8 and iOS 9 use different objects. Only one will actually be referenced in the initalizer.
     HKQueryAnchor *_anchor;
     NSUInteger _anchorValue;
-    HKQuantitySample *_lastSample;
+    
+    // Pages waiting for the logging queue.
+    _Atomic(NSInteger) _pendingWriteCount;
+    _Atomic(NSInteger) _maximumPendingWriteCount;
 }
 
 @end
@@ -86,6 +100,8 @@
         self.continuesInBackground = YES;
         _anchorValue = HKAnchoredObjectQueryNoAnchor;
         _anchor = [HKQueryAnchor anchorFromValue:_anchorValue];
+        _pageSizer = [[ORKQueryPageSizer alloc] initWithInitialLimit:100 minimumLimit:100 maximumLimit:5000];
+        _loggingQueue = dispatch_queue_create("org.researchkit.recorder.healthquantity", DISPATCH_QUEUE_SERIAL);
     }
     return self;
 }
@@ -105,37 +121,62 @@
     }
 }
 
-static const NSInteger _HealthAnchoredQueryLimit = 100;
-
-- (void)query_logResults:(NSArray *)results withAnchor:(HKQueryAnchor*)newAnchor anchorValue:(NSUInteger)anchorValue {
+- (void)query_logResults:(NSArray *)results withAnchor:(HKQueryAnchor*)newAnchor anchorValue:(NSUInteger)anchorValue limit:(NSUInteger)limit queryDuration:(NSTimeInterval)queryDuration {
     
     NSUInteger resultCount = results.count;
     if (resultCount == 0) {
         return;
     }
     
+    CFAbsoluteTime processingStartTime = CFAbsoluteTimeGetCurrent();
+    
     // Do conversion to dictionary on whatever queue we happen to be on.
     NSMutableArray *dictionaries = [NSMutableArray arrayWithCapacity:resultCount];
     [results enumerateObjectsUsingBlock:^(HKQuantitySample *sample, NSUInteger idx, BOOL *stop) {
         [dictionaries addObject:[sample ork_JSONDictionaryWithOptions:ORKSampleIncludeSource|ORKSampleIncludeMetadata unit:_unit]];
     }];
     
+    // Only the notification needs the main thread.
+    HKQuantitySample *lastSample = results.lastObject;
     dispatch_async(dispatch_get_main_queue(), ^{
-        [self updateMostRecentSample:results.lastObject];
+        [self updateMostRecentSample:lastSample];
+    });
+    
+    NSInteger pendingWriteCount = atomic_fetch_add(&_pendingWriteCount, 1) + 1;
+    NSInteger maximumPendingWriteCount = atomic_load(&_maximumPendingWriteCount);
+    while (pendingWriteCount > maximumPendingWriteCount
+           && !atomic_compare_exchange_weak(&_maximumPendingWriteCount, &maximumPendingWriteCount, pendingWriteCount)) {
+    }
+    
+    dispatch_async(_loggingQueue, ^{
+        atomic_fetch_sub(&_pendingWriteCount, 1);
+        if (!_loggingEnabled) {
+            return;
+        }
         
         NSError *error = nil;
         if (![_logger appendObjects:dictionaries error:&error]) {
             // Logger writes are unrecoverable
-            [self finishRecordingWithError:error];
+            _loggingEnabled = NO;
+            dispatch_async(dispatch_get_main_queue(), ^{
+                [self finishRecordingWithError:error];
+            });
             return;
         }
         
         _anchor = newAnchor;
         _anchorValue = anchorValue;
         
-        if (resultCount == _HealthAnchoredQueryLimit) {
+        [_pageSizer recordPageWithCount:resultCount
+                                  limit:limit
+                          queryDuration:queryDuration
+                     processingDuration:CFAbsoluteTimeGetCurrent() - processingStartTime];
+        
+        if (resultCount == limit) {
             // Do another fetch immediately rather than wait for an observation
-            [self doFetchNewData];
+            dispatch_async(dispatch_get_main_queue(), ^{
+                [self doFetchNewData];
+            });
         }
     });
 }
@@ -146,6 +187,20 @@ static const NSInteger _HealthAnchoredQueryLimit = 100;
     }
     NSAssert(_samplePredicate != nil, @"Sample predicate should be non-nil if recording");
     
+    HKHealthStore *healthStore = _healthStore;
+    NSPredicate *samplePredicate = _samplePredicate;
+    
+    // The anchor belongs to the logging queue, which also orders this query after the pages already received.
+    dispatch_async(_loggingQueue, ^{
+        if (_loggingEnabled) {
+            [self logging_executeAnchoredQueryWithHealthStore:healthStore predicate:samplePredicate];
+        }
+    });
+}
+
+- (void)logging_executeAnchoredQueryWithHealthStore:(HKHealthStore *)healthStore predicate:(NSPredicate *)samplePredicate {
+    NSUInteger limit = _pageSizer.limit;
+    CFAbsoluteTime queryStartTime = CFAbsoluteTimeGetCurrent();
     __weak typeof(self) weakSelf = self;
     void (^handleResults)(NSArray <__kindof HKSample *> *, HKQueryAnchor *, NSUInteger, NSError *) = ^ (NSArray *results, HKQueryAnchor *newAnchor, NSUInteger newAnchorValue, NSError *error) {
         if (error) {
@@ -155,7 +210,7 @@ static const NSInteger _HealthAnchoredQueryLimit = 100;
         }
         
         __typeof(self) strongSelf = weakSelf;
-        [strongSelf query_logResults:results withAnchor:newAnchor anchorValue:newAnchorValue];
+        [strongSelf query_logResults:results withAnchor:newAnchor anchorValue:newAnchorValue limit:limit queryDuration:CFAbsoluteTimeGetCurrent() - queryStartTime];
     };
     
     
@@ -163,9 +218,9 @@ static const NSInteger _HealthAnchoredQueryLimit = 100;
     if ([HKAnchoredObjectQuery instancesRespondToSelector:@selector(initWithType:predicate:anchor:limit:resultsHandler:)]) {
         
         anchoredQuery = [[HKAnchoredObjectQuery alloc] initWithType:_quantityType
-                                                          predicate:_samplePredicate
+                                                          predicate:samplePredicate
                                                              anchor:_anchor
-                                                              limit:_HealthAnchoredQueryLimit
+                                                              limit:limit
                                                      resultsHandler:
                          ^(HKAnchoredObjectQuery *query, NSArray *sampleObjects, NSArray *deletedObjects, HKQueryAnchor *newAnchor, NSError *error) {
                              handleResults(sampleObjects, newAnchor, 0, error);
@@ -174,9 +229,9 @@ static const NSInteger _HealthAnchoredQueryLimit = 100;
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Wdeprecated-declarations"
         anchoredQuery = [[HKAnchoredObjectQuery alloc] initWithType:_quantityType
-                                                          predicate:_samplePredicate
+                                                          predicate:samplePredicate
                                                              anchor:_anchorValue
-                                                              limit:_HealthAnchoredQueryLimit
+                                                              limit:limit
                                                   completionHandler:
                          ^(HKAnchoredObjectQuery *query, NSArray<__kindof HKSample *> *results, NSUInteger newAnchor, NSError *error) {
                              handleResults(results, nil, newAnchor, error);
@@ -186,7 +241,7 @@ static const NSInteger _HealthAnchoredQueryLimit = 100;
     else {
         NSAssert(NO, @"Could not instantiate an HKAnchoredObjectQuery.");
     }
-    [_healthStore executeQuery:anchoredQuery];
+    [healthStore executeQuery:anchoredQuery];
 }
 
 - (void)start {
@@ -245,6 +300,9 @@ static const NSInteger _HealthAnchoredQueryLimit = 100;
                       }];
     
     _isRecording = YES;
+    dispatch_async(_loggingQueue, ^{
+        _loggingEnabled = YES;
+    });
     [_healthStore executeQuery:_observerQuery];
 }
 
@@ -258,6 +316,8 @@ static const NSInteger _HealthAnchoredQueryLimit = 100;
     }
     
     [self doStopRecording];
+    // Wait for the pages already received to be written.
+    dispatch_sync(_loggingQueue, ^{});
     [_logger finishCurrentLog];
     
     NSError *error = nil;
@@ -279,6 +339,9 @@ static const NSInteger _HealthAnchoredQueryLimit = 100;
         
         _samplePredicate = nil;
         _isRecording = NO;
+        dispatch_async(_loggingQueue, ^{
+            _loggingEnabled = NO;
+        });
         
         [self updateMostRecentSample:nil];
     }
@@ -293,6 +356,10 @@ static const NSInteger _HealthAnchoredQueryLimit = 100;
     return _isRecording;
 }
 
+- (NSDictionary *)userInfo {
+    return @{@"maximumPendingWriteCount": @(atomic_load(&_maximumPendingWriteCount))};
+}
+
 - (NSString *)mimeType {
     return @"application/json";
 }
@@ -31,7 +31,8 @@
 
 #import "ORKLocationRecorder.h"
 
-#import "ORKDataLogger.h"
+#import "ORKDataLogger_Internal.h"
+#import "ORKRecorderMetrics.h"
 
 #import "ORKRecorder_Internal.h"
 
@@ -72,7 +73,9 @@
 }
 
 - (CLLocationManager *)createLocationManager {
-    return [[CLLocationManager alloc] init];
+    id<ORKRecorderSampleSource> sampleSource = self.sampleSource;
+    CLLocationManager *locationManager = [sampleSource respondsToSelector:@selector(locationManagerForRecorder:)] ? [sampleSource locationManagerForRecorder:self] : nil;
+    return locationManager ? : [[CLLocationManager alloc] init];
 }
 
 - (void)start {
@@ -87,6 +90,9 @@
         }
     }
     
+    [self.metrics reset];
+    _logger.metrics = self.metrics;
+    
     self.locationManager = [self createLocationManager];
     if ([CLLocationManager authorizationStatus] <= kCLAuthorizationStatusDenied) {
         [self.locationManager requestWhenInUseAuthorization];
@@ -134,8 +140,10 @@
     NSParameterAssert(locations.count >= 0);
     NSError *error = nil;
     if (locations) {
+        ORKRecorderMetrics *metrics = self.metrics;
         NSMutableArray *dictionaries = [NSMutableArray arrayWithCapacity:locations.count];
         [locations enumerateObjectsUsingBlock:^(CLLocation *obj, NSUInteger idx, BOOL *stop) {
+            [metrics recordSampleWithTimestamp:obj.timestamp.timeIntervalSinceReferenceDate];
             NSDictionary *d = [obj ork_JSONDictionary];
             [dictionaries addObject:d];
         }];
@@ -31,7 +31,8 @@
 
 #import "ORKPedometerRecorder.h"
 
-#import "ORKDataLogger.h"
+#import "ORKDataLogger_Internal.h"
+#import "ORKRecorderMetrics.h"
 
 #import "ORKRecorder_Internal.h"
 
@@ -83,7 +84,9 @@
 }
 
 - (CMPedometer *)createPedometer {
-    return [[CMPedometer alloc] init];
+    id<ORKRecorderSampleSource> sampleSource = self.sampleSource;
+    CMPedometer *pedometer = [sampleSource respondsToSelector:@selector(pedometerForRecorder:)] ? [sampleSource pedometerForRecorder:self] : nil;
+    return pedometer ? : [[CMPedometer alloc] init];
 }
 
 - (void)start {
@@ -102,6 +105,10 @@
         }
     }
     
+    ORKRecorderMetrics *metrics = self.metrics;
+    [metrics reset];
+    _logger.metrics = metrics;
+    
     self.pedometer = [self createPedometer];
     
     if (![[self.pedometer class] isStepCountingAvailable]) {
@@ -117,11 +124,14 @@
         
         BOOL success = NO;
         if (pedometerData) {
+            [metrics recordSampleWithTimestamp:pedometerData.endDate.timeIntervalSinceReferenceDate];
             success = [_logger append:[pedometerData ork_JSONDictionary] error:&error];
-            dispatch_async(dispatch_get_main_queue(), ^{
-                ORKStrongTypeOf(self) strongSelf = weakSelf;
-                [strongSelf updateStatisticsWithData:pedometerData];
-            });
+            if (success) {
+                dispatch_async(dispatch_get_main_queue(), ^{
+                    ORKStrongTypeOf(self) strongSelf = weakSelf;
+                    [strongSelf updateStatisticsWithData:pedometerData];
+                });
+            }
         }
         if (!success || error) {
             dispatch_async(dispatch_get_main_queue(), ^{
@@ -0,0 +1,84 @@
+/*
+ Copyright (c) 2016, Apple Inc. All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+ 
+ 1.  Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ 2.  Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation and/or
+ other materials provided with the distribution.
+ 
+ 3.  Neither the name of the copyright holder(s) nor the names of any contributors
+ may be used to endorse or promote products derived from this software without
+ specific prior written permission. No license is granted to the trademarks of
+ the copyright holders even if such marks are included in this software.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+@import Foundation;
+@import CoreMotion;
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// The angles tracked by an `ORKRangeOfMotionAnalyzer` object, in degrees.
+typedef struct {
+    /// The angle of the first attitude, which is the reference for the others.
+    double referenceAngle;
+    /// The smallest and largest angles relative to the reference, including 0.
+    double lowestAngle;
+    double highestAngle;
+    /// The angle of the latest attitude, relative to the reference.
+    double lastAngle;
+    NSUInteger sampleCount;
+} ORKRangeOfMotionSummary;
+
+/**
+ The `ORKRangeOfMotionAnalyzer` class follows the angle of the device relative to its first
+ attitude, working directly on attitude quaternions.
+ 
+ Attitudes are appended in batches from the recorder's queue and processed in fixed-size blocks with
+ vDSP and vForce. Only the running extremes and the latest angle are kept, so no object is created
+ per sample. The summary can be read from any thread.
+ */
+@interface ORKRangeOfMotionAnalyzer : NSObject
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/**
+ Returns an initialized analyzer.
+ 
+ @param landscape   Whether the device is held in a landscape orientation, in which case the angle
+                        is the roll of the device. Otherwise it is the pitch, over the full circle.
+ */
+- (instancetype)initWithLandscapeOrientation:(BOOL)landscape NS_DESIGNATED_INITIALIZER;
+
+@property (nonatomic, readonly, getter=isLandscapeOrientation) BOOL landscapeOrientation;
+
+// Appends attitudes in timestamp order. Must be called from a single serial queue.
+- (void)appendAttitudeQuaternions:(const CMQuaternion *)quaternions count:(NSUInteger)count;
+
+// Convenience for appending the attitudes of device motion samples.
+- (void)appendDeviceMotionSamples:(NSArray<CMDeviceMotion *> *)samples;
+
+@property (readonly) ORKRangeOfMotionSummary summary;
+
+- (void)reset;
+
+@end
+
+NS_ASSUME_NONNULL_END
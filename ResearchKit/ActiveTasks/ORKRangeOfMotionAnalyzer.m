@@ -0,0 +1,198 @@
+/*
+ Copyright (c) 2016, Apple Inc. All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+ 
+ 1.  Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ 2.  Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation and/or
+ other materials provided with the distribution.
+ 
+ 3.  Neither the name of the copyright holder(s) nor the names of any contributors
+ may be used to endorse or promote products derived from this software without
+ specific prior written permission. No license is granted to the trademarks of
+ the copyright holders even if such marks are included in this software.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#import "ORKRangeOfMotionAnalyzer.h"
+
+@import Accelerate;
+#include <pthread.h>
+
+
+#define ORKRadiansToDegrees(radians) ((radians) * 180.0 / M_PI)
+
+enum {
+    ORKRangeOfMotionBlockSize = 64
+};
+
+/*
+ Attitude quaternions are unit quaternions, so the inverse of the reference is its conjugate. Pitch
+ uses atan2 rather than `CMAttitude.pitch`, which only covers half a circle. Roll is
+ `CMAttitude.roll`, atan2(2(yw - xz), 1 - 2(x² + y²)).
+ */
+static double ORKDeviceAngleInDegrees(CMQuaternion q, BOOL landscape) {
+    double x = q.x, y = q.y, z = q.z, w = q.w;
+    if (landscape) {
+        return ORKRadiansToDegrees(atan2(2.0 * (y * w - x * z), 1.0 - 2.0 * (x * x + y * y)));
+    }
+    return ORKRadiansToDegrees(atan2(2.0 * (x * w + y * z), 1.0 - 2.0 * (x * x + z * z)));
+}
+
+/*
+ Computes the angles of up to one block of attitudes relative to the reference whose inverse is `r`,
+ that is the angles of the products r * q. The components are read straight out of the
+ `CMQuaternion` array with a stride of four.
+ */
+static void ORKRelativeDeviceAnglesInDegrees(const CMQuaternion *quaternions, CMQuaternion r, BOOL landscape, double *angles, vDSP_Length n) {
+    const double *x = &quaternions[0].x;
+    const double *y = &quaternions[0].y;
+    const double *z = &quaternions[0].z;
+    const double *w = &quaternions[0].w;
+    const vDSP_Stride stride = sizeof(CMQuaternion) / sizeof(double);
+    const double negativeX = -r.x, negativeY = -r.y, negativeZ = -r.z;
+    
+    double rx[ORKRangeOfMotionBlockSize];
+    double ry[ORKRangeOfMotionBlockSize];
+    double rz[ORKRangeOfMotionBlockSize];
+    double rw[ORKRangeOfMotionBlockSize];
+    
+    // rx = r.w x + r.x w + r.y z - r.z y
+    vDSP_vsmulD(x, stride, &r.w, rx, 1, n);
+    vDSP_vsmaD(w, stride, &r.x, rx, 1, rx, 1, n);
+    vDSP_vsmaD(z, stride, &r.y, rx, 1, rx, 1, n);
+    vDSP_vsmaD(y, stride, &negativeZ, rx, 1, rx, 1, n);
+    // ry = r.w y - r.x z + r.y w + r.z x
+    vDSP_vsmulD(y, stride, &r.w, ry, 1, n);
+    vDSP_vsmaD(z, stride, &negativeX, ry, 1, ry, 1, n);
+    vDSP_vsmaD(w, stride, &r.y, ry, 1, ry, 1, n);
+    vDSP_vsmaD(x, stride, &r.z, ry, 1, ry, 1, n);
+    // rz = r.w z + r.x y - r.y x + r.z w
+    vDSP_vsmulD(z, stride, &r.w, rz, 1, n);
+    vDSP_vsmaD(y, stride, &r.x, rz, 1, rz, 1, n);
+    vDSP_vsmaD(x, stride, &negativeY, rz, 1, rz, 1, n);
+    vDSP_vsmaD(w, stride, &r.z, rz, 1, rz, 1, n);
+    // rw = r.w w - r.x x - r.y y - r.z z
+    vDSP_vsmulD(w, stride, &r.w, rw, 1, n);
+    vDSP_vsmaD(x, stride, &negativeX, rw, 1, rw, 1, n);
+    vDSP_vsmaD(y, stride, &negativeY, rw, 1, rw, 1, n);
+    vDSP_vsmaD(z, stride, &negativeZ, rw, 1, rw, 1, n);
+    
+    // Reuses rx and rz as the atan2 operands once they are no longer needed.
+    double *numerator = angles;
+    double *denominator = landscape ? rx : rz;
+    const double two = 2.0, negativeTwo = -2.0, one = 1.0;
+    if (landscape) {
+        vDSP_vmmsbD(ry, 1, rw, 1, rx, 1, rz, 1, numerator, 1, n);
+        vDSP_vmmaD(rx, 1, rx, 1, ry, 1, ry, 1, denominator, 1, n);
+    } else {
+        vDSP_vmmaD(rx, 1, rw, 1, ry, 1, rz, 1, numerator, 1, n);
+        vDSP_vmmaD(rx, 1, rx, 1, rz, 1, rz, 1, denominator, 1, n);
+    }
+    vDSP_vsmulD(numerator, 1, &two, numerator, 1, n);
+    vDSP_vsmsaD(denominator, 1, &negativeTwo, &one, denominator, 1, n);
+    
+    int count = (int)n;
+    vvatan2(angles, numerator, denominator, &count);
+    const double degreesPerRadian = 180.0 / M_PI;
+    vDSP_vsmulD(angles, 1, &degreesPerRadian, angles, 1, n);
+}
+
+
+@implementation ORKRangeOfMotionAnalyzer {
+    // Only touched on the appending queue.
+    BOOL _hasReference;
+    CMQuaternion _inverseReference;
+    
+    pthread_mutex_t _lock;
+    ORKRangeOfMotionSummary _summary;
+}
+
+- (instancetype)initWithLandscapeOrientation:(BOOL)landscape {
+    self = [super init];
+    if (self) {
+        _landscapeOrientation = landscape;
+        pthread_mutex_init(&_lock, NULL);
+    }
+    return self;
+}
+
+- (void)dealloc {
+    pthread_mutex_destroy(&_lock);
+}
+
+- (void)appendAttitudeQuaternions:(const CMQuaternion *)quaternions count:(NSUInteger)count {
+    if (count == 0) {
+        return;
+    }
+    
+    ORKRangeOfMotionSummary summary = self.summary;
+    if (!_hasReference) {
+        _hasReference = YES;
+        CMQuaternion reference = quaternions[0];
+        _inverseReference = (CMQuaternion){ .x = -reference.x, .y = -reference.y, .z = -reference.z, .w = reference.w };
+        summary.referenceAngle = ORKDeviceAngleInDegrees(reference, _landscapeOrientation);
+    }
+    
+    double angles[ORKRangeOfMotionBlockSize];
+    for (NSUInteger offset = 0; offset < count; offset += ORKRangeOfMotionBlockSize) {
+        vDSP_Length n = MIN(count - offset, (NSUInteger)ORKRangeOfMotionBlockSize);
+        ORKRelativeDeviceAnglesInDegrees(quaternions + offset, _inverseReference, _landscapeOrientation, angles, n);
+        
+        double lowest, highest;
+        vDSP_minvD(angles, 1, &lowest, n);
+        vDSP_maxvD(angles, 1, &highest, n);
+        summary.lowestAngle = MIN(summary.lowestAngle, lowest);
+        summary.highestAngle = MAX(summary.highestAngle, highest);
+        summary.lastAngle = angles[n - 1];
+    }
+    summary.sampleCount += count;
+    
+    pthread_mutex_lock(&_lock);
+    _summary = summary;
+    pthread_mutex_unlock(&_lock);
+}
+
+- (void)appendDeviceMotionSamples:(NSArray<CMDeviceMotion *> *)samples {
+    CMQuaternion block[ORKRangeOfMotionBlockSize];
+    NSUInteger count = 0;
+    for (CMDeviceMotion *sample in samples) {
+        block[count++] = sample.attitude.quaternion;
+        if (count == ORKRangeOfMotionBlockSize) {
+            [self appendAttitudeQuaternions:block count:count];
+            count = 0;
+        }
+    }
+    [self appendAttitudeQuaternions:block count:count];
+}
+
+- (ORKRangeOfMotionSummary)summary {
+    pthread_mutex_lock(&_lock);
+    ORKRangeOfMotionSummary summary = _summary;
+    pthread_mutex_unlock(&_lock);
+    return summary;
+}
+
+- (void)reset {
+    _hasReference = NO;
+    pthread_mutex_lock(&_lock);
+    _summary = (ORKRangeOfMotionSummary){0};
+    pthread_mutex_unlock(&_lock);
+}
+
+@end
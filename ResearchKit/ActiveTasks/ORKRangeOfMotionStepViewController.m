@@ -38,12 +38,10 @@
 #import "ORKDeviceMotionRecorder.h"
 #import "ORKActiveStepView.h"
 #import "ORKProgressView.h"
+#import "ORKRangeOfMotionAnalyzer.h"
 #import "ORKSkin.h"
 
 
-#define radiansToDegrees(radians) ((radians) * 180.0 / M_PI)
-#define allOrientationsForPitch(x, w, y, z) (atan2(2.0 * (x*w + y*z), 1.0 - 2.0 * (x*x + z*z)))
-
 @interface ORKRangeOfMotionContentView : ORKActiveStepCustomView {
     NSLayoutConstraint *_topConstraint;
 }
@@ -118,11 +116,7 @@
 @interface ORKRangeOfMotionStepViewController () <ORKDeviceMotionRecorderDelegate> {
     ORKRangeOfMotionContentView *_contentView;
     UITapGestureRecognizer *_gestureRecognizer;
-    CMAttitude *_referenceAttitude;
-    UIInterfaceOrientation _orientation;
-    double _highestAngle;
-    double _lowestAngle;
-    double _lastAngle;
+    ORKRangeOfMotionAnalyzer *_analyzer;
 }
 @end
 
@@ -138,72 +132,45 @@
     [self.activeStepView addGestureRecognizer:_gestureRecognizer];
 }
 
+- (void)recordersWillStart {
+    [super recordersWillStart];
+    // The orientation is read once, on the main queue, since the analyzer runs on the recorder's queue.
+    BOOL landscape = UIInterfaceOrientationIsLandscape([UIApplication sharedApplication].statusBarOrientation);
+    _analyzer = [[ORKRangeOfMotionAnalyzer alloc] initWithLandscapeOrientation:landscape];
+}
+
 - (void)handleTap:(UIGestureRecognizer *)sender {
-    [self calculateAndSetFlexedAndExtendedAngles];
     [self finish];
 }
 
 - (void)calculateAndSetFlexedAndExtendedAngles {
-    _flexedAngle = fabs([self getDeviceAngleInDegreesFromAttitude:_referenceAttitude]);
+    ORKRangeOfMotionSummary summary = _analyzer.summary;
+    _flexedAngle = fabs(summary.referenceAngle);
     
-    BOOL rangeOfMotionMoreThan180Degrees = _highestAngle > 175 && _lowestAngle < 175;
+    BOOL rangeOfMotionMoreThan180Degrees = summary.highestAngle > 175 && summary.lowestAngle < 175;
     if (rangeOfMotionMoreThan180Degrees) {
-        _rangeOfMotionAngle = 360 - fabs(_lastAngle);
+        _rangeOfMotionAngle = 360 - fabs(summary.lastAngle);
     } else {
-        _rangeOfMotionAngle = fabs(_lastAngle);
+        _rangeOfMotionAngle = fabs(summary.lastAngle);
     }
 }
 
 #pragma mark - ORKDeviceMotionRecorderDelegate
 
-- (void)deviceMotionRecorderDidUpdateWithMotion:(CMDeviceMotion *)motion {
-    if (!_referenceAttitude) {
-        _referenceAttitude = motion.attitude;
-    }
-    CMAttitude *currentAttitude = [motion.attitude copy];
-
-    [currentAttitude multiplyByInverseOfAttitude:_referenceAttitude];
-    
-    double angle = [self getDeviceAngleInDegreesFromAttitude:currentAttitude];
-
-    if (angle > _highestAngle) {
-        _highestAngle = angle;
-    }
-    if (angle < _lowestAngle) {
-        _lowestAngle = angle;
-    }
-    _lastAngle = angle;
+- (void)deviceMotionRecorder:(ORKDeviceMotionRecorder *)recorder didCaptureMotionSamples:(NSArray<CMDeviceMotion *> *)samples {
+    [_analyzer appendDeviceMotionSamples:samples];
 }
 
-/*
- When the device is in Portrait mode, we need to get the attitude's pitch
- to determine the device's angle. attitude.pitch doesn't return all
- orientations, so we use the attitude's quaternion to calculate the
- angle.
- */
-- (double)getDeviceAngleInDegreesFromAttitude:(CMAttitude *)attitude {
-    if (!_orientation) {
-        _orientation = [UIApplication sharedApplication].statusBarOrientation;
-    }
-    double angle;
-    if (UIInterfaceOrientationIsLandscape(_orientation)) {
-        angle = radiansToDegrees(attitude.roll);
-    } else {
-        double x = attitude.quaternion.x;
-        double w = attitude.quaternion.w;
-        double y = attitude.quaternion.y;
-        double z = attitude.quaternion.z;
-        angle = radiansToDegrees(allOrientationsForPitch(x, w, y, z));
-    }
-    return angle;
-}
-
-
 #pragma mark - ORKActiveTaskViewController
 
 - (ORKResult *)result {
     ORKStepResult *stepResult = [super result];
     
+    // Finishing stops the recorders, which waits for the analyzer to see every captured sample.
+    if (self.finished) {
+        [self calculateAndSetFlexedAndExtendedAngles];
+    }
+    
     ORKRangeOfMotionResult *result = [[ORKRangeOfMotionResult alloc] initWithIdentifier:self.step.identifier];
     result.flexed = _flexedAngle;
     result.extended = result.flexed - _rangeOfMotionAngle;
@@ -0,0 +1,74 @@
+/*
+ Copyright (c) 2016, Apple Inc. All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+ 
+ 1.  Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ 2.  Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation and/or
+ other materials provided with the distribution.
+ 
+ 3.  Neither the name of the copyright holder(s) nor the names of any contributors
+ may be used to endorse or promote products derived from this software without
+ specific prior written permission. No license is granted to the trademarks of
+ the copyright holders even if such marks are included in this software.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+@import Foundation;
+@import CoreMotion;
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ The `ORKReactionTimeDetector` class finds the moment a stream of device motion samples first
+ exceeds an acceleration threshold.
+ 
+ The crossing is found from the samples' own timestamps, interpolating linearly between the last
+ sample below the threshold and the first one above it, so the result does not depend on when or
+ on which queue the samples are delivered.
+ */
+@interface ORKReactionTimeDetector : NSObject
+
+- (instancetype)init NS_UNAVAILABLE;
+
+- (instancetype)initWithThresholdAcceleration:(double)thresholdAcceleration NS_DESIGNATED_INITIALIZER;
+
+@property (nonatomic, readonly) double thresholdAcceleration;
+
+/// Forgets the samples seen so far, ready for a new attempt.
+- (void)reset;
+
+/**
+ Adds the next sample of the stream.
+ 
+ @return `YES` if this sample is the first to exceed the threshold since the last reset.
+ */
+- (BOOL)addSampleWithTimestamp:(NSTimeInterval)timestamp userAcceleration:(CMAcceleration)userAcceleration;
+
+@property (nonatomic, readonly, getter=hasCrossedThreshold) BOOL crossedThreshold;
+
+/// The timestamp of the first sample that exceeded the threshold, or 0 before the crossing.
+@property (nonatomic, readonly) NSTimeInterval crossingSampleTimestamp;
+
+/// The interpolated time at which the acceleration reached the threshold, or 0 before the crossing.
+@property (nonatomic, readonly) NSTimeInterval crossingTimestamp;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,79 @@
+/*
+ Copyright (c) 2016, Apple Inc. All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+ 
+ 1.  Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ 2.  Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation and/or
+ other materials provided with the distribution.
+ 
+ 3.  Neither the name of the copyright holder(s) nor the names of any contributors
+ may be used to endorse or promote products derived from this software without
+ specific prior written permission. No license is granted to the trademarks of
+ the copyright holders even if such marks are included in this software.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#import "ORKReactionTimeDetector.h"
+
+
+@implementation ORKReactionTimeDetector {
+    BOOL _hasPreviousSample;
+    NSTimeInterval _previousTimestamp;
+    double _previousMagnitude;
+}
+
+- (instancetype)initWithThresholdAcceleration:(double)thresholdAcceleration {
+    self = [super init];
+    if (self) {
+        _thresholdAcceleration = thresholdAcceleration;
+    }
+    return self;
+}
+
+- (void)reset {
+    _hasPreviousSample = NO;
+    _crossedThreshold = NO;
+    _crossingSampleTimestamp = 0;
+    _crossingTimestamp = 0;
+}
+
+- (BOOL)addSampleWithTimestamp:(NSTimeInterval)timestamp userAcceleration:(CMAcceleration)v {
+    if (_crossedThreshold) {
+        return NO;
+    }
+    
+    double magnitude = sqrt((v.x * v.x) + (v.y * v.y) + (v.z * v.z));
+    if (magnitude > _thresholdAcceleration) {
+        _crossedThreshold = YES;
+        _crossingSampleTimestamp = timestamp;
+        _crossingTimestamp = timestamp;
+        if (_hasPreviousSample && timestamp > _previousTimestamp) {
+            double fraction = (_thresholdAcceleration - _previousMagnitude) / (magnitude - _previousMagnitude);
+            _crossingTimestamp = _previousTimestamp + fraction * (timestamp - _previousTimestamp);
+        }
+        return YES;
+    }
+    
+    _hasPreviousSample = YES;
+    _previousTimestamp = timestamp;
+    _previousMagnitude = magnitude;
+    return NO;
+}
+
+@end
@@ -32,7 +32,9 @@
 #import "ORKReactionTimeViewController.h"
 
 #import "ORKActiveStepView.h"
+#import "ORKActiveTaskClock.h"
 #import "ORKReactionTimeContentView.h"
+#import "ORKReactionTimeDetector.h"
 
 #import "ORKActiveStepViewController_Internal.h"
 #import "ORKStepViewController_Internal.h"
@@ -49,9 +51,12 @@
 @implementation ORKReactionTimeViewController {
     ORKReactionTimeContentView *_reactionTimeContentView;
     NSMutableArray *_results;
-    NSTimer *_stimulusTimer;
-    NSTimer *_timeoutTimer;
+    ORKActiveTaskClockTimer *_stimulusTimer;
+    ORKActiveTaskClockTimer *_timeoutTimer;
+    ORKReactionTimeDetector *_detector;
+    CADisplayLink *_presentationLink;
     NSTimeInterval _stimulusTimestamp;
+    NSTimeInterval _stimulusPresentationTimestamp;
     BOOL _validResult;
     BOOL _timedOut;
     BOOL _shouldIndicateFailure;
@@ -70,6 +75,7 @@ static const NSTimeInterval OutcomeAnimationDuration = 0.3;
     self.activeStepView.activeCustomView = _reactionTimeContentView;
     self.activeStepView.stepViewFillsAvailableSpace = YES;
     [_reactionTimeContentView setStimulusHidden:YES];
+    _detector = [[ORKReactionTimeDetector alloc] initWithThresholdAcceleration:[self reactionTimeStep].thresholdAcceleration];
 }
 
 - (void)viewDidAppear:(BOOL)animated {
@@ -87,6 +93,8 @@ static const NSTimeInterval OutcomeAnimationDuration = 0.3;
 
 - (void)start {
     [super start];
+    [_detector reset];
+    _stimulusPresentationTimestamp = 0;
     [self startStimulusTimer];
 
 }
@@ -95,9 +103,7 @@ static const NSTimeInterval OutcomeAnimationDuration = 0.3;
 - (void)motionBegan:(UIEventSubtype)motion withEvent:(UIEvent *)event {
     if (event.type == UIEventSubtypeMotionShake) {
         if (_validResult) {
-            ORKReactionTimeResult *reactionTimeResult = [[ORKReactionTimeResult alloc] initWithIdentifier:self.step.identifier];
-            reactionTimeResult.timestamp = _stimulusTimestamp;
-            [_results addObject:reactionTimeResult];
+            [_results addObject:[self reactionTimeResultWithResponseSampleTimestamp:event.timestamp responseTimestamp:event.timestamp]];
         }
         [self attemptDidFinish];
     }
@@ -114,8 +120,9 @@ static const NSTimeInterval OutcomeAnimationDuration = 0.3;
 - (void)applicationWillResignActive:(NSNotification *)notification {
     [super applicationWillResignActive:notification];
     _validResult = NO;
-    [_stimulusTimer invalidate];
-    [_timeoutTimer invalidate];
+    [_stimulusTimer cancel];
+    [_timeoutTimer cancel];
+    [self stopPresentationLink];
 }
 
 - (void)applicationDidBecomeActive:(NSNotification *)notification {
@@ -127,8 +134,8 @@ static const NSTimeInterval OutcomeAnimationDuration = 0.3;
 
 - (void)recorder:(ORKRecorder *)recorder didCompleteWithResult:(ORKResult *)result {
     if (_validResult) {
-        ORKReactionTimeResult *reactionTimeResult = [[ORKReactionTimeResult alloc] initWithIdentifier:self.step.identifier];
-        reactionTimeResult.timestamp = _stimulusTimestamp;
+        ORKReactionTimeResult *reactionTimeResult = [self reactionTimeResultWithResponseSampleTimestamp:_detector.crossingSampleTimestamp
+                                                                                      responseTimestamp:_detector.crossingTimestamp];
         reactionTimeResult.fileResult = (ORKFileResult *)result;
         [_results addObject:reactionTimeResult];
     }
@@ -138,9 +145,9 @@ static const NSTimeInterval OutcomeAnimationDuration = 0.3;
 #pragma mark - ORKDeviceMotionRecorderDelegate
 
 - (void)deviceMotionRecorderDidUpdateWithMotion:(CMDeviceMotion *)motion {
-    CMAcceleration v = motion.userAcceleration;
-    double vectorMagnitude = sqrt(((v.x * v.x) + (v.y * v.y) + (v.z * v.z)));
-    if (vectorMagnitude > [self reactionTimeStep].thresholdAcceleration) {
+    // The samples arrive in order, and the detector works from their timestamps, so the delay in
+    // delivering them to the main queue does not affect the measured response time.
+    if ([_detector addSampleWithTimestamp:motion.timestamp userAcceleration:motion.userAcceleration]) {
         [self stopRecorders];
     }
 }
@@ -172,8 +179,9 @@ static const NSTimeInterval OutcomeAnimationDuration = 0.3;
     }
     _validResult = NO;
     _timedOut = NO;
-    [_stimulusTimer invalidate];
-    [_timeoutTimer invalidate];
+    [_stimulusTimer cancel];
+    [_timeoutTimer cancel];
+    [self stopPresentationLink];
 }
 
 - (void)indicateSuccess:(void(^)(void))completion {
@@ -199,20 +207,62 @@ static const NSTimeInterval OutcomeAnimationDuration = 0.3;
 }
 
 - (void)startStimulusTimer {
-    _stimulusTimer = [NSTimer scheduledTimerWithTimeInterval:[self stimulusInterval] target:self selector:@selector(stimulusTimerDidFire) userInfo:nil repeats:NO];
+    ORKWeakTypeOf(self) weakSelf = self;
+    _stimulusTimer = [[ORKActiveTaskClock sharedClock] scheduleTimerWithDelay:[self stimulusInterval]
+                                                                     interval:0
+                                                                        queue:dispatch_get_main_queue()
+                                                                      handler:^{
+                                                                          [weakSelf stimulusTimerDidFire];
+                                                                      }];
 }
 
 - (void)stimulusTimerDidFire {
-    _stimulusTimestamp = [NSProcessInfo processInfo].systemUptime;
+    _stimulusTimestamp = ORKActiveTaskClockNow();
     [_reactionTimeContentView setStimulusHidden:NO];
     _validResult = YES;
+    [self startPresentationLink];
     [self startTimeoutTimer];
 }
 
+- (void)startPresentationLink {
+    [self stopPresentationLink];
+    _presentationLink = [CADisplayLink displayLinkWithTarget:self selector:@selector(presentationLinkDidFire:)];
+    [_presentationLink addToRunLoop:[NSRunLoop mainRunLoop] forMode:NSRunLoopCommonModes];
+}
+
+- (void)stopPresentationLink {
+    [_presentationLink invalidate];
+    _presentationLink = nil;
+}
+
+- (void)presentationLinkDidFire:(CADisplayLink *)displayLink {
+    // The first callback after the stimulus is unhidden comes at the start of the frame that
+    // renders it, so it reaches the display at the following refresh.
+    _stimulusPresentationTimestamp = displayLink.timestamp + displayLink.duration;
+    [self stopPresentationLink];
+}
+
+- (ORKReactionTimeResult *)reactionTimeResultWithResponseSampleTimestamp:(NSTimeInterval)responseSampleTimestamp
+                                                       responseTimestamp:(NSTimeInterval)responseTimestamp {
+    ORKReactionTimeResult *reactionTimeResult = [[ORKReactionTimeResult alloc] initWithIdentifier:self.step.identifier];
+    reactionTimeResult.timestamp = _stimulusTimestamp;
+    reactionTimeResult.stimulusPresentationTimestamp = _stimulusPresentationTimestamp;
+    reactionTimeResult.rawReactionTime = responseSampleTimestamp - _stimulusTimestamp;
+    NSTimeInterval presentationTimestamp = (_stimulusPresentationTimestamp > 0) ? _stimulusPresentationTimestamp : _stimulusTimestamp;
+    reactionTimeResult.correctedReactionTime = responseTimestamp - presentationTimestamp;
+    return reactionTimeResult;
+}
+
 - (void)startTimeoutTimer {
     NSTimeInterval timeout = [self reactionTimeStep].timeout;
     if (timeout > 0) {
-        _timeoutTimer = [NSTimer scheduledTimerWithTimeInterval:timeout target:self selector:@selector(timeoutTimerDidFire) userInfo:nil repeats:NO];
+        ORKWeakTypeOf(self) weakSelf = self;
+        _timeoutTimer = [[ORKActiveTaskClock sharedClock] scheduleTimerWithDelay:timeout
+                                                                        interval:0
+                                                                           queue:dispatch_get_main_queue()
+                                                                         handler:^{
+                                                                             [weakSelf timeoutTimerDidFire];
+                                                                         }];
     }
 }
 
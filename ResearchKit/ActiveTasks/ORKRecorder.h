@@ -129,6 +129,15 @@ ORK_CLASS_AVAILABLE
  */
 @property (nonatomic, readonly) double frequency;
 
+/**
+ A Boolean value indicating whether the recorder computes gait features on the device.
+ 
+ When the value of this property is `YES`, the recorder streams the accelerometer samples through
+ a gait analysis stage and reports an `ORKGaitSummaryResult` object alongside its `ORKFileResult` object.
+ The default value of this property is `NO`.
+ */
+@property (nonatomic, assign) BOOL includesGaitSummary;
+
 /**
  Returns an initialized accelerometer recorder configuration using the specified frequency.
  
@@ -226,6 +235,15 @@ ORK_CLASS_AVAILABLE
  */
 @property (nonatomic, readonly) double frequency;
 
+/**
+ A Boolean value indicating whether the recorder computes gait features on the device.
+ 
+ When the value of this property is `YES`, the recorder streams the device motion samples through
+ a gait analysis stage and reports an `ORKGaitSummaryResult` object alongside its `ORKFileResult` object.
+ The default value of this property is `NO`.
+ */
+@property (nonatomic, assign) BOOL includesGaitSummary;
+
 /**
  Returns an initialized device motion recorder configuration using the specified frequency.
  
@@ -421,6 +439,31 @@ need to implement it.
  */
 - (void)recorder:(ORKRecorder *)recorder didFailWithError:(NSError *)error;
 
+@optional
+/**
+ Tells the delegate that the recorder has summarized how it performed while recording.
+ 
+ This method is called by recorders that collect performance metrics, just after they report
+ their file result. The same summary is included in the file result's `userInfo` dictionary,
+ under the `metrics` key.
+ 
+ @param recorder        The generating recorder object.
+ @param metrics         A property list summarizing the recorder's counters and histograms.
+ */
+- (void)recorder:(ORKRecorder *)recorder didReportMetrics:(NSDictionary<NSString *, id> *)metrics;
+
+/**
+ Tells the delegate that the recorder has derived a result from the recorded data, in addition to
+ the result it completes with.
+ 
+ This method is called just before `recorder:didCompleteWithResult:`, which is still called
+ exactly once per recording.
+ 
+ @param recorder        The generating recorder object.
+ @param result          The derived result, such as an `ORKGaitSummaryResult` object.
+ */
+- (void)recorder:(ORKRecorder *)recorder didReportAdditionalResult:(ORKResult *)result;
+
 @end
 
 
@@ -34,6 +34,7 @@
 #import "ORKRecorder_Internal.h"
 
 #import "ORKDataLogger.h"
+#import "ORKRecorderMetrics.h"
 #import "ORKResult.h"
 
 #import "ORKHelpers_Internal.h"
@@ -102,6 +103,7 @@
 @implementation ORKRecorder {
     UIBackgroundTaskIdentifier _backgroundTask;
     NSUUID *_recorderUUID;
+    ORKRecorderMetrics *_metrics;
 }
 
 + (instancetype)new {
@@ -226,6 +228,13 @@
     return nil;
 }
 
+- (ORKRecorderMetrics *)metrics {
+    if (!_metrics) {
+        _metrics = [[ORKRecorderMetrics alloc] init];
+    }
+    return _metrics;
+}
+
 - (void)applyFileProtection:(ORKFileProtectionMode)fileProtection toFileAtURL:(NSURL *)url {
     NSFileManager *fileManager = [NSFileManager defaultManager];
     NSError *error = nil;
@@ -234,19 +243,38 @@
     }
 }
 
+- (void)reportAdditionalResult:(ORKResult *)result {
+    id<ORKRecorderDelegate> localDelegate = self.delegate;
+    if (localDelegate && [localDelegate respondsToSelector:@selector(recorder:didReportAdditionalResult:)]) {
+        [localDelegate recorder:self didReportAdditionalResult:result];
+    }
+}
+
 - (void)reportFileResultWithFile:(NSURL *)fileUrl error:(NSError *)error {
     
     id<ORKRecorderDelegate> localDelegate = self.delegate;
     if (fileUrl && !error) {
         if (localDelegate && [localDelegate respondsToSelector:@selector(recorder:didCompleteWithResult:)]) {
+            NSDictionary *metricsSummary = [_metrics summary];
+            NSDictionary *userInfo = self.userInfo;
+            if (metricsSummary) {
+                NSMutableDictionary *userInfoWithMetrics = [NSMutableDictionary dictionaryWithDictionary:userInfo ? : @{}];
+                userInfoWithMetrics[@"metrics"] = metricsSummary;
+                userInfo = [userInfoWithMetrics copy];
+            }
+            
             ORKFileResult *result = [[ORKFileResult alloc] initWithIdentifier:self.identifier];
             result.contentType = [self mimeType];
             result.fileURL = fileUrl;
-            result.userInfo = self.userInfo;
+            result.userInfo = userInfo;
             result.startDate = self.startDate;
             
             [localDelegate recorder:self didCompleteWithResult:result];
             
+            if (metricsSummary && [localDelegate respondsToSelector:@selector(recorder:didReportMetrics:)]) {
+                [localDelegate recorder:self didReportMetrics:metricsSummary];
+            }
+            
             // Point future recording at a new directory
             [self reset];
         }
@@ -0,0 +1,94 @@
+/*
+ Copyright (c) 2016, Apple Inc. All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+ 
+ 1.  Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ 2.  Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation and/or
+ other materials provided with the distribution.
+ 
+ 3.  Neither the name of the copyright holder(s) nor the names of any contributors
+ may be used to endorse or promote products derived from this software without
+ specific prior written permission. No license is granted to the trademarks of
+ the copyright holders even if such marks are included in this software.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+@import Foundation;
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ The `ORKRecorderCaptureQueue` class decouples sensor delivery from persistence in a recorder.
+
+ Samples are enqueued from the thread that delivers them, into a buffer that holds at most
+ `capacity` samples, and drained in batches on a dedicated serial queue with user-initiated
+ quality of service. Enqueueing never blocks: when the buffer is full, the sample is dropped
+ and counted as an overflow. Samples whose timestamp is earlier than that of the last accepted
+ sample are dropped and counted as out of order, so the batches handed to the handler are always
+ in non-decreasing timestamp order.
+
+ The counters are reported by recorders in the `userInfo` dictionary of their file results.
+ */
+@interface ORKRecorderCaptureQueue : NSObject
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/**
+ Returns an initialized capture queue.
+
+ @param label       The label of the underlying dispatch queue.
+ @param capacity    The maximum number of samples waiting to be handled.
+ @param handler     The block called on the capture queue with each batch of accepted samples, in order.
+
+ @return An initialized capture queue.
+ */
+- (instancetype)initWithLabel:(NSString *)label
+                     capacity:(NSUInteger)capacity
+                      handler:(void (^)(NSArray *samples))handler NS_DESIGNATED_INITIALIZER;
+
+@property (nonatomic, readonly) NSUInteger capacity;
+
+// A capacity holding thirty seconds of samples at the given frequency, and never less than 1000 samples.
++ (NSUInteger)capacityForFrequency:(double)frequency;
+
+// Returns `NO` if the sample was dropped.
+- (BOOL)enqueueSample:(id)sample timestamp:(NSTimeInterval)timestamp;
+
+// Blocks until every accepted sample has been handled. Must not be called on the capture queue.
+- (void)flush;
+
+// The number of samples accepted.
+@property (readonly) NSUInteger capturedSampleCount;
+
+// The number of samples dropped because the buffer was full.
+@property (readonly) NSUInteger overflowCount;
+
+// The number of samples dropped because their timestamp went backwards.
+@property (readonly) NSUInteger outOfOrderCount;
+
+// The largest number of samples that were waiting at once.
+@property (readonly) NSUInteger maximumDepth;
+
+// The counters above, keyed by `capturedSampleCount`, `overflowCount`, `outOfOrderCount` and `maximumQueueDepth`.
+- (NSDictionary<NSString *, NSNumber *> *)statistics;
+
+@end
+
+NS_ASSUME_NONNULL_END
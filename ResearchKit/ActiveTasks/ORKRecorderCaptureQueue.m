@@ -0,0 +1,165 @@
+/*
+ Copyright (c) 2016, Apple Inc. All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+ 
+ 1.  Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ 2.  Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation and/or
+ other materials provided with the distribution.
+ 
+ 3.  Neither the name of the copyright holder(s) nor the names of any contributors
+ may be used to endorse or promote products derived from this software without
+ specific prior written permission. No license is granted to the trademarks of
+ the copyright holders even if such marks are included in this software.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#import "ORKRecorderCaptureQueue.h"
+
+#import "ORKHelpers_Internal.h"
+
+#include <pthread.h>
+
+
+@implementation ORKRecorderCaptureQueue {
+    dispatch_queue_t _queue;
+    void (^_handler)(NSArray *samples);
+
+    // Everything below is guarded by _lock.
+    pthread_mutex_t _lock;
+    NSMutableArray *_pendingSamples;
+    BOOL _drainScheduled;
+    NSTimeInterval _lastTimestamp;
+    NSUInteger _capturedSampleCount;
+    NSUInteger _overflowCount;
+    NSUInteger _outOfOrderCount;
+    NSUInteger _maximumDepth;
+}
+
+- (instancetype)init {
+    ORKThrowMethodUnavailableException();
+}
+
+- (instancetype)initWithLabel:(NSString *)label capacity:(NSUInteger)capacity handler:(void (^)(NSArray *samples))handler {
+    self = [super init];
+    if (self) {
+        ORKThrowInvalidArgumentExceptionIfNil(handler);
+        dispatch_queue_attr_t attributes = dispatch_queue_attr_make_with_qos_class(DISPATCH_QUEUE_SERIAL, QOS_CLASS_USER_INITIATED, 0);
+        _queue = dispatch_queue_create([label cStringUsingEncoding:NSUTF8StringEncoding], attributes);
+        _handler = [handler copy];
+        _capacity = MAX(capacity, (NSUInteger)1);
+        pthread_mutex_init(&_lock, NULL);
+        _pendingSamples = [NSMutableArray arrayWithCapacity:MIN(_capacity, (NSUInteger)256)];
+        _lastTimestamp = -DBL_MAX;
+    }
+    return self;
+}
+
++ (NSUInteger)capacityForFrequency:(double)frequency {
+    return MAX((NSUInteger)1000, (NSUInteger)ceil(MAX(frequency, 0) * 30));
+}
+
+- (void)dealloc {
+    pthread_mutex_destroy(&_lock);
+}
+
+- (BOOL)enqueueSample:(id)sample timestamp:(NSTimeInterval)timestamp {
+    BOOL accepted = NO;
+    BOOL scheduleDrain = NO;
+    pthread_mutex_lock(&_lock);
+    if (timestamp < _lastTimestamp) {
+        _outOfOrderCount++;
+    } else if (_pendingSamples.count >= _capacity) {
+        _overflowCount++;
+    } else {
+        [_pendingSamples addObject:sample];
+        _lastTimestamp = timestamp;
+        _capturedSampleCount++;
+        _maximumDepth = MAX(_maximumDepth, _pendingSamples.count);
+        accepted = YES;
+        scheduleDrain = !_drainScheduled;
+        _drainScheduled = YES;
+    }
+    pthread_mutex_unlock(&_lock);
+    
+    if (scheduleDrain) {
+        dispatch_async(_queue, ^{
+            [self drain];
+        });
+    }
+    return accepted;
+}
+
+// Called on _queue. Takes everything pending in one batch, so a burst costs one handler call.
+- (void)drain {
+    pthread_mutex_lock(&_lock);
+    NSArray *samples = _pendingSamples;
+    _pendingSamples = [NSMutableArray arrayWithCapacity:MIN(_capacity, MAX(samples.count, (NSUInteger)16))];
+    _drainScheduled = NO;
+    pthread_mutex_unlock(&_lock);
+    
+    if (samples.count > 0) {
+        _handler(samples);
+    }
+}
+
+- (void)flush {
+    dispatch_sync(_queue, ^{
+        [self drain];
+    });
+}
+
+- (NSUInteger)capturedSampleCount {
+    pthread_mutex_lock(&_lock);
+    NSUInteger count = _capturedSampleCount;
+    pthread_mutex_unlock(&_lock);
+    return count;
+}
+
+- (NSUInteger)overflowCount {
+    pthread_mutex_lock(&_lock);
+    NSUInteger count = _overflowCount;
+    pthread_mutex_unlock(&_lock);
+    return count;
+}
+
+- (NSUInteger)outOfOrderCount {
+    pthread_mutex_lock(&_lock);
+    NSUInteger count = _outOfOrderCount;
+    pthread_mutex_unlock(&_lock);
+    return count;
+}
+
+- (NSUInteger)maximumDepth {
+    pthread_mutex_lock(&_lock);
+    NSUInteger depth = _maximumDepth;
+    pthread_mutex_unlock(&_lock);
+    return depth;
+}
+
+- (NSDictionary<NSString *, NSNumber *> *)statistics {
+    pthread_mutex_lock(&_lock);
+    NSDictionary *statistics = @{ @"capturedSampleCount": @(_capturedSampleCount),
+                                  @"overflowCount": @(_overflowCount),
+                                  @"outOfOrderCount": @(_outOfOrderCount),
+                                  @"maximumQueueDepth": @(_maximumDepth) };
+    pthread_mutex_unlock(&_lock);
+    return statistics;
+}
+
+@end
@@ -0,0 +1,128 @@
+/*
+ Copyright (c) 2016, Apple Inc. All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+ 
+ 1.  Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ 2.  Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation and/or
+ other materials provided with the distribution.
+ 
+ 3.  Neither the name of the copyright holder(s) nor the names of any contributors
+ may be used to endorse or promote products derived from this software without
+ specific prior written permission. No license is granted to the trademarks of
+ the copyright holders even if such marks are included in this software.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+@import Foundation;
+#import <ResearchKit/ORKDefines.h>
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ The counters maintained by an `ORKRecorderMetrics` object.
+ */
+typedef NS_ENUM(NSInteger, ORKRecorderCounter) {
+    /// Samples delivered to the recorder by its sensor.
+    ORKRecorderCounterSamplesReceived,
+    
+    /// Samples the recorder could not keep.
+    ORKRecorderCounterSamplesDropped,
+    
+    /// Bytes written to the recorder's log files.
+    ORKRecorderCounterBytesWritten,
+    
+    /// Log files rolled over because they reached their size or age limit.
+    ORKRecorderCounterLogRollovers,
+    
+    /// Appends to the recorder's log that failed.
+    ORKRecorderCounterAppendErrors
+} ORK_ENUM_AVAILABLE;
+
+/**
+ The histograms maintained by an `ORKRecorderMetrics` object. All histograms hold durations.
+ */
+typedef NS_ENUM(NSInteger, ORKRecorderHistogram) {
+    /// Time taken by each append to the recorder's log.
+    ORKRecorderHistogramAppendLatency,
+    
+    /// Time between consecutive samples, in the sensor's time base.
+    ORKRecorderHistogramSampleInterval
+} ORK_ENUM_AVAILABLE;
+
+/// An opaque token returned by `beginInterval` and passed back to `endInterval:inHistogram:`.
+typedef uint64_t ORKRecorderIntervalToken;
+
+/**
+ The `ORKRecorderMetrics` class collects counters and duration histograms that describe how a
+ recorder behaved while it was recording.
+
+ Every reporting method can be called from any thread, and none of them allocates memory, so they
+ are safe to use on the path that handles each sensor sample. Histograms use power-of-two
+ microsecond buckets; the percentiles in the summary are the upper bounds of those buckets.
+
+ Recorders that report metrics add their summary to the `userInfo` dictionary of their file
+ result, under the `metrics` key, and pass it to the `recorder:didReportMetrics:` delegate method.
+ */
+ORK_CLASS_AVAILABLE
+@interface ORKRecorderMetrics : NSObject
+
+/// Adds `amount` to a counter.
+- (void)incrementCounter:(ORKRecorderCounter)counter by:(int64_t)amount;
+
+/// The current value of a counter.
+- (int64_t)valueOfCounter:(ORKRecorderCounter)counter;
+
+/// Records a duration, in seconds, in a histogram.
+- (void)recordDuration:(NSTimeInterval)duration inHistogram:(ORKRecorderHistogram)histogram;
+
+/// The number of durations recorded in a histogram.
+- (int64_t)countOfHistogram:(ORKRecorderHistogram)histogram;
+
+/**
+ Counts a received sample and records the interval since the previous one.
+ 
+ Samples must be reported from one serial context, in the order they are received.
+ 
+ @param timestamp   The sample timestamp, in seconds, in the time base of the sensor.
+ */
+- (void)recordSampleWithTimestamp:(NSTimeInterval)timestamp;
+
+/// Starts timing an interval.
+- (ORKRecorderIntervalToken)beginInterval;
+
+/// Records the time elapsed since `beginInterval` returned `token` in a histogram.
+- (void)endInterval:(ORKRecorderIntervalToken)token inHistogram:(ORKRecorderHistogram)histogram;
+
+/**
+ Returns a property list summarizing the metrics.
+ 
+ The summary contains the counters (`samplesReceived`, `samplesDropped`, `bytesWritten`,
+ `logRollovers`, `appendErrors`), the sample rate achieved between the first and the last sample
+ (`achievedSampleRate`, in hertz), and one dictionary per non-empty histogram (`appendLatency`,
+ `sampleInterval`) holding its `count`, `mean`, `max`, `p50`, `p95` and `p99`, in seconds.
+ */
+- (NSDictionary<NSString *, id> *)summary;
+
+/// Clears all counters and histograms. Must not be called while metrics are being reported.
+- (void)reset;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,220 @@
+/*
+ Copyright (c) 2016, Apple Inc. All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+ 
+ 1.  Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ 2.  Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation and/or
+ other materials provided with the distribution.
+ 
+ 3.  Neither the name of the copyright holder(s) nor the names of any contributors
+ may be used to endorse or promote products derived from this software without
+ specific prior written permission. No license is granted to the trademarks of
+ the copyright holders even if such marks are included in this software.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#import "ORKRecorderMetrics.h"
+
+#import "ORKActiveTaskClock.h"
+
+#include <mach/mach_time.h>
+#include <stdatomic.h>
+
+
+enum {
+    ORKRecorderCounterCount = ORKRecorderCounterAppendErrors + 1,
+    ORKRecorderHistogramCount = ORKRecorderHistogramSampleInterval + 1,
+    
+    // Bucket `i` holds durations in [2^i, 2^(i+1)) microseconds; the last one also holds anything longer.
+    ORKRecorderHistogramBucketCount = 32
+};
+
+typedef struct {
+    _Atomic(int64_t) buckets[ORKRecorderHistogramBucketCount];
+    _Atomic(int64_t) count;
+    _Atomic(int64_t) sumMicroseconds;
+    _Atomic(int64_t) maxMicroseconds;
+} ORKRecorderHistogramStorage;
+
+typedef struct {
+    _Atomic(int64_t) counters[ORKRecorderCounterCount];
+    ORKRecorderHistogramStorage histograms[ORKRecorderHistogramCount];
+    
+    // Only written by -recordSampleWithTimestamp:, which is called from one serial context.
+    NSTimeInterval firstSampleTimestamp;
+    NSTimeInterval lastSampleTimestamp;
+} ORKRecorderMetricsStorage;
+
+static NSString *ORKRecorderCounterKey(ORKRecorderCounter counter) {
+    switch (counter) {
+        case ORKRecorderCounterSamplesReceived: return @"samplesReceived";
+        case ORKRecorderCounterSamplesDropped: return @"samplesDropped";
+        case ORKRecorderCounterBytesWritten: return @"bytesWritten";
+        case ORKRecorderCounterLogRollovers: return @"logRollovers";
+        case ORKRecorderCounterAppendErrors: return @"appendErrors";
+    }
+    return nil;
+}
+
+static NSString *ORKRecorderHistogramKey(ORKRecorderHistogram histogram) {
+    switch (histogram) {
+        case ORKRecorderHistogramAppendLatency: return @"appendLatency";
+        case ORKRecorderHistogramSampleInterval: return @"sampleInterval";
+    }
+    return nil;
+}
+
+static double ORKMachTimeToMicroseconds(uint64_t machTime) {
+    return ORKTimeIntervalFromMachTime(machTime) * USEC_PER_SEC;
+}
+
+static NSUInteger ORKHistogramBucketForMicroseconds(int64_t microseconds) {
+    if (microseconds <= 1) {
+        return 0;
+    }
+    NSUInteger bucket = 63 - __builtin_clzll((unsigned long long)microseconds);
+    return MIN(bucket, (NSUInteger)ORKRecorderHistogramBucketCount - 1);
+}
+
+
+@implementation ORKRecorderMetrics {
+    ORKRecorderMetricsStorage *_storage;
+}
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        _storage = calloc(1, sizeof(ORKRecorderMetricsStorage));
+    }
+    return self;
+}
+
+- (void)dealloc {
+    free(_storage);
+}
+
+- (void)incrementCounter:(ORKRecorderCounter)counter by:(int64_t)amount {
+    NSParameterAssert(counter >= 0 && counter < ORKRecorderCounterCount);
+    atomic_fetch_add_explicit(&_storage->counters[counter], amount, memory_order_relaxed);
+}
+
+- (int64_t)valueOfCounter:(ORKRecorderCounter)counter {
+    NSParameterAssert(counter >= 0 && counter < ORKRecorderCounterCount);
+    return atomic_load_explicit(&_storage->counters[counter], memory_order_relaxed);
+}
+
+- (void)recordMicroseconds:(int64_t)microseconds inHistogram:(ORKRecorderHistogram)histogram {
+    NSParameterAssert(histogram >= 0 && histogram < ORKRecorderHistogramCount);
+    ORKRecorderHistogramStorage *storage = &_storage->histograms[histogram];
+    microseconds = MAX(microseconds, (int64_t)0);
+    
+    atomic_fetch_add_explicit(&storage->buckets[ORKHistogramBucketForMicroseconds(microseconds)], 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&storage->sumMicroseconds, microseconds, memory_order_relaxed);
+    int64_t max = atomic_load_explicit(&storage->maxMicroseconds, memory_order_relaxed);
+    while (microseconds > max && !atomic_compare_exchange_weak_explicit(&storage->maxMicroseconds, &max, microseconds, memory_order_relaxed, memory_order_relaxed)) {
+    }
+    atomic_fetch_add_explicit(&storage->count, 1, memory_order_relaxed);
+}
+
+- (void)recordDuration:(NSTimeInterval)duration inHistogram:(ORKRecorderHistogram)histogram {
+    [self recordMicroseconds:(int64_t)llround(duration * USEC_PER_SEC) inHistogram:histogram];
+}
+
+- (int64_t)countOfHistogram:(ORKRecorderHistogram)histogram {
+    NSParameterAssert(histogram >= 0 && histogram < ORKRecorderHistogramCount);
+    return atomic_load_explicit(&_storage->histograms[histogram].count, memory_order_relaxed);
+}
+
+- (void)recordSampleWithTimestamp:(NSTimeInterval)timestamp {
+    int64_t previousCount = atomic_fetch_add_explicit(&_storage->counters[ORKRecorderCounterSamplesReceived], 1, memory_order_relaxed);
+    if (previousCount == 0) {
+        _storage->firstSampleTimestamp = timestamp;
+    } else {
+        [self recordDuration:(timestamp - _storage->lastSampleTimestamp) inHistogram:ORKRecorderHistogramSampleInterval];
+    }
+    _storage->lastSampleTimestamp = timestamp;
+}
+
+- (ORKRecorderIntervalToken)beginInterval {
+    return mach_absolute_time();
+}
+
+- (void)endInterval:(ORKRecorderIntervalToken)token inHistogram:(ORKRecorderHistogram)histogram {
+    uint64_t now = mach_absolute_time();
+    [self recordMicroseconds:(int64_t)ORKMachTimeToMicroseconds(now - token) inHistogram:histogram];
+}
+
+- (NSDictionary *)summaryOfHistogram:(ORKRecorderHistogram)histogram {
+    ORKRecorderHistogramStorage *storage = &_storage->histograms[histogram];
+    int64_t buckets[ORKRecorderHistogramBucketCount];
+    int64_t count = 0;
+    for (NSUInteger bucket = 0; bucket < ORKRecorderHistogramBucketCount; bucket++) {
+        buckets[bucket] = atomic_load_explicit(&storage->buckets[bucket], memory_order_relaxed);
+        count += buckets[bucket];
+    }
+    if (count == 0) {
+        return nil;
+    }
+    int64_t max = atomic_load_explicit(&storage->maxMicroseconds, memory_order_relaxed);
+    int64_t sum = atomic_load_explicit(&storage->sumMicroseconds, memory_order_relaxed);
+    
+    NSNumber *(^percentile)(double) = ^NSNumber *(double fraction) {
+        int64_t rank = (int64_t)ceil(fraction * count);
+        int64_t cumulative = 0;
+        for (NSUInteger bucket = 0; bucket < ORKRecorderHistogramBucketCount; bucket++) {
+            cumulative += buckets[bucket];
+            if (cumulative >= rank) {
+                int64_t upperBound = (int64_t)1 << (bucket + 1);
+                return @((double)MIN(upperBound, max) / USEC_PER_SEC);
+            }
+        }
+        return @((double)max / USEC_PER_SEC);
+    };
+    
+    return @{ @"count": @(count),
+              @"mean": @((double)sum / count / USEC_PER_SEC),
+              @"max": @((double)max / USEC_PER_SEC),
+              @"p50": percentile(0.50),
+              @"p95": percentile(0.95),
+              @"p99": percentile(0.99) };
+}
+
+- (NSDictionary<NSString *, id> *)summary {
+    NSMutableDictionary *summary = [NSMutableDictionary dictionary];
+    for (NSInteger counter = 0; counter < ORKRecorderCounterCount; counter++) {
+        summary[ORKRecorderCounterKey(counter)] = @([self valueOfCounter:counter]);
+    }
+    
+    int64_t samples = [self valueOfCounter:ORKRecorderCounterSamplesReceived];
+    NSTimeInterval span = _storage->lastSampleTimestamp - _storage->firstSampleTimestamp;
+    if (samples > 1 && span > 0) {
+        summary[@"achievedSampleRate"] = @((samples - 1) / span);
+    }
+    
+    for (NSInteger histogram = 0; histogram < ORKRecorderHistogramCount; histogram++) {
+        summary[ORKRecorderHistogramKey(histogram)] = [self summaryOfHistogram:histogram];
+    }
+    return [summary copy];
+}
+
+- (void)reset {
+    memset(_storage, 0, sizeof(ORKRecorderMetricsStorage));
+}
+
+@end
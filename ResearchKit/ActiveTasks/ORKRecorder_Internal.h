@@ -35,6 +35,7 @@
 NS_ASSUME_NONNULL_BEGIN
 
 @class ORKDataLogger;
+@class ORKResult;
 
 @interface ORKRecorder ()
 
@@ -54,6 +55,8 @@ NS_ASSUME_NONNULL_BEGIN
 
 - (void)reportFileResultWithFile:(NSURL *)fileUrl error:(nullable NSError *)error;
 
+- (void)reportAdditionalResult:(ORKResult *)result;
+
 - (nullable NSURL *)recordingDirectoryURL;
 
 @end
@@ -35,8 +35,37 @@
 
 NS_ASSUME_NONNULL_BEGIN
 
+@class CLLocationManager;
+@class CMMotionManager;
+@class CMPedometer;
+@class ORKRecorderMetrics;
 @class ORKStep;
 
+/**
+ The `ORKRecorderSampleSource` protocol lets a recorder be driven by something other than the
+ device's sensors, such as recorded or synthetic samples in tests.
+ 
+ A recorder asks its sample source for the object it would otherwise create when it starts.
+ Returning `nil`, or not implementing a method, keeps the recorder's default.
+ */
+@protocol ORKRecorderSampleSource <NSObject>
+
+@optional
+/// Used by `ORKAccelerometerRecorder` and `ORKDeviceMotionRecorder`.
+- (nullable CMMotionManager *)motionManagerForRecorder:(ORKRecorder *)recorder;
+
+/// Used by `ORKPedometerRecorder`.
+- (nullable CMPedometer *)pedometerForRecorder:(ORKRecorder *)recorder;
+
+/// Used by `ORKLocationRecorder`.
+- (nullable CLLocationManager *)locationManagerForRecorder:(ORKRecorder *)recorder;
+
+/// Used by `ORKTouchRecorder` when no view was provided by the step view controller.
+- (nullable UIView *)touchViewForRecorder:(ORKRecorder *)recorder;
+
+@end
+
+
 /**
  The `ORKTouchRecorderConfiguration` is a recorder configuration class for
  generating an `ORKTouchRecorder`.
@@ -114,6 +143,22 @@ ORK_CLASS_AVAILABLE
  */
 - (void)applyFileProtection:(ORKFileProtectionMode)fileProtection toFileAtURL:(NSURL *)url;
 
+/**
+ The performance metrics of the recorder.
+ 
+ Recorders that collect metrics report into this object while recording. When it has been
+ used, its summary is added to the `userInfo` dictionary of the file result and passed to the
+ delegate's `recorder:didReportMetrics:` method. The object is created on first access.
+ */
+@property (nonatomic, strong, readonly) ORKRecorderMetrics *metrics;
+
+/**
+ The source of the recorder's samples, or `nil` to record from the device's sensors.
+ 
+ Set this property before starting the recorder.
+ */
+@property (nonatomic, strong, nullable) id<ORKRecorderSampleSource> sampleSource;
+
 @end
 
 
@@ -0,0 +1,92 @@
+/*
+ Copyright (c) 2016, Apple Inc. All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+ 
+ 1.  Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ 2.  Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation and/or
+ other materials provided with the distribution.
+ 
+ 3.  Neither the name of the copyright holder(s) nor the names of any contributors
+ may be used to endorse or promote products derived from this software without
+ specific prior written permission. No license is granted to the trademarks of
+ the copyright holders even if such marks are included in this software.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+@import Foundation;
+@import CoreMotion;
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ The `ORKSensorHub` class shares one `CMMotionManager` object and one serial delivery
+ queue between all the recorders that consume CoreMotion data.
+
+ Each sensor stream (accelerometer, device motion) runs at the highest frequency requested by
+ its current consumers, and each consumer is handed only the samples it needs for its own
+ frequency. A stream is started when its first consumer is added and stopped when its last
+ consumer is removed.
+
+ Handlers are called on the hub's serial queue, in sample order. They must not wait
+ synchronously on the thread that removes consumers.
+ */
+@interface ORKSensorHub : NSObject
+
+/// The hub used by recorders that do not provide their own motion manager.
++ (ORKSensorHub *)sharedHub;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+- (instancetype)initWithMotionManager:(CMMotionManager *)motionManager NS_DESIGNATED_INITIALIZER;
+
+@property (nonatomic, strong, readonly) CMMotionManager *motionManager;
+
+/**
+ Adds an accelerometer consumer, starting accelerometer updates if needed.
+
+ @param frequency   The frequency at which the consumer wants samples, in hertz (Hz).
+ @param handler     The handler to call with each sample.
+
+ @return An opaque token to pass to `removeConsumer:`, or `nil` if the accelerometer is unavailable.
+ */
+- (nullable id)addAccelerometerConsumerWithFrequency:(double)frequency handler:(CMAccelerometerHandler)handler;
+
+/**
+ Adds a device motion consumer, starting device motion updates if needed.
+
+ @param frequency   The frequency at which the consumer wants samples, in hertz (Hz).
+ @param handler     The handler to call with each sample.
+
+ @return An opaque token to pass to `removeConsumer:`, or `nil` if device motion is unavailable.
+ */
+- (nullable id)addDeviceMotionConsumerWithFrequency:(double)frequency handler:(CMDeviceMotionHandler)handler;
+
+/**
+ Removes a consumer, stopping its stream if no other consumer needs it.
+
+ The consumer's handler is never called after this method returns. When called from outside the
+ hub's queue, it waits only for a sample being delivered to this consumer, not for other
+ consumers' pending samples. It can also be called from a handler.
+ */
+- (void)removeConsumer:(id)consumer;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,279 @@
+/*
+ Copyright (c) 2016, Apple Inc. All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+ 
+ 1.  Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ 2.  Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation and/or
+ other materials provided with the distribution.
+ 
+ 3.  Neither the name of the copyright holder(s) nor the names of any contributors
+ may be used to endorse or promote products derived from this software without
+ specific prior written permission. No license is granted to the trademarks of
+ the copyright holders even if such marks are included in this software.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#import "ORKSensorHub.h"
+
+#import "ORKHelpers_Internal.h"
+
+#include <pthread.h>
+
+
+typedef NS_ENUM(NSInteger, ORKSensorHubStream) {
+    ORKSensorHubStreamAccelerometer,
+    ORKSensorHubStreamDeviceMotion
+};
+
+
+@interface ORKSensorHubConsumer : NSObject
+
+@property (nonatomic, readonly) ORKSensorHubStream stream;
+
+@property (nonatomic, readonly) NSTimeInterval interval;
+
+@property (nonatomic, copy, readonly) id handler;
+
+// Only read and written on the hub queue.
+@property (nonatomic) NSTimeInterval lastTimestamp;
+
+@end
+
+
+@implementation ORKSensorHubConsumer {
+    // Held while the handler runs, so deactivating waits for this consumer's delivery only.
+    pthread_mutex_t _deliveryLock;
+    BOOL _active;
+}
+
+- (instancetype)initWithStream:(ORKSensorHubStream)stream frequency:(double)frequency handler:(id)handler {
+    self = [super init];
+    if (self) {
+        _stream = stream;
+        _interval = 1.0 / ((frequency > 0) ? frequency : 1);
+        _handler = [handler copy];
+        _lastTimestamp = -DBL_MAX;
+        _active = YES;
+        pthread_mutex_init(&_deliveryLock, NULL);
+    }
+    return self;
+}
+
+- (void)dealloc {
+    pthread_mutex_destroy(&_deliveryLock);
+}
+
+// Called on the hub queue. The block is not run once the consumer has been deactivated.
+- (void)deliver:(dispatch_block_t)block {
+    pthread_mutex_lock(&_deliveryLock);
+    if (_active) {
+        block();
+    }
+    pthread_mutex_unlock(&_deliveryLock);
+}
+
+- (void)deactivateOnHubQueue:(BOOL)onHubQueue {
+    if (onHubQueue) {
+        // Deliveries are serial on the hub queue, so none of this consumer's can be in progress,
+        // unless this is called from its own handler, which already holds the lock.
+        _active = NO;
+        return;
+    }
+    pthread_mutex_lock(&_deliveryLock);
+    _active = NO;
+    pthread_mutex_unlock(&_deliveryLock);
+}
+
+// Decimates a stream running at `streamInterval` down to the consumer's own interval.
+- (BOOL)wantsSampleAtTimestamp:(NSTimeInterval)timestamp streamInterval:(NSTimeInterval)streamInterval {
+    if (_interval > streamInterval && (timestamp - _lastTimestamp) < (_interval - streamInterval / 2)) {
+        return NO;
+    }
+    _lastTimestamp = timestamp;
+    return YES;
+}
+
+@end
+
+
+@implementation ORKSensorHub {
+    NSOperationQueue *_queue;
+
+    // Replaced rather than mutated, so delivery only holds the lock long enough to read them.
+    // Each stream's interval is kept with its consumers, so delivery reads a matching pair.
+    NSArray<ORKSensorHubConsumer *> *_accelerometerConsumers;
+    NSArray<ORKSensorHubConsumer *> *_deviceMotionConsumers;
+    NSTimeInterval _accelerometerStreamInterval;
+    NSTimeInterval _deviceMotionStreamInterval;
+}
+
++ (ORKSensorHub *)sharedHub {
+    static ORKSensorHub *sharedHub = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        sharedHub = [[ORKSensorHub alloc] initWithMotionManager:[[CMMotionManager alloc] init]];
+    });
+    return sharedHub;
+}
+
+- (instancetype)init {
+    ORKThrowMethodUnavailableException();
+}
+
+- (instancetype)initWithMotionManager:(CMMotionManager *)motionManager {
+    self = [super init];
+    if (self) {
+        ORKThrowInvalidArgumentExceptionIfNil(motionManager);
+        _motionManager = motionManager;
+        _queue = [[NSOperationQueue alloc] init];
+        _queue.name = @"org.researchkit.sensorhub";
+        _queue.maxConcurrentOperationCount = 1;
+        _queue.qualityOfService = NSQualityOfServiceUserInitiated;
+        _accelerometerConsumers = @[];
+        _deviceMotionConsumers = @[];
+    }
+    return self;
+}
+
++ (NSTimeInterval)streamIntervalForConsumers:(NSArray<ORKSensorHubConsumer *> *)consumers {
+    NSTimeInterval interval = DBL_MAX;
+    for (ORKSensorHubConsumer *consumer in consumers) {
+        interval = MIN(interval, consumer.interval);
+    }
+    return interval;
+}
+
+- (id)addAccelerometerConsumerWithFrequency:(double)frequency handler:(CMAccelerometerHandler)handler {
+    if (!_motionManager.accelerometerAvailable) {
+        return nil;
+    }
+
+    ORKSensorHubConsumer *consumer = [[ORKSensorHubConsumer alloc] initWithStream:ORKSensorHubStreamAccelerometer frequency:frequency handler:handler];
+    @synchronized (self) {
+        NSArray<ORKSensorHubConsumer *> *consumers = [_accelerometerConsumers arrayByAddingObject:consumer];
+        _accelerometerConsumers = consumers;
+
+        _accelerometerStreamInterval = [ORKSensorHub streamIntervalForConsumers:consumers];
+        _motionManager.accelerometerUpdateInterval = _accelerometerStreamInterval;
+        if (consumers.count == 1) {
+            __weak typeof(self) weakSelf = self;
+            [_motionManager startAccelerometerUpdatesToQueue:_queue withHandler:^(CMAccelerometerData *data, NSError *error) {
+                [weakSelf deliverAccelerometerData:data error:error];
+            }];
+        }
+    }
+    return consumer;
+}
+
+- (id)addDeviceMotionConsumerWithFrequency:(double)frequency handler:(CMDeviceMotionHandler)handler {
+    if (!_motionManager.deviceMotionAvailable) {
+        return nil;
+    }
+
+    ORKSensorHubConsumer *consumer = [[ORKSensorHubConsumer alloc] initWithStream:ORKSensorHubStreamDeviceMotion frequency:frequency handler:handler];
+    @synchronized (self) {
+        NSArray<ORKSensorHubConsumer *> *consumers = [_deviceMotionConsumers arrayByAddingObject:consumer];
+        _deviceMotionConsumers = consumers;
+
+        _deviceMotionStreamInterval = [ORKSensorHub streamIntervalForConsumers:consumers];
+        _motionManager.deviceMotionUpdateInterval = _deviceMotionStreamInterval;
+        if (consumers.count == 1) {
+            __weak typeof(self) weakSelf = self;
+            [_motionManager startDeviceMotionUpdatesToQueue:_queue withHandler:^(CMDeviceMotion *motion, NSError *error) {
+                [weakSelf deliverDeviceMotion:motion error:error];
+            }];
+        }
+    }
+    return consumer;
+}
+
+- (void)removeConsumer:(id)consumer {
+    if (![consumer isKindOfClass:[ORKSensorHubConsumer class]]) {
+        return;
+    }
+    ORKSensorHubConsumer *hubConsumer = (ORKSensorHubConsumer *)consumer;
+    [hubConsumer deactivateOnHubQueue:([NSOperationQueue currentQueue] == _queue)];
+
+    @synchronized (self) {
+        switch (hubConsumer.stream) {
+            case ORKSensorHubStreamAccelerometer: {
+                NSMutableArray *consumers = [_accelerometerConsumers mutableCopy];
+                [consumers removeObjectIdenticalTo:hubConsumer];
+                _accelerometerConsumers = [consumers copy];
+                if (consumers.count == 0) {
+                    [_motionManager stopAccelerometerUpdates];
+                } else {
+                    _accelerometerStreamInterval = [ORKSensorHub streamIntervalForConsumers:consumers];
+                    _motionManager.accelerometerUpdateInterval = _accelerometerStreamInterval;
+                }
+                break;
+            }
+            case ORKSensorHubStreamDeviceMotion: {
+                NSMutableArray *consumers = [_deviceMotionConsumers mutableCopy];
+                [consumers removeObjectIdenticalTo:hubConsumer];
+                _deviceMotionConsumers = [consumers copy];
+                if (consumers.count == 0) {
+                    [_motionManager stopDeviceMotionUpdates];
+                } else {
+                    _deviceMotionStreamInterval = [ORKSensorHub streamIntervalForConsumers:consumers];
+                    _motionManager.deviceMotionUpdateInterval = _deviceMotionStreamInterval;
+                }
+                break;
+            }
+        }
+    }
+}
+
+- (void)deliverAccelerometerData:(CMAccelerometerData *)data error:(NSError *)error {
+    NSArray<ORKSensorHubConsumer *> *consumers = nil;
+    NSTimeInterval streamInterval = 0;
+    @synchronized (self) {
+        consumers = _accelerometerConsumers;
+        streamInterval = _accelerometerStreamInterval;
+    }
+    for (ORKSensorHubConsumer *consumer in consumers) {
+        if (data && ![consumer wantsSampleAtTimestamp:data.timestamp streamInterval:streamInterval]) {
+            continue;
+        }
+        CMAccelerometerHandler handler = consumer.handler;
+        [consumer deliver:^{
+            handler(data, error);
+        }];
+    }
+}
+
+- (void)deliverDeviceMotion:(CMDeviceMotion *)motion error:(NSError *)error {
+    NSArray<ORKSensorHubConsumer *> *consumers = nil;
+    NSTimeInterval streamInterval = 0;
+    @synchronized (self) {
+        consumers = _deviceMotionConsumers;
+        streamInterval = _deviceMotionStreamInterval;
+    }
+    for (ORKSensorHubConsumer *consumer in consumers) {
+        if (motion && ![consumer wantsSampleAtTimestamp:motion.timestamp streamInterval:streamInterval]) {
+            continue;
+        }
+        CMDeviceMotionHandler handler = consumer.handler;
+        [consumer deliver:^{
+            handler(motion, error);
+        }];
+    }
+}
+
+@end
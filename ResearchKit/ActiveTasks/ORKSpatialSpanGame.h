@@ -57,13 +57,29 @@ NS_ASSUME_NONNULL_BEGIN
                   sequenceLength:(NSInteger)sequenceLength
                             seed:(uint32_t)seed NS_DESIGNATED_INITIALIZER;
 
+/**
+ Returns a pool of games generated concurrently, one for each pair of game size and sequence length.
+ 
+ @param gameSizes           The number of tiles in each game.
+ @param sequenceLengths     The sequence length of each game. Must have as many elements as `gameSizes`.
+ @param seeds               The seed of each game, or `nil` to use a random seed for every game.
+ */
++ (NSArray<ORKSpatialSpanGame *> *)gamesWithGameSizes:(NSArray<NSNumber *> *)gameSizes
+                                      sequenceLengths:(NSArray<NSNumber *> *)sequenceLengths
+                                                seeds:(nullable NSArray<NSNumber *> *)seeds;
+
 /// The number of tiles in the game.
 @property (nonatomic, readonly) NSInteger gameSize;
 
 /// The length of the sequence. A sequence is a sub-array of a random permutation of integers (0..gameSize-1) that  has a length of `sequenceLength`.
 @property (nonatomic, readonly) NSInteger sequenceLength;
 
-/// The seed to use to generate the sequence. Note that if you pass `seed` to another game, you get the same game.
+/**
+ The seed to use to generate the sequence. Note that if you pass `seed` to another game, you get the same game.
+ 
+ The sequence is generated with an embedded generator rather than the C library's, so a seed gives the
+ same sequence on any device and thread.
+ */
 @property (nonatomic, readonly) uint32_t seed;
 
 /**
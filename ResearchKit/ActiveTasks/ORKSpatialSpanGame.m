@@ -34,6 +34,46 @@
 #import "ORKHelpers_Internal.h"
 
 
+/*
+ A PCG32 generator (O'Neill, "PCG: A Family of Simple Fast Space-Efficient Statistically Good
+ Algorithms for Random Number Generation"). Each game keeps its own state, so games can be
+ generated on any thread, and a seed gives the same sequence on every platform.
+ */
+typedef struct {
+    uint64_t state;
+    uint64_t increment;
+} ORKSpatialSpanRandomGenerator;
+
+static const uint64_t ORKSpatialSpanRandomStream = 0xda3e39cb94b95bdbULL;
+
+static uint32_t ORKSpatialSpanRandomNext(ORKSpatialSpanRandomGenerator *generator) {
+    uint64_t state = generator->state;
+    generator->state = state * 6364136223846793005ULL + generator->increment;
+    uint32_t xorShifted = (uint32_t)(((state >> 18) ^ state) >> 27);
+    uint32_t rotation = (uint32_t)(state >> 59);
+    return (xorShifted >> rotation) | (xorShifted << ((-rotation) & 31));
+}
+
+static ORKSpatialSpanRandomGenerator ORKSpatialSpanRandomGeneratorMake(uint32_t seed) {
+    ORKSpatialSpanRandomGenerator generator = { .state = 0, .increment = (ORKSpatialSpanRandomStream << 1) | 1 };
+    ORKSpatialSpanRandomNext(&generator);
+    generator.state += seed;
+    ORKSpatialSpanRandomNext(&generator);
+    return generator;
+}
+
+// Returns a uniformly distributed value in [0 .. bound - 1], rejecting the values that would bias a plain modulo.
+static uint32_t ORKSpatialSpanRandomUniform(ORKSpatialSpanRandomGenerator *generator, uint32_t bound) {
+    uint32_t threshold = (-bound) % bound;
+    for (;;) {
+        uint32_t value = ORKSpatialSpanRandomNext(generator);
+        if (value >= threshold) {
+            return value % bound;
+        }
+    }
+}
+
+
 @implementation ORKSpatialSpanGame {
     NSInteger *_sequence;
 }
@@ -55,11 +95,11 @@
         _sequence[i] = i;
     }
     
-    // Knuth algorithm: swap each with a random element elsewhere in the array.
-    // Note: we will only use the first _sequenceLength elements of this array
-    srandom(_seed);
-    for (NSInteger i = 0; i < _gameSize; i++) {
-        NSInteger rand_i = random() % _gameSize;
+    // Fisher-Yates shuffle: swap each element with a random one at or after it. Only the first
+    // _sequenceLength elements are used, so the shuffle stops there.
+    ORKSpatialSpanRandomGenerator generator = ORKSpatialSpanRandomGeneratorMake(_seed);
+    for (NSInteger i = 0; i < _sequenceLength; i++) {
+        NSInteger rand_i = i + ORKSpatialSpanRandomUniform(&generator, (uint32_t)(_gameSize - i));
         NSInteger tmp = _sequence[i];
         _sequence[i] = _sequence[rand_i];
         _sequence[rand_i] = tmp;
@@ -96,6 +136,34 @@
     return self;
 }
 
++ (NSArray<ORKSpatialSpanGame *> *)gamesWithGameSizes:(NSArray<NSNumber *> *)gameSizes
+                                      sequenceLengths:(NSArray<NSNumber *> *)sequenceLengths
+                                                seeds:(NSArray<NSNumber *> *)seeds {
+    NSParameterAssert(gameSizes.count == sequenceLengths.count);
+    NSParameterAssert(seeds == nil || seeds.count == gameSizes.count);
+    
+    size_t count = gameSizes.count;
+    __strong ORKSpatialSpanGame **games = (__strong ORKSpatialSpanGame **)calloc(count, sizeof(ORKSpatialSpanGame *));
+    if (games == NULL) {
+        return @[];
+    }
+    dispatch_apply(count, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t index) {
+        games[index] = [[ORKSpatialSpanGame alloc] initWithGameSize:gameSizes[index].integerValue
+                                                     sequenceLength:sequenceLengths[index].integerValue
+                                                               seed:seeds[index].unsignedIntValue];
+    });
+    
+    NSMutableArray *pool = [NSMutableArray arrayWithCapacity:count];
+    for (size_t index = 0; index < count; index++) {
+        if (games[index]) {
+            [pool addObject:games[index]];
+        }
+        games[index] = nil;
+    }
+    free(games);
+    return [pool copy];
+}
+
 /// Step parameter is the step in the sequence; tileIndex is the value of that step of the sequence.
 - (void)enumerateSequenceWithHandler:(void(^)(NSInteger step, NSInteger tileIndex, BOOL isLastStep, BOOL *stop))handler {
     BOOL stop = NO;
@@ -117,6 +117,7 @@ typedef void (^_ORKStateHandler)(ORKState *fromState, ORKState *_toState, id con
     ORKGridSize _gridSize;
     
     ORKSpatialSpanGameState *_currentGameState;
+    NSMutableDictionary<NSNumber *, ORKSpatialSpanGame *> *_gamePool;
     UIBarButtonItem *_customLearnMoreButtonItem;
     UIBarButtonItem *_learnMoreButtonItem;
     
@@ -374,9 +375,27 @@ typedef void (^_ORKStateHandler)(ORKState *fromState, ORKState *_toState, id con
     ORKSpatialSpanMemoryStep *step = [self spatialSpanStep];
     _nextGameSequenceLength = step.initialSpan;
     
+    [self fillGamePool];
     [self resetForNewGame];
 }
 
+// Generates a game for every span the step can reach up front, rather than one as each game starts.
+- (void)fillGamePool {
+    ORKSpatialSpanMemoryStep *step = [self spatialSpanStep];
+    NSMutableArray *gameSizes = [NSMutableArray array];
+    NSMutableArray *sequenceLengths = [NSMutableArray array];
+    for (NSInteger span = step.minimumSpan; span <= step.maximumSpan; span++) {
+        ORKGridSize gridSize = [self gridSizeForSpan:span];
+        [gameSizes addObject:@(gridSize.width * gridSize.height)];
+        [sequenceLengths addObject:@(span)];
+    }
+    
+    _gamePool = [NSMutableDictionary dictionary];
+    for (ORKSpatialSpanGame *game in [ORKSpatialSpanGame gamesWithGameSizes:gameSizes sequenceLengths:sequenceLengths seeds:nil]) {
+        _gamePool[@(game.sequenceLength)] = game;
+    }
+}
+
 - (void)resetUI {
     _contentView.numberOfItems = _score;
     _contentView.score = _numberOfItems;
@@ -395,7 +414,12 @@ typedef void (^_ORKStateHandler)(ORKState *fromState, ORKState *_toState, id con
     NSInteger sequenceLength = _nextGameSequenceLength;
     _gridSize = [self gridSizeForSpan:sequenceLength];
     
-    ORKSpatialSpanGame *game = [[ORKSpatialSpanGame alloc] initWithGameSize:_gridSize.width * _gridSize.height sequenceLength:sequenceLength seed:0];
+    // Each pooled game is used once; a span that is played again gets a new game.
+    ORKSpatialSpanGame *game = _gamePool[@(sequenceLength)];
+    [_gamePool removeObjectForKey:@(sequenceLength)];
+    if (!game) {
+        game = [[ORKSpatialSpanGame alloc] initWithGameSize:_gridSize.width * _gridSize.height sequenceLength:sequenceLength seed:0];
+    }
     ORKSpatialSpanGameState *gameState = [[ORKSpatialSpanGameState alloc] initWithGame:game];
     
     _currentGameState = gameState;
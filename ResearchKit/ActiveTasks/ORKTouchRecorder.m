@@ -31,13 +31,20 @@
 
 #import "ORKTouchRecorder.h"
 
-#import "ORKDataLogger.h"
+#import "ORKDataLogger_Internal.h"
+#import "ORKRecorderMetrics.h"
 
 #import "ORKRecorder_Internal.h"
 
+#import "ORKHelpers_Internal.h"
 #import "UITouch+ORKJSONDictionary.h"
 
 
+// Touch samples are handed to the logging queue when this many are buffered, or after `ORKTouchBatchMaximumDelay`.
+static const NSUInteger ORKTouchBatchCapacity = 64;
+static const NSTimeInterval ORKTouchBatchMaximumDelay = 0.5;
+
+
 @protocol ORKTouchRecordingDelegate <NSObject>
 
 - (void)view:(UIView *)view didDetectTouch:(UITouch *)touch;
@@ -89,12 +96,21 @@
 
 @interface ORKTouchRecorder () <ORKTouchRecordingDelegate> {
     ORKDataLogger *_logger;
+    dispatch_queue_t _loggingQueue;
+    
+    // Only accessed on the main thread.
+    ORKTouchSample _batch[ORKTouchBatchCapacity];
+    NSUInteger _batchCount;
+    NSUInteger _batchGeneration;
+    
+    // Indexes of the touches in progress, keyed by identity. Touches are retired when they end,
+    // so lookups stay constant-time however many touches a step records.
+    NSMapTable<UITouch *, NSNumber *> *_touchIndexes;
+    NSUInteger _nextTouchIndex;
 }
 
 @property (nonatomic, strong) ORKTouchGestureRecognizer *gestureRecognizer;
 
-@property (nonatomic, strong) NSMutableArray *touchArray;
-
 @property (nonatomic) NSTimeInterval uptime;
 
 @property (nonatomic, strong) NSError *recordingError;
@@ -104,6 +120,14 @@
 
 @implementation ORKTouchRecorder
 
+- (instancetype)initWithIdentifier:(NSString *)identifier step:(ORKStep *)step outputDirectory:(NSURL *)outputDirectory {
+    self = [super initWithIdentifier:identifier step:step outputDirectory:outputDirectory];
+    if (self) {
+        _loggingQueue = dispatch_queue_create("org.researchkit.recorder.touch", DISPATCH_QUEUE_SERIAL);
+    }
+    return self;
+}
+
 - (void)dealloc {
     [_logger finishCurrentLog];
 }
@@ -124,12 +148,22 @@
         }
     }
     
+    [self.metrics reset];
+    _logger.metrics = self.metrics;
+    
+    id<ORKRecorderSampleSource> sampleSource = self.sampleSource;
+    if (!_touchView && [sampleSource respondsToSelector:@selector(touchViewForRecorder:)]) {
+        _touchView = [sampleSource touchViewForRecorder:self];
+    }
+    
     if (self.touchView) {
         [self.touchView addGestureRecognizer:self.gestureRecognizer];
         
         [super start];
         
-        self.touchArray = [NSMutableArray array];
+        _touchIndexes = [NSMapTable mapTableWithKeyOptions:NSPointerFunctionsStrongMemory | NSPointerFunctionsObjectPointerPersonality
+                                              valueOptions:NSPointerFunctionsStrongMemory];
+        _nextTouchIndex = 0;
         _uptime = [NSProcessInfo processInfo].systemUptime;
     } else {
         @throw [NSException exceptionWithName:NSGenericException
@@ -148,6 +182,8 @@
 
 - (void)stop {
     [self doStopRecording];
+    [self flushBatch];
+    dispatch_sync(_loggingQueue, ^{});
     [_logger finishCurrentLog];
     
     NSError *error = nil;
@@ -166,6 +202,7 @@
         [self.touchView removeGestureRecognizer:self.gestureRecognizer];
         _touchView = nil;
     }
+    [_touchIndexes removeAllObjects];
 }
 
 - (void)finishRecordingWithError:(NSError *)error {
@@ -190,16 +227,62 @@
 #pragma mark - ORKTouchRecordingDelegate
 
 - (void)view:(UIView *)view didDetectTouch:(UITouch *)touch {
+    [self.metrics recordSampleWithTimestamp:touch.timestamp];
     
-    if ([self.touchArray containsObject:touch] == NO) {
-        [self.touchArray addObject:touch];
+    NSNumber *indexNumber = [_touchIndexes objectForKey:touch];
+    NSUInteger index = indexNumber ? indexNumber.unsignedIntegerValue : _nextTouchIndex++;
+    UITouchPhase phase = touch.phase;
+    if (phase == UITouchPhaseEnded || phase == UITouchPhaseCancelled) {
+        [_touchIndexes removeObjectForKey:touch];
+    } else if (!indexNumber) {
+        [_touchIndexes setObject:@(index) forKey:touch];
     }
     
-    NSError *error = nil;
-    if (![_logger append:[touch ork_JSONDictionaryInView:view allTouches:self.touchArray] error:&error]) {
-        assert(error != nil);
-        [self finishRecordingWithError:error];
+    _batch[_batchCount] = [touch ork_touchSampleInView:view index:index];
+    _batchCount++;
+    if (_batchCount == ORKTouchBatchCapacity) {
+        [self flushBatch];
+    } else if (_batchCount == 1) {
+        // Bound how long a sample can wait when touches are sparse.
+        NSUInteger generation = _batchGeneration;
+        ORKWeakTypeOf(self) weakSelf = self;
+        dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(ORKTouchBatchMaximumDelay * NSEC_PER_SEC)), dispatch_get_main_queue(), ^{
+            ORKStrongTypeOf(self) strongSelf = weakSelf;
+            if (strongSelf && strongSelf->_batchGeneration == generation) {
+                [strongSelf flushBatch];
+            }
+        });
+    }
+}
+
+// Hands the buffered samples to the logging queue; the dictionaries are built and written there.
+- (void)flushBatch {
+    _batchGeneration++;
+    if (_batchCount == 0) {
+        return;
     }
+    NSData *batch = [NSData dataWithBytes:_batch length:_batchCount * sizeof(ORKTouchSample)];
+    _batchCount = 0;
+    
+    ORKDataLogger *logger = _logger;
+    ORKWeakTypeOf(self) weakSelf = self;
+    dispatch_async(_loggingQueue, ^{
+        const ORKTouchSample *samples = batch.bytes;
+        NSUInteger count = batch.length / sizeof(ORKTouchSample);
+        NSMutableArray *dictionaries = [NSMutableArray arrayWithCapacity:count];
+        for (NSUInteger i = 0; i < count; i++) {
+            [dictionaries addObject:ORKJSONDictionaryFromTouchSample(samples[i])];
+        }
+        
+        NSError *error = nil;
+        if (![logger appendObjects:dictionaries error:&error]) {
+            assert(error != nil);
+            dispatch_async(dispatch_get_main_queue(), ^{
+                ORKStrongTypeOf(self) strongSelf = weakSelf;
+                [strongSelf finishRecordingWithError:error];
+            });
+        }
+    });
 }
 
 @end
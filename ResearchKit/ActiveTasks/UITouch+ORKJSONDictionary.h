@@ -34,9 +34,22 @@
 
 NS_ASSUME_NONNULL_BEGIN
 
+// The fields of a touch event that are logged, captured without allocating.
+typedef struct {
+    NSTimeInterval timestamp;
+    UITouchPhase phase;
+    NSInteger index;
+    CGPoint location;
+    CGSize viewSize;
+} ORKTouchSample;
+
+// Converts a captured touch sample into the dictionary written to the touch log.
+NSDictionary *ORKJSONDictionaryFromTouchSample(ORKTouchSample sample);
+
 @interface UITouch (ORKJSONDictionary)
 
-- (NSDictionary *)ork_JSONDictionaryInView:(UIView *)view allTouches:(NSArray *)allTouches;
+// `index` identifies the touch among those recorded; the caller keeps the mapping.
+- (ORKTouchSample)ork_touchSampleInView:(UIView *)view index:(NSInteger)index;
 
 @end
 
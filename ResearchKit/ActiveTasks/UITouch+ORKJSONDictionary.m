@@ -32,22 +32,28 @@
 #import "UITouch+ORKJSONDictionary.h"
 
 
+NSDictionary *ORKJSONDictionaryFromTouchSample(ORKTouchSample sample) {
+    return @{@"timestamp": [NSDecimalNumber numberWithDouble:sample.timestamp],
+             @"phase": @(sample.phase),
+             @"index": @(sample.index),
+             @"x": @(sample.location.x),
+             @"y": @(sample.location.y),
+             @"width": @(sample.viewSize.width),
+             @"height": @(sample.viewSize.height)
+             };
+}
+
+
 @implementation UITouch (ORKJSONDictionary)
 
-- (NSDictionary *)ork_JSONDictionaryInView:(UIView *)view allTouches:(NSArray *)allTouches {
-    CGPoint point = [self locationInView:view];
-    
-    CGRect touchViewBounds = view.bounds;
-    
-    NSDictionary *dictionary = @{@"timestamp": [NSDecimalNumber numberWithDouble:self.timestamp],
-                                 @"phase": @(self.phase),
-                                 @"index": @([allTouches indexOfObject:self]),
-                                 @"x": @(point.x),
-                                 @"y": @(point.y),
-                                 @"width": @(touchViewBounds.size.width),
-                                 @"height": @(touchViewBounds.size.height)
-                                 };
-    return dictionary;
+- (ORKTouchSample)ork_touchSampleInView:(UIView *)view index:(NSInteger)index {
+    return (ORKTouchSample){
+        .timestamp = self.timestamp,
+        .phase = self.phase,
+        .index = index,
+        .location = [self locationInView:view],
+        .viewSize = view.bounds.size
+    };
 }
 
 @end
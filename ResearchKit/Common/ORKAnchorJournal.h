@@ -0,0 +1,80 @@
+/*
+ Copyright (c) 2016, Apple Inc. All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+ 
+ 1.  Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ 2.  Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation and/or
+ other materials provided with the distribution.
+ 
+ 3.  Neither the name of the copyright holder(s) nor the names of any contributors
+ may be used to endorse or promote products derived from this software without
+ specific prior written permission. No license is granted to the trademarks of
+ the copyright holders even if such marks are included in this software.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+@import Foundation;
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+@class HKQueryAnchor;
+
+/**
+ The `ORKAnchorJournal` class is an append-only log of collector progress (HealthKit anchors and
+ motion activity dates), kept next to the data collection manager's snapshot of its collectors.
+
+ Appending a record costs one write and one flush to storage (`F_FULLFSYNC`), whatever the
+ number of collectors. Each record carries its length and a checksum, so a record torn by a crash
+ is detected and ignored, along with anything after it. The manager replays the journal on top of the snapshot when it loads its collectors,
+ and truncates it each time it writes a new snapshot.
+ 
+ A journal is not thread-safe; it is only used on the data collection manager's work queue.
+ */
+@interface ORKAnchorJournal : NSObject
+
+- (instancetype)init NS_UNAVAILABLE;
+
+- (instancetype)initWithPath:(NSString *)path NS_DESIGNATED_INITIALIZER;
+
+@property (nonatomic, copy, readonly) NSString *path;
+
+/// The number of records appended since the journal was last truncated, including those read back from disk.
+@property (nonatomic, readonly) NSUInteger recordCount;
+
+/**
+ Appends the progress of the collector at `index` in the snapshot.
+ 
+ Only one of `anchor` and `lastDate` is expected, depending on the kind of collector.
+ */
+- (BOOL)appendRecordForCollectorAtIndex:(NSUInteger)index
+                             identifier:(NSString *)identifier
+                                 anchor:(nullable HKQueryAnchor *)anchor
+                               lastDate:(nullable NSDate *)lastDate
+                                  error:(NSError * _Nullable *)error;
+
+/// Calls `block` with each intact record, oldest first.
+- (void)enumerateRecordsUsingBlock:(void (^)(NSUInteger index, NSString *identifier, HKQueryAnchor * _Nullable anchor, NSDate * _Nullable lastDate))block;
+
+/// Discards all records. Call this once their content is in a durable snapshot.
+- (BOOL)truncateWithError:(NSError * _Nullable *)error;
+
+@end
+
+NS_ASSUME_NONNULL_END
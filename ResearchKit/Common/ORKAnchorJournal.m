@@ -0,0 +1,248 @@
+/*
+ Copyright (c) 2016, Apple Inc. All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+ 
+ 1.  Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ 2.  Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation and/or
+ other materials provided with the distribution.
+ 
+ 3.  Neither the name of the copyright holder(s) nor the names of any contributors
+ may be used to endorse or promote products derived from this software without
+ specific prior written permission. No license is granted to the trademarks of
+ the copyright holders even if such marks are included in this software.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#import "ORKAnchorJournal.h"
+
+#import "ORKHelpers_Internal.h"
+
+#import <HealthKit/HealthKit.h>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+
+// Each record is a header followed by a keyed archive of the record dictionary.
+typedef struct {
+    uint32_t length;
+    uint32_t checksum;
+} ORKAnchorJournalRecordHeader;
+
+static NSString *const ORKAnchorJournalIndexKey = @"index";
+static NSString *const ORKAnchorJournalIdentifierKey = @"identifier";
+static NSString *const ORKAnchorJournalAnchorKey = @"anchor";
+static NSString *const ORKAnchorJournalLastDateKey = @"lastDate";
+
+// FNV-1a; only needs to catch torn writes, not tampering.
+static uint32_t ORKAnchorJournalChecksum(const void *bytes, NSUInteger length) {
+    const uint8_t *p = bytes;
+    uint32_t hash = 2166136261u;
+    for (NSUInteger i = 0; i < length; i++) {
+        hash ^= p[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// Flushes the file to permanent storage, returning 0 or an `errno` value. `fsync` alone only
+// reaches the drive's cache, which does not survive power loss, so `F_FULLFSYNC` is tried first.
+static int ORKAnchorJournalSync(int fileDescriptor) {
+    if (fcntl(fileDescriptor, F_FULLFSYNC) != -1 || fsync(fileDescriptor) == 0) {
+        return 0;
+    }
+    return errno;
+}
+
+
+@implementation ORKAnchorJournal {
+    NSFileHandle *_fileHandle;
+    BOOL _hasCountedRecords;
+    unsigned long long _intactLength;
+}
+
+- (instancetype)init {
+    ORKThrowMethodUnavailableException();
+}
+
+- (instancetype)initWithPath:(NSString *)path {
+    self = [super init];
+    if (self) {
+        ORKThrowInvalidArgumentExceptionIfNil(path);
+        _path = [path copy];
+    }
+    return self;
+}
+
+- (void)dealloc {
+    [_fileHandle closeFile];
+}
+
+- (NSUInteger)recordCount {
+    if (!_hasCountedRecords) {
+        __block NSUInteger count = 0;
+        _intactLength = [self enumerateIntactRecordsUsingBlock:^(NSUInteger index, NSString *identifier, HKQueryAnchor *anchor, NSDate *lastDate) {
+            count++;
+        }];
+        _recordCount = count;
+        _hasCountedRecords = YES;
+    }
+    return _recordCount;
+}
+
+- (NSFileHandle *)fileHandleWithError:(NSError **)error {
+    if (!_fileHandle) {
+        NSFileManager *fileManager = [NSFileManager defaultManager];
+        if (![fileManager fileExistsAtPath:_path]) {
+            if (![fileManager createFileAtPath:_path contents:nil attributes:@{NSFileProtectionKey: NSFileProtectionComplete}]) {
+                if (error) {
+                    *error = [NSError errorWithDomain:NSCocoaErrorDomain code:NSFileWriteUnknownError userInfo:@{NSFilePathErrorKey: _path}];
+                }
+                return nil;
+            }
+        }
+        _fileHandle = [NSFileHandle fileHandleForWritingAtPath:_path];
+        if (!_fileHandle) {
+            if (error) {
+                *error = [NSError errorWithDomain:NSCocoaErrorDomain code:NSFileWriteNoPermissionError userInfo:@{NSFilePathErrorKey: _path}];
+            }
+            return nil;
+        }
+        
+        // Drop a torn record left by a crash, so that new records are not appended after it.
+        [self recordCount];
+        if ([_fileHandle seekToEndOfFile] > _intactLength) {
+            [_fileHandle truncateFileAtOffset:_intactLength];
+        }
+    }
+    return _fileHandle;
+}
+
+- (BOOL)appendRecordForCollectorAtIndex:(NSUInteger)index
+                             identifier:(NSString *)identifier
+                                 anchor:(HKQueryAnchor *)anchor
+                               lastDate:(NSDate *)lastDate
+                                  error:(NSError **)error {
+    ORKThrowInvalidArgumentExceptionIfNil(identifier);
+    
+    NSMutableDictionary *record = [NSMutableDictionary dictionaryWithCapacity:4];
+    record[ORKAnchorJournalIndexKey] = @(index);
+    record[ORKAnchorJournalIdentifierKey] = identifier;
+    record[ORKAnchorJournalAnchorKey] = anchor;
+    record[ORKAnchorJournalLastDateKey] = lastDate;
+    NSData *payload = [NSKeyedArchiver archivedDataWithRootObject:record];
+    
+    ORKAnchorJournalRecordHeader header = {
+        .length = (uint32_t)payload.length,
+        .checksum = ORKAnchorJournalChecksum(payload.bytes, payload.length)
+    };
+    NSMutableData *data = [NSMutableData dataWithCapacity:sizeof(header) + payload.length];
+    [data appendBytes:&header length:sizeof(header)];
+    [data appendData:payload];
+    
+    NSFileHandle *fileHandle = [self fileHandleWithError:error];
+    if (!fileHandle) {
+        return NO;
+    }
+    @try {
+        [fileHandle seekToEndOfFile];
+        [fileHandle writeData:data];
+    } @catch (NSException *exception) {
+        if (error) {
+            *error = [NSError errorWithDomain:NSCocoaErrorDomain code:NSFileWriteUnknownError userInfo:@{NSFilePathErrorKey: _path, NSLocalizedFailureReasonErrorKey: exception.reason ? : @""}];
+        }
+        return NO;
+    }
+    
+    // The caller may discard its own copy of the progress once this returns, so the record must be durable.
+    int syncError = ORKAnchorJournalSync(fileHandle.fileDescriptor);
+    if (syncError != 0) {
+        if (error) {
+            *error = [NSError errorWithDomain:NSPOSIXErrorDomain code:syncError userInfo:@{NSFilePathErrorKey: _path}];
+        }
+        return NO;
+    }
+    _recordCount++;
+    return YES;
+}
+
+- (void)enumerateRecordsUsingBlock:(void (^)(NSUInteger, NSString *, HKQueryAnchor *, NSDate *))block {
+    [self enumerateIntactRecordsUsingBlock:block];
+}
+
+// Returns the length of the intact records at the start of the file.
+- (unsigned long long)enumerateIntactRecordsUsingBlock:(void (^)(NSUInteger, NSString *, HKQueryAnchor *, NSDate *))block {
+    NSData *data = [NSData dataWithContentsOfFile:_path options:NSDataReadingMappedIfSafe error:NULL];
+    const uint8_t *bytes = data.bytes;
+    NSUInteger offset = 0;
+    while (offset + sizeof(ORKAnchorJournalRecordHeader) <= data.length) {
+        ORKAnchorJournalRecordHeader header;
+        memcpy(&header, bytes + offset, sizeof(header));
+        NSUInteger payloadOffset = offset + sizeof(header);
+        if (header.length > data.length - payloadOffset || ORKAnchorJournalChecksum(bytes + payloadOffset, header.length) != header.checksum) {
+            ORK_Log_Debug(@"Anchor journal %@ ends with a torn record at offset %@", _path, @(offset));
+            break;
+        }
+        
+        NSDictionary *record = nil;
+        @try {
+            record = [NSKeyedUnarchiver unarchiveObjectWithData:[data subdataWithRange:NSMakeRange(payloadOffset, header.length)]];
+        } @catch (NSException *exception) {
+            record = nil;
+        }
+        if (![record isKindOfClass:[NSDictionary class]] || ![record[ORKAnchorJournalIdentifierKey] isKindOfClass:[NSString class]]) {
+            break;
+        }
+        offset = payloadOffset + header.length;
+        
+        block(((NSNumber *)record[ORKAnchorJournalIndexKey]).unsignedIntegerValue,
+              record[ORKAnchorJournalIdentifierKey],
+              record[ORKAnchorJournalAnchorKey],
+              record[ORKAnchorJournalLastDateKey]);
+    }
+    return offset;
+}
+
+- (BOOL)truncateWithError:(NSError **)error {
+    NSFileHandle *fileHandle = [self fileHandleWithError:error];
+    if (!fileHandle) {
+        return NO;
+    }
+    @try {
+        [fileHandle truncateFileAtOffset:0];
+    } @catch (NSException *exception) {
+        if (error) {
+            *error = [NSError errorWithDomain:NSCocoaErrorDomain code:NSFileWriteUnknownError userInfo:@{NSFilePathErrorKey: _path, NSLocalizedFailureReasonErrorKey: exception.reason ? : @""}];
+        }
+        return NO;
+    }
+    int syncError = ORKAnchorJournalSync(fileHandle.fileDescriptor);
+    if (syncError != 0) {
+        if (error) {
+            *error = [NSError errorWithDomain:NSPOSIXErrorDomain code:syncError userInfo:@{NSFilePathErrorKey: _path}];
+        }
+        return NO;
+    }
+    _recordCount = 0;
+    _intactLength = 0;
+    _hasCountedRecords = YES;
+    return YES;
+}
+
+@end
@@ -46,6 +46,7 @@ NS_ASSUME_NONNULL_BEGIN
 @class ORKMultipleValuePickerAnswerFormat;
 @class ORKImageChoiceAnswerFormat;
 @class ORKTextChoiceAnswerFormat;
+@class ORKSearchableChoiceAnswerFormat;
 @class ORKBooleanAnswerFormat;
 @class ORKNumericAnswerFormat;
 @class ORKTimeOfDayAnswerFormat;
@@ -59,6 +60,8 @@ NS_ASSUME_NONNULL_BEGIN
 @class ORKTextChoice;
 @class ORKImageChoice;
 
+@protocol ORKSearchableChoiceDataSource;
+
 /**
  The `ORKAnswerFormat` class is the abstract base class for classes that describe the
  format in which a survey question or form item should be answered. The ResearchKit framework uses
@@ -129,6 +132,9 @@ ORK_CLASS_AVAILABLE
 + (ORKTextChoiceAnswerFormat *)choiceAnswerFormatWithStyle:(ORKChoiceAnswerStyle)style
                                                textChoices:(NSArray<ORKTextChoice *> *)textChoices;
 
++ (ORKSearchableChoiceAnswerFormat *)searchableChoiceAnswerFormatWithStyle:(ORKChoiceAnswerStyle)style
+                                                                dataSource:(id<ORKSearchableChoiceDataSource>)dataSource;
+
 + (ORKNumericAnswerFormat *)decimalAnswerFormatWithUnit:(nullable NSString *)unit;
 + (ORKNumericAnswerFormat *)integerAnswerFormatWithUnit:(nullable NSString *)unit;
 
@@ -825,6 +831,83 @@ ORK_CLASS_AVAILABLE
 @end
 
 
+/**
+ The `ORKSearchableChoiceDataSource` protocol provides the choices of an
+ `ORKSearchableChoiceAnswerFormat` object one page at a time.
+ 
+ The methods of this protocol may be called on any queue, and must be safe to call concurrently.
+ The choices must not change while a task that uses them is being presented.
+ */
+@protocol ORKSearchableChoiceDataSource <NSObject>
+
+/**
+ Returns the total number of choices.
+ */
+- (NSUInteger)numberOfChoices;
+
+/**
+ Returns the choices in the specified range.
+ 
+ @param range   A range that lies within the total number of choices.
+ 
+ @return An array containing one `ORKTextChoice` object for each index in `range`. Each choice
+ must have a value, which identifies it in the result.
+ */
+- (NSArray<ORKTextChoice *> *)textChoicesInRange:(NSRange)range;
+
+@end
+
+
+/**
+ The `ORKSearchableChoiceAnswerFormat` class represents an answer format that lets participants
+ search a very large set of text choices, such as a list of medications or conditions, and choose
+ one or more of them.
+ 
+ Unlike `ORKTextChoiceAnswerFormat`, the choices are not held by the answer format. They are
+ read from a data source one page at a time, so only the rows being displayed are created.
+ The first search builds an in-memory index of the words in each choice's text, after which
+ each keystroke narrows the list to the choices that contain a word starting with each word
+ of the search text.
+ 
+ The data source is not archived, so an answer format that is decoded from an archive has no
+ data source and fails validation.
+ 
+ The searchable choice answer format can only be used with an `ORKQuestionStep` object. It
+ produces an `ORKChoiceQuestionResult` object.
+ */
+ORK_CLASS_AVAILABLE
+@interface ORKSearchableChoiceAnswerFormat : ORKAnswerFormat
+
++ (instancetype)new NS_UNAVAILABLE;
+- (instancetype)init NS_UNAVAILABLE;
+
+/**
+ Returns an initialized searchable choice answer format using the specified question style
+ and data source.
+ 
+ @param style           The style of question, such as single or multiple choice.
+ @param dataSource      The data source that provides the choices.
+ 
+ @return An initialized searchable choice answer format.
+ */
+- (instancetype)initWithStyle:(ORKChoiceAnswerStyle)style
+                   dataSource:(id<ORKSearchableChoiceDataSource>)dataSource NS_DESIGNATED_INITIALIZER;
+
+/**
+ The style of the question (that is, single or multiple choice).
+ */
+@property (readonly) ORKChoiceAnswerStyle style;
+
+/**
+ The data source that provides the choices. (read-only)
+ 
+ The answer format keeps a strong reference to its data source.
+ */
+@property (strong, readonly, nullable) id<ORKSearchableChoiceDataSource> dataSource;
+
+@end
+
+
 /**
  The `ORKBooleanAnswerFormat` class behaves the same as the `ORKTextChoiceAnswerFormat` class,
  except that it is preconfigured to use only Yes and No answers.
@@ -38,6 +38,7 @@
 #import "ORKAnswerFormat_Internal.h"
 
 #import "ORKChoiceAnswerFormatHelper.h"
+#import "ORKChoiceSearchIndex.h"
 #import "ORKHealthAnswerFormat.h"
 #import "ORKResult_Private.h"
 
@@ -336,6 +337,11 @@ NSNumberFormatterStyle ORKNumberFormattingStyleConvert(ORKNumberFormattingStyle
     return [[ORKTextChoiceAnswerFormat alloc] initWithStyle:style textChoices:textChoices];
 }
 
++ (ORKSearchableChoiceAnswerFormat *)searchableChoiceAnswerFormatWithStyle:(ORKChoiceAnswerStyle)style
+                                                                dataSource:(id<ORKSearchableChoiceDataSource>)dataSource {
+    return [[ORKSearchableChoiceAnswerFormat alloc] initWithStyle:style dataSource:dataSource];
+}
+
 + (ORKNumericAnswerFormat *)decimalAnswerFormatWithUnit:(NSString *)unit {
     return [[ORKNumericAnswerFormat alloc] initWithStyle:ORKNumericAnswerStyleDecimal unit:unit minimum:nil maximum:nil];
 }
@@ -957,6 +963,120 @@ static NSArray *ork_processTextChoices(NSArray<ORKTextChoice *> *textChoices) {
 @end
 
 
+#pragma mark - ORKSearchableChoiceAnswerFormat
+
+static const NSUInteger ORKSearchableChoicePageSize = 200;
+
+@implementation ORKSearchableChoiceAnswerFormat {
+    ORKChoiceSearchIndex *_searchIndex;
+}
+
++ (instancetype)new {
+    ORKThrowMethodUnavailableException();
+}
+
+- (instancetype)init {
+    ORKThrowMethodUnavailableException();
+}
+
+- (instancetype)initWithStyle:(ORKChoiceAnswerStyle)style
+                   dataSource:(id<ORKSearchableChoiceDataSource>)dataSource {
+    self = [super init];
+    if (self) {
+        _style = style;
+        _dataSource = dataSource;
+    }
+    return self;
+}
+
+- (void)validateParameters {
+    [super validateParameters];
+    
+    if (_dataSource == nil) {
+        @throw [NSException exceptionWithName:NSInvalidArgumentException
+                                       reason:@"ORKSearchableChoiceAnswerFormat requires a data source."
+                                     userInfo:nil];
+    }
+    if ([_dataSource numberOfChoices] < 1) {
+        @throw [NSException exceptionWithName:NSInvalidArgumentException
+                                       reason:@"The number of choices cannot be less than 1."
+                                     userInfo:nil];
+    }
+}
+
+- (ORKChoiceSearchIndex *)searchIndex {
+    if (_searchIndex == nil && _dataSource != nil) {
+        _searchIndex = [[ORKChoiceSearchIndex alloc] initWithDataSource:_dataSource pageSize:ORKSearchableChoicePageSize];
+    }
+    return _searchIndex;
+}
+
+- (instancetype)copyWithZone:(NSZone *)zone {
+    ORKSearchableChoiceAnswerFormat *answerFormat = [[[self class] allocWithZone:zone] initWithStyle:_style dataSource:_dataSource];
+    // Copies share the data source, so they can share its index too.
+    answerFormat->_searchIndex = _searchIndex;
+    return answerFormat;
+}
+
+- (BOOL)isEqual:(id)object {
+    BOOL isParentSame = [super isEqual:object];
+    
+    __typeof(self) castObject = object;
+    return (isParentSame &&
+            (_dataSource == castObject.dataSource) &&
+            (_style == castObject.style));
+}
+
+- (NSUInteger)hash {
+    return super.hash ^ _dataSource.hash ^ _style;
+}
+
+- (instancetype)initWithCoder:(NSCoder *)aDecoder {
+    self = [super initWithCoder:aDecoder];
+    if (self) {
+        ORK_DECODE_ENUM(aDecoder, style);
+    }
+    return self;
+}
+
+- (void)encodeWithCoder:(NSCoder *)aCoder {
+    [super encodeWithCoder:aCoder];
+    ORK_ENCODE_ENUM(aCoder, style);
+}
+
++ (BOOL)supportsSecureCoding {
+    return YES;
+}
+
+- (ORKQuestionType)questionType {
+    return (_style == ORKChoiceAnswerStyleSingleChoice) ? ORKQuestionTypeSingleChoice : ORKQuestionTypeMultipleChoice;
+}
+
+- (Class)questionResultClass {
+    return [ORKChoiceQuestionResult class];
+}
+
+- (NSString *)stringForAnswer:(id)answer {
+    if (![answer isKindOfClass:[NSArray class]]) {
+        return nil;
+    }
+    
+    // Does not wait for the search index to be built, so choices not yet read are left out until it is.
+    ORKChoiceSearchIndex *searchIndex = [self searchIndex];
+    NSMutableArray<NSString *> *answerStrings = [NSMutableArray array];
+    for (id value in (NSArray *)answer) {
+        NSUInteger index = [searchIndex indexOfChoiceWithValue:value];
+        NSString *text = (index != NSNotFound) ? [searchIndex textChoiceAtIndex:index].text : nil;
+        if (text != nil) {
+            [answerStrings addObject:text];
+        }
+    }
+    return [answerStrings componentsJoinedByString:@"\n"];
+}
+
+@end
+
+
 #pragma mark - ORKTextChoice
 
 @implementation ORKTextChoice {
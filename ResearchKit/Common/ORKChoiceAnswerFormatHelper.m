@@ -40,6 +40,9 @@
 @implementation ORKChoiceAnswerFormatHelper {
     NSArray *_choices;
     BOOL _isValuePicker;
+    
+    // Maps each choice value to the index of the first choice with that value. Built on first use.
+    NSDictionary<id, NSNumber *> *_indexesForValues;
 }
 
 - (instancetype)initWithAnswerFormat:(ORKAnswerFormat *)answerFormat {
@@ -125,6 +128,21 @@
     return indexes.count > 0 ? indexes.firstObject : nil;
 }
 
+- (NSDictionary<id, NSNumber *> *)indexesForValues {
+    if (_indexesForValues == nil) {
+        NSMutableDictionary<id, NSNumber *> *indexesForValues = [NSMutableDictionary dictionaryWithCapacity:_choices.count];
+        [_choices enumerateObjectsUsingBlock:^(id<ORKAnswerOption> choice, NSUInteger idx, BOOL *stop) {
+            id value = choice.value;
+            // Keep the first match, as a linear search would.
+            if (value != nil && indexesForValues[value] == nil) {
+                indexesForValues[value] = @(idx);
+            }
+        }];
+        _indexesForValues = [indexesForValues copy];
+    }
+    return _indexesForValues;
+}
+
 - (NSArray *)selectedIndexesForAnswer:(nullable id)answer {
     // Works with boolean result
     if ([answer isKindOfClass:[NSNumber class]]) {
@@ -137,26 +155,20 @@
         
         NSAssert([answer isKindOfClass:[ORKChoiceQuestionResult answerClass] ], @"Wrong answer type");
         
+        NSDictionary<id, NSNumber *> *indexesForValues = [self indexesForValues];
         for (id answerValue in (NSArray *)answer) {
-            id<ORKAnswerOption> matchedChoice = nil;
-            for ( id<ORKAnswerOption> choice in _choices) {
-                if ([choice.value isEqual:answerValue]) {
-                    matchedChoice = choice;
-                    break;
-                }
-            }
+            NSNumber *matchedIndex = indexesForValues[answerValue];
             
-            if (nil == matchedChoice) {
+            if (nil == matchedIndex) {
                 NSAssert([answerValue isKindOfClass:[NSNumber class]], @"");
-                if (_isValuePicker) {
-                    matchedChoice = _choices[((NSNumber *)answerValue).unsignedIntegerValue + 1];
-                } else {
-                    matchedChoice = _choices[((NSNumber *)answerValue).unsignedIntegerValue];
+                NSUInteger index = ((NSNumber *)answerValue).unsignedIntegerValue + (_isValuePicker ? 1 : 0);
+                if (index < _choices.count) {
+                    matchedIndex = @(index);
                 }
             }
             
-            if (matchedChoice) {
-                [indexArray addObject:@([_choices indexOfObject:matchedChoice])];
+            if (matchedIndex) {
+                [indexArray addObject:matchedIndex];
             }
         }
     }
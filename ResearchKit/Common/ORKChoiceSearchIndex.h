@@ -0,0 +1,95 @@
+/*
+ Copyright (c) 2016, Apple Inc. All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+ 
+ 1.  Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ 2.  Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation and/or
+ other materials provided with the distribution.
+ 
+ 3.  Neither the name of the copyright holder(s) nor the names of any contributors
+ may be used to endorse or promote products derived from this software without
+ specific prior written permission. No license is granted to the trademarks of
+ the copyright holders even if such marks are included in this software.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+@import Foundation;
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+@class ORKTextChoice;
+@protocol ORKSearchableChoiceDataSource;
+
+/**
+ The `ORKChoiceSearchIndex` class gives access to the choices of an
+ `ORKSearchableChoiceDataSource` object without holding all of them in memory.
+
+ Choices are read from the data source a page at a time, and only a few recently used pages are
+ kept. Searching uses a sorted list of the words in each choice's text, folded for case and
+ diacritics, so a word of the query matches every choice with a word starting with it. The word
+ list and a map from choice values to indexes are built once, by reading every page, on the
+ index's own queue. Until then, values are looked up among the pages read so far.
+
+ An index is thread-safe.
+ */
+@interface ORKChoiceSearchIndex : NSObject
+
+- (instancetype)init NS_UNAVAILABLE;
+
+- (instancetype)initWithDataSource:(id<ORKSearchableChoiceDataSource>)dataSource
+                          pageSize:(NSUInteger)pageSize NS_DESIGNATED_INITIALIZER;
+
+@property (nonatomic, strong, readonly) id<ORKSearchableChoiceDataSource> dataSource;
+
+@property (nonatomic, readonly) NSUInteger pageSize;
+
+@property (nonatomic, readonly) NSUInteger numberOfChoices;
+
+/// Returns the choice at `index`, reading its page from the data source if it is not cached.
+- (nullable ORKTextChoice *)textChoiceAtIndex:(NSUInteger)index;
+
+/// Whether the word list and value map have been built.
+@property (readonly, getter=isPrepared) BOOL prepared;
+
+/**
+ Returns the indexes of the choices that match a search query.
+
+ Each word of the query must be the start of a word in the choice's text. An empty query
+ matches every choice.
+
+ This method does not wait for the index to be built: until it is prepared, every choice is
+ returned and the build is started. Search again from the completion of `prepareWithCompletion:`.
+ */
+- (NSIndexSet *)indexesOfChoicesMatchingQuery:(NSString *)query;
+
+/**
+ Returns the index of the first choice whose value is equal to `value`, or `NSNotFound`.
+
+ This method does not wait for the index to be built: until it is prepared, only the values of
+ pages already read by `textChoiceAtIndex:` are found, and the build is started for any other value.
+ */
+- (NSUInteger)indexOfChoiceWithValue:(id)value;
+
+/// Builds the word list and value map on a background queue, then calls `completion` on the main queue.
+- (void)prepareWithCompletion:(nullable void (^)(void))completion;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,265 @@
+/*
+ Copyright (c) 2016, Apple Inc. All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+ 
+ 1.  Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ 2.  Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation and/or
+ other materials provided with the distribution.
+ 
+ 3.  Neither the name of the copyright holder(s) nor the names of any contributors
+ may be used to endorse or promote products derived from this software without
+ specific prior written permission. No license is granted to the trademarks of
+ the copyright holders even if such marks are included in this software.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#import "ORKChoiceSearchIndex.h"
+
+#import "ORKAnswerFormat.h"
+
+#import "ORKHelpers_Internal.h"
+
+#include <stdatomic.h>
+
+
+static const NSUInteger ORKChoiceSearchIndexCachedPageCount = 8;
+
+static NSArray<NSString *> *ORKChoiceSearchWords(NSString *text) {
+    NSString *folded = [text stringByFoldingWithOptions:(NSCaseInsensitiveSearch | NSDiacriticInsensitiveSearch)
+                                                 locale:[NSLocale currentLocale]];
+    NSCharacterSet *separators = [[NSCharacterSet alphanumericCharacterSet] invertedSet];
+    NSMutableArray<NSString *> *words = [NSMutableArray array];
+    for (NSString *word in [folded componentsSeparatedByCharactersInSet:separators]) {
+        if (word.length > 0) {
+            [words addObject:word];
+        }
+    }
+    return words;
+}
+
+
+@implementation ORKChoiceSearchIndex {
+    dispatch_queue_t _queue;
+    NSCache<NSNumber *, NSArray<ORKTextChoice *> *> *_pages;
+    NSUInteger _numberOfChoices;
+    
+    // The values of the pages read so far, kept after their pages leave the cache. Guarded by `@synchronized`.
+    NSMutableDictionary<id, NSNumber *> *_indexesForLoadedValues;
+    
+    // Built on `_queue`, and only read once `_built` is set.
+    _Atomic(bool) _built;
+    NSArray<NSString *> *_words;          // Sorted
+    NSData *_wordChoiceIndexes;           // One uint32_t choice index per entry in `_words`
+    NSDictionary<id, NSNumber *> *_indexesForValues;
+}
+
+- (instancetype)init {
+    ORKThrowMethodUnavailableException();
+}
+
+- (instancetype)initWithDataSource:(id<ORKSearchableChoiceDataSource>)dataSource pageSize:(NSUInteger)pageSize {
+    self = [super init];
+    if (self) {
+        ORKThrowInvalidArgumentExceptionIfNil(dataSource);
+        _dataSource = dataSource;
+        _pageSize = MAX(pageSize, (NSUInteger)1);
+        _numberOfChoices = [dataSource numberOfChoices];
+        _queue = dispatch_queue_create("org.researchkit.choicesearchindex", DISPATCH_QUEUE_SERIAL);
+        _pages = [NSCache new];
+        _pages.countLimit = ORKChoiceSearchIndexCachedPageCount;
+        _indexesForLoadedValues = [NSMutableDictionary dictionary];
+    }
+    return self;
+}
+
+- (NSUInteger)numberOfChoices {
+    return _numberOfChoices;
+}
+
+- (NSArray<ORKTextChoice *> *)pageAtPageIndex:(NSUInteger)pageIndex {
+    NSArray<ORKTextChoice *> *page = [_pages objectForKey:@(pageIndex)];
+    if (page == nil) {
+        NSUInteger location = pageIndex * _pageSize;
+        NSRange range = NSMakeRange(location, MIN(_pageSize, _numberOfChoices - location));
+        page = [[_dataSource textChoicesInRange:range] copy] ? : @[];
+        [_pages setObject:page forKey:@(pageIndex)];
+        [self addIndexesForValuesInPage:page location:location];
+    }
+    return page;
+}
+
+- (void)addIndexesForValuesInPage:(NSArray<ORKTextChoice *> *)page location:(NSUInteger)location {
+    @synchronized (_indexesForLoadedValues) {
+        [page enumerateObjectsUsingBlock:^(ORKTextChoice *choice, NSUInteger idx, BOOL *stop) {
+            id value = choice.value;
+            if (value != nil && _indexesForLoadedValues[value] == nil) {
+                _indexesForLoadedValues[value] = @(location + idx);
+            }
+        }];
+    }
+}
+
+- (ORKTextChoice *)textChoiceAtIndex:(NSUInteger)index {
+    if (index >= _numberOfChoices) {
+        return nil;
+    }
+    NSArray<ORKTextChoice *> *page = [self pageAtPageIndex:index / _pageSize];
+    NSUInteger indexInPage = index % _pageSize;
+    return (indexInPage < page.count) ? page[indexInPage] : nil;
+}
+
+#pragma mark Index
+
+- (BOOL)isPrepared {
+    return atomic_load(&_built);
+}
+
+- (void)queue_buildIfNeeded {
+    if (atomic_load(&_built)) {
+        return;
+    }
+    
+    NSMutableArray<NSString *> *words = [NSMutableArray array];
+    NSMutableData *wordChoiceIndexes = [NSMutableData data];
+    NSMutableDictionary<id, NSNumber *> *indexesForValues = [NSMutableDictionary dictionaryWithCapacity:_numberOfChoices];
+    
+    // Read the pages directly rather than through the cache, so building does not evict the pages on screen.
+    for (NSUInteger location = 0; location < _numberOfChoices; location += _pageSize) {
+        @autoreleasepool {
+            NSRange range = NSMakeRange(location, MIN(_pageSize, _numberOfChoices - location));
+            NSArray<ORKTextChoice *> *page = [_dataSource textChoicesInRange:range];
+            [page enumerateObjectsUsingBlock:^(ORKTextChoice *choice, NSUInteger idx, BOOL *stop) {
+                uint32_t choiceIndex = (uint32_t)(location + idx);
+                for (NSString *word in ORKChoiceSearchWords(choice.text)) {
+                    [words addObject:word];
+                    [wordChoiceIndexes appendBytes:&choiceIndex length:sizeof(choiceIndex)];
+                }
+                id value = choice.value;
+                if (value != nil && indexesForValues[value] == nil) {
+                    indexesForValues[value] = @(choiceIndex);
+                }
+            }];
+        }
+    }
+    
+    // Sort the words, carrying each word's choice index along with it.
+    NSUInteger count = words.count;
+    NSMutableArray<NSNumber *> *order = [NSMutableArray arrayWithCapacity:count];
+    for (NSUInteger idx = 0; idx < count; idx++) {
+        [order addObject:@(idx)];
+    }
+    [order sortUsingComparator:^NSComparisonResult(NSNumber *lhs, NSNumber *rhs) {
+        return [words[lhs.unsignedIntegerValue] compare:words[rhs.unsignedIntegerValue] options:NSLiteralSearch];
+    }];
+    
+    NSMutableArray<NSString *> *sortedWords = [NSMutableArray arrayWithCapacity:count];
+    NSMutableData *sortedChoiceIndexes = [NSMutableData dataWithLength:count * sizeof(uint32_t)];
+    const uint32_t *choiceIndexes = wordChoiceIndexes.bytes;
+    uint32_t *sortedIndexes = sortedChoiceIndexes.mutableBytes;
+    for (NSUInteger idx = 0; idx < count; idx++) {
+        NSUInteger from = order[idx].unsignedIntegerValue;
+        [sortedWords addObject:words[from]];
+        sortedIndexes[idx] = choiceIndexes[from];
+    }
+    
+    _words = [sortedWords copy];
+    _wordChoiceIndexes = [sortedChoiceIndexes copy];
+    _indexesForValues = [indexesForValues copy];
+    atomic_store(&_built, true);
+}
+
+// Returns the indexes of the choices with a word starting with `prefix`. The index must be built.
+- (NSMutableIndexSet *)indexesOfChoicesWithWordPrefix:(NSString *)prefix {
+    NSUInteger low = 0;
+    NSUInteger high = _words.count;
+    while (low < high) {
+        NSUInteger mid = low + (high - low) / 2;
+        if ([_words[mid] compare:prefix options:NSLiteralSearch] == NSOrderedAscending) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    
+    NSMutableIndexSet *indexes = [NSMutableIndexSet indexSet];
+    const uint32_t *choiceIndexes = _wordChoiceIndexes.bytes;
+    for (NSUInteger idx = low; idx < _words.count && [_words[idx] hasPrefix:prefix]; idx++) {
+        [indexes addIndex:choiceIndexes[idx]];
+    }
+    return indexes;
+}
+
+- (NSIndexSet *)indexesOfChoicesMatchingQuery:(NSString *)query {
+    NSArray<NSString *> *queryWords = ORKChoiceSearchWords(query ? : @"");
+    if (queryWords.count == 0) {
+        return [NSIndexSet indexSetWithIndexesInRange:NSMakeRange(0, _numberOfChoices)];
+    }
+    if (![self isPrepared]) {
+        [self prepareWithCompletion:nil];
+        return [NSIndexSet indexSetWithIndexesInRange:NSMakeRange(0, _numberOfChoices)];
+    }
+    
+    // Once built, the word list is immutable, so the search does not need the queue.
+    NSMutableIndexSet *matches = nil;
+    for (NSString *queryWord in queryWords) {
+        NSMutableIndexSet *wordMatches = [self indexesOfChoicesWithWordPrefix:queryWord];
+        if (matches == nil) {
+            matches = wordMatches;
+        } else {
+            [matches removeIndexes:[matches indexesPassingTest:^BOOL(NSUInteger idx, BOOL *stop) {
+                return ![wordMatches containsIndex:idx];
+            }]];
+        }
+        if (matches.count == 0) {
+            break;
+        }
+    }
+    return [matches copy];
+}
+
+- (NSUInteger)indexOfChoiceWithValue:(id)value {
+    if (value == nil) {
+        return NSNotFound;
+    }
+    
+    // Once built, the value map is immutable, so the lookup does not need the queue.
+    NSNumber *indexNumber = nil;
+    if ([self isPrepared]) {
+        indexNumber = _indexesForValues[value];
+    } else {
+        @synchronized (_indexesForLoadedValues) {
+            indexNumber = _indexesForLoadedValues[value];
+        }
+        if (indexNumber == nil) {
+            [self prepareWithCompletion:nil];
+        }
+    }
+    return indexNumber ? indexNumber.unsignedIntegerValue : NSNotFound;
+}
+
+- (void)prepareWithCompletion:(void (^)(void))completion {
+    dispatch_async(_queue, ^{
+        [self queue_buildIfNeeded];
+        if (completion) {
+            dispatch_async(dispatch_get_main_queue(), completion);
+        }
+    });
+}
+
+@end
@@ -59,12 +59,28 @@ ORK_CLASS_AVAILABLE
  Serialization helper that produces serialized output.
  Subclasses should implement to provide a default serialization for upload.
  
+ The output is compact JSON of the form `{"items":[...]}`.
+ 
  @params objects    The objects to be serialized.
  
  @return Serialized data object.
  */
 - (NSData *)serializedDataForObjects:(NSArray *)objects;
 
+/**
+ Writes the output of `serializedDataForObjects:` to a stream, a few objects at a time.
+ 
+ Health samples are encoded directly, without building intermediate dictionaries, so large
+ batches can be written to a file without holding their whole serialization in memory.
+ 
+ @params objects        The objects to be serialized.
+ @params outputStream   An open stream to write to.
+ @params error          The error that occurred, if the objects could not be serialized or written.
+ 
+ @return `YES` if all the objects were written.
+ */
+- (BOOL)writeSerializedObjects:(NSArray *)objects toOutputStream:(NSOutputStream *)outputStream error:(NSError * _Nullable *)error;
+
 /**
  Serialization helper that produces objects suitable for serialization to JSON.
  
@@ -109,6 +125,20 @@ ORK_CLASS_AVAILABLE
  */
 @property (copy, readonly) HKQueryAnchor *lastAnchor;
 
+/**
+ Number of samples requested from HealthKit by the next query.
+ 
+ The limit adapts to the time taken to query and deliver each page, so that dense sample types
+ are fetched in fewer, larger pages.
+ */
+@property (readonly) NSUInteger queryLimit;
+
+/**
+ Observed collection throughput, in samples per second, including the time the delegate takes to
+ process each page. Zero until a page has been collected.
+ */
+@property (readonly) double samplesPerSecond;
+
 @end
 
 
@@ -146,6 +176,20 @@ ORK_CLASS_AVAILABLE
  */
 @property (copy, readonly) HKQueryAnchor *lastAnchor;
 
+/**
+ Number of samples requested from HealthKit by the next query.
+ 
+ The limit adapts to the time taken to query and deliver each page, so that dense sample types
+ are fetched in fewer, larger pages.
+ */
+@property (readonly) NSUInteger queryLimit;
+
+/**
+ Observed collection throughput, in samples per second, including the time the delegate takes to
+ process each page. Zero until a page has been collected.
+ */
+@property (readonly) double samplesPerSecond;
+
 @end
 
 
@@ -36,6 +36,8 @@
 #import "CMMotionActivity+ORKJSONDictionary.h"
 #import "ORKHealthSampleQueryOperation.h"
 #import "ORKMotionActivityQueryOperation.h"
+#import "ORKQueryPageSizer.h"
+#import "ORKJSONStreamWriter.h"
 #import <CoreMotion/CoreMotion.h>
 
 
@@ -43,6 +45,11 @@ static NSString *const ItemsKey = @"items";
 static NSString *const ItemIdentifierFormat = @"org.researchkit.%@";
 static NSString *const ItemIdentifierFormatWithTwoPlaceholders = @"org.researchkit.%@.%@";
 
+// Page size learned at run time; it is neither archived nor copied.
+static ORKQueryPageSizer *ORKMakeHealthQueryPageSizer(void) {
+    return [[ORKQueryPageSizer alloc] initWithInitialLimit:1000 minimumLimit:100 maximumLimit:20000];
+}
+
 @implementation ORKCollector
 
 #pragma mark - NSSecureCoding
@@ -77,19 +84,39 @@ static NSString *const ItemIdentifierFormatWithTwoPlaceholders = @"org.researchk
 }
 
 - (NSData *)serializedDataForObjects:(NSArray *)objects {
-
-    NSDictionary *output = @{ ItemsKey : [self serializableObjectsForObjects:objects] };
+    ORKJSONStreamWriter *writer = [ORKJSONStreamWriter new];
     
     NSError *localError;
-    NSData *jsonData = [NSJSONSerialization dataWithJSONObject:output
-                                                       options:NSJSONWritingPrettyPrinted
-                                                         error:&localError];
-    if (!jsonData) {
+    if (![self writeSerializedObjects:objects writer:writer error:&localError]) {
         [NSException raise:NSInternalInconsistencyException format:@"Error serializing objects to JSON: %@", [localError localizedDescription]];
         return nil;
     }
     
-    return jsonData;
+    return writer.data;
+}
+
+- (BOOL)writeSerializedObjects:(NSArray *)objects toOutputStream:(NSOutputStream *)outputStream error:(NSError **)error {
+    ORKThrowInvalidArgumentExceptionIfNil(outputStream);
+    return [self writeSerializedObjects:objects writer:[[ORKJSONStreamWriter alloc] initWithOutputStream:outputStream] error:error];
+}
+
+- (BOOL)writeSerializedObjects:(NSArray *)objects writer:(ORKJSONStreamWriter *)writer error:(NSError **)error {
+    [writer beginObject];
+    [writer writeKey:ItemsKey];
+    [writer beginArray];
+    for (id object in objects) {
+        // Keep the autoreleased temporaries of each object from piling up over large batches.
+        @autoreleasepool {
+            [self writeSerializableObject:object writer:writer];
+        }
+    }
+    [writer endArray];
+    [writer endObject];
+    return [writer finishWithError:error];
+}
+
+- (void)writeSerializableObject:(id)object writer:(ORKJSONStreamWriter *)writer {
+    [writer writeJSONObject:[self serializableObjectsForObjects:@[object]].firstObject];
 }
 
 - (ORKOperation *)collectionOperationWithManager:(ORKDataCollectionManager *)mananger {
@@ -113,7 +140,9 @@ static NSString *const ItemIdentifierFormatWithTwoPlaceholders = @"org.researchk
 @end
 
 
-@implementation ORKHealthCollector : ORKCollector
+@implementation ORKHealthCollector : ORKCollector {
+    ORKQueryPageSizer *_pageSizer;
+}
 
 - (instancetype)initWithSampleType:(HKSampleType*)sampleType unit:(HKUnit*)unit startDate:(NSDate*)startDate {
     NSString *itemIdentifier = [NSString stringWithFormat:ItemIdentifierFormatWithTwoPlaceholders, sampleType.identifier, unit.unitString];
@@ -122,6 +151,7 @@ static NSString *const ItemIdentifierFormatWithTwoPlaceholders = @"org.researchk
         _sampleType = sampleType;
         _unit = unit;
         _startDate = startDate;
+        _pageSizer = ORKMakeHealthQueryPageSizer();
     }
     return self;
 }
@@ -137,6 +167,7 @@ static NSString *const ItemIdentifierFormatWithTwoPlaceholders = @"org.researchk
         ORK_DECODE_OBJ(aDecoder, unit);
         ORK_DECODE_OBJ(aDecoder, startDate);
         ORK_DECODE_OBJ(aDecoder, lastAnchor);
+        _pageSizer = ORKMakeHealthQueryPageSizer();
     }
     return self;
 }
@@ -159,6 +190,10 @@ static NSString *const ItemIdentifierFormatWithTwoPlaceholders = @"org.researchk
     return elements;
 }
 
+- (void)writeSerializableObject:(HKSample *)sample writer:(ORKJSONStreamWriter *)writer {
+    [sample ork_writeJSONWithOptions:(ORKSampleJSONOptions)(ORKSampleIncludeMetadata|ORKSampleIncludeSource|ORKSampleIncludeUUID) unit:self.unit writer:writer];
+}
+
 - (ORKOperation*)collectionOperationWithManager:(ORKDataCollectionManager*)mananger {
     if (! [HKHealthStore isHealthDataAvailable]) {
         return nil;
@@ -177,10 +212,23 @@ static NSString *const ItemIdentifierFormatWithTwoPlaceholders = @"org.researchk
     collector->_sampleType = self.sampleType;
     collector->_unit = [self.unit copy];
     collector->_lastAnchor = self.lastAnchor;
+    collector->_pageSizer = ORKMakeHealthQueryPageSizer();
     
     return collector;
 }
 
+- (ORKQueryPageSizer *)pageSizer {
+    return _pageSizer;
+}
+
+- (NSUInteger)queryLimit {
+    return _pageSizer.limit;
+}
+
+- (double)samplesPerSecond {
+    return _pageSizer.samplesPerSecond;
+}
+
 - (BOOL)isEqual:(id)object {
     BOOL isParentSame = [super isEqual:object];
     
@@ -195,7 +243,9 @@ static NSString *const ItemIdentifierFormatWithTwoPlaceholders = @"org.researchk
 @end
 
 
-@implementation ORKHealthCorrelationCollector : ORKCollector
+@implementation ORKHealthCorrelationCollector : ORKCollector {
+    ORKQueryPageSizer *_pageSizer;
+}
 
 - (instancetype)initWithCorrelationType:(HKCorrelationType *)correlationType
                             sampleTypes:(NSArray *)sampleTypes
@@ -208,6 +258,7 @@ static NSString *const ItemIdentifierFormatWithTwoPlaceholders = @"org.researchk
         _sampleTypes = sampleTypes;
         _units = units;
         _startDate = startDate;
+        _pageSizer = ORKMakeHealthQueryPageSizer();
     }
     return self;
 }
@@ -224,6 +275,7 @@ static NSString *const ItemIdentifierFormatWithTwoPlaceholders = @"org.researchk
         ORK_DECODE_OBJ_ARRAY(aDecoder, units, HKUnit);
         ORK_DECODE_OBJ(aDecoder, startDate);
         ORK_DECODE_OBJ(aDecoder, lastAnchor);
+        _pageSizer = ORKMakeHealthQueryPageSizer();
     }
     return self;
 }
@@ -257,6 +309,10 @@ static NSString *const ItemIdentifierFormatWithTwoPlaceholders = @"org.researchk
     return elements;
 }
 
+- (void)writeSerializableObject:(HKCorrelation *)correlation writer:(ORKJSONStreamWriter *)writer {
+    [correlation ork_writeJSONWithOptions:(ORKSampleJSONOptions)(ORKSampleIncludeMetadata|ORKSampleIncludeSource|ORKSampleIncludeUUID) sampleTypes:self.sampleTypes units:self.units writer:writer];
+}
+
 - (ORKOperation *)collectionOperationWithManager:(ORKDataCollectionManager *)manager {
     if (! [HKHealthStore isHealthDataAvailable]) {
         return nil;
@@ -272,10 +328,23 @@ static NSString *const ItemIdentifierFormatWithTwoPlaceholders = @"org.researchk
     collector->_sampleTypes = [self.sampleTypes copy];
     collector->_units = [self.units copy];
     collector->_lastAnchor = self.lastAnchor;
+    collector->_pageSizer = ORKMakeHealthQueryPageSizer();
     
     return collector;
 }
 
+- (ORKQueryPageSizer *)pageSizer {
+    return _pageSizer;
+}
+
+- (NSUInteger)queryLimit {
+    return _pageSizer.limit;
+}
+
+- (double)samplesPerSecond {
+    return _pageSizer.samplesPerSecond;
+}
+
 - (BOOL)isEqual:(id)object {
     BOOL isParentSame = [super isEqual:object];
     
@@ -34,6 +34,8 @@
 
 
 @class ORKOperation;
+@class ORKJSONStreamWriter;
+@class ORKQueryPageSizer;
 
 @interface ORKCollector () <NSSecureCoding>
 
@@ -41,6 +43,9 @@
 
 - (ORKOperation *)collectionOperationWithManager:(ORKDataCollectionManager *)mananger;
 
+// Writes one element of the serialized items array. The default writes the result of `serializableObjectsForObjects:`.
+- (void)writeSerializableObject:(id)object writer:(ORKJSONStreamWriter *)writer;
+
 @end
 
 
@@ -51,6 +56,7 @@
 - (NSDate *)startDate;
 - (HKQueryAnchor *)lastAnchor;
 - (void)setLastAnchor:(HKQueryAnchor *)lastAnchor;
+- (ORKQueryPageSizer *)pageSizer;
 
 @end
 
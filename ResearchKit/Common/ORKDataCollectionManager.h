@@ -135,6 +135,14 @@ ORK_CLASS_AVAILABLE
  */
 @property (nonatomic, weak, nullable) id<ORKDataCollectionManagerDelegate> delegate;
 
+/**
+ The maximum number of collectors that collect data at the same time.
+ 
+ Collectors that have collected before are started ahead of collectors that are still
+ backfilling their history. The default value is 4.
+ */
+@property (nonatomic) NSInteger maximumConcurrentCollectionCount;
+
 /**
  Add a collector for HealthKit quantity and category samples.
  
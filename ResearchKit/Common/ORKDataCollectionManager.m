@@ -30,6 +30,7 @@
 
 
 #import "ORKDataCollectionManager_Internal.h"
+#import "ORKAnchorJournal.h"
 #import "ORKCollector_Internal.h"
 #import "ORKOperation.h"
 #import "ORKHelpers_Internal.h"
@@ -37,6 +38,15 @@
 
 
 static  NSString *const ORKDataCollectionPersistenceFileName = @".dataCollection.ork.data";
+static  NSString *const ORKDataCollectionJournalFileName = @".dataCollection.ork.journal";
+
+// Number of journaled progress records after which the collectors are written to a new snapshot.
+static const NSUInteger ORKDataCollectionJournalCompactionThreshold = 128;
+
+static const NSInteger ORKDataCollectionDefaultMaximumConcurrentCollectionCount = 4;
+
+// Interval at which running operations are checked against their deadlines.
+static const NSTimeInterval ORKDataCollectionWatchdogInterval = 1;
 
 @implementation ORKDataCollectionManager {
     dispatch_queue_t _queue;
@@ -46,6 +56,8 @@ static  NSString *const ORKDataCollectionPersistenceFileName = @".dataCollection
     HKHealthStore *_healthStore;
     CMMotionActivityManager *_activityManager;
     NSMutableArray<HKObserverQueryCompletionHandler> *_completionHandlers;
+    ORKAnchorJournal *_journal;
+    dispatch_source_t _watchdogTimer;
 }
 
 - (instancetype)initWithPersistenceDirectoryURL:(NSURL *)directoryURL {
@@ -76,6 +88,8 @@ static  NSString *const ORKDataCollectionPersistenceFileName = @".dataCollection
             }
         }
         
+        _journal = [[ORKAnchorJournal alloc] initWithPath:[_managedDirectory stringByAppendingPathComponent:ORKDataCollectionJournalFileName]];
+        
         // Create persistance file if needed
         if (![defaultManager fileExistsAtPath:self.persistFilePath]) {
             _collectors = [NSArray new];
@@ -85,10 +99,23 @@ static  NSString *const ORKDataCollectionPersistenceFileName = @".dataCollection
         NSString *queueId = [@"ResearchKit.DataCollection." stringByAppendingString:_managedDirectory];
         _queue = dispatch_queue_create([queueId cStringUsingEncoding:NSUTF8StringEncoding], DISPATCH_QUEUE_SERIAL);
         _operationQueue = [[NSOperationQueue alloc] init];
+        _operationQueue.qualityOfService = NSQualityOfServiceUtility;
+        self.maximumConcurrentCollectionCount = ORKDataCollectionDefaultMaximumConcurrentCollectionCount;
     }
     return self;
 }
 
+- (NSInteger)maximumConcurrentCollectionCount {
+    return _operationQueue.maxConcurrentOperationCount;
+}
+
+- (void)setMaximumConcurrentCollectionCount:(NSInteger)maximumConcurrentCollectionCount {
+    if (maximumConcurrentCollectionCount < 1) {
+        @throw [NSException exceptionWithName:NSInvalidArgumentException reason:@"maximumConcurrentCollectionCount must be at least 1" userInfo:nil];
+    }
+    _operationQueue.maxConcurrentOperationCount = maximumConcurrentCollectionCount;
+}
+
 #pragma mark Data collection
 
 // dispatch_sync, but tries not to deadlock if we're already on the specified queue
@@ -137,10 +164,54 @@ static inline void dispatch_sync_if_not_on_queue(dispatch_queue_t queue, dispatc
         if (_collectors == nil) {
             @throw [NSException exceptionWithName:NSGenericException reason: [NSString stringWithFormat:@"Failed to read from path %@", [self persistFilePath]] userInfo:nil];
         }
+        [self replayJournal];
     }
     return _collectors;
 }
 
+// Applies the progress journaled since the snapshot was written. Records are keyed by position,
+// which is stable between snapshots because adding or removing a collector writes a new snapshot.
+- (void)replayJournal {
+    NSArray<ORKCollector *> *collectors = _collectors;
+    [_journal enumerateRecordsUsingBlock:^(NSUInteger index, NSString *identifier, HKQueryAnchor *anchor, NSDate *lastDate) {
+        if (index >= collectors.count || ![collectors[index].identifier isEqualToString:identifier]) {
+            return;
+        }
+        ORKCollector *collector = collectors[index];
+        if (anchor && [collector conformsToProtocol:@protocol(ORKHealthCollectable)]) {
+            [(ORKCollector<ORKHealthCollectable> *)collector setLastAnchor:anchor];
+        } else if (lastDate && [collector isKindOfClass:[ORKMotionActivityCollector class]]) {
+            ((ORKMotionActivityCollector *)collector).lastDate = lastDate;
+        }
+    }];
+}
+
+- (void)persistProgressOfCollector:(ORKCollector *)collector {
+    NSUInteger index = [self.collectors indexOfObjectIdenticalTo:collector];
+    if (index == NSNotFound) {
+        return;
+    }
+    
+    HKQueryAnchor *anchor = nil;
+    NSDate *lastDate = nil;
+    if ([collector conformsToProtocol:@protocol(ORKHealthCollectable)]) {
+        anchor = [(ORKCollector<ORKHealthCollectable> *)collector lastAnchor];
+    } else if ([collector isKindOfClass:[ORKMotionActivityCollector class]]) {
+        lastDate = ((ORKMotionActivityCollector *)collector).lastDate;
+    }
+    
+    NSError *error = nil;
+    if (![_journal appendRecordForCollectorAtIndex:index identifier:collector.identifier anchor:anchor lastDate:lastDate error:&error]) {
+        ORK_Log_Warning(@"Failed to journal progress of %@: %@", collector, error);
+        [self persistCollectors];
+        return;
+    }
+    
+    if (_journal.recordCount >= ORKDataCollectionJournalCompactionThreshold) {
+        [self persistCollectors];
+    }
+}
+
 - (NSString * _Nonnull)persistFilePath {
     return [_managedDirectory stringByAppendingPathComponent:ORKDataCollectionPersistenceFileName];
 }
@@ -155,6 +226,11 @@ static inline void dispatch_sync_if_not_on_queue(dispatch_queue_t queue, dispatc
     if (error) {
         @throw [NSException exceptionWithName:NSGenericException reason: [NSString stringWithFormat:@"Failed to write to path %@", [self persistFilePath]] userInfo:nil];
     }
+    
+    // The snapshot now holds everything the journal recorded.
+    if (![_journal truncateWithError:&error]) {
+        ORK_Log_Warning(@"Failed to truncate %@: %@", _journal.path, error);
+    }
 }
 
 - (void)addCollector:(ORKCollector *)collector {
@@ -293,6 +369,9 @@ static inline void dispatch_sync_if_not_on_queue(dispatch_queue_t queue, dispatc
             if (operation) {
                 __block ORKOperation *blockOp = operation;
                 
+                // Keep up-to-date collectors current before spending time on backfilling history.
+                operation.queuePriority = [self collectorHasProgress:collector] ? NSOperationQueuePriorityHigh : NSOperationQueuePriorityLow;
+                
                 [operation setCompletionBlock:^{
                     typeof(self) strongSelf = weakSelf;
                     if (blockOp.error) {
@@ -312,6 +391,8 @@ static inline void dispatch_sync_if_not_on_queue(dispatch_queue_t queue, dispatc
             
             typeof(self) strongSelf = weakSelf;
             [strongSelf onWorkQueueSync:^BOOL(ORKDataCollectionManager *manager) {
+                [manager stopWatchdog];
+                
                 if (_delegate && [_delegate respondsToSelector:@selector(dataCollectionManagerDidCompleteCollection:)]) {
                     [_delegate dataCollectionManagerDidCompleteCollection:self];
                 }
@@ -330,6 +411,7 @@ static inline void dispatch_sync_if_not_on_queue(dispatch_queue_t queue, dispatc
         }
         
         ORK_Log_Debug(@"Data Collection queue - new operations:\n%@", operations);
+        [self startWatchdog];
         [_operationQueue addOperations:operations waitUntilFinished:NO];
         [_operationQueue addOperation:completionOperation];
         
@@ -339,4 +421,44 @@ static inline void dispatch_sync_if_not_on_queue(dispatch_queue_t queue, dispatc
 
 }
 
+// Run this only on the work queue
+- (BOOL)collectorHasProgress:(ORKCollector *)collector {
+    if ([collector conformsToProtocol:@protocol(ORKHealthCollectable)]) {
+        return ([(ORKCollector<ORKHealthCollectable> *)collector lastAnchor] != nil);
+    } else if ([collector isKindOfClass:[ORKMotionActivityCollector class]]) {
+        return (((ORKMotionActivityCollector *)collector).lastDate != nil);
+    }
+    return NO;
+}
+
+// A single timer checks the deadlines of all the running operations, rather than one watchdog per query.
+// Run this only on the work queue
+- (void)startWatchdog {
+    [self stopWatchdog];
+    
+    dispatch_source_t timer = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, _queue);
+    uint64_t interval = (uint64_t)(ORKDataCollectionWatchdogInterval * NSEC_PER_SEC);
+    dispatch_source_set_timer(timer, dispatch_time(DISPATCH_TIME_NOW, interval), interval, interval / 10);
+    
+    NSOperationQueue *operationQueue = _operationQueue;
+    dispatch_source_set_event_handler(timer, ^{
+        CFAbsoluteTime now = CFAbsoluteTimeGetCurrent();
+        for (NSOperation *operation in operationQueue.operations) {
+            if ([operation isKindOfClass:[ORKOperation class]]) {
+                [(ORKOperation *)operation timeoutIfPastDeadline:now];
+            }
+        }
+    });
+    dispatch_resume(timer);
+    _watchdogTimer = timer;
+}
+
+// Run this only on the work queue
+- (void)stopWatchdog {
+    if (_watchdogTimer) {
+        dispatch_source_cancel(_watchdogTimer);
+        _watchdogTimer = nil;
+    }
+}
+
 @end
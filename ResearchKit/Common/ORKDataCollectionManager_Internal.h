@@ -43,6 +43,12 @@
 
 - (void)onWorkQueueAsync:(BOOL (^)(ORKDataCollectionManager *manager))block;
 
+/**
+ Records the anchor or last date of a collector in the journal, without rewriting the snapshot
+ of all collectors. Must be called on the work queue.
+ */
+- (void)persistProgressOfCollector:(ORKCollector *)collector;
+
 /**
  Last collection date.
  */
@@ -73,6 +73,11 @@
     [super validateParameters];
     
     for (ORKFormItem *item in _formItems) {
+        if ([item.answerFormat isKindOfClass:[ORKSearchableChoiceAnswerFormat class]]) {
+            @throw [NSException exceptionWithName:NSInvalidArgumentException
+                                           reason:@"ORKSearchableChoiceAnswerFormat can only be used with an ORKQuestionStep."
+                                         userInfo:nil];
+        }
         [item.answerFormat validateParameters];
     }
     
@@ -134,6 +134,11 @@
 
 @property (nonatomic, readonly) CGFloat maxLabelWidth;
 
+// Sections are equivalent when they have the same title and the same form items, in the same order.
+- (BOOL)isEquivalentToSection:(ORKTableSection *)section;
+
+- (NSSet<NSString *> *)formItemIdentifiers;
+
 @end
 
 
@@ -184,6 +189,32 @@
     return max;
 }
 
+- (BOOL)isEquivalentToSection:(ORKTableSection *)section {
+    if (!ORKEqualObjects(self.title, section.title) || self.items.count != section.items.count) {
+        return NO;
+    }
+    
+    __block BOOL equivalent = YES;
+    [self.items enumerateObjectsUsingBlock:^(ORKTableCellItem *item, NSUInteger idx, BOOL *stop) {
+        ORKTableCellItem *otherItem = section.items[idx];
+        if (!ORKEqualObjects(item.formItem, otherItem.formItem)) {
+            equivalent = NO;
+            *stop = YES;
+        }
+    }];
+    return equivalent;
+}
+
+- (NSSet<NSString *> *)formItemIdentifiers {
+    NSMutableSet<NSString *> *identifiers = [NSMutableSet set];
+    for (ORKTableCellItem *item in self.items) {
+        if (item.formItem.identifier) {
+            [identifiers addObject:item.formItem.identifier];
+        }
+    }
+    return identifiers;
+}
+
 @end
 
 @interface ORKFormSectionHeaderView : UIView
@@ -289,10 +320,17 @@
 @implementation ORKFormStepViewController {
     ORKAnswerDefaultSource *_defaultSource;
     ORKNavigationContainerView *_continueSkipView;
-    NSMutableSet *_formItemCells;
+    NSMutableDictionary<NSString *, ORKFormItemCell *> *_formItemCells;
     NSMutableArray<ORKTableSection *> *_sections;
     BOOL _skipped;
     ORKFormItemCell *_currentFirstResponderCell;
+    
+    // Answer state, keyed by form item identifier. Built lazily from the saved answers and kept
+    // up to date as individual answers change, so button states do not walk every form item.
+    NSDictionary<NSString *, ORKFormItem *> *_answerableFormItems;
+    NSMutableSet<NSString *> *_answeredIdentifiers;
+    NSMutableSet<NSString *> *_invalidAnswerIdentifiers;
+    NSMutableSet<NSString *> *_missingAnswerIdentifiers;
 }
 
 - (instancetype)ORKFormStepViewController_initWithResult:(ORKResult *)result {
@@ -369,15 +407,35 @@
 }
 
 - (void)updateDefaults:(NSMutableDictionary *)defaults {
+    NSDictionary *previousDefaults = _savedDefaults;
     _savedDefaults = defaults;
     
-    for (ORKFormItemCell *cell in [_tableView visibleCells]) {
-        NSIndexPath *indexPath = [_tableView indexPathForCell:cell];
+    // Only the form items whose default changed need their cells updated.
+    NSMutableSet<NSString *> *changedIdentifiers = [NSMutableSet setWithArray:defaults.allKeys];
+    [changedIdentifiers addObjectsFromArray:previousDefaults.allKeys];
+    for (NSString *identifier in [changedIdentifiers allObjects]) {
+        if (ORKEqualObjects(previousDefaults[identifier], defaults[identifier])) {
+            [changedIdentifiers removeObject:identifier];
+        }
+    }
+    
+    if (changedIdentifiers.count > 0) {
+        for (NSString *identifier in changedIdentifiers) {
+            _formItemCells[identifier].defaultAnswer = _savedDefaults[identifier];
+        }
         
-        ORKTableSection *section = _sections[indexPath.section];
-        ORKTableCellItem *cellItem = [section items][indexPath.row];
-        ORKFormItem *formItem = cellItem.formItem;
-        if ([cell isKindOfClass:[ORKChoiceViewCell class]]) {
+        NSMutableIndexSet *visitedSections = [NSMutableIndexSet indexSet];
+        for (NSIndexPath *indexPath in [_tableView indexPathsForVisibleRows]) {
+            ORKTableSection *section = _sections[indexPath.section];
+            if (section.textChoiceCellGroup == nil || [visitedSections containsIndex:indexPath.section]) {
+                continue;
+            }
+            [visitedSections addIndex:indexPath.section];
+            
+            ORKFormItem *formItem = [(ORKTableCellItem *)section.items.firstObject formItem];
+            if (![changedIdentifiers containsObject:formItem.identifier]) {
+                continue;
+            }
             id answer = _savedAnswers[formItem.identifier];
             answer = answer ? : _savedDefaults[formItem.identifier];
             
@@ -385,9 +443,6 @@
             
             // Answers need to be saved.
             [self setAnswer:answer forIdentifier:formItem.identifier];
-            
-        } else {
-            cell.defaultAnswer = _savedDefaults[formItem.identifier];
         }
     }
     
@@ -433,6 +488,7 @@
     }
     [_savedAnswers removeObjectForKey:identifier];
     _savedAnswerDates[identifier] = [NSDate date];
+    [self updateAnswerStateForIdentifier:identifier];
 }
 
 - (void)setAnswer:(id)answer forIdentifier:(NSString *)identifier {
@@ -455,6 +511,12 @@
     _savedAnswerDates[identifier] = [NSDate date];
     _savedSystemCalendars[identifier] = [NSCalendar currentCalendar];
     _savedSystemTimeZones[identifier] = [NSTimeZone systemTimeZone];
+    [self updateAnswerStateForIdentifier:identifier];
+}
+
+- (void)setSavedAnswers:(NSMutableDictionary *)savedAnswers {
+    _savedAnswers = savedAnswers;
+    [self invalidateAnswerState];
 }
 
 // Override to monitor button title change
@@ -480,6 +542,15 @@
 
 - (void)stepDidChange {
     [super stepDidChange];
+    [self invalidateAnswerState];
+    
+    if (self.isViewLoaded && self.step && _tableContainer) {
+        // Keep the table, and only reload the sections whose form items changed.
+        [self updateSections];
+        [self updateHeaderAndNavigationViews];
+        [_tableContainer setNeedsLayout];
+        return;
+    }
 
     [_tableContainer removeFromSuperview];
     _tableContainer = nil;
@@ -494,7 +565,7 @@
     if (self.isViewLoaded && self.step) {
         [self buildSections];
         
-        _formItemCells = [NSMutableSet new];
+        _formItemCells = [NSMutableDictionary new];
         
         _tableContainer = [[ORKTableContainerView alloc] initWithFrame:self.view.bounds];
         _tableContainer.delegate = self;
@@ -510,25 +581,72 @@
         _tableView.estimatedSectionHeaderHeight = 30.0;
         
         _headerView = _tableContainer.stepHeaderView;
-        _headerView.captionLabel.text = [[self formStep] title];
-        _headerView.captionLabel.useSurveyMode = [[self formStep] useSurveyMode];
-        _headerView.instructionLabel.text = [[self formStep] text];
-        _headerView.learnMoreButtonItem = self.learnMoreButtonItem;
-        
         _continueSkipView = _tableContainer.continueSkipContainerView;
-        _continueSkipView.skipButtonItem = self.skipButtonItem;
-        _continueSkipView.continueEnabled = [self continueButtonEnabled];
-        _continueSkipView.continueButtonItem = self.continueButtonItem;
-        _continueSkipView.optional = self.step.optional;
-        _continueSkipView.footnoteLabel.text = [self formStep].footnote;
-        if (self.readOnlyMode) {
-            _continueSkipView.optional = YES;
-            [_continueSkipView setNeverHasContinueButton:YES];
-            _continueSkipView.skipEnabled = [self skipButtonEnabled];
-            _continueSkipView.skipButton.accessibilityTraits = UIAccessibilityTraitStaticText;
-        }
+        [self updateHeaderAndNavigationViews];
+    }
+}
+
+- (void)updateHeaderAndNavigationViews {
+    _headerView.captionLabel.text = [[self formStep] title];
+    _headerView.captionLabel.useSurveyMode = [[self formStep] useSurveyMode];
+    _headerView.instructionLabel.text = [[self formStep] text];
+    _headerView.learnMoreButtonItem = self.learnMoreButtonItem;
+    
+    _continueSkipView.skipButtonItem = self.skipButtonItem;
+    _continueSkipView.continueEnabled = [self continueButtonEnabled];
+    _continueSkipView.continueButtonItem = self.continueButtonItem;
+    _continueSkipView.optional = self.step.optional;
+    _continueSkipView.footnoteLabel.text = [self formStep].footnote;
+    if (self.readOnlyMode) {
+        _continueSkipView.optional = YES;
+        [_continueSkipView setNeverHasContinueButton:YES];
+        _continueSkipView.skipEnabled = [self skipButtonEnabled];
+        _continueSkipView.skipButton.accessibilityTraits = UIAccessibilityTraitStaticText;
+    }
+}
 
+- (void)updateSections {
+    NSArray<ORKTableSection *> *oldSections = [_sections copy];
+    [self buildSections];
+    NSArray<ORKTableSection *> *newSections = [_sections copy];
+    
+    // Equivalent sections at the same index keep their old section object, and with it their cells
+    // and choice selection. Everything else is reloaded, inserted or deleted.
+    NSMutableIndexSet *reloadedSections = [NSMutableIndexSet indexSet];
+    NSMutableSet<NSString *> *staleIdentifiers = [NSMutableSet set];
+    for (NSUInteger idx = 0; idx < oldSections.count; idx++) {
+        if (idx < newSections.count && [oldSections[idx] isEquivalentToSection:newSections[idx]]) {
+            _sections[idx] = oldSections[idx];
+            continue;
+        }
+        if (idx < newSections.count) {
+            [reloadedSections addIndex:idx];
+        }
+        [staleIdentifiers unionSet:[oldSections[idx] formItemIdentifiers]];
+    }
+    
+    if (reloadedSections.count == 0 && newSections.count == oldSections.count) {
+        return;
+    }
+    
+    [_formItemCells removeObjectsForKeys:[staleIdentifiers allObjects]];
+    if (_currentFirstResponderCell && [staleIdentifiers containsObject:_currentFirstResponderCell.formItem.identifier]) {
+        [_currentFirstResponderCell resignFirstResponder];
+        _currentFirstResponderCell = nil;
+    }
+    
+    [_tableView beginUpdates];
+    if (reloadedSections.count > 0) {
+        [_tableView reloadSections:reloadedSections withRowAnimation:UITableViewRowAnimationNone];
     }
+    if (newSections.count > oldSections.count) {
+        NSRange range = NSMakeRange(oldSections.count, newSections.count - oldSections.count);
+        [_tableView insertSections:[NSIndexSet indexSetWithIndexesInRange:range] withRowAnimation:UITableViewRowAnimationNone];
+    } else if (newSections.count < oldSections.count) {
+        NSRange range = NSMakeRange(newSections.count, oldSections.count - newSections.count);
+        [_tableView deleteSections:[NSIndexSet indexSetWithIndexesInRange:range] withRowAnimation:UITableViewRowAnimationNone];
+    }
+    [_tableView endUpdates];
 }
 
 - (void)buildSections {
@@ -598,29 +716,83 @@
 }
 
 - (NSInteger)numberOfAnsweredFormItems {
-    return [self numberOfAnsweredFormItemsInDictionary:self.savedAnswers];
+    [self buildAnswerStateIfNeeded];
+    return _answeredIdentifiers.count;
 }
 
 - (BOOL)allAnsweredFormItemsAreValid {
-    for (ORKFormItem *item in [self formItems]) {
-        id answer = _savedAnswers[item.identifier];
-        if (ORKIsAnswerEmpty(answer) == NO && ![item.impliedAnswerFormat isAnswerValid:answer]) {
-            return NO;
-        }
-    }
-    return YES;
+    [self buildAnswerStateIfNeeded];
+    return (_invalidAnswerIdentifiers.count == 0);
 }
 
 - (BOOL)allNonOptionalFormItemsHaveAnswers {
+    [self buildAnswerStateIfNeeded];
+    return (_missingAnswerIdentifiers.count == 0);
+}
+
+- (void)invalidateAnswerState {
+    _answerableFormItems = nil;
+    _answeredIdentifiers = nil;
+    _invalidAnswerIdentifiers = nil;
+    _missingAnswerIdentifiers = nil;
+}
+
+- (void)buildAnswerStateIfNeeded {
+    if (_answerableFormItems) {
+        return;
+    }
+    
+    NSMutableDictionary<NSString *, ORKFormItem *> *answerableFormItems = [NSMutableDictionary dictionary];
     for (ORKFormItem *item in [self formItems]) {
-        if (!item.optional) {
-            id answer = _savedAnswers[item.identifier];
-            if (ORKIsAnswerEmpty(answer) || ![item.impliedAnswerFormat isAnswerValid:answer]) {
-                return NO;
-            }
+        if (item.identifier) {
+            answerableFormItems[item.identifier] = item;
         }
     }
-    return YES;
+    _answerableFormItems = [answerableFormItems copy];
+    _answeredIdentifiers = [NSMutableSet set];
+    _invalidAnswerIdentifiers = [NSMutableSet set];
+    _missingAnswerIdentifiers = [NSMutableSet set];
+    
+    NSMutableSet<NSString *> *identifiers = [NSMutableSet setWithArray:_answerableFormItems.allKeys];
+    [identifiers addObjectsFromArray:_savedAnswers.allKeys];
+    for (NSString *identifier in identifiers) {
+        [self updateAnswerStateForIdentifier:identifier];
+    }
+}
+
+- (void)updateAnswerStateForIdentifier:(NSString *)identifier {
+    if (_answerableFormItems == nil) {
+        // Built from scratch the next time it is needed.
+        return;
+    }
+    
+    id answer = _savedAnswers[identifier];
+    BOOL answered = (ORKIsAnswerEmpty(answer) == NO);
+    BOOL invalid = NO;
+    BOOL missing = NO;
+    
+    ORKFormItem *item = _answerableFormItems[identifier];
+    if (item) {
+        BOOL valid = answered && [item.impliedAnswerFormat isAnswerValid:answer];
+        invalid = answered && !valid;
+        missing = !item.optional && !valid;
+    }
+    
+    if (answered) {
+        [_answeredIdentifiers addObject:identifier];
+    } else {
+        [_answeredIdentifiers removeObject:identifier];
+    }
+    if (invalid) {
+        [_invalidAnswerIdentifiers addObject:identifier];
+    } else {
+        [_invalidAnswerIdentifiers removeObject:identifier];
+    }
+    if (missing) {
+        [_missingAnswerIdentifiers addObject:identifier];
+    } else {
+        [_missingAnswerIdentifiers removeObject:identifier];
+    }
 }
 
 - (BOOL)continueButtonEnabled {
@@ -767,99 +939,103 @@
     return [self numberOfRowsInSection:section];
 }
 
-- (UITableViewCell *)tableView:(UITableView *)tableView cellForRowAtIndexPath:(NSIndexPath *)indexPath {
-    NSString *identifier = [NSString stringWithFormat:@"%ld-%ld",(long)indexPath.section, (long)indexPath.row];
+- (Class)cellClassForFormItem:(ORKFormItem *)formItem {
+    ORKAnswerFormat *answerFormat = [formItem impliedAnswerFormat];
+    ORKQuestionType type = answerFormat.questionType;
     
-    UITableViewCell *cell = [tableView dequeueReusableCellWithIdentifier:identifier];
-    
-    if (cell == nil) {
-        ORKTableSection *section = (ORKTableSection *)_sections[indexPath.section];
-        ORKTableCellItem *cellItem = [section items][indexPath.row];
-        ORKFormItem *formItem = cellItem.formItem;
-        id answer = _savedAnswers[formItem.identifier];
-        
-        if (section.textChoiceCellGroup) {
-            [section.textChoiceCellGroup setAnswer:answer];
-            cell = [section.textChoiceCellGroup cellAtIndexPath:indexPath withReuseIdentifier:identifier];
-        } else {
-            ORKAnswerFormat *answerFormat = [cellItem.formItem impliedAnswerFormat];
-            ORKQuestionType type = answerFormat.questionType;
-            
-            Class class = nil;
-            switch (type) {
-                case ORKQuestionTypeSingleChoice:
-                case ORKQuestionTypeMultipleChoice: {
-                    if ([formItem.impliedAnswerFormat isKindOfClass:[ORKImageChoiceAnswerFormat class]]) {
-                        class = [ORKFormItemImageSelectionCell class];
-                    } else if ([formItem.impliedAnswerFormat isKindOfClass:[ORKValuePickerAnswerFormat class]]) {
-                        class = [ORKFormItemPickerCell class];
-                    }
-                    break;
-                }
-                    
-                case ORKQuestionTypeDateAndTime:
-                case ORKQuestionTypeDate:
-                case ORKQuestionTypeTimeOfDay:
-                case ORKQuestionTypeTimeInterval:
-                case ORKQuestionTypeMultiplePicker:
-                case ORKQuestionTypeHeight: {
-                    class = [ORKFormItemPickerCell class];
-                    break;
-                }
-                    
-                case ORKQuestionTypeDecimal:
-                case ORKQuestionTypeInteger: {
-                    class = [ORKFormItemNumericCell class];
-                    break;
-                }
-                    
-                case ORKQuestionTypeText: {
-                    if ([formItem.answerFormat isKindOfClass:[ORKConfirmTextAnswerFormat class]]) {
-                        class = [ORKFormItemConfirmTextCell class];
-                    } else {
-                        ORKTextAnswerFormat *textFormat = (ORKTextAnswerFormat *)answerFormat;
-                        if (!textFormat.multipleLines) {
-                            class = [ORKFormItemTextFieldCell class];
-                        } else {
-                            class = [ORKFormItemTextCell class];
-                        }
-                    }
-                    break;
-                }
-                    
-                case ORKQuestionTypeScale: {
-                    class = [ORKFormItemScaleCell class];
-                    break;
-                }
-                    
-                case ORKQuestionTypeLocation: {
-                    class = [ORKFormItemLocationCell class];
-                    break;
-                }
-                    
-                default:
-                    NSAssert(NO, @"SHOULD NOT FALL IN HERE %@ %@", @(type), answerFormat);
-                    break;
+    Class class = nil;
+    switch (type) {
+        case ORKQuestionTypeSingleChoice:
+        case ORKQuestionTypeMultipleChoice: {
+            if ([answerFormat isKindOfClass:[ORKTextChoiceAnswerFormat class]]) {
+                class = [ORKChoiceViewCell class];
+            } else if ([answerFormat isKindOfClass:[ORKImageChoiceAnswerFormat class]]) {
+                class = [ORKFormItemImageSelectionCell class];
+            } else if ([answerFormat isKindOfClass:[ORKValuePickerAnswerFormat class]]) {
+                class = [ORKFormItemPickerCell class];
             }
+            break;
+        }
             
-            if (class) {
-                if ([class isSubclassOfClass:[ORKChoiceViewCell class]]) {
-                    NSAssert(NO, @"SHOULD NOT FALL IN HERE");
+        case ORKQuestionTypeDateAndTime:
+        case ORKQuestionTypeDate:
+        case ORKQuestionTypeTimeOfDay:
+        case ORKQuestionTypeTimeInterval:
+        case ORKQuestionTypeMultiplePicker:
+        case ORKQuestionTypeHeight: {
+            class = [ORKFormItemPickerCell class];
+            break;
+        }
+            
+        case ORKQuestionTypeDecimal:
+        case ORKQuestionTypeInteger: {
+            class = [ORKFormItemNumericCell class];
+            break;
+        }
+            
+        case ORKQuestionTypeText: {
+            if ([formItem.answerFormat isKindOfClass:[ORKConfirmTextAnswerFormat class]]) {
+                class = [ORKFormItemConfirmTextCell class];
+            } else {
+                ORKTextAnswerFormat *textFormat = (ORKTextAnswerFormat *)answerFormat;
+                if (!textFormat.multipleLines) {
+                    class = [ORKFormItemTextFieldCell class];
                 } else {
-                    ORKFormItemCell *formCell = nil;
-                    formCell = [[class alloc] initWithReuseIdentifier:identifier formItem:formItem answer:answer maxLabelWidth:section.maxLabelWidth delegate:self];
-                    [_formItemCells addObject:formCell];
-                    [formCell setExpectedLayoutWidth:self.tableView.bounds.size.width];
-                    formCell.selectionStyle = UITableViewCellSelectionStyleNone;
-                    formCell.defaultAnswer = _savedDefaults[formItem.identifier];
-                    if (!_savedAnswers) {
-                        _savedAnswers = [NSMutableDictionary new];
-                    }
-                    formCell.savedAnswers = _savedAnswers;
-                    cell = formCell;
+                    class = [ORKFormItemTextCell class];
                 }
             }
+            break;
+        }
+            
+        case ORKQuestionTypeScale: {
+            class = [ORKFormItemScaleCell class];
+            break;
+        }
+            
+        case ORKQuestionTypeLocation: {
+            class = [ORKFormItemLocationCell class];
+            break;
+        }
+            
+        default:
+            NSAssert(NO, @"SHOULD NOT FALL IN HERE %@ %@", @(type), answerFormat);
+            break;
+    }
+    return class;
+}
+
+/*
+ Cells are reused by cell class. Form item cells take their form item at initialization and cannot
+ be reconfigured, so each one is kept in `_formItemCells` until its section is replaced, and choice
+ cells are kept by their section's cell group.
+ */
+- (UITableViewCell *)tableView:(UITableView *)tableView cellForRowAtIndexPath:(NSIndexPath *)indexPath {
+    ORKTableSection *section = (ORKTableSection *)_sections[indexPath.section];
+    ORKTableCellItem *cellItem = [section items][indexPath.row];
+    ORKFormItem *formItem = cellItem.formItem;
+    id answer = _savedAnswers[formItem.identifier];
+    
+    Class class = [self cellClassForFormItem:formItem];
+    NSString *identifier = NSStringFromClass(class);
+    
+    UITableViewCell *cell = nil;
+    if (section.textChoiceCellGroup) {
+        [section.textChoiceCellGroup setAnswer:answer];
+        cell = [section.textChoiceCellGroup cellAtIndexPath:indexPath withReuseIdentifier:identifier];
+    } else if (class) {
+        ORKFormItemCell *formCell = _formItemCells[formItem.identifier];
+        if (formCell.formItem != formItem) {
+            formCell = [[class alloc] initWithReuseIdentifier:identifier formItem:formItem answer:answer maxLabelWidth:section.maxLabelWidth delegate:self];
+            _formItemCells[formItem.identifier] = formCell;
+            [formCell setExpectedLayoutWidth:self.tableView.bounds.size.width];
+            formCell.selectionStyle = UITableViewCellSelectionStyleNone;
+            formCell.defaultAnswer = _savedDefaults[formItem.identifier];
+            if (!_savedAnswers) {
+                _savedAnswers = [NSMutableDictionary new];
+            }
+            formCell.savedAnswers = _savedAnswers;
         }
+        cell = formCell;
     }
     cell.userInteractionEnabled = !self.readOnlyMode;
     return cell;
@@ -1016,13 +1192,15 @@ static NSString *const _ORKOriginalAnswersRestoreKey = @"originalAnswers";
     _savedSystemCalendars = [coder decodeObjectOfClass:[NSMutableDictionary class] forKey:_ORKSavedSystemCalendarsRestoreKey];
     _savedSystemTimeZones = [coder decodeObjectOfClass:[NSMutableDictionary class] forKey:_ORKSavedSystemTimeZonesRestoreKey];
     _originalAnswers = [coder decodeObjectOfClass:[NSMutableDictionary class] forKey:_ORKOriginalAnswersRestoreKey];
+    [self invalidateAnswerState];
+    [self updateButtonStates];
 }
 
 #pragma mark Rotate
 
 - (void)viewWillTransitionToSize:(CGSize)size withTransitionCoordinator:(id<UIViewControllerTransitionCoordinator>)coordinator {
     [super viewWillTransitionToSize:size withTransitionCoordinator:coordinator];
-    for (ORKFormItemCell *cell in _formItemCells) {
+    for (ORKFormItemCell *cell in _formItemCells.allValues) {
         [cell setExpectedLayoutWidth:size.width];
     }
 }
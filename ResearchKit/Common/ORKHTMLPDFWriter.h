@@ -36,6 +36,9 @@ NS_ASSUME_NONNULL_BEGIN
 
 @interface ORKHTMLPDFWriter : NSObject
 
+/// A4 when the current locale uses the metric system, US Letter otherwise.
++ (CGSize)defaultPageSize;
+
 - (void)writePDFFromHTML:(NSString *)html withCompletionBlock:(void (^)(NSData *data, NSError *error))completionBlock;
 
 @end
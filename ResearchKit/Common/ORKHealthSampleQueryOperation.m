@@ -34,16 +34,30 @@
 #import "ORKHelpers_Internal.h"
 #import "ORKCollector_Internal.h"
 #import "ORKDataCollectionManager_Internal.h"
+#import "ORKQueryPageSizer.h"
 
 
-static NSUInteger const QueryLimitSize = 1000;
+// Time allowed for HealthKit to answer a single query.
+static NSTimeInterval const QueryTimeout = 10;
+
+// Pages fetched but not yet handed to the delegate; the next query is not started beyond this.
+static NSUInteger const MaximumPendingPages = 2;
 
 @implementation ORKHealthSampleQueryOperation {
     // All of these are strong references created at init time
     ORKCollector<ORKHealthCollectable> *_collector;
     __weak ORKDataCollectionManager *_manager;
-    HKQueryAnchor *_currentAnchor;
-    dispatch_semaphore_t _sem;
+    dispatch_queue_t _deliveryQueue;
+    
+    // Everything below is guarded by self.lock.
+    HKSampleType *_sampleType;
+    NSDate *_startDate;
+    HKQueryAnchor *_nextAnchor;
+    NSUInteger _queryLimit;
+    CFAbsoluteTime _queryStartTime;
+    BOOL _queryInFlight;
+    BOOL _hasMoreResults;
+    NSUInteger _pendingPages;
 }
 
 
@@ -69,11 +83,10 @@ static NSUInteger const QueryLimitSize = 1000;
     if (self) {
         _collector = collector;
         _manager = manager;
-        _currentAnchor = nil;
-        _sem = dispatch_semaphore_create(0);
+        _deliveryQueue = dispatch_queue_create("ResearchKit.HealthSampleQuery.delivery", DISPATCH_QUEUE_SERIAL);
         
         self.startBlock = ^void(ORKOperation* operation) {
-            [(ORKHealthSampleQueryOperation*)operation doNextQuery];
+            [(ORKHealthSampleQueryOperation*)operation doFirstQuery];
         };
         
     }
@@ -89,43 +102,25 @@ static NSUInteger const QueryLimitSize = 1000;
     [self safeFinish];
 }
 
-- (void)doNextQuery {
+- (void)doFirstQuery {
     [self.lock lock];
     
     __block HKSampleType *sampleType = nil;
     __block NSDate *startDate = nil;
-    
     __block HKQueryAnchor *lastAnchor = nil;
-    __block NSString *itemIdentifier = nil;
     
     // Check if everything's valid and we should continue with collection
     __block BOOL shouldContinue = YES;
     
     [_manager onWorkQueueSync:^BOOL(ORKDataCollectionManager *manager) {
-        
         shouldContinue = [self _shouldContinue];
-        
-        BOOL changed = NO;
         if (shouldContinue) {
-            // _currentAnchor will be NSNotFound on the first pass of the operation
-            if (_currentAnchor != nil) {
-                changed = YES;
-                // Update the anchor if we have one
-                _collector.lastAnchor = [_currentAnchor copy];
-            }
-            
             lastAnchor = _collector.lastAnchor;
             sampleType = _collector.sampleType;
             startDate = _collector.startDate;
-            itemIdentifier = _collector.identifier;
         }
-        
-        return changed;
+        return NO;
     }];
-
-    if (_currentAnchor == nil) {
-        _currentAnchor = lastAnchor;
-    }
     
     if (!shouldContinue) {
         [self finishWithErrorCode:ORKErrorInvalidObject];
@@ -133,18 +128,42 @@ static NSUInteger const QueryLimitSize = 1000;
         return;
     }
     
+    _sampleType = sampleType;
+    _startDate = startDate;
+    _nextAnchor = lastAnchor;
+    _hasMoreResults = YES;
+    [self startNextQueryIfNeeded];
+    
+    [self.lock unlock];
+}
+
+/*
+ Starts the query for the page after the last one received, unless a query is already running,
+ all the results have been fetched, or too many pages are waiting for the delegate.
+ Must be called under the lock.
+ */
+- (void)startNextQueryIfNeeded {
+    if (![self isExecuting] || [self isCancelled] || _queryInFlight || !_hasMoreResults || _pendingPages >= MaximumPendingPages) {
+        return;
+    }
+    _queryInFlight = YES;
+    _queryLimit = _collector.pageSizer.limit;
+    _queryStartTime = CFAbsoluteTimeGetCurrent();
+    self.deadline = _queryStartTime + QueryTimeout;
+    
     __weak ORKHealthSampleQueryOperation * weakSelf = self;
     
     NSPredicate *predicate = nil;
-    if (startDate) {
-        predicate = [HKQuery predicateForSamplesWithStartDate:startDate endDate:nil options:HKQueryOptionStrictStartDate];
+    if (_startDate) {
+        predicate = [HKQuery predicateForSamplesWithStartDate:_startDate endDate:nil options:HKQueryOptionStrictStartDate];
     }
     
-    HKQueryAnchor *anchor = _currentAnchor;
+    HKSampleType *sampleType = _sampleType;
+    HKQueryAnchor *anchor = _nextAnchor;
     HKAnchoredObjectQuery *syncQuery = [[HKAnchoredObjectQuery alloc] initWithType:sampleType
                                                                          predicate:predicate
                                                                             anchor:anchor
-                                                                             limit:QueryLimitSize
+                                                                             limit:_queryLimit
                                                                     resultsHandler:^(HKAnchoredObjectQuery *query,
                                                                                      NSArray<__kindof HKSample *> *sampleObjects,
                                                                                      NSArray<HKDeletedObject *> *deletedObjects,
@@ -153,49 +172,28 @@ static NSUInteger const QueryLimitSize = 1000;
                                                                         
                                                                         ORKHealthSampleQueryOperation *op = weakSelf;
                                                                         ORK_Log_Debug(@"\nHK Query returned: %@\n", @{@"sampleType": sampleType, @"items":@([sampleObjects count]), @"newAnchor":[newAnchor description]?:@"nil"});
-                                                                        // Signal that query returned
-                                                                        dispatch_semaphore_signal(_sem);
-                                                                        [op handleResults:sampleObjects newAnchor:newAnchor error:error itemIdentifier:itemIdentifier];
+                                                                        [op handleResults:sampleObjects newAnchor:newAnchor error:error];
                                                                  }];
 
     
-    ORK_Log_Debug(@"\nHK Query: %@ \n", @{@"identifier": sampleType.identifier, @"anchor": anchor.description ? :@"", @"startDate": [NSDateFormatter localizedStringFromDate:startDate dateStyle:NSDateFormatterShortStyle timeStyle:NSDateFormatterShortStyle]});
+    ORK_Log_Debug(@"\nHK Query: %@ \n", @{@"identifier": sampleType.identifier, @"anchor": anchor.description ? :@"", @"limit": @(_queryLimit), @"startDate": [NSDateFormatter localizedStringFromDate:_startDate dateStyle:NSDateFormatterShortStyle timeStyle:NSDateFormatterShortStyle]});
     [_manager.healthStore executeQuery:syncQuery];
-    
-    [self.lock unlock];
-    
-    dispatch_time_t timeout = dispatch_time(DISPATCH_TIME_NOW, (int64_t)(10 * NSEC_PER_SEC));
-    
-    dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_HIGH, 0), ^{
-        if (dispatch_semaphore_wait(_sem, timeout)) {
-            [self timeoutForAnchor:anchor];
-        }
-    });
-    
-}
-
-- (void)timeoutForAnchor:(HKQueryAnchor *)anchor {
-    ORK_Log_Debug(@"Query timeout: cancel operation %@", self);
-    [self.lock lock];
-    
-    if ([self isExecuting] && ![self isCancelled] && [anchor isEqual:_currentAnchor]) {
-        self.error = [NSError errorWithDomain:ORKErrorDomain code:ORKErrorException userInfo:@{NSLocalizedDescriptionKey:@"Query timeout"}];
-        [self safeFinish];
-    }
-    
-    [self.lock unlock];
 }
 
 /*
- Handles the result of an HKAnchoredObjectQuery, and starts a new query if needed
+ Handles the result of an HKAnchoredObjectQuery. The next page is requested right away, so that
+ HealthKit fetches it while the delegate processes this one; pages are handed to the delegate in
+ order on the delivery queue.
  */
 - (void)handleResults:(NSArray<HKSample *> *)results
             newAnchor:(HKQueryAnchor *)newAnchor
-                error:(NSError *)error
-       itemIdentifier:(NSString *)itemIdentifier {
+                error:(NSError *)error {
     [self.lock lock];
     // Check our actual state under the lock
     
+    _queryInFlight = NO;
+    self.deadline = 0;
+    
     if (![self isExecuting] || [self isCancelled]) {
         // Give up immediately if we've been cancelled or are no longer executing
         [self.lock unlock];
@@ -209,39 +207,86 @@ static NSUInteger const QueryLimitSize = 1000;
         return;
     }
     
+    if (results.count > 0) {
+        // A short page means HealthKit had nothing more when it ran the query.
+        NSUInteger limit = _queryLimit;
+        NSTimeInterval queryDuration = CFAbsoluteTimeGetCurrent() - _queryStartTime;
+        _hasMoreResults = (results.count >= limit);
+        _nextAnchor = newAnchor;
+        _pendingPages++;
+        dispatch_async(_deliveryQueue, ^{
+            [self deliverResults:results anchor:newAnchor limit:limit queryDuration:queryDuration];
+        });
+    } else {
+        _hasMoreResults = NO;
+    }
+    
+    [self startNextQueryIfNeeded];
+    [self finishAfterDeliveriesIfDone];
+    
     [self.lock unlock];
+}
+
+// Must be called under the lock.
+- (void)finishAfterDeliveriesIfDone {
+    if (!_hasMoreResults && !_queryInFlight) {
+        dispatch_async(_deliveryQueue, ^{
+            [self safeFinish];
+        });
+    }
+}
+
+// Runs on the delivery queue. The page's query and delivery times feed the collector's page sizer.
+- (void)deliverResults:(NSArray<HKSample *> *)results anchor:(HKQueryAnchor *)anchor limit:(NSUInteger)limit queryDuration:(NSTimeInterval)queryDuration {
+    if (![self isExecuting] || [self isCancelled]) {
+        return;
+    }
     
-    BOOL doContinue = (results && [results count] > 0);
-    if (doContinue) {        
-        id<ORKDataCollectionManagerDelegate> delegate = _manager.delegate;
-        
-        BOOL handoutSuccess = NO;
-        
-        if (delegate) {
-            if ([_collector isKindOfClass:[ORKHealthCollector class]]
-                && [delegate respondsToSelector:@selector(healthCollector:didCollectSamples:)]) {
-                handoutSuccess = [delegate healthCollector:(ORKHealthCollector *)_collector didCollectSamples:results];
-            } else if ([_collector isKindOfClass:[ORKHealthCorrelationCollector class]]
-                       && [delegate respondsToSelector:@selector(healthCorrelationCollector:didCollectCorrelations:)]) {
-                handoutSuccess = [delegate healthCorrelationCollector:(ORKHealthCorrelationCollector *)_collector didCollectCorrelations:(NSArray<HKCorrelation *> *)results];
-            }
-        }
-        
-        if (!handoutSuccess) {
-            doContinue = NO;
-            self.error = [NSError errorWithDomain:ORKErrorDomain code:ORKErrorException userInfo:@{NSLocalizedFailureReasonErrorKey: @"Results were not properly delivered to the data collection manager delegate."}];
+    CFAbsoluteTime deliveryStartTime = CFAbsoluteTimeGetCurrent();
+    id<ORKDataCollectionManagerDelegate> delegate = _manager.delegate;
+    
+    BOOL handoutSuccess = NO;
+    
+    if (delegate) {
+        if ([_collector isKindOfClass:[ORKHealthCollector class]]
+            && [delegate respondsToSelector:@selector(healthCollector:didCollectSamples:)]) {
+            handoutSuccess = [delegate healthCollector:(ORKHealthCollector *)_collector didCollectSamples:results];
+        } else if ([_collector isKindOfClass:[ORKHealthCorrelationCollector class]]
+                   && [delegate respondsToSelector:@selector(healthCorrelationCollector:didCollectCorrelations:)]) {
+            handoutSuccess = [delegate healthCorrelationCollector:(ORKHealthCorrelationCollector *)_collector didCollectCorrelations:(NSArray<HKCorrelation *> *)results];
         }
     }
     
-    if (doContinue) {
-        // Do the next fetch
-        self->_currentAnchor = newAnchor;
-        [self doNextQuery];
-
-    } else {
+    [_collector.pageSizer recordPageWithCount:results.count
+                                        limit:limit
+                                queryDuration:queryDuration
+                           processingDuration:CFAbsoluteTimeGetCurrent() - deliveryStartTime];
+    
+    __block BOOL shouldContinue = NO;
+    if (handoutSuccess) {
+        // Only advance the stored anchor once the delegate has accepted the page.
+        [_manager onWorkQueueSync:^BOOL(ORKDataCollectionManager *manager) {
+            shouldContinue = [self _shouldContinue];
+            if (shouldContinue) {
+                _collector.lastAnchor = [anchor copy];
+                [manager persistProgressOfCollector:_collector];
+            }
+            return NO;
+        }];
+    }
+    
+    [self.lock lock];
+    _pendingPages--;
+    if (!handoutSuccess) {
         // Stop for now (even if maybe we haven't fetched all the records)
+        self.error = [NSError errorWithDomain:ORKErrorDomain code:ORKErrorException userInfo:@{NSLocalizedFailureReasonErrorKey: @"Results were not properly delivered to the data collection manager delegate."}];
         [self safeFinish];
+    } else if (!shouldContinue) {
+        [self finishWithErrorCode:ORKErrorInvalidObject];
+    } else {
+        [self startNextQueryIfNeeded];
     }
+    [self.lock unlock];
 }
 
 @end
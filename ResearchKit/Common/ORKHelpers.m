@@ -30,6 +30,7 @@
 
 
 #import "ORKHelpers_Internal.h"
+#import "ORKISO8601DateCodec.h"
 
 #import "ORKStep.h"
 
@@ -89,26 +90,47 @@ id findInArrayByKey(NSArray * array, NSString *key, id value) {
     return nil;
 }
 
-NSString *ORKStringFromDateISO8601(NSDate *date) {
-    static NSDateFormatter *formatter = nil;
-    static dispatch_once_t onceToken;
-    dispatch_once(&onceToken, ^{
+// Formatter for the dates outside the range of the ISO 8601 codec. Formatters are kept per thread,
+// since they are not safe to share between threads.
+static NSDateFormatter *ORKISO8601FallbackFormatter() {
+    static NSString *const ThreadDictionaryKey = @"org.researchkit.iso8601formatter";
+    NSMutableDictionary *threadDictionary = [NSThread currentThread].threadDictionary;
+    NSDateFormatter *formatter = threadDictionary[ThreadDictionaryKey];
+    if (!formatter) {
         formatter = [[NSDateFormatter alloc] init];
         [formatter setDateFormat:@"yyyy-MM-dd'T'HH:mm:ssZ"];
         [formatter setLocale:[NSLocale localeWithLocaleIdentifier:@"en_US_POSIX"]];
-    });
-    return [formatter stringFromDate:date];
+        threadDictionary[ThreadDictionaryKey] = formatter;
+    }
+    return formatter;
+}
+
+NSString *ORKStringFromDateISO8601(NSDate *date) {
+    if (!date) {
+        return nil;
+    }
+    char buffer[ORKISO8601DateLength + 1];
+    size_t length = ORKISO8601FormatDate(date, buffer);
+    if (length == 0) {
+        return [ORKISO8601FallbackFormatter() stringFromDate:date];
+    }
+    return [[NSString alloc] initWithBytes:buffer length:length encoding:NSASCIIStringEncoding];
 }
 
 NSDate *ORKDateFromStringISO8601(NSString *string) {
-    static NSDateFormatter *formatter = nil;
-    static dispatch_once_t onceToken;
-    dispatch_once(&onceToken, ^{
-        formatter = [[NSDateFormatter alloc] init];
-        [formatter setDateFormat:@"yyyy-MM-dd'T'HH:mm:ssZ"];
-        [formatter setLocale:[NSLocale localeWithLocaleIdentifier:@"en_US_POSIX"]];
-    });
-    return [formatter dateFromString:string];
+    if (!string) {
+        return nil;
+    }
+    char buffer[32];
+    NSUInteger length = 0;
+    if ([string getBytes:buffer maxLength:sizeof(buffer) usedLength:&length encoding:NSASCIIStringEncoding options:0 range:NSMakeRange(0, string.length) remainingRange:NULL]
+        && length == string.length) {
+        NSDate *date = ORKISO8601ParseDate(buffer, length);
+        if (date) {
+            return date;
+        }
+    }
+    return [ORKISO8601FallbackFormatter() dateFromString:string];
 }
 
 NSString *ORKSignatureStringFromDate(NSDate *date) {
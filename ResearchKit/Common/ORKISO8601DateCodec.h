@@ -0,0 +1,67 @@
+/*
+ Copyright (c) 2016, Apple Inc. All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+ 
+ 1.  Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ 2.  Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation and/or
+ other materials provided with the distribution.
+ 
+ 3.  Neither the name of the copyright holder(s) nor the names of any contributors
+ may be used to endorse or promote products derived from this software without
+ specific prior written permission. No license is granted to the trademarks of
+ the copyright holders even if such marks are included in this software.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+
+
+@import Foundation;
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*
+ Encoder and decoder for the fixed `yyyy-MM-dd'T'HH:mm:ssZ` format used throughout ResearchKit
+ output, such as `2016-05-04T10:11:12-0700`.
+
+ Dates are converted with calendar arithmetic rather than `NSDateFormatter`, in the default time
+ zone. Each thread caches the UTC offset of the default time zone until its next transition, so
+ the common case of many nearby dates only looks the offset up once. The functions are
+ thread-safe, and match `NSDateFormatter` with the `en_US_POSIX` locale.
+ */
+
+// Length of a formatted date, without the terminating NUL.
+#define ORKISO8601DateLength 24
+
+/*
+ Formats `date` into `buffer`, which must hold `ORKISO8601DateLength + 1` characters, NUL-terminated.
+
+ Returns the number of characters written (`ORKISO8601DateLength`), or 0 if the year of the date
+ does not fit in four digits.
+ */
+size_t ORKISO8601FormatDate(NSDate *date, char *buffer);
+
+/*
+ Parses a date in the format above. The time zone can also be given as `Z`, `+hh`, or `+hh:mm`.
+
+ Returns `nil` if the characters are not in this format.
+ */
+NSDate *_Nullable ORKISO8601ParseDate(const char *characters, size_t length);
+
+NS_ASSUME_NONNULL_END
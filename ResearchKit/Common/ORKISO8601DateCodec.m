@@ -0,0 +1,227 @@
+/*
+ Copyright (c) 2016, Apple Inc. All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+ 
+ 1.  Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ 2.  Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation and/or
+ other materials provided with the distribution.
+ 
+ 3.  Neither the name of the copyright holder(s) nor the names of any contributors
+ may be used to endorse or promote products derived from this software without
+ specific prior written permission. No license is granted to the trademarks of
+ the copyright holders even if such marks are included in this software.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+
+
+#import "ORKISO8601DateCodec.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+
+
+typedef struct {
+    // Retained, so a different zone cannot be allocated at the same address while it is cached.
+    const void *timeZone;
+    uint64_t generation;
+    NSTimeInterval validFrom;
+    NSTimeInterval validUntil;
+    NSInteger offset;
+} ORKISO8601OffsetCache;
+
+static __thread ORKISO8601OffsetCache ORKISO8601ThreadOffsetCache;
+
+// Bumped when the system time zone changes, invalidating every thread's cache.
+static _Atomic(uint64_t) ORKISO8601TimeZoneGeneration = 1;
+
+// Holds the same zone as the thread's cache, releasing it when the thread exits.
+static pthread_key_t ORKISO8601TimeZoneKey;
+
+static void ORKISO8601ReleaseTimeZone(void *timeZone) {
+    CFRelease(timeZone);
+}
+
+static NSInteger ORKISO8601OffsetForTime(NSTimeInterval time) {
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        pthread_key_create(&ORKISO8601TimeZoneKey, ORKISO8601ReleaseTimeZone);
+        [[NSNotificationCenter defaultCenter] addObserverForName:NSSystemTimeZoneDidChangeNotification
+                                                          object:nil
+                                                           queue:nil
+                                                      usingBlock:^(NSNotification *note) {
+                                                          atomic_fetch_add(&ORKISO8601TimeZoneGeneration, 1);
+                                                      }];
+    });
+    
+    NSTimeZone *timeZone = [NSTimeZone defaultTimeZone];
+    uint64_t generation = atomic_load(&ORKISO8601TimeZoneGeneration);
+    ORKISO8601OffsetCache *cache = &ORKISO8601ThreadOffsetCache;
+    if (cache->timeZone == (__bridge const void *)timeZone && cache->generation == generation
+        && time >= cache->validFrom && time < cache->validUntil) {
+        return cache->offset;
+    }
+    
+    NSDate *date = [NSDate dateWithTimeIntervalSince1970:time];
+    NSDate *nextTransition = [timeZone nextDaylightSavingTimeTransitionAfterDate:date];
+    if (cache->timeZone != (__bridge const void *)timeZone) {
+        const void *previousTimeZone = cache->timeZone;
+        cache->timeZone = CFBridgingRetain(timeZone);
+        pthread_setspecific(ORKISO8601TimeZoneKey, cache->timeZone);
+        if (previousTimeZone) {
+            CFRelease(previousTimeZone);
+        }
+    }
+    cache->generation = generation;
+    cache->offset = [timeZone secondsFromGMTForDate:date];
+    cache->validFrom = time;
+    cache->validUntil = nextTransition ? nextTransition.timeIntervalSince1970 : DBL_MAX;
+    return cache->offset;
+}
+
+// Days since 1970-01-01 to a proleptic Gregorian civil date, and back.
+static void ORKCivilFromDays(long long days, long long *year, unsigned *month, unsigned *day) {
+    days += 719468;
+    long long era = (days >= 0 ? days : days - 146096) / 146097;
+    unsigned dayOfEra = (unsigned)(days - era * 146097);
+    unsigned yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    unsigned dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    unsigned monthPrime = (5 * dayOfYear + 2) / 153;
+    *day = dayOfYear - (153 * monthPrime + 2) / 5 + 1;
+    *month = monthPrime < 10 ? monthPrime + 3 : monthPrime - 9;
+    *year = (long long)yearOfEra + era * 400 + (*month <= 2);
+}
+
+static long long ORKDaysFromCivil(long long year, unsigned month, unsigned day) {
+    year -= (month <= 2);
+    long long era = (year >= 0 ? year : year - 399) / 400;
+    unsigned yearOfEra = (unsigned)(year - era * 400);
+    unsigned dayOfYear = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    unsigned dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + (long long)dayOfEra - 719468;
+}
+
+static inline void ORKWriteDigits(char *buffer, long long value, int count) {
+    for (int i = count - 1; i >= 0; i--) {
+        buffer[i] = '0' + (value % 10);
+        value /= 10;
+    }
+}
+
+size_t ORKISO8601FormatDate(NSDate *date, char *buffer) {
+    // Like NSDateFormatter, drop any fraction of a second.
+    NSTimeInterval time = floor(date.timeIntervalSince1970);
+    NSInteger offset = ORKISO8601OffsetForTime(time);
+    long long seconds = (long long)time + offset;
+    long long days = (seconds >= 0 ? seconds : seconds - 86399) / 86400;
+    long long secondOfDay = seconds - days * 86400;
+    
+    long long year;
+    unsigned month, day;
+    ORKCivilFromDays(days, &year, &month, &day);
+    if (year < 0 || year > 9999) {
+        return 0;
+    }
+    
+    NSInteger absoluteOffset = offset < 0 ? -offset : offset;
+    ORKWriteDigits(buffer, year, 4);
+    buffer[4] = '-';
+    ORKWriteDigits(buffer + 5, month, 2);
+    buffer[7] = '-';
+    ORKWriteDigits(buffer + 8, day, 2);
+    buffer[10] = 'T';
+    ORKWriteDigits(buffer + 11, secondOfDay / 3600, 2);
+    buffer[13] = ':';
+    ORKWriteDigits(buffer + 14, (secondOfDay / 60) % 60, 2);
+    buffer[16] = ':';
+    ORKWriteDigits(buffer + 17, secondOfDay % 60, 2);
+    buffer[19] = (offset < 0) ? '-' : '+';
+    ORKWriteDigits(buffer + 20, absoluteOffset / 3600, 2);
+    ORKWriteDigits(buffer + 22, (absoluteOffset / 60) % 60, 2);
+    buffer[ORKISO8601DateLength] = '\0';
+    return ORKISO8601DateLength;
+}
+
+static BOOL ORKReadDigits(const char *characters, int count, unsigned *value) {
+    unsigned result = 0;
+    for (int i = 0; i < count; i++) {
+        char c = characters[i];
+        if (c < '0' || c > '9') {
+            return NO;
+        }
+        result = result * 10 + (unsigned)(c - '0');
+    }
+    *value = result;
+    return YES;
+}
+
+NSDate *ORKISO8601ParseDate(const char *characters, size_t length) {
+    static const unsigned DaysInMonth[] = { 31, 29, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+    
+    unsigned year, month, day, hour, minute, second;
+    if (length < 20
+        || !ORKReadDigits(characters, 4, &year) || characters[4] != '-'
+        || !ORKReadDigits(characters + 5, 2, &month) || characters[7] != '-'
+        || !ORKReadDigits(characters + 8, 2, &day) || characters[10] != 'T'
+        || !ORKReadDigits(characters + 11, 2, &hour) || characters[13] != ':'
+        || !ORKReadDigits(characters + 14, 2, &minute) || characters[16] != ':'
+        || !ORKReadDigits(characters + 17, 2, &second)) {
+        return nil;
+    }
+    BOOL leapYear = (year % 4 == 0) && (year % 100 != 0 || year % 400 == 0);
+    if (month < 1 || month > 12 || day < 1 || day > DaysInMonth[month - 1] || (month == 2 && day == 29 && !leapYear)
+        || hour > 23 || minute > 59 || second > 59) {
+        return nil;
+    }
+    
+    const char *zone = characters + 19;
+    size_t zoneLength = length - 19;
+    long long offset = 0;
+    if (zoneLength == 1 && zone[0] == 'Z') {
+        offset = 0;
+    } else if (zoneLength >= 3 && (zone[0] == '+' || zone[0] == '-')) {
+        unsigned offsetHours, offsetMinutes = 0;
+        if (!ORKReadDigits(zone + 1, 2, &offsetHours)) {
+            return nil;
+        }
+        if (zoneLength == 5) {
+            if (!ORKReadDigits(zone + 3, 2, &offsetMinutes)) {
+                return nil;
+            }
+        } else if (zoneLength == 6) {
+            if (zone[3] != ':' || !ORKReadDigits(zone + 4, 2, &offsetMinutes)) {
+                return nil;
+            }
+        } else if (zoneLength != 3) {
+            return nil;
+        }
+        if (offsetHours > 23 || offsetMinutes > 59) {
+            return nil;
+        }
+        offset = (long long)offsetHours * 3600 + offsetMinutes * 60;
+        if (zone[0] == '-') {
+            offset = -offset;
+        }
+    } else {
+        return nil;
+    }
+    
+    long long seconds = ORKDaysFromCivil(year, month, day) * 86400 + hour * 3600 + minute * 60 + second - offset;
+    return [NSDate dateWithTimeIntervalSince1970:(NSTimeInterval)seconds];
+}
@@ -42,6 +42,7 @@
 #import "ORKHelpers_Internal.h"
 
 @import AVFoundation;
+@import ImageIO;
 
 
 @interface ORKImageCaptureStepViewController () <ORKImageCaptureViewDelegate>
@@ -56,6 +57,13 @@
     AVCaptureStillImageOutput *_stillImageOutput;
     NSData *_capturedImageData;
     NSURL *_fileURL;
+    
+    // Captured data is written, and old files removed, in order on this queue. Work that finishes
+    // after the data it was started for has been replaced is ignored, by comparing generations.
+    dispatch_queue_t _persistenceQueue;
+    dispatch_group_t _persistenceGroup;
+    NSUInteger _captureGeneration;
+    CGFloat _previewMaxPixelSize;
 }
 
 - (instancetype)initWithStep:(ORKStep *)step result:(ORKResult *)result {
@@ -67,9 +75,11 @@
             ORKFileResult *fileResult = ORKDynamicCast([stepResult results].firstObject, ORKFileResult);
 
             if (fileResult.fileURL) {
-                // Setting these properties in this order allows us to reuse the existing file on disk
-                self.capturedImageData = [NSData dataWithContentsOfURL:fileResult.fileURL];
-                _fileURL = fileResult.fileURL;
+                // Reuse the existing file on disk rather than writing it again
+                NSData *data = [NSData dataWithContentsOfURL:fileResult.fileURL];
+                [self setCapturedImageData:data
+                              previewImage:[[self class] previewImageWithData:data maxPixelSize:_previewMaxPixelSize]
+                                   fileURL:fileResult.fileURL];
             }
         }
     }
@@ -80,6 +90,11 @@
     self = [super initWithStep:step];
     if (self) {
         NSParameterAssert([step isKindOfClass:[ORKImageCaptureStep class]]);
+        _persistenceQueue = dispatch_queue_create("org.researchkit.imagecapture.persistence", DISPATCH_QUEUE_SERIAL);
+        _persistenceGroup = dispatch_group_create();
+        // The preview only needs to fill the screen, so it is decoded at that size rather than in full
+        CGSize screenSize = [UIScreen mainScreen].bounds.size;
+        _previewMaxPixelSize = MAX(screenSize.width, screenSize.height) * [UIScreen mainScreen].scale;
         _imageCaptureView = [[ORKImageCaptureView alloc] initWithFrame:CGRectZero];
         _imageCaptureView.imageCaptureStep = (ORKImageCaptureStep *)step;
         _imageCaptureView.delegate = self;
@@ -145,15 +160,17 @@
 - (void)queue_CaptureImageFromData:(CMSampleBufferRef)imageDataSampleBuffer handler:(void (^)(BOOL))handler {
     // Capture the JPEG image data, if available
     NSData *capturedImageData = !imageDataSampleBuffer ? nil : [AVCaptureStillImageOutput jpegStillImageNSDataRepresentation:imageDataSampleBuffer];
-    // If something was captured, stop the capture session
+    // If something was captured, stop the capture session, and decode the preview while still off the main queue
+    UIImage *previewImage = nil;
     if (capturedImageData) {
         [_captureSession stopRunning];
+        previewImage = [[self class] previewImageWithData:capturedImageData maxPixelSize:_previewMaxPixelSize];
     }
     
     // Use the main queue, as UI components may need to be updated
     dispatch_async(dispatch_get_main_queue(), ^{
         // Set this, even if there was an error and we got a nil buffer
-        self.capturedImageData = capturedImageData;
+        [self setCapturedImageData:capturedImageData previewImage:previewImage fileURL:nil];
         if (handler) {
             handler(capturedImageData != nil);
         }
@@ -247,26 +264,89 @@
     _imageCaptureView.capturedImage = nil;
     _capturedImageData = nil;
     _fileURL = nil;
+    _captureGeneration++;
     
     // Show the error in the image capture view
     _imageCaptureView.error = error;
 }
 
 - (void)setCapturedImageData:(NSData *)capturedImageData {
-    _capturedImageData = capturedImageData;
-    _imageCaptureView.capturedImage = capturedImageData ? [UIImage imageWithData:capturedImageData] : nil;
+    [self setCapturedImageData:capturedImageData
+                  previewImage:[[self class] previewImageWithData:capturedImageData maxPixelSize:_previewMaxPixelSize]
+                       fileURL:nil];
+}
+
+// Pass a file URL when the data is already on disk there; otherwise the data is written out in the
+// background, once the output directory is known.
+- (void)setCapturedImageData:(NSData *)capturedImageData previewImage:(UIImage *)previewImage fileURL:(NSURL *)fileURL {
+    _captureGeneration++;
     
     // Remove the old file, if it exists, now that new data was acquired or reset
-    if (_fileURL) {
-        [[NSFileManager defaultManager] removeItemAtURL:_fileURL error:nil];
-        // Force the file to be rewritten the next time the result is requested
-        _fileURL = nil;
+    if (_fileURL && ![_fileURL isEqual:fileURL]) {
+        NSURL *oldFileURL = _fileURL;
+        dispatch_group_async(_persistenceGroup, _persistenceQueue, ^{
+            [[NSFileManager defaultManager] removeItemAtURL:oldFileURL error:nil];
+        });
+    }
+    _fileURL = fileURL;
+    _capturedImageData = capturedImageData;
+    _imageCaptureView.capturedImage = previewImage;
+    
+    if (_capturedImageData && !_fileURL && self.outputDirectory) {
+        [self persistCapturedData];
     }
     
     [self notifyDelegateOnResultChange];
 }
 
-- (NSURL *)writeCapturedDataWithError:(NSError **)error {
++ (UIImage *)previewImageWithData:(NSData *)data maxPixelSize:(CGFloat)maxPixelSize {
+    if (!data) {
+        return nil;
+    }
+    
+    UIImage *previewImage = nil;
+    CGImageSourceRef imageSource = CGImageSourceCreateWithData((__bridge CFDataRef)data, NULL);
+    if (imageSource) {
+        NSDictionary *options = @{ (id)kCGImageSourceCreateThumbnailFromImageAlways: @YES,
+                                   (id)kCGImageSourceCreateThumbnailWithTransform: @YES,
+                                   (id)kCGImageSourceThumbnailMaxPixelSize: @(maxPixelSize) };
+        CGImageRef thumbnail = CGImageSourceCreateThumbnailAtIndex(imageSource, 0, (__bridge CFDictionaryRef)options);
+        if (thumbnail) {
+            previewImage = [UIImage imageWithCGImage:thumbnail];
+            CGImageRelease(thumbnail);
+        }
+        CFRelease(imageSource);
+    }
+    return previewImage;
+}
+
+- (void)persistCapturedData {
+    NSError *error = nil;
+    NSURL *URL = [self captureFileURLWithError:&error];
+    if (!URL) {
+        [self handleError:error];
+        return;
+    }
+    
+    // Hand out the URL now; the file is in place before the step moves on (see -goForward)
+    _fileURL = URL;
+    NSData *data = _capturedImageData;
+    NSUInteger generation = _captureGeneration;
+    ORKWeakTypeOf(self) weakSelf = self;
+    dispatch_group_async(_persistenceGroup, _persistenceQueue, ^{
+        NSError *writeError = nil;
+        if (![ORKImageCaptureStepViewController writeCapturedData:data toURL:URL error:&writeError]) {
+            dispatch_async(dispatch_get_main_queue(), ^{
+                ORKStrongTypeOf(self) strongSelf = weakSelf;
+                if (strongSelf && generation == strongSelf->_captureGeneration) {
+                    [strongSelf handleError:writeError];
+                }
+            });
+        }
+    });
+}
+
+- (NSURL *)captureFileURLWithError:(NSError **)error {
     NSURL *URL = [self.outputDirectory URLByAppendingPathComponent:[NSString stringWithFormat:@"%@.jpg",self.step.identifier]];
     // Confirm the outputDirectory was set properly
     if (!URL) {
@@ -275,34 +355,51 @@
         }
         return nil;
     }
-    
+    return URL;
+}
+
++ (BOOL)writeCapturedData:(NSData *)data toURL:(NSURL *)URL error:(NSError **)error {
     // If set properly, the outputDirectory is already created, so write the file into it
     NSError *writeError = nil;
-    if (![_capturedImageData writeToURL:URL options:NSDataWritingAtomic|NSDataWritingFileProtectionCompleteUnlessOpen error:&writeError]) {
+    if (![data writeToURL:URL options:NSDataWritingAtomic|NSDataWritingFileProtectionCompleteUnlessOpen error:&writeError]) {
         if (writeError) {
             ORK_Log_Warning(@"%@", writeError);
         }
         if (error) {
             *error = [NSError errorWithDomain:NSCocoaErrorDomain code:NSFileWriteInvalidFileNameError userInfo:@{NSLocalizedDescriptionKey:ORKLocalizedString(@"CAPTURE_ERROR_CANNOT_WRITE_FILE", nil)}];
         }
-        return nil;
+        return NO;
+    }
+    return YES;
+}
+
+- (void)setOutputDirectory:(NSURL *)outputDirectory {
+    [super setOutputDirectory:outputDirectory];
+    
+    // Write out a capture made before the directory was known
+    if (_capturedImageData && !_fileURL && outputDirectory) {
+        [self persistCapturedData];
+    }
+}
+
+- (void)goForward {
+    // A capture still waiting for an output directory cannot be saved; this reports the error
+    if (_capturedImageData && !_fileURL) {
+        [self persistCapturedData];
     }
     
-    return URL;
+    // Let any pending write land before the result is handed on
+    dispatch_group_notify(_persistenceGroup, dispatch_get_main_queue(), ^{
+        [super goForward];
+    });
 }
 
 - (ORKStepResult *)result {
     ORKStepResult *stepResult = [super result];
     NSDate *now = stepResult.endDate;
     
-    // If we have captured data, but have not yet written that data to a file, do it now
-    if (!_fileURL && _capturedImageData) {
-        NSError *error = nil;
-        _fileURL = [self writeCapturedDataWithError:&error];
-        if (error) {
-            [self handleError:error];
-        }
-    }
+    // Captured data is written as soon as the output directory is known, so the URL is returned
+    // without waiting. Until then, the file result has no URL.
     
     NSMutableArray *results = [NSMutableArray arrayWithArray:stepResult.results];
     ORKFileResult *fileResult = [[ORKFileResult alloc] initWithIdentifier:self.step.identifier];
@@ -0,0 +1,102 @@
+/*
+ Copyright (c) 2016, Apple Inc. All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+ 
+ 1.  Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ 2.  Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation and/or
+ other materials provided with the distribution.
+ 
+ 3.  Neither the name of the copyright holder(s) nor the names of any contributors
+ may be used to endorse or promote products derived from this software without
+ specific prior written permission. No license is granted to the trademarks of
+ the copyright holders even if such marks are included in this software.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+
+
+@import Foundation;
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ The `ORKJSONStreamWriter` class writes compact UTF-8 JSON incrementally, without building
+ intermediate dictionaries or strings.
+
+ Output is collected in a buffer which, for a writer with an output stream, is written out
+ whenever it grows past a fixed size. Consecutive values written at the top level are separated
+ by commas, so a writer can also produce the elements of an array whose brackets are written
+ separately.
+
+ Writing a value that cannot be represented in JSON (for example, a non-finite number) records
+ an error and stops output; the error is returned by `finishWithError:`.
+
+ A writer is not thread-safe.
+ */
+@interface ORKJSONStreamWriter : NSObject
+
+/// Returns a writer that collects its output in `data`.
+- (instancetype)init;
+
+/// Returns a writer that appends its output to `data`.
+- (instancetype)initWithMutableData:(NSMutableData *)data;
+
+/// Returns a writer that writes its output to an open output stream.
+- (instancetype)initWithOutputStream:(NSOutputStream *)outputStream;
+
+/// The output not yet written to the output stream; for a writer without one, the whole output.
+@property (nonatomic, readonly) NSData *data;
+
+- (void)beginObject;
+- (void)endObject;
+- (void)beginArray;
+- (void)endArray;
+
+/// Writes a key inside an object. It must be followed by exactly one value.
+- (void)writeKey:(NSString *)key;
+
+- (void)writeString:(NSString *)string;
+- (void)writeInteger:(long long)value;
+- (void)writeDouble:(double)value;
+- (void)writeBool:(BOOL)value;
+- (void)writeNull;
+
+/// Writes a date as an ISO 8601 string in the default time zone, in the format of `ORKStringFromDateISO8601`.
+- (void)writeDate:(NSDate *)date;
+
+/**
+ Writes a property list made of `NSDictionary` (with string keys), `NSArray`, `NSString`,
+ `NSNumber`, `NSNull`, and `NSDate` objects; dates are written as with `writeDate:`, and
+ `NSDecimalNumber` objects are written in full, as `NSJSONSerialization` writes them.
+
+ @return `YES` if the object could be written.
+ */
+- (BOOL)writeJSONObject:(id)object;
+
+/**
+ Writes any buffered output to the output stream.
+
+ @return `YES` if all of the output so far was written without error.
+ */
+- (BOOL)finishWithError:(NSError * _Nullable *)error;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,430 @@
+/*
+ Copyright (c) 2016, Apple Inc. All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+ 
+ 1.  Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ 2.  Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation and/or
+ other materials provided with the distribution.
+ 
+ 3.  Neither the name of the copyright holder(s) nor the names of any contributors
+ may be used to endorse or promote products derived from this software without
+ specific prior written permission. No license is granted to the trademarks of
+ the copyright holders even if such marks are included in this software.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+
+
+#import "ORKJSONStreamWriter.h"
+
+#import "ORKErrors.h"
+#import "ORKHelpers_Internal.h"
+#import "ORKISO8601DateCodec.h"
+
+
+// Buffered output is written to the output stream once it grows past this size.
+static const NSUInteger ORKJSONStreamWriterFlushSize = 64 * 1024;
+
+static const NSUInteger ORKJSONStreamWriterMaximumDepth = 64;
+
+typedef NS_ENUM(uint8_t, ORKJSONStreamWriterContainer) {
+    ORKJSONStreamWriterContainerObject,
+    ORKJSONStreamWriterContainerArray
+};
+
+static const char ORKJSONHexDigits[] = "0123456789abcdef";
+
+@implementation ORKJSONStreamWriter {
+    NSMutableData *_buffer;
+    NSOutputStream *_outputStream;
+    NSError *_error;
+    
+    // _containers[0] stands for the top level, which behaves like an array without brackets.
+    ORKJSONStreamWriterContainer _containers[ORKJSONStreamWriterMaximumDepth + 1];
+    BOOL _hasValue[ORKJSONStreamWriterMaximumDepth + 1];
+    NSUInteger _depth;
+    BOOL _afterKey;
+}
+
+- (instancetype)init {
+    return [self initWithMutableData:[NSMutableData data]];
+}
+
+- (instancetype)initWithMutableData:(NSMutableData *)data {
+    self = [super init];
+    if (self) {
+        _buffer = data;
+        _containers[0] = ORKJSONStreamWriterContainerArray;
+    }
+    return self;
+}
+
+- (instancetype)initWithOutputStream:(NSOutputStream *)outputStream {
+    self = [self initWithMutableData:[NSMutableData dataWithCapacity:ORKJSONStreamWriterFlushSize]];
+    if (self) {
+        ORKThrowInvalidArgumentExceptionIfNil(outputStream);
+        _outputStream = outputStream;
+    }
+    return self;
+}
+
+- (NSData *)data {
+    return _buffer;
+}
+
+#pragma mark Output
+
+- (void)failWithReason:(NSString *)reason {
+    if (!_error) {
+        _error = [NSError errorWithDomain:ORKErrorDomain code:ORKErrorInvalidObject userInfo:@{NSLocalizedFailureReasonErrorKey: reason}];
+    }
+}
+
+static inline void ORKJSONAppend(ORKJSONStreamWriter *writer, const void *bytes, NSUInteger length) {
+    [writer->_buffer appendBytes:bytes length:length];
+}
+
+- (void)flushIfNeeded:(BOOL)force {
+    if (!_outputStream || _error || _buffer.length == 0 || (!force && _buffer.length < ORKJSONStreamWriterFlushSize)) {
+        return;
+    }
+    const uint8_t *bytes = _buffer.bytes;
+    NSUInteger length = _buffer.length;
+    NSUInteger offset = 0;
+    while (offset < length) {
+        NSInteger written = [_outputStream write:bytes + offset maxLength:length - offset];
+        if (written <= 0) {
+            _error = _outputStream.streamError ? : [NSError errorWithDomain:NSCocoaErrorDomain code:NSFileWriteUnknownError userInfo:nil];
+            return;
+        }
+        offset += written;
+    }
+    _buffer.length = 0;
+}
+
+// Writes the separator needed before a value in the current container.
+- (BOOL)beginValue {
+    if (_error) {
+        return NO;
+    }
+    if (_afterKey) {
+        _afterKey = NO;
+        return YES;
+    }
+    if (_containers[_depth] == ORKJSONStreamWriterContainerObject) {
+        [self failWithReason:@"Object values must follow a key"];
+        return NO;
+    }
+    if (_hasValue[_depth]) {
+        ORKJSONAppend(self, ",", 1);
+    }
+    _hasValue[_depth] = YES;
+    return YES;
+}
+
+- (void)endValue {
+    if (_depth == 0) {
+        [self flushIfNeeded:NO];
+    }
+}
+
+#pragma mark Containers
+
+- (void)beginContainer:(ORKJSONStreamWriterContainer)container {
+    if (![self beginValue]) {
+        return;
+    }
+    if (_depth == ORKJSONStreamWriterMaximumDepth) {
+        [self failWithReason:@"Maximum nesting depth exceeded"];
+        return;
+    }
+    ORKJSONAppend(self, (container == ORKJSONStreamWriterContainerObject) ? "{" : "[", 1);
+    _depth++;
+    _containers[_depth] = container;
+    _hasValue[_depth] = NO;
+}
+
+- (void)endContainer:(ORKJSONStreamWriterContainer)container {
+    if (_error) {
+        return;
+    }
+    if (_depth == 0 || _containers[_depth] != container || _afterKey) {
+        [self failWithReason:@"Unbalanced container"];
+        return;
+    }
+    ORKJSONAppend(self, (container == ORKJSONStreamWriterContainerObject) ? "}" : "]", 1);
+    _depth--;
+    [self endValue];
+}
+
+- (void)beginObject {
+    [self beginContainer:ORKJSONStreamWriterContainerObject];
+}
+
+- (void)endObject {
+    [self endContainer:ORKJSONStreamWriterContainerObject];
+}
+
+- (void)beginArray {
+    [self beginContainer:ORKJSONStreamWriterContainerArray];
+}
+
+- (void)endArray {
+    [self endContainer:ORKJSONStreamWriterContainerArray];
+}
+
+- (void)writeKey:(NSString *)key {
+    if (_error) {
+        return;
+    }
+    if (_containers[_depth] != ORKJSONStreamWriterContainerObject || _afterKey) {
+        [self failWithReason:@"Keys can only be written inside an object"];
+        return;
+    }
+    if (_hasValue[_depth]) {
+        ORKJSONAppend(self, ",", 1);
+    }
+    _hasValue[_depth] = YES;
+    [self appendEscapedString:key];
+    ORKJSONAppend(self, ":", 1);
+    _afterKey = YES;
+}
+
+#pragma mark Scalars
+
+// Appends a quoted string, escaping only what JSON requires. The string is transcoded in chunks
+// into a stack buffer, so no intermediate C string is allocated.
+- (void)appendEscapedString:(NSString *)string {
+    ORKJSONAppend(self, "\"", 1);
+    
+    uint8_t chunk[256];
+    NSRange remaining = NSMakeRange(0, string.length);
+    while (remaining.length > 0) {
+        NSUInteger used = 0;
+        NSRange left;
+        [string getBytes:chunk maxLength:sizeof(chunk) usedLength:&used encoding:NSUTF8StringEncoding options:0 range:remaining remainingRange:&left];
+        if (used == 0) {
+            [self failWithReason:@"String cannot be encoded as UTF-8"];
+            return;
+        }
+        remaining = left;
+        
+        NSUInteger start = 0;
+        for (NSUInteger i = 0; i < used; i++) {
+            uint8_t c = chunk[i];
+            if (c >= 0x20 && c != '"' && c != '\\') {
+                continue;
+            }
+            if (i > start) {
+                ORKJSONAppend(self, chunk + start, i - start);
+            }
+            char escape[6] = { '\\', 0, 0, 0, 0, 0 };
+            NSUInteger escapeLength = 2;
+            switch (c) {
+                case '"': escape[1] = '"'; break;
+                case '\\': escape[1] = '\\'; break;
+                case '\b': escape[1] = 'b'; break;
+                case '\f': escape[1] = 'f'; break;
+                case '\n': escape[1] = 'n'; break;
+                case '\r': escape[1] = 'r'; break;
+                case '\t': escape[1] = 't'; break;
+                default:
+                    escape[1] = 'u';
+                    escape[2] = '0';
+                    escape[3] = '0';
+                    escape[4] = ORKJSONHexDigits[c >> 4];
+                    escape[5] = ORKJSONHexDigits[c & 0xf];
+                    escapeLength = 6;
+                    break;
+            }
+            ORKJSONAppend(self, escape, escapeLength);
+            start = i + 1;
+        }
+        if (used > start) {
+            ORKJSONAppend(self, chunk + start, used - start);
+        }
+    }
+    
+    ORKJSONAppend(self, "\"", 1);
+}
+
+- (void)writeString:(NSString *)string {
+    if (![self beginValue]) {
+        return;
+    }
+    [self appendEscapedString:string];
+    [self endValue];
+}
+
+- (void)writeInteger:(long long)value {
+    if (![self beginValue]) {
+        return;
+    }
+    char text[24];
+    int length = snprintf(text, sizeof(text), "%lld", value);
+    ORKJSONAppend(self, text, length);
+    [self endValue];
+}
+
+- (void)writeUnsignedInteger:(unsigned long long)value {
+    if (![self beginValue]) {
+        return;
+    }
+    char text[24];
+    int length = snprintf(text, sizeof(text), "%llu", value);
+    ORKJSONAppend(self, text, length);
+    [self endValue];
+}
+
+- (void)writeDouble:(double)value {
+    if (!isfinite(value)) {
+        [self failWithReason:@"Non-finite numbers cannot be written to JSON"];
+        return;
+    }
+    if (![self beginValue]) {
+        return;
+    }
+    // Use the shortest of the two precisions that reads back as the same value.
+    char text[32];
+    int length = snprintf(text, sizeof(text), "%.15g", value);
+    if (strtod(text, NULL) != value) {
+        length = snprintf(text, sizeof(text), "%.17g", value);
+    }
+    ORKJSONAppend(self, text, length);
+    [self endValue];
+}
+
+- (void)writeBool:(BOOL)value {
+    if (![self beginValue]) {
+        return;
+    }
+    if (value) {
+        ORKJSONAppend(self, "true", 4);
+    } else {
+        ORKJSONAppend(self, "false", 5);
+    }
+    [self endValue];
+}
+
+- (void)writeNull {
+    if (![self beginValue]) {
+        return;
+    }
+    ORKJSONAppend(self, "null", 4);
+    [self endValue];
+}
+
+- (void)writeDecimalNumber:(NSDecimalNumber *)number {
+    if ([number isEqualToNumber:[NSDecimalNumber notANumber]]) {
+        [self failWithReason:@"Non-finite numbers cannot be written to JSON"];
+        return;
+    }
+    if (![self beginValue]) {
+        return;
+    }
+    // Written in full, as `NSJSONSerialization` does, rather than rounded through a double.
+    NSData *text = [number.stringValue dataUsingEncoding:NSUTF8StringEncoding];
+    ORKJSONAppend(self, text.bytes, text.length);
+    [self endValue];
+}
+
+- (void)writeNumber:(NSNumber *)number {
+    // `NSDecimalNumber` is not a `CFNumber`, so it is handled first, and other numbers are classified by `objCType`.
+    const char *type = number.objCType;
+    if ([number isKindOfClass:[NSDecimalNumber class]]) {
+        [self writeDecimalNumber:(NSDecimalNumber *)number];
+    } else if (CFGetTypeID((__bridge CFTypeRef)number) == CFBooleanGetTypeID()) {
+        [self writeBool:number.boolValue];
+    } else if (strcmp(type, @encode(double)) == 0 || strcmp(type, @encode(float)) == 0) {
+        [self writeDouble:number.doubleValue];
+    } else if (strcmp(type, @encode(unsigned long long)) == 0) {
+        [self writeUnsignedInteger:number.unsignedLongLongValue];
+    } else {
+        [self writeInteger:number.longLongValue];
+    }
+}
+
+#pragma mark Dates
+
+- (void)writeDate:(NSDate *)date {
+    char text[ORKISO8601DateLength + 1];
+    size_t length = ORKISO8601FormatDate(date, text);
+    if (length == 0) {
+        [self writeString:ORKStringFromDateISO8601(date)];
+        return;
+    }
+    if (![self beginValue]) {
+        return;
+    }
+    ORKJSONAppend(self, "\"", 1);
+    ORKJSONAppend(self, text, length);
+    ORKJSONAppend(self, "\"", 1);
+    [self endValue];
+}
+
+#pragma mark Objects
+
+- (BOOL)writeJSONObject:(id)object {
+    if ([object isKindOfClass:[NSString class]]) {
+        [self writeString:object];
+    } else if ([object isKindOfClass:[NSNumber class]]) {
+        [self writeNumber:object];
+    } else if ([object isKindOfClass:[NSDictionary class]]) {
+        [self beginObject];
+        for (id key in (NSDictionary *)object) {
+            if (![key isKindOfClass:[NSString class]]) {
+                [self failWithReason:@"Dictionary keys must be strings"];
+                break;
+            }
+            [self writeKey:key];
+            if (![self writeJSONObject:((NSDictionary *)object)[key]]) {
+                break;
+            }
+        }
+        [self endObject];
+    } else if ([object isKindOfClass:[NSArray class]]) {
+        [self beginArray];
+        for (id element in (NSArray *)object) {
+            if (![self writeJSONObject:element]) {
+                break;
+            }
+        }
+        [self endArray];
+    } else if ([object isKindOfClass:[NSNull class]]) {
+        [self writeNull];
+    } else if ([object isKindOfClass:[NSDate class]]) {
+        [self writeDate:object];
+    } else {
+        [self failWithReason:[NSString stringWithFormat:@"Objects of class %@ cannot be written to JSON", [object class]]];
+    }
+    return (_error == nil);
+}
+
+- (BOOL)finishWithError:(NSError **)error {
+    if (!_error && (_depth != 0 || _afterKey)) {
+        [self failWithReason:@"Unterminated container"];
+    }
+    [self flushIfNeeded:YES];
+    if (_error && error) {
+        *error = _error;
+    }
+    return (_error == nil);
+}
+
+@end
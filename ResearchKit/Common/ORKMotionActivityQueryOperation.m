@@ -82,21 +82,18 @@
     __block NSString *itemIdentifier = nil;
     
     [_manager onWorkQueueSync:^BOOL(ORKDataCollectionManager *manager) {
-        BOOL changed = NO;
-        
         // _currentAnchor will be NSNotFound on the first pass of the operation
         if (_currentDate != nil) {
-            changed = YES;
-            
             // Update the anchor if we have one
             _collector.lastDate = _currentDate;
+            [manager persistProgressOfCollector:_collector];
         }
         
         lastDate = _collector.lastDate;
         startDate = _collector.startDate;
         itemIdentifier = _collector.identifier;
         
-        return changed;
+        return NO;
     }];
     
     if (_currentDate == nil) {
@@ -172,7 +169,7 @@
             }
             
             dispatch_semaphore_signal(sem);
-            return YES;
+            return NO;
         }];
         dispatch_semaphore_wait(sem, DISPATCH_TIME_FOREVER);
         
@@ -193,7 +190,8 @@
             // Store it on the collector
             [_manager onWorkQueueAsync:^BOOL(ORKDataCollectionManager *manager) {
                 _collector.lastDate = nextStartDate;
-                return YES;
+                [manager persistProgressOfCollector:_collector];
+                return NO;
             }];
             
         }
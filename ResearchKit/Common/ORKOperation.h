@@ -69,4 +69,19 @@ typedef void (^ORKOperationBlock)(ORKOperation *operation);
  */
 - (void)doTimeout;
 
+/**
+ The absolute time (as returned by `CFAbsoluteTimeGetCurrent`) after which the operation times out,
+ or 0 when it is not waiting on anything. The owner of the operation checks it with
+ `timeoutIfPastDeadline:` from a single watchdog timer.
+ */
+@property (atomic, assign) NSTimeInterval deadline;
+
+/**
+ Sets the error to indicate a timeout, and finishes, if the deadline has passed.
+ 
+ This method never blocks on the operation's lock: if the lock is held elsewhere, it does nothing,
+ and the timeout is applied on a later call.
+ */
+- (void)timeoutIfPastDeadline:(NSTimeInterval)now;
+
 @end
@@ -169,4 +169,25 @@ static BOOL stateTransitionIsValid(ORKOperationState fromState, ORKOperationStat
     [self.lock unlock];
 }
 
+- (void)timeoutIfPastDeadline:(NSTimeInterval)now {
+    NSTimeInterval deadline = self.deadline;
+    if (deadline <= 0 || now < deadline) {
+        return;
+    }
+    
+    // The watchdog runs on the manager's work queue, which the operations wait on while holding
+    // their lock, so blocking on the lock here could deadlock. A busy operation is checked again
+    // on the next tick instead.
+    if (![self.lock tryLock]) {
+        return;
+    }
+    deadline = self.deadline;
+    if (deadline > 0 && now >= deadline && self.state == ORKOperationExecuting && ![self isCancelled]) {
+        ORK_Log_Debug(@"Timeout: cancel operation %@", self);
+        self.error = [NSError errorWithDomain:ORKErrorDomain code:ORKErrorException userInfo:@{NSLocalizedDescriptionKey:@"Query timeout"}];
+        [self finish];
+    }
+    [self.lock unlock];
+}
+
 @end
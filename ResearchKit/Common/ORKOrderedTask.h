@@ -157,7 +157,11 @@ typedef NS_OPTIONS(NSUInteger, ORKPredefinedTaskOption) {
     ORKPredefinedTaskOptionExcludeHeartRate = (1 << 6),
     
     /// Exclude audio data collection.
-    ORKPredefinedTaskOptionExcludeAudio = (1 << 7)
+    ORKPredefinedTaskOptionExcludeAudio = (1 << 7),
+    
+    /// Compute an on-device gait summary (`ORKGaitSummaryResult`) for the walking steps of walking tasks, from the
+    /// device motion data, or from the accelerometer data when device motion is excluded.
+    ORKPredefinedTaskOptionIncludeGaitSummary = (1 << 8)
 } ORK_ENUM_AVAILABLE;
 
 /**
@@ -817,12 +817,18 @@ void ORKStepArrayAddStep(NSMutableArray *array, ORKStep *step) {
                 [recorderConfigurations addObject:[[ORKPedometerRecorderConfiguration alloc] initWithIdentifier:ORKPedometerRecorderIdentifier]];
             }
             if (!(ORKPredefinedTaskOptionExcludeAccelerometer & options)) {
-                [recorderConfigurations addObject:[[ORKAccelerometerRecorderConfiguration alloc] initWithIdentifier:ORKAccelerometerRecorderIdentifier
-                                                                                                          frequency:100]];
+                ORKAccelerometerRecorderConfiguration *accelerometerConfiguration = [[ORKAccelerometerRecorderConfiguration alloc] initWithIdentifier:ORKAccelerometerRecorderIdentifier
+                                                                                                                                         frequency:100];
+                // Without device motion, the gait summary is computed from the accelerometer.
+                accelerometerConfiguration.includesGaitSummary = ((ORKPredefinedTaskOptionIncludeGaitSummary & options)
+                                                                  && (ORKPredefinedTaskOptionExcludeDeviceMotion & options)) ? YES : NO;
+                [recorderConfigurations addObject:accelerometerConfiguration];
             }
             if (!(ORKPredefinedTaskOptionExcludeDeviceMotion & options)) {
-                [recorderConfigurations addObject:[[ORKDeviceMotionRecorderConfiguration alloc] initWithIdentifier:ORKDeviceMotionRecorderIdentifier
-                                                                                                         frequency:100]];
+                ORKDeviceMotionRecorderConfiguration *deviceMotionConfiguration = [[ORKDeviceMotionRecorderConfiguration alloc] initWithIdentifier:ORKDeviceMotionRecorderIdentifier
+                                                                                                                                       frequency:100];
+                deviceMotionConfiguration.includesGaitSummary = (ORKPredefinedTaskOptionIncludeGaitSummary & options) ? YES : NO;
+                [recorderConfigurations addObject:deviceMotionConfiguration];
             }
 
             ORKWalkingTaskStep *walkingStep = [[ORKWalkingTaskStep alloc] initWithIdentifier:ORKShortWalkOutboundStepIdentifier];
@@ -846,12 +852,18 @@ void ORKStepArrayAddStep(NSMutableArray *array, ORKStep *step) {
                 [recorderConfigurations addObject:[[ORKPedometerRecorderConfiguration alloc] initWithIdentifier:ORKPedometerRecorderIdentifier]];
             }
             if (!(ORKPredefinedTaskOptionExcludeAccelerometer & options)) {
-                [recorderConfigurations addObject:[[ORKAccelerometerRecorderConfiguration alloc] initWithIdentifier:ORKAccelerometerRecorderIdentifier
-                                                                                                          frequency:100]];
+                ORKAccelerometerRecorderConfiguration *accelerometerConfiguration = [[ORKAccelerometerRecorderConfiguration alloc] initWithIdentifier:ORKAccelerometerRecorderIdentifier
+                                                                                                                                         frequency:100];
+                // Without device motion, the gait summary is computed from the accelerometer.
+                accelerometerConfiguration.includesGaitSummary = ((ORKPredefinedTaskOptionIncludeGaitSummary & options)
+                                                                  && (ORKPredefinedTaskOptionExcludeDeviceMotion & options)) ? YES : NO;
+                [recorderConfigurations addObject:accelerometerConfiguration];
             }
             if (!(ORKPredefinedTaskOptionExcludeDeviceMotion & options)) {
-                [recorderConfigurations addObject:[[ORKDeviceMotionRecorderConfiguration alloc] initWithIdentifier:ORKDeviceMotionRecorderIdentifier
-                                                                                                         frequency:100]];
+                ORKDeviceMotionRecorderConfiguration *deviceMotionConfiguration = [[ORKDeviceMotionRecorderConfiguration alloc] initWithIdentifier:ORKDeviceMotionRecorderIdentifier
+                                                                                                                                       frequency:100];
+                deviceMotionConfiguration.includesGaitSummary = (ORKPredefinedTaskOptionIncludeGaitSummary & options) ? YES : NO;
+                [recorderConfigurations addObject:deviceMotionConfiguration];
             }
 
             ORKWalkingTaskStep *walkingStep = [[ORKWalkingTaskStep alloc] initWithIdentifier:ORKShortWalkReturnStepIdentifier];
@@ -954,12 +966,18 @@ void ORKStepArrayAddStep(NSMutableArray *array, ORKStep *step) {
                 [recorderConfigurations addObject:[[ORKPedometerRecorderConfiguration alloc] initWithIdentifier:ORKPedometerRecorderIdentifier]];
             }
             if (!(ORKPredefinedTaskOptionExcludeAccelerometer & options)) {
-                [recorderConfigurations addObject:[[ORKAccelerometerRecorderConfiguration alloc] initWithIdentifier:ORKAccelerometerRecorderIdentifier
-                                                                                                          frequency:100]];
+                ORKAccelerometerRecorderConfiguration *accelerometerConfiguration = [[ORKAccelerometerRecorderConfiguration alloc] initWithIdentifier:ORKAccelerometerRecorderIdentifier
+                                                                                                                                         frequency:100];
+                // Without device motion, the gait summary is computed from the accelerometer.
+                accelerometerConfiguration.includesGaitSummary = ((ORKPredefinedTaskOptionIncludeGaitSummary & options)
+                                                                  && (ORKPredefinedTaskOptionExcludeDeviceMotion & options)) ? YES : NO;
+                [recorderConfigurations addObject:accelerometerConfiguration];
             }
             if (!(ORKPredefinedTaskOptionExcludeDeviceMotion & options)) {
-                [recorderConfigurations addObject:[[ORKDeviceMotionRecorderConfiguration alloc] initWithIdentifier:ORKDeviceMotionRecorderIdentifier
-                                                                                                         frequency:100]];
+                ORKDeviceMotionRecorderConfiguration *deviceMotionConfiguration = [[ORKDeviceMotionRecorderConfiguration alloc] initWithIdentifier:ORKDeviceMotionRecorderIdentifier
+                                                                                                                                       frequency:100];
+                deviceMotionConfiguration.includesGaitSummary = (ORKPredefinedTaskOptionIncludeGaitSummary & options) ? YES : NO;
+                [recorderConfigurations addObject:deviceMotionConfiguration];
             }
             
             ORKWalkingTaskStep *walkingStep = [[ORKWalkingTaskStep alloc] initWithIdentifier:ORKShortWalkOutboundStepIdentifier];
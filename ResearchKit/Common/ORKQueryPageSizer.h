@@ -0,0 +1,86 @@
+/*
+ Copyright (c) 2016, Apple Inc. All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+ 
+ 1.  Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ 2.  Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation and/or
+ other materials provided with the distribution.
+ 
+ 3.  Neither the name of the copyright holder(s) nor the names of any contributors
+ may be used to endorse or promote products derived from this software without
+ specific prior written permission. No license is granted to the trademarks of
+ the copyright holders even if such marks are included in this software.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+
+
+@import Foundation;
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ The `ORKQueryPageSizer` class picks the page size of successive HealthKit anchored queries.
+
+ After each page, the time HealthKit took to return it and the time spent processing it are
+ used to estimate the cost of a single sample, and the next limit is chosen so a full page
+ takes about `targetPageDuration`. The limit at most doubles or halves from one page to the
+ next, and only grows after a full page, since a short page says nothing about how many more
+ samples a query could have returned.
+
+ A sizer is thread-safe.
+ */
+@interface ORKQueryPageSizer : NSObject
+
+- (instancetype)init NS_UNAVAILABLE;
+
+- (instancetype)initWithInitialLimit:(NSUInteger)initialLimit
+                        minimumLimit:(NSUInteger)minimumLimit
+                        maximumLimit:(NSUInteger)maximumLimit NS_DESIGNATED_INITIALIZER;
+
+/// The limit to use for the next query.
+@property (readonly) NSUInteger limit;
+
+@property (readonly) NSUInteger minimumLimit;
+
+@property (readonly) NSUInteger maximumLimit;
+
+/// The time a full page should take to query and process, in seconds. The default is 0.5 seconds.
+@property NSTimeInterval targetPageDuration;
+
+/// A moving average of the samples collected per second, counting both query and processing time.
+@property (readonly) double samplesPerSecond;
+
+/**
+ Records a page and updates the limit for the next query.
+
+ @param count               The number of samples returned.
+ @param limit               The limit the page was queried with.
+ @param queryDuration       The time HealthKit took to return the page, in seconds.
+ @param processingDuration  The time spent processing the page once returned, in seconds.
+ */
+- (void)recordPageWithCount:(NSUInteger)count
+                      limit:(NSUInteger)limit
+              queryDuration:(NSTimeInterval)queryDuration
+         processingDuration:(NSTimeInterval)processingDuration;
+
+@end
+
+NS_ASSUME_NONNULL_END
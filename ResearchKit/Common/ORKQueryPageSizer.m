@@ -0,0 +1,112 @@
+/*
+ Copyright (c) 2016, Apple Inc. All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+ 
+ 1.  Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ 2.  Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation and/or
+ other materials provided with the distribution.
+ 
+ 3.  Neither the name of the copyright holder(s) nor the names of any contributors
+ may be used to endorse or promote products derived from this software without
+ specific prior written permission. No license is granted to the trademarks of
+ the copyright holders even if such marks are included in this software.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+
+
+#import "ORKQueryPageSizer.h"
+
+#import "ORKHelpers_Internal.h"
+
+
+// Weight of the latest page in the throughput moving average.
+static const double ORKQueryPageSizerSmoothing = 0.3;
+
+@implementation ORKQueryPageSizer {
+    NSUInteger _limit;
+    double _samplesPerSecond;
+}
+
+- (instancetype)init {
+    ORKThrowMethodUnavailableException();
+}
+
+- (instancetype)initWithInitialLimit:(NSUInteger)initialLimit
+                        minimumLimit:(NSUInteger)minimumLimit
+                        maximumLimit:(NSUInteger)maximumLimit {
+    self = [super init];
+    if (self) {
+        if (minimumLimit == 0 || minimumLimit > maximumLimit) {
+            @throw [NSException exceptionWithName:NSInvalidArgumentException reason:@"Limits must satisfy 0 < minimumLimit <= maximumLimit" userInfo:nil];
+        }
+        _minimumLimit = minimumLimit;
+        _maximumLimit = maximumLimit;
+        _limit = MIN(MAX(initialLimit, minimumLimit), maximumLimit);
+        _targetPageDuration = 0.5;
+    }
+    return self;
+}
+
+- (NSUInteger)limit {
+    @synchronized (self) {
+        return _limit;
+    }
+}
+
+- (double)samplesPerSecond {
+    @synchronized (self) {
+        return _samplesPerSecond;
+    }
+}
+
+- (void)recordPageWithCount:(NSUInteger)count
+                      limit:(NSUInteger)limit
+              queryDuration:(NSTimeInterval)queryDuration
+         processingDuration:(NSTimeInterval)processingDuration {
+    if (count == 0) {
+        return;
+    }
+    NSTimeInterval duration = MAX(queryDuration, 0) + MAX(processingDuration, 0);
+    
+    @synchronized (self) {
+        if (duration > 0) {
+            double rate = count / duration;
+            _samplesPerSecond = (_samplesPerSecond > 0) ? (ORKQueryPageSizerSmoothing * rate + (1 - ORKQueryPageSizerSmoothing) * _samplesPerSecond) : rate;
+        }
+        
+        double next = _limit;
+        if (duration <= 0) {
+            next = _limit * 2.0;
+        } else {
+            next = _targetPageDuration * count / duration;
+        }
+        next = MIN(MAX(next, _limit / 2.0), _limit * 2.0);
+        if (count < limit) {
+            next = MIN(next, _limit);
+        }
+        _limit = MIN(MAX((NSUInteger)next, _minimumLimit), _maximumLimit);
+    }
+}
+
+- (NSString *)description {
+    return [NSString stringWithFormat:@"<%@: %p; limit: %@; samplesPerSecond: %.1f>", NSStringFromClass([self class]), self, @(self.limit), self.samplesPerSecond];
+}
+
+@end
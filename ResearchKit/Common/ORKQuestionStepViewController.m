@@ -31,6 +31,7 @@
 
 #import "ORKQuestionStepViewController.h"
 
+#import "ORKChoiceSearchIndex.h"
 #import "ORKChoiceViewCell.h"
 #import "ORKQuestionStepView.h"
 #import "ORKStepHeaderView_Internal.h"
@@ -63,7 +64,7 @@ typedef NS_ENUM(NSInteger, ORKQuestionSection) {
 };
 
 
-@interface ORKQuestionStepViewController () <UITableViewDataSource,UITableViewDelegate, ORKSurveyAnswerCellDelegate> {
+@interface ORKQuestionStepViewController () <UITableViewDataSource,UITableViewDelegate, UISearchBarDelegate, ORKSurveyAnswerCellDelegate> {
     id _answer;
     
     ORKTableContainerView *_tableContainer;
@@ -76,6 +77,11 @@ typedef NS_ENUM(NSInteger, ORKQuestionSection) {
     
     ORKTextChoiceCellGroup *_choiceCellGroup;
     
+    // Only used by `ORKSearchableChoiceAnswerFormat`, whose rows are cells reused across choices.
+    ORKChoiceSearchIndex *_searchIndex;
+    UISearchBar *_searchBar;
+    NSData *_matchingChoiceIndexes; // NSUInteger per row, or nil when every choice is shown
+    
     id _defaultAnswer;
     
     BOOL _visible;
@@ -137,6 +143,10 @@ typedef NS_ENUM(NSInteger, ORKQuestionSection) {
 - (void)stepDidChange {
     [super stepDidChange];
     _answerFormat = [self.questionStep impliedAnswerFormat];
+    _searchIndex = [ORKDynamicCast(_answerFormat, ORKSearchableChoiceAnswerFormat) searchIndex];
+    _matchingChoiceIndexes = nil;
+    _searchBar.delegate = nil;
+    _searchBar = nil;
     
     self.hasChangedAnswer = NO;
     
@@ -160,6 +170,19 @@ typedef NS_ENUM(NSInteger, ORKQuestionSection) {
             _tableView.dataSource = self;
             _tableView.clipsToBounds = YES;
             
+            if (_searchIndex) {
+                // Row heights are only computed for the rows that are displayed.
+                _tableView.estimatedRowHeight = ORKGetMetricForWindow(ORKScreenMetricTableCellDefaultHeight, self.view.window);
+                _tableView.keyboardDismissMode = UIScrollViewKeyboardDismissModeOnDrag;
+                
+                _searchBar = [UISearchBar new];
+                _searchBar.delegate = self;
+                _searchBar.searchBarStyle = UISearchBarStyleMinimal;
+                _searchBar.autocorrectionType = UITextAutocorrectionTypeNo;
+                _searchBar.userInteractionEnabled = !self.readOnlyMode;
+                [_searchBar sizeToFit];
+            }
+            
             [self.view addSubview:_tableContainer];
             _tableContainer.tapOffView = self.view;
             
@@ -342,6 +365,16 @@ typedef NS_ENUM(NSInteger, ORKQuestionSection) {
     
     _visible = YES;
     
+    // Build the search index before the first keystroke needs it. Searches made before it is
+    // ready show every choice, so filter again once it is.
+    ORKWeakTypeOf(self) weakSelf = self;
+    [_searchIndex prepareWithCompletion:^{
+        ORKStrongTypeOf(weakSelf) strongSelf = weakSelf;
+        if (strongSelf && strongSelf->_searchBar.text.length > 0) {
+            [strongSelf updateMatchingChoicesForQuery:strongSelf->_searchBar.text];
+        }
+    }];
+    
     UIAccessibilityPostNotification(UIAccessibilityScreenChangedNotification, nil);
 }
 
@@ -490,7 +523,12 @@ typedef NS_ENUM(NSInteger, ORKQuestionSection) {
         self.continueButtonItem  = self.internalContinueButtonItem;
     }
     
-    [self.tableView reloadData];
+    if (_searchIndex) {
+        // A full reload would take the search bar, the section header, out of the window.
+        [self reloadSearchableChoiceRowsWithChangedSelection];
+    } else {
+        [self.tableView reloadData];
+    }
 }
 
 - (id<NSCopying, NSCoding, NSObject>)answer {
@@ -547,6 +585,9 @@ typedef NS_ENUM(NSInteger, ORKQuestionSection) {
     ORKAnswerFormat *impliedAnswerFormat = [_answerFormat impliedAnswerFormat];
     
     if (section == ORKQuestionSectionAnswer) {
+        if (_searchIndex) {
+            return _matchingChoiceIndexes ? (_matchingChoiceIndexes.length / sizeof(NSUInteger)) : _searchIndex.numberOfChoices;
+        }
         if (_choiceCellGroup == nil) {
             _choiceCellGroup = [[ORKTextChoiceCellGroup alloc] initWithTextChoiceAnswerFormat:(ORKTextChoiceAnswerFormat *)impliedAnswerFormat
                                                                                        answer:self.answer
@@ -623,6 +664,10 @@ typedef NS_ENUM(NSInteger, ORKQuestionSection) {
     // Section for Answer Area
     //////////////////////////////////
     
+    if (_searchIndex) {
+        return [self searchableChoiceCellForTableView:tableView atIndexPath:indexPath];
+    }
+    
     static NSString *identifier = nil;
 
     assert (self.questionStep.isFormatFitsChoiceCells);
@@ -639,6 +684,23 @@ typedef NS_ENUM(NSInteger, ORKQuestionSection) {
     return cell;
 }
 
+- (ORKChoiceViewCell *)searchableChoiceCellForTableView:(UITableView *)tableView atIndexPath:(NSIndexPath *)indexPath {
+    static NSString *const identifier = @"ORKSearchableChoiceCell";
+    
+    ORKChoiceViewCell *cell = [tableView dequeueReusableCellWithIdentifier:identifier];
+    if (cell == nil) {
+        cell = [[ORKChoiceViewCell alloc] initWithStyle:UITableViewCellStyleDefault reuseIdentifier:identifier];
+    }
+    
+    ORKTextChoice *textChoice = [self searchableChoiceAtRow:indexPath.row];
+    cell.immediateNavigation = [self isStepImmediateNavigation];
+    cell.shortLabel.text = textChoice.text;
+    cell.longLabel.text = textChoice.detailText;
+    cell.selectedItem = [self isSearchableChoiceSelected:textChoice];
+    cell.userInteractionEnabled = !self.readOnlyMode;
+    return cell;
+}
+
 - (void)tableView:(UITableView *)tableView willDisplayCell:(UITableViewCell *)cell forRowAtIndexPath:(NSIndexPath *)indexPath {
     cell.layoutMargins = UIEdgeInsetsZero;
     cell.separatorInset = (UIEdgeInsets){.left = ORKStandardLeftMarginForTableViewCell(tableView)};
@@ -700,12 +762,16 @@ typedef NS_ENUM(NSInteger, ORKQuestionSection) {
 - (void)tableView:(UITableView *)tableView didSelectRowAtIndexPath:(NSIndexPath *)indexPath {
     [tableView deselectRowAtIndexPath:indexPath animated:YES];
     
-    [_choiceCellGroup didSelectCellAtIndexPath:indexPath];
-    
     // Capture `isStepImmediateNavigation` before saving an answer.
     BOOL immediateNavigation = [self isStepImmediateNavigation];
     
-    id answer = (self.questionStep.questionType == ORKQuestionTypeBoolean) ? [_choiceCellGroup answerForBoolean] :[_choiceCellGroup answer];
+    id answer = nil;
+    if (_searchIndex) {
+        answer = [self searchableChoiceAnswerBySelectingChoice:[self searchableChoiceAtRow:indexPath.row]];
+    } else {
+        [_choiceCellGroup didSelectCellAtIndexPath:indexPath];
+        answer = (self.questionStep.questionType == ORKQuestionTypeBoolean) ? [_choiceCellGroup answerForBoolean] :[_choiceCellGroup answer];
+    }
     
     [self saveAnswer:answer];
     self.hasChangedAnswer = YES;
@@ -723,7 +789,10 @@ typedef NS_ENUM(NSInteger, ORKQuestionSection) {
     switch (self.questionStep.questionType) {
         case ORKQuestionTypeSingleChoice:
         case ORKQuestionTypeMultipleChoice:{
-            if ([self.questionStep isFormatFitsChoiceCells]) {
+            if (_searchIndex) {
+                ORKTextChoice *textChoice = [self searchableChoiceAtRow:indexPath.row];
+                height = [ORKChoiceViewCell suggestedCellHeightForShortText:textChoice.text LongText:textChoice.detailText inTableView:_tableView];
+            } else if ([self.questionStep isFormatFitsChoiceCells]) {
                 height = [self heightForChoiceItemOptionAtIndex:indexPath.row];
             } else {
                 height = [ORKSurveyAnswerCellForPicker suggestedCellHeightForView:tableView];
@@ -760,6 +829,96 @@ typedef NS_ENUM(NSInteger, ORKQuestionSection) {
     return height;
 }
 
+- (UIView *)tableView:(UITableView *)tableView viewForHeaderInSection:(NSInteger)section {
+    return (section == ORKQuestionSectionAnswer) ? _searchBar : nil;
+}
+
+- (CGFloat)tableView:(UITableView *)tableView heightForHeaderInSection:(NSInteger)section {
+    return (section == ORKQuestionSectionAnswer && _searchBar) ? _searchBar.bounds.size.height : tableView.sectionHeaderHeight;
+}
+
+#pragma mark - Searchable choices
+
+- (ORKTextChoice *)searchableChoiceAtRow:(NSUInteger)row {
+    NSUInteger choiceIndex = _matchingChoiceIndexes ? ((const NSUInteger *)_matchingChoiceIndexes.bytes)[row] : row;
+    return [_searchIndex textChoiceAtIndex:choiceIndex];
+}
+
+- (BOOL)isSearchableChoiceSelected:(ORKTextChoice *)textChoice {
+    id answer = self.answer;
+    return textChoice.value && [answer isKindOfClass:[NSArray class]] && [(NSArray *)answer containsObject:textChoice.value];
+}
+
+- (id)searchableChoiceAnswerBySelectingChoice:(ORKTextChoice *)textChoice {
+    if (textChoice.value == nil) {
+        return self.answer;
+    }
+    if (self.questionStep.questionType == ORKQuestionTypeSingleChoice) {
+        return @[textChoice.value];
+    }
+    
+    NSArray *selectedValues = [self.answer isKindOfClass:[NSArray class]] ? (NSArray *)self.answer : @[];
+    if ([selectedValues containsObject:textChoice.value]) {
+        NSMutableArray *values = [selectedValues mutableCopy];
+        [values removeObject:textChoice.value];
+        return [values copy];
+    }
+    
+    // Selecting an exclusive choice clears the others, and selecting any other choice clears an exclusive one.
+    NSMutableArray *values = [NSMutableArray array];
+    if (!textChoice.exclusive) {
+        for (id value in selectedValues) {
+            NSUInteger index = [_searchIndex indexOfChoiceWithValue:value];
+            if (index == NSNotFound || ![_searchIndex textChoiceAtIndex:index].exclusive) {
+                [values addObject:value];
+            }
+        }
+    }
+    [values addObject:textChoice.value];
+    return [values copy];
+}
+
+- (void)reloadSearchableChoiceRowsWithChangedSelection {
+    NSMutableArray<NSIndexPath *> *changedIndexPaths = [NSMutableArray array];
+    for (NSIndexPath *indexPath in _tableView.indexPathsForVisibleRows) {
+        ORKChoiceViewCell *cell = ORKDynamicCast([_tableView cellForRowAtIndexPath:indexPath], ORKChoiceViewCell);
+        if (cell && cell.selectedItem != [self isSearchableChoiceSelected:[self searchableChoiceAtRow:indexPath.row]]) {
+            [changedIndexPaths addObject:indexPath];
+        }
+    }
+    if (changedIndexPaths.count > 0) {
+        [_tableView reloadRowsAtIndexPaths:changedIndexPaths withRowAnimation:UITableViewRowAnimationNone];
+    }
+}
+
+- (void)updateMatchingChoicesForQuery:(NSString *)query {
+    NSIndexSet *indexes = [_searchIndex indexesOfChoicesMatchingQuery:query];
+    if (indexes.count == _searchIndex.numberOfChoices) {
+        _matchingChoiceIndexes = nil;
+    } else {
+        NSMutableData *matchingChoiceIndexes = [NSMutableData dataWithLength:indexes.count * sizeof(NSUInteger)];
+        [indexes getIndexes:matchingChoiceIndexes.mutableBytes maxCount:indexes.count inIndexRange:NULL];
+        _matchingChoiceIndexes = [matchingChoiceIndexes copy];
+    }
+    
+    // The search bar is the section header, which a reload takes out of the window.
+    BOOL searching = _searchBar.isFirstResponder;
+    [_tableView reloadData];
+    if (searching) {
+        [_searchBar becomeFirstResponder];
+    }
+}
+
+#pragma mark - UISearchBarDelegate
+
+- (void)searchBar:(UISearchBar *)searchBar textDidChange:(NSString *)searchText {
+    [self updateMatchingChoicesForQuery:searchText];
+}
+
+- (void)searchBarSearchButtonClicked:(UISearchBar *)searchBar {
+    [searchBar resignFirstResponder];
+}
+
 #pragma mark - ORKSurveyAnswerCellDelegate
 
 - (void)answerCell:(ORKSurveyAnswerCell *)cell answerDidChangeTo:(id)answer dueUserAction:(BOOL)dueUserAction {
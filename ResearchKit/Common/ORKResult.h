@@ -643,6 +643,11 @@ Each entry of motion data in this file contains a time interval which may be dir
  The fileResult property references the motion data recorded from the beginning of the attempt until the threshold acceleration was reached.
 Using the time taken to reach the threshold acceleration as the reaction time of a participant will yield a rather crude measurement. Rather, you should devise your own method using the data recorded to obtain an accurate approximation of the true reaction time.
  
+ The `rawReactionTime` and `correctedReactionTime` properties report the framework's own
+ measurements. The corrected time is measured from when the stimulus reached the display to when
+ the acceleration crossed the threshold, interpolated between motion samples, so it excludes most of
+ the scheduling and delivery latency included in the raw time.
+ 
  A reaction time result is typically generated by the framework as the task proceeds. When the task
  completes, it may be appropriate to serialize the sample for transmission to a server
  or to immediately perform analysis on it.
@@ -654,6 +659,24 @@ ORK_CLASS_AVAILABLE
 
 @property (nonatomic, strong) ORKFileResult *fileResult;
 
+/**
+ The estimated time at which the stimulus appeared on the display, on the same clock as `timestamp`,
+ or 0 if it is unknown.
+ */
+@property (nonatomic, assign) NSTimeInterval stimulusPresentationTimestamp;
+
+/**
+ The time from `timestamp` to the first motion sample whose acceleration exceeded the threshold,
+ in seconds.
+ */
+@property (nonatomic, assign) NSTimeInterval rawReactionTime;
+
+/**
+ The time from `stimulusPresentationTimestamp` to the interpolated moment the acceleration
+ reached the threshold, in seconds.
+ */
+@property (nonatomic, assign) NSTimeInterval correctedReactionTime;
+
 @end
 
 
@@ -1001,6 +1024,58 @@ ORK_CLASS_AVAILABLE
 @end
 
 
+/**
+ The `ORKGaitSummaryResult` class records gait features computed on the device while
+ accelerometer or device motion data is being recorded.
+
+ A gait summary result is produced alongside the `ORKFileResult` of an accelerometer or device motion
+ recorder whose configuration has `includesGaitSummary` set. It is meant for immediate feedback and for
+ reducing the amount of raw data that needs to be analyzed after upload; the raw samples remain
+ available in the file result.
+ */
+ORK_CLASS_AVAILABLE
+@interface ORKGaitSummaryResult : ORKResult
+
+/**
+ The number of steps detected.
+ */
+@property (nonatomic, assign) NSInteger numberOfSteps;
+
+/**
+ The step cadence, in steps per minute, between the first and last detected steps.
+ */
+@property (nonatomic, assign) double cadence;
+
+/**
+ The mean time between successive foot strikes of the same foot, in seconds.
+ */
+@property (nonatomic, assign) NSTimeInterval meanStrideDuration;
+
+/**
+ The coefficient of variation (standard deviation divided by mean) of the stride duration.
+ */
+@property (nonatomic, assign) double strideDurationVariability;
+
+/**
+ The root mean square of the vertical component of the user acceleration, in g.
+ */
+@property (nonatomic, assign) double verticalAccelerationRMS;
+
+/**
+ The root mean square of the horizontal component of the user acceleration, in g.
+ 
+ This value is a measure of sway.
+ */
+@property (nonatomic, assign) double horizontalAccelerationRMS;
+
+/**
+ The time span covered by the analyzed samples.
+ */
+@property (nonatomic, assign) NSTimeInterval duration;
+
+@end
+
+
 /**
  The `ORKTextQuestionResult` class represents the answer to a question or
  form item that uses an `ORKTextAnswerFormat` format.
@@ -1411,6 +1486,13 @@ ORK_CLASS_AVAILABLE
  */
 @property (nonatomic, copy, nullable) NSArray <UIBezierPath *> *signaturePath;
 
+/**
+ The strokes of the signature in a compact vector form, which is much smaller than
+ `signaturePath`. Each stroke is stored as a little-endian 32-bit point count, followed by that
+ many points. Each point is three little-endian 32-bit floats: x, y, and line width, in points.
+ */
+@property (nonatomic, copy, nullable) NSData *signatureStrokeData;
+
 @end
 
 
@@ -789,6 +789,9 @@ const NSUInteger NumberOfPaddingSpacesForIndentationLevel = 4;
     [super encodeWithCoder:aCoder];
     ORK_ENCODE_DOUBLE(aCoder, timestamp);
     ORK_ENCODE_OBJ(aCoder, fileResult);
+    ORK_ENCODE_DOUBLE(aCoder, stimulusPresentationTimestamp);
+    ORK_ENCODE_DOUBLE(aCoder, rawReactionTime);
+    ORK_ENCODE_DOUBLE(aCoder, correctedReactionTime);
 }
 
 - (instancetype)initWithCoder:(NSCoder *)aDecoder {
@@ -796,6 +799,9 @@ const NSUInteger NumberOfPaddingSpacesForIndentationLevel = 4;
     if (self) {
         ORK_DECODE_DOUBLE(aDecoder, timestamp);
         ORK_DECODE_OBJ_CLASS(aDecoder, fileResult, ORKFileResult);
+        ORK_DECODE_DOUBLE(aDecoder, stimulusPresentationTimestamp);
+        ORK_DECODE_DOUBLE(aDecoder, rawReactionTime);
+        ORK_DECODE_DOUBLE(aDecoder, correctedReactionTime);
     }
     return self;
 }
@@ -810,7 +816,10 @@ const NSUInteger NumberOfPaddingSpacesForIndentationLevel = 4;
     __typeof(self) castObject = object;
     return (isParentSame &&
             (self.timestamp == castObject.timestamp) &&
-            ORKEqualObjects(self.fileResult, castObject.fileResult)) ;
+            ORKEqualObjects(self.fileResult, castObject.fileResult) &&
+            (self.stimulusPresentationTimestamp == castObject.stimulusPresentationTimestamp) &&
+            (self.rawReactionTime == castObject.rawReactionTime) &&
+            (self.correctedReactionTime == castObject.correctedReactionTime)) ;
 }
 
 - (NSUInteger)hash {
@@ -821,11 +830,14 @@ const NSUInteger NumberOfPaddingSpacesForIndentationLevel = 4;
     ORKReactionTimeResult *result = [super copyWithZone:zone];
     result.fileResult = [self.fileResult copy];
     result.timestamp = self.timestamp;
+    result.stimulusPresentationTimestamp = self.stimulusPresentationTimestamp;
+    result.rawReactionTime = self.rawReactionTime;
+    result.correctedReactionTime = self.correctedReactionTime;
     return result;
 }
 
 - (NSString *)descriptionWithNumberOfPaddingSpaces:(NSUInteger)numberOfPaddingSpaces {
-    return [NSString stringWithFormat:@"%@; timestamp: %f; fileResult: %@%@", [self descriptionPrefixWithNumberOfPaddingSpaces:numberOfPaddingSpaces], self.timestamp, self.fileResult.description, self.descriptionSuffix];
+    return [NSString stringWithFormat:@"%@; timestamp: %f; rawReactionTime: %f; correctedReactionTime: %f; fileResult: %@%@", [self descriptionPrefixWithNumberOfPaddingSpaces:numberOfPaddingSpaces], self.timestamp, self.rawReactionTime, self.correctedReactionTime, self.fileResult.description, self.descriptionSuffix];
 }
 
 @end
@@ -884,6 +896,74 @@ const NSUInteger NumberOfPaddingSpacesForIndentationLevel = 4;
 @end
 
 
+@implementation ORKGaitSummaryResult
+
+- (void)encodeWithCoder:(NSCoder *)aCoder {
+    [super encodeWithCoder:aCoder];
+    ORK_ENCODE_INTEGER(aCoder, numberOfSteps);
+    ORK_ENCODE_DOUBLE(aCoder, cadence);
+    ORK_ENCODE_DOUBLE(aCoder, meanStrideDuration);
+    ORK_ENCODE_DOUBLE(aCoder, strideDurationVariability);
+    ORK_ENCODE_DOUBLE(aCoder, verticalAccelerationRMS);
+    ORK_ENCODE_DOUBLE(aCoder, horizontalAccelerationRMS);
+    ORK_ENCODE_DOUBLE(aCoder, duration);
+}
+
+- (instancetype)initWithCoder:(NSCoder *)aDecoder {
+    self = [super initWithCoder:aDecoder];
+    if (self) {
+        ORK_DECODE_INTEGER(aDecoder, numberOfSteps);
+        ORK_DECODE_DOUBLE(aDecoder, cadence);
+        ORK_DECODE_DOUBLE(aDecoder, meanStrideDuration);
+        ORK_DECODE_DOUBLE(aDecoder, strideDurationVariability);
+        ORK_DECODE_DOUBLE(aDecoder, verticalAccelerationRMS);
+        ORK_DECODE_DOUBLE(aDecoder, horizontalAccelerationRMS);
+        ORK_DECODE_DOUBLE(aDecoder, duration);
+    }
+    return self;
+}
+
++ (BOOL)supportsSecureCoding {
+    return YES;
+}
+
+- (BOOL)isEqual:(id)object {
+    BOOL isParentSame = [super isEqual:object];
+    
+    __typeof(self) castObject = object;
+    return (isParentSame &&
+            (self.numberOfSteps == castObject.numberOfSteps) &&
+            (self.cadence == castObject.cadence) &&
+            (self.meanStrideDuration == castObject.meanStrideDuration) &&
+            (self.strideDurationVariability == castObject.strideDurationVariability) &&
+            (self.verticalAccelerationRMS == castObject.verticalAccelerationRMS) &&
+            (self.horizontalAccelerationRMS == castObject.horizontalAccelerationRMS) &&
+            (self.duration == castObject.duration));
+}
+
+- (NSUInteger)hash {
+    return super.hash;
+}
+
+- (instancetype)copyWithZone:(NSZone *)zone {
+    ORKGaitSummaryResult *result = [super copyWithZone:zone];
+    result.numberOfSteps = self.numberOfSteps;
+    result.cadence = self.cadence;
+    result.meanStrideDuration = self.meanStrideDuration;
+    result.strideDurationVariability = self.strideDurationVariability;
+    result.verticalAccelerationRMS = self.verticalAccelerationRMS;
+    result.horizontalAccelerationRMS = self.horizontalAccelerationRMS;
+    result.duration = self.duration;
+    return result;
+}
+
+- (NSString *)descriptionWithNumberOfPaddingSpaces:(NSUInteger)numberOfPaddingSpaces {
+    return [NSString stringWithFormat:@"%@; steps: %@; cadence: %@; stride: %@ (cv %@); vertical: %@; sway: %@%@", [self descriptionPrefixWithNumberOfPaddingSpaces:numberOfPaddingSpaces], @(self.numberOfSteps), @(self.cadence), @(self.meanStrideDuration), @(self.strideDurationVariability), @(self.verticalAccelerationRMS), @(self.horizontalAccelerationRMS), self.descriptionSuffix];
+}
+
+@end
+
+
 @implementation ORKPSATSample
 
 + (BOOL)supportsSecureCoding {
@@ -2262,6 +2342,7 @@ static NSString *const RegionIdentifierKey = @"region.identifier";
     [super encodeWithCoder:aCoder];
     ORK_ENCODE_IMAGE(aCoder, signatureImage);
     ORK_ENCODE_OBJ(aCoder, signaturePath);
+    ORK_ENCODE_OBJ(aCoder, signatureStrokeData);
 }
 
 - (instancetype)initWithCoder:(NSCoder *)aDecoder {
@@ -2269,6 +2350,7 @@ static NSString *const RegionIdentifierKey = @"region.identifier";
     if (self) {
         ORK_DECODE_IMAGE(aDecoder, signatureImage);
         ORK_DECODE_OBJ_ARRAY(aDecoder, signaturePath, UIBezierPath);
+        ORK_DECODE_OBJ_CLASS(aDecoder, signatureStrokeData, NSData);
     }
     return self;
 }
@@ -2287,13 +2369,15 @@ static NSString *const RegionIdentifierKey = @"region.identifier";
     __typeof(self) castObject = object;
     return (isParentSame &&
             ORKEqualObjects(self.signatureImage, castObject.signatureImage) &&
-            ORKEqualObjects(self.signaturePath, castObject.signaturePath));
+            ORKEqualObjects(self.signaturePath, castObject.signaturePath) &&
+            ORKEqualObjects(self.signatureStrokeData, castObject.signatureStrokeData));
 }
 
 - (instancetype)copyWithZone:(NSZone *)zone {
     ORKSignatureResult *result = [super copyWithZone:zone];
     result->_signatureImage = [_signatureImage copy];
     result->_signaturePath = ORKArrayCopyObjects(_signaturePath);
+    result->_signatureStrokeData = [_signatureStrokeData copy];
     return result;
 }
 
@@ -208,6 +208,7 @@
 @property (nonatomic, strong) ORKConsentSigningView *signingView;
 @property (nonatomic, strong) ORKNavigationContainerView *continueSkipView;
 @property (nonatomic, strong) NSArray <UIBezierPath *> *originalPath;
+@property (nonatomic, copy) NSData *originalStrokeData;
 
 @end
 
@@ -221,6 +222,7 @@
             [[(ORKStepResult *)result results] enumerateObjectsUsingBlock:^(ORKResult * _Nonnull obj, NSUInteger idx, BOOL * _Nonnull stop) {
                 if ([obj isKindOfClass:[ORKSignatureResult class]]) {
                     _originalPath = [(ORKSignatureResult*)obj signaturePath];
+                    _originalStrokeData = [(ORKSignatureResult*)obj signatureStrokeData];
                     *stop = YES;
                 }
             }];
@@ -233,8 +235,12 @@
 - (void)viewWillAppear:(BOOL)animated {
     [super viewWillAppear:animated];
     
-    // set the original path and update state
-    self.signatureView.signaturePath = self.originalPath;
+    // set the original strokes, or the original path for results without them, and update state
+    if (self.originalStrokeData) {
+        self.signatureView.signatureStrokeData = self.originalStrokeData;
+    } else {
+        self.signatureView.signaturePath = self.originalPath;
+    }
     [self updateButtonStates];
 }
 
@@ -244,6 +250,7 @@
     if (self.signatureView.signatureExists) {
         ORKSignatureResult *sigResult = [[ORKSignatureResult alloc] initWithSignatureImage:self.signatureView.signatureImage
                                                                              signaturePath:self.signatureView.signaturePath];
+        sigResult.signatureStrokeData = self.signatureView.signatureStrokeData;
         parentResult.results = @[sigResult];
     }
     
@@ -65,6 +65,16 @@ NS_ASSUME_NONNULL_BEGIN
 @property (nonatomic, strong, nullable) UIGestureRecognizer *signatureGestureRecognizer;
 @property (nonatomic, copy, nullable) NSArray <UIBezierPath *> *signaturePath;
 
+/**
+ The strokes drawn in the view, in a compact vector form.
+ 
+ For each stroke, the data holds a 32-bit point count followed by that many points, each made of
+ three 32-bit floats: x, y, and line width, in points. All values are little-endian. Paths set
+ through `signaturePath` are not included.
+ */
+@property (nonatomic, copy, nullable) NSData *signatureStrokeData;
+
+/// Returns the signature drawn at a scale of 1, the size of the view in points (200 by 200 before layout).
 - (UIImage *)signatureImage;
 
 @property (nonatomic, readonly) BOOL signatureExists;
@@ -103,11 +103,36 @@ static const CGFloat DefaultLineWidth = 1;
 static const CGFloat DefaultLineWidthVariation = 3;
 static const CGFloat MaxPressureForStrokeVelocity = 9;
 static const CGFloat LineWidthStepValue = 0.25f;
+static const CGFloat DotRadius = 0.1;
+
+/// One sampled point of a stroke. Strokes are stored as packed runs of these.
+typedef struct {
+    float x;
+    float y;
+    float width;
+} ORKSignaturePoint;
+
+static CGPoint ORKSignaturePointLocation(ORKSignaturePoint point) {
+    return CGPointMake(point.x, point.y);
+}
+
+static CGPoint mmid_Point(CGPoint p1, CGPoint p2) {
+    return CGPointMake((p1.x + p2.x) * 0.5, (p1.y + p2.y) * 0.5);
+}
+
+/*
+ Segment `index` (at least 1) of a stroke is a quadratic curve through the midpoints on either side
+ of the previous point, which acts as the control point; the first segment starts at the first point.
+ */
+static void ORKSignatureSegmentGeometry(const ORKSignaturePoint *points, NSUInteger index, CGPoint *from, CGPoint *control, CGPoint *to) {
+    CGPoint previous = ORKSignaturePointLocation(points[index - 1]);
+    *from = (index == 1) ? previous : mmid_Point(ORKSignaturePointLocation(points[index - 2]), previous);
+    *control = previous;
+    *to = mmid_Point(previous, ORKSignaturePointLocation(points[index]));
+}
 
 @interface ORKSignatureView () <ORKSignatureGestureRecognizerDelegate> {
     CGPoint currentPoint;
-    CGPoint previousPoint1;
-    CGPoint previousPoint2;
     // Pressure scale based on if using force or speed of stroke.
     CGFloat minPressure;
     CGFloat maxPressure;
@@ -115,8 +140,11 @@ static const CGFloat LineWidthStepValue = 0.25f;
     NSTimeInterval previousTouchTime;
 }
 
-@property (nonatomic, strong) UIBezierPath *currentPath;
-@property (nonatomic, strong) NSMutableArray *pathArray;
+// Committed strokes, each a packed array of ORKSignaturePoint.
+@property (nonatomic, strong) NSMutableArray<NSData *> *strokes;
+@property (nonatomic, strong, nullable) NSMutableData *currentStroke;
+// Paths handed to -setSignaturePath: that are not backed by strokes, such as those from older results.
+@property (nonatomic, copy) NSArray<UIBezierPath *> *importedPaths;
 @property (nonatomic, strong) NSArray *backgroundLines;
 
 @end
@@ -125,6 +153,11 @@ static const CGFloat LineWidthStepValue = 0.25f;
 @implementation ORKSignatureView {
     NSLayoutConstraint *_heightConstraint;
     NSLayoutConstraint *_widthConstraint;
+    
+    // Everything signed so far, rasterized as it is drawn, so that redrawing costs the same however
+    // long the signature gets. Rebuilt from the strokes only when the size or color changes.
+    CGContextRef _backingContext;
+    CGFloat _backingScale;
 }
 
 + (void)initialize {
@@ -140,12 +173,18 @@ static const CGFloat LineWidthStepValue = 0.25f;
     if (self) {
         _lineWidth = DefaultLineWidth;
         _lineWidthVariation = DefaultLineWidthVariation;
+        _strokes = [NSMutableArray new];
+        _importedPaths = @[];
         [self makeSignatureGestureRecognizer];
         [self setUpConstraints];
     }
     return self;
 }
 
+- (void)dealloc {
+    CGContextRelease(_backingContext);
+}
+
 - (void)willMoveToWindow:(UIWindow *)newWindow {
     [super willMoveToWindow:newWindow];
     [self updateConstraintConstantsForWindow:newWindow];
@@ -187,12 +226,20 @@ static const CGFloat LineWidthStepValue = 0.25f;
 }
 
 - (void)setBounds:(CGRect)bounds {
+    BOOL sizeChanged = !CGSizeEqualToSize(bounds.size, self.bounds.size);
     [super setBounds:bounds];
+    if (sizeChanged) {
+        [self invalidateBackingContext];
+    }
     [self setNeedsDisplay];
 }
 
 - (void)setFrame:(CGRect)frame {
+    BOOL sizeChanged = !CGSizeEqualToSize(frame.size, self.frame.size);
     [super setFrame:frame];
+    if (sizeChanged) {
+        [self invalidateBackingContext];
+    }
     [self setNeedsDisplay];
 }
 
@@ -220,11 +267,10 @@ static const CGFloat LineWidthStepValue = 0.25f;
     return _lineColor;
 }
 
-- (NSMutableArray *)pathArray {
-    if (_pathArray == nil) {
-        _pathArray = [NSMutableArray new];
-    }
-    return _pathArray;
+- (void)setLineColor:(UIColor *)lineColor {
+    _lineColor = lineColor;
+    [self invalidateBackingContext];
+    [self setNeedsDisplay];
 }
 
 - (CGPoint)placeholderPoint {
@@ -257,6 +303,102 @@ static const CGFloat LineWidthStepValue = 0.25f;
     return _backgroundLines;
 }
 
+#pragma mark Rasterization
+
+- (void)invalidateBackingContext {
+    CGContextRelease(_backingContext);
+    _backingContext = NULL;
+}
+
+// Returns a transparent bitmap context of `size` points, flipped to match UIKit coordinates.
++ (CGContextRef)newStrokeContextWithSize:(CGSize)size scale:(CGFloat)scale {
+    size_t pixelWidth = (size_t)ceil(size.width * scale);
+    size_t pixelHeight = (size_t)ceil(size.height * scale);
+    if (pixelWidth == 0 || pixelHeight == 0) {
+        return NULL;
+    }
+    
+    CGColorSpaceRef colorSpace = CGColorSpaceCreateDeviceRGB();
+    CGContextRef context = CGBitmapContextCreate(NULL, pixelWidth, pixelHeight, 8, 0, colorSpace,
+                                                 kCGImageAlphaPremultipliedFirst | kCGBitmapByteOrder32Host);
+    CGColorSpaceRelease(colorSpace);
+    if (context) {
+        CGContextTranslateCTM(context, 0, pixelHeight);
+        CGContextScaleCTM(context, scale, -scale);
+        CGContextSetLineCap(context, kCGLineCapRound);
+        CGContextSetLineJoin(context, kCGLineJoinRound);
+    }
+    return context;
+}
+
+- (CGContextRef)backingContext {
+    if (!_backingContext) {
+        _backingScale = self.window.screen.scale ? : [UIScreen mainScreen].scale;
+        _backingContext = [[self class] newStrokeContextWithSize:self.bounds.size scale:_backingScale];
+        [self rasterizeSignatureInContext:_backingContext];
+    }
+    return _backingContext;
+}
+
+- (void)rasterizeSignatureInContext:(CGContextRef)context {
+    if (!context) {
+        return;
+    }
+    
+    CGContextSetStrokeColorWithColor(context, self.lineColor.CGColor);
+    for (UIBezierPath *path in _importedPaths) {
+        CGContextAddPath(context, path.CGPath);
+        CGContextSetLineWidth(context, path.lineWidth);
+        CGContextStrokePath(context);
+    }
+    
+    NSMutableArray<NSData *> *strokes = [_strokes mutableCopy];
+    if (_currentStroke) {
+        [strokes addObject:_currentStroke];
+    }
+    for (NSData *stroke in strokes) {
+        const ORKSignaturePoint *points = stroke.bytes;
+        NSUInteger count = stroke.length / sizeof(ORKSignaturePoint);
+        for (NSUInteger index = 0; index < count; index++) {
+            [self rasterizeSegmentAtIndex:index ofPoints:points inContext:context];
+        }
+    }
+}
+
+// Draws one segment of a stroke (the starting dot for index 0), and returns the area it covers.
+- (CGRect)rasterizeSegmentAtIndex:(NSUInteger)index ofPoints:(const ORKSignaturePoint *)points inContext:(CGContextRef)context {
+    CGFloat width = points[index].width;
+    CGRect bounds;
+    if (index == 0) {
+        CGPoint center = ORKSignaturePointLocation(points[0]);
+        CGContextAddArc(context, center.x, center.y, DotRadius, 0, 2.0 * M_PI, 0);
+        bounds = CGRectMake(center.x, center.y, 0, 0);
+    } else {
+        CGPoint from, control, to;
+        ORKSignatureSegmentGeometry(points, index, &from, &control, &to);
+        CGContextMoveToPoint(context, from.x, from.y);
+        CGContextAddQuadCurveToPoint(context, control.x, control.y, to.x, to.y);
+        bounds = CGContextGetPathBoundingBox(context);
+    }
+    CGContextSetLineWidth(context, width);
+    CGContextStrokePath(context);
+    return CGRectInset(bounds, -width * 2.0, -width * 2.0);
+}
+
+- (void)appendPointToCurrentStroke:(CGPoint)point lineWidth:(CGFloat)lineWidth {
+    ORKSignaturePoint signaturePoint = { (float)point.x, (float)point.y, (float)lineWidth };
+    [_currentStroke appendBytes:&signaturePoint length:sizeof(signaturePoint)];
+    
+    CGContextRef context = [self backingContext];
+    NSUInteger index = _currentStroke.length / sizeof(ORKSignaturePoint) - 1;
+    if (context) {
+        CGContextSetStrokeColorWithColor(context, self.lineColor.CGColor);
+        [self setNeedsDisplayInRect:[self rasterizeSegmentAtIndex:index ofPoints:_currentStroke.bytes inContext:context]];
+    } else {
+        [self setNeedsDisplay];
+    }
+}
+
 #pragma mark Touch Event Handlers
 
 - (BOOL)isForceTouchAvailable {
@@ -288,13 +430,12 @@ static const CGFloat LineWidthStepValue = 0.25f;
 - (void)gestureTouchesBegan:(NSSet *)touches withEvent:(UIEvent *)event {
     UITouch *touch = [touches anyObject];
     
-    self.currentPath = [self pathWithRoundedStyle];
+    // A cancelled stroke is already on screen, so keep it
+    [self commitCurrentStroke];
     
-    // Trigger full redraw - whether there's a path has changed
+    // Trigger full redraw - whether there's a stroke has changed
     [self setNeedsDisplay];
     
-    previousPoint1 = [touch previousLocationInView:self];
-    previousPoint2 = [touch previousLocationInView:self];
     currentPoint = [touch locationInView:self];
     
     if ([self isForceTouchAvailable] || [self isTouchTypeStylus:touch]) {
@@ -310,17 +451,15 @@ static const CGFloat LineWidthStepValue = 0.25f;
         previousTouchTime = touch.timestamp;
     }
     
-    [self.currentPath moveToPoint:currentPoint];
-    [self.currentPath addArcWithCenter:currentPoint radius:0.1 startAngle:0.0 endAngle:2.0 * M_PI clockwise:YES];
-    [self gestureTouchesMoved:touches withEvent:event];
-}
-
-static CGPoint mmid_Point(CGPoint p1, CGPoint p2) {
-    return CGPointMake((p1.x + p2.x) * 0.5, (p1.y + p2.y) * 0.5);
+    self.currentStroke = [NSMutableData data];
+    [self appendPointToCurrentStroke:currentPoint lineWidth:self.lineWidth];
 }
 
 - (void)gestureTouchesMoved:(NSSet *)touches withEvent:(UIEvent *)event {
     UITouch *touch = [touches anyObject];
+    if (!_currentStroke) {
+        return;
+    }
     
     CGPoint point = [touch locationInView:self];
     
@@ -358,69 +497,41 @@ static CGPoint mmid_Point(CGPoint p1, CGPoint p2) {
     pressure = MAX(minPressure, pressure);
     pressure = MIN(maxPressure, pressure);
     
-    CGFloat previousLineWidth = self.currentPath.lineWidth;
+    const ORKSignaturePoint *points = _currentStroke.bytes;
+    CGFloat previousLineWidth = points[_currentStroke.length / sizeof(ORKSignaturePoint) - 1].width;
     CGFloat proposedLineWidth = ((pressure - minPressure) *
                                  self.lineWidthVariation /
                                  (maxPressure - minPressure))
                                 + self.lineWidth;
     
     // Only step the line width up and down by a set value.
-    // This prevents the line looking jagged, and adding excessive
-    // separate line segments.
+    // This prevents the line looking jagged.
+    CGFloat lineWidth = previousLineWidth;
     if (ABS(previousLineWidth - proposedLineWidth) >= LineWidthStepValue) {
-        
-        CGFloat lineWidth = previousLineWidth;
-        
         if (proposedLineWidth > previousLineWidth) {
             lineWidth = previousLineWidth + LineWidthStepValue;
         }
         else if (proposedLineWidth < previousLineWidth) {
             lineWidth = previousLineWidth - LineWidthStepValue;
         }
-        
-        [self commitCurrentPath];
-        
-        self.currentPath = [self pathWithRoundedStyle];
-        self.currentPath.lineWidth = lineWidth;
-        
-        CGPoint previousMid2 = mmid_Point(currentPoint, previousPoint1);
-        [self.currentPath moveToPoint:previousMid2];
     }
     
-    previousPoint2 = previousPoint1;
-    previousPoint1 = [touch previousLocationInView:self];
-    currentPoint = [touch locationInView:self];
-    
-    CGPoint mid1 = mmid_Point(previousPoint1, previousPoint2);
-    CGPoint mid2 = mmid_Point(currentPoint, previousPoint1);
-    
-    UIBezierPath *subPath = [UIBezierPath bezierPath];
-    [subPath moveToPoint:mid1];
-    [subPath addQuadCurveToPoint:mid2 controlPoint:previousPoint1];
-    CGRect bounds = CGPathGetBoundingBox(subPath.CGPath);
-    
-    [self.currentPath addQuadCurveToPoint:mid2 controlPoint:previousPoint1];
-    
-    CGRect drawBox = bounds;
-    drawBox.origin.x -= self.currentPath.lineWidth * 2.0;
-    drawBox.origin.y -= self.currentPath.lineWidth * 2.0;
-    drawBox.size.width += self.currentPath.lineWidth * 4.0;
-    drawBox.size.height += self.currentPath.lineWidth * 4.0;
-    
-    [self setNeedsDisplayInRect:drawBox];
+    currentPoint = point;
+    [self appendPointToCurrentStroke:currentPoint lineWidth:lineWidth];
 }
 
 - (void)gestureTouchesEnded:(NSSet *)touches withEvent:(UIEvent *)event {
-    [self commitCurrentPath];
+    [self commitCurrentStroke];
 }
 
-- (void)commitCurrentPath {
-    CGRect rect = self.currentPath.bounds;
-    if (CGSizeEqualToSize(rect.size, CGSizeZero)) {
+- (void)commitCurrentStroke {
+    if (_currentStroke.length == 0) {
+        self.currentStroke = nil;
         return;
     }
     
-    [self.pathArray addObject:self.currentPath];
+    [self.strokes addObject:[_currentStroke copy]];
+    self.currentStroke = nil;
     
     [self.delegate signatureViewDidEditImage:self];
 }
@@ -434,60 +545,141 @@ static CGPoint mmid_Point(CGPoint p1, CGPoint p2) {
         [path stroke];
     }
     
-    if (![self signatureExists] && (!self.currentPath || [self.currentPath isEmpty])) {
+    if (![self signatureExists] && _currentStroke.length == 0) {
         [ORKLocalizedString(@"CONSENT_SIGNATURE_PLACEHOLDER", nil) drawAtPoint:[self placeholderPoint]
                                            withAttributes:@{ NSFontAttributeName: [ORKSelectionTitleLabel defaultFont],
                                                              NSForegroundColorAttributeName: [[UIColor blackColor] colorWithAlphaComponent:0.2]}];
     }
     
-    for (UIBezierPath *path in self.pathArray) {
-        [self.lineColor setStroke];
-        [path stroke];
+    CGContextRef backingContext = [self backingContext];
+    if (backingContext) {
+        CGImageRef strokesImage = CGBitmapContextCreateImage(backingContext);
+        [[UIImage imageWithCGImage:strokesImage scale:_backingScale orientation:UIImageOrientationUp] drawInRect:self.bounds];
+        CGImageRelease(strokesImage);
     }
-    
-    [self.lineColor setStroke];
-    [self.currentPath stroke];
 }
 
 - (NSArray <UIBezierPath *> *)signaturePath {
-    return [self.pathArray copy];
+    NSMutableArray<UIBezierPath *> *paths = [_importedPaths mutableCopy];
+    
+    // Consecutive segments of the same width share a path
+    for (NSData *stroke in _strokes) {
+        const ORKSignaturePoint *points = stroke.bytes;
+        NSUInteger count = stroke.length / sizeof(ORKSignaturePoint);
+        
+        UIBezierPath *path = [self pathWithRoundedStyle];
+        path.lineWidth = points[0].width;
+        CGPoint start = ORKSignaturePointLocation(points[0]);
+        [path moveToPoint:start];
+        [path addArcWithCenter:start radius:DotRadius startAngle:0.0 endAngle:2.0 * M_PI clockwise:YES];
+        
+        for (NSUInteger index = 1; index < count; index++) {
+            CGPoint from, control, to;
+            ORKSignatureSegmentGeometry(points, index, &from, &control, &to);
+            if (points[index].width != path.lineWidth) {
+                [paths addObject:path];
+                path = [self pathWithRoundedStyle];
+                path.lineWidth = points[index].width;
+                [path moveToPoint:from];
+            }
+            [path addQuadCurveToPoint:to controlPoint:control];
+        }
+        [paths addObject:path];
+    }
+    return [paths copy];
 }
 
 - (void)setSignaturePath:(NSArray<UIBezierPath *> *)signaturePath {
     if (signaturePath) {
-        _pathArray = [signaturePath mutableCopy];
+        [_strokes removeAllObjects];
+        self.currentStroke = nil;
+        self.importedPaths = signaturePath;
+        [self invalidateBackingContext];
         [self setNeedsDisplay];
     }
 }
 
-- (UIImage *)signatureImage {
-    CGSize imageContextSize;
-    imageContextSize = (self.bounds.size.width == 0 || self.bounds.size.height == 0) ? CGSizeMake(200, 200) :
-                        self.bounds.size;
-    UIGraphicsBeginImageContext(imageContextSize);
-
-    for (UIBezierPath *path in self.pathArray) {
-        [self.lineColor setStroke];
-        [path stroke];
+- (NSData *)signatureStrokeData {
+    if (_strokes.count == 0) {
+        return nil;
     }
     
-    UIImage *image = UIGraphicsGetImageFromCurrentImageContext();
-    UIGraphicsEndImageContext();
+    NSMutableData *data = [NSMutableData data];
+    for (NSData *stroke in _strokes) {
+        uint32_t count = CFSwapInt32HostToLittle((uint32_t)(stroke.length / sizeof(ORKSignaturePoint)));
+        [data appendBytes:&count length:sizeof(count)];
+        const uint32_t *words = stroke.bytes;
+        for (NSUInteger index = 0; index < stroke.length / sizeof(uint32_t); index++) {
+            uint32_t word = CFSwapInt32HostToLittle(words[index]);
+            [data appendBytes:&word length:sizeof(word)];
+        }
+    }
+    return [data copy];
+}
+
+- (void)setSignatureStrokeData:(NSData *)signatureStrokeData {
+    NSMutableArray<NSData *> *strokes = [NSMutableArray new];
+    const uint8_t *bytes = signatureStrokeData.bytes;
+    NSUInteger length = signatureStrokeData.length;
+    NSUInteger offset = 0;
+    while (offset + sizeof(uint32_t) <= length) {
+        uint32_t count;
+        memcpy(&count, bytes + offset, sizeof(count));
+        count = CFSwapInt32LittleToHost(count);
+        offset += sizeof(count);
+        
+        NSUInteger strokeLength = count * sizeof(ORKSignaturePoint);
+        if (count == 0 || strokeLength > length - offset) {
+            ORK_Log_Warning(@"Ignoring malformed signature stroke data");
+            strokes = nil;
+            break;
+        }
+        NSMutableData *stroke = [NSMutableData dataWithBytes:bytes + offset length:strokeLength];
+        uint32_t *words = stroke.mutableBytes;
+        for (NSUInteger index = 0; index < strokeLength / sizeof(uint32_t); index++) {
+            words[index] = CFSwapInt32LittleToHost(words[index]);
+        }
+        [strokes addObject:stroke];
+        offset += strokeLength;
+    }
+    if (!strokes) {
+        return;
+    }
     
+    _strokes = strokes;
+    self.currentStroke = nil;
+    self.importedPaths = @[];
+    [self invalidateBackingContext];
+    [self setNeedsDisplay];
+}
+
+- (UIImage *)signatureImage {
+    // Exported at 1x, whatever the screen scale, so the image stored in results keeps its size.
+    // The strokes are redrawn for it rather than copied from the backing context.
+    CGSize size = (self.bounds.size.width == 0 || self.bounds.size.height == 0) ? CGSizeMake(200, 200) : self.bounds.size;
+    CGContextRef context = [[self class] newStrokeContextWithSize:size scale:1];
+    if (!context) {
+        return nil;
+    }
+    [self rasterizeSignatureInContext:context];
+    
+    CGImageRef strokesImage = CGBitmapContextCreateImage(context);
+    UIImage *image = [UIImage imageWithCGImage:strokesImage scale:1 orientation:UIImageOrientationUp];
+    CGImageRelease(strokesImage);
+    CGContextRelease(context);
     return image;
 }
 
 - (BOOL)signatureExists {
-    return self.pathArray.count > 0;
+    return self.strokes.count > 0 || self.importedPaths.count > 0;
 }
 
 - (void)clear {
-    if (self.pathArray.count > 0) {
-        if (self.currentPath != nil) {
-            self.currentPath = [self pathWithRoundedStyle];
-        }
-        
-        [self.pathArray removeAllObjects];
+    if ([self signatureExists]) {
+        self.currentStroke = nil;
+        [self.strokes removeAllObjects];
+        self.importedPaths = @[];
+        [self invalidateBackingContext];
         [self setNeedsDisplayInRect:self.bounds];
     }
 }
@@ -42,6 +42,23 @@ NS_ASSUME_NONNULL_BEGIN
 @class ORKConsentSignatureFormatter;
 @class ORKHTMLPDFWriter;
 
+/**
+ Values that identify how `makePDFWithCompletionHandler:` produces the consent PDF.
+ */
+typedef NS_ENUM(NSInteger, ORKConsentDocumentPDFBackend) {
+    /// The document is rendered as HTML in a web view, then printed page by page.
+    ORKConsentDocumentPDFBackendHTML = 0,
+    
+    /**
+     The sections and signatures are typeset straight into a PDF context, without a web view.
+     
+     This is much faster and uses much less memory. Section `htmlContent` is converted to
+     attributed text, so only basic formatting is kept. Documents that provide
+     `htmlReviewContent` are still rendered with the HTML backend.
+     */
+    ORKConsentDocumentPDFBackendNative
+} ORK_ENUM_AVAILABLE;
+
 /**
  The `ORKConsentDocument` class represents the content of an informed consent
  document, which is a document that's used to obtain informed consent from participants
@@ -147,6 +164,13 @@ ORK_CLASS_AVAILABLE
 
 /// @name PDF generation
 
+/**
+ The backend used to generate the PDF file.
+ 
+ The default value is `ORKConsentDocumentPDFBackendHTML`.
+ */
+@property (nonatomic) ORKConsentDocumentPDFBackend PDFBackend;
+
 /**
  Initializer with ORKHTMLPDFWriter parameter. Allows for injecting mock dependency for the
  purposes of isolated unit testing.
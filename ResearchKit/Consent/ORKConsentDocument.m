@@ -36,6 +36,7 @@
 #import "ORKHeadlineLabel.h"
 #import "ORKSubheadlineLabel.h"
 
+#import "ORKConsentPDFRenderer.h"
 #import "ORKConsentSection_Private.h"
 #import "ORKConsentSectionFormatter.h"
 #import "ORKConsentSignature.h"
@@ -46,8 +47,48 @@
 #import "ORKErrors.h"
 
 
+/// A rendered section or signature, with the properties it was rendered from.
+@interface ORKConsentHTMLFragment : NSObject
+
+@property (nonatomic, copy) NSArray *inputs;
+@property (nonatomic, copy) NSString *HTML;
+
+@end
+
+
+@implementation ORKConsentHTMLFragment
+
+@end
+
+
+static id ORKNullIfNil(id object) {
+    return object ? : [NSNull null];
+}
+
+static NSArray *ORKConsentSectionHTMLInputs(ORKConsentSection *section) {
+    return @[ORKNullIfNil(section.formalTitle),
+             ORKNullIfNil(section.title),
+             ORKNullIfNil(section.htmlContent),
+             ORKNullIfNil(section.content)];
+}
+
+static NSArray *ORKConsentSignatureHTMLInputs(ORKConsentSignature *signature) {
+    return @[ORKNullIfNil(signature.title),
+             ORKNullIfNil(signature.givenName),
+             ORKNullIfNil(signature.familyName),
+             ORKNullIfNil(signature.signatureImage),
+             ORKNullIfNil(signature.signatureDate),
+             @(signature.requiresName),
+             @(signature.requiresSignatureImage)];
+}
+
+
 @implementation ORKConsentDocument {
     NSMutableArray<ORKConsentSignature *> *_signatures;
+    
+    // Rendered sections and signatures, keyed by object. A fragment is reused for as long as the
+    // properties it was rendered from are unchanged; unchanged copy properties compare by pointer.
+    NSMapTable<id, ORKConsentHTMLFragment *> *_fragmentCache;
 }
 
 #pragma mark - Initializers
@@ -79,6 +120,16 @@
     return [_signatures copy];
 }
 
+- (void)setSectionFormatter:(ORKConsentSectionFormatter *)sectionFormatter {
+    _sectionFormatter = sectionFormatter;
+    [_fragmentCache removeAllObjects];
+}
+
+- (void)setSignatureFormatter:(ORKConsentSignatureFormatter *)signatureFormatter {
+    _signatureFormatter = signatureFormatter;
+    [_fragmentCache removeAllObjects];
+}
+
 #pragma mark - Public
 
 - (void)addSignature:(ORKConsentSignature *)signature {
@@ -89,6 +140,14 @@
 }
 
 - (void)makePDFWithCompletionHandler:(void (^)(NSData *data, NSError *error))completionBlock {
+    if (_PDFBackend == ORKConsentDocumentPDFBackendNative && !_htmlReviewContent) {
+        if (!_renderer) {
+            _renderer = [[ORKConsentPDFRenderer alloc] init];
+        }
+        [_renderer writePDFForDocument:self withCompletionBlock:completionBlock];
+        return;
+    }
+    
     [_writer writePDFFromHTML:[self htmlForMobile:NO withTitle:nil detail:nil]
           withCompletionBlock:^(NSData *data, NSError *error) {
         if (error) {
@@ -107,6 +166,37 @@
     return [self htmlForMobile:YES withTitle:title detail:detail];
 }
 
+- (NSString *)HTMLForObject:(id)object inputs:(NSArray *)inputs render:(NSString *(^)(void))render {
+    if (!_fragmentCache) {
+        // Sections and signatures are mutable, so key by pointer rather than by hash.
+        _fragmentCache = [[NSMapTable alloc] initWithKeyOptions:(NSPointerFunctionsWeakMemory | NSPointerFunctionsObjectPointerPersonality)
+                                                   valueOptions:NSPointerFunctionsStrongMemory
+                                                       capacity:0];
+    }
+    ORKConsentHTMLFragment *fragment = [_fragmentCache objectForKey:object];
+    if (!fragment || ![fragment.inputs isEqualToArray:inputs]) {
+        fragment = [ORKConsentHTMLFragment new];
+        fragment.inputs = inputs;
+        fragment.HTML = render() ? : @"";
+        [_fragmentCache setObject:fragment forKey:object];
+    }
+    return fragment.HTML;
+}
+
+- (NSString *)HTMLForSection:(ORKConsentSection *)section {
+    ORKConsentSectionFormatter *formatter = _sectionFormatter;
+    return [self HTMLForObject:section inputs:ORKConsentSectionHTMLInputs(section) render:^NSString *{
+        return [formatter HTMLForSection:section];
+    }];
+}
+
+- (NSString *)HTMLForSignature:(ORKConsentSignature *)signature {
+    ORKConsentSignatureFormatter *formatter = _signatureFormatter;
+    return [self HTMLForObject:signature inputs:ORKConsentSignatureHTMLInputs(signature) render:^NSString *{
+        return [formatter HTMLForSignature:signature];
+    }];
+}
+
 + (NSString *)cssStyleSheet:(BOOL)mobile {
     NSMutableString *css = [@"@media print { .pagebreak { page-break-before: always; } }\n" mutableCopy];
     if (mobile) {
@@ -169,7 +259,7 @@
     NSMutableString *body = [NSMutableString new];
     
     // header
-    [body appendFormat:@"<div class='header'>"];
+    [body appendString:@"<div class='header'>"];
     if (title) {
         [body appendFormat:@"<h1>%@</h1>", title];
     }
@@ -177,7 +267,7 @@
     if (detail) {
         [body appendFormat:@"<p>%@</p>", detail];
     }
-    [body appendFormat:@"</div>"];
+    [body appendString:@"</div>"];
     
     if (_htmlReviewContent) {
         [body appendString:_htmlReviewContent];
@@ -189,7 +279,7 @@
         // scenes
         for (ORKConsentSection *section in _sections) {
             if (!section.omitFromDocument) {
-                [body appendFormat:@"%@", [_sectionFormatter HTMLForSection:section]];
+                [body appendString:[self HTMLForSection:section]];
             }
         }
         
@@ -198,8 +288,8 @@
             [body appendFormat:@"<h4 class=\"pagebreak\">%@</h4>", _signaturePageTitle ? : @""];
             [body appendFormat:@"<p>%@</p>", _signaturePageContent ? : @""];
             
-            for (ORKConsentSignature *signature in self.signatures) {
-                [body appendFormat:@"%@", [_signatureFormatter HTMLForSignature:signature]];
+            for (ORKConsentSignature *signature in _signatures) {
+                [body appendString:[self HTMLForSignature:signature]];
             }
         }
     }
@@ -218,6 +308,7 @@
         NSArray *signatures = (NSArray *)[aDecoder decodeObjectOfClass:[NSArray class] forKey:@"signatures"];
         _signatures = [signatures mutableCopy];
         ORK_DECODE_OBJ_ARRAY(aDecoder, sections, ORKConsentSection);
+        ORK_DECODE_INTEGER(aDecoder, PDFBackend);
     }
     return self;
 }
@@ -229,6 +320,7 @@
     ORK_ENCODE_OBJ(aCoder, signatures);
     ORK_ENCODE_OBJ(aCoder, htmlReviewContent);
     ORK_ENCODE_OBJ(aCoder, sections);
+    ORK_ENCODE_INTEGER(aCoder, PDFBackend);
 }
 
 + (BOOL)supportsSecureCoding {
@@ -243,6 +335,7 @@
     doc.signaturePageTitle = _signaturePageTitle;
     doc.signaturePageContent = _signaturePageContent;
     doc.htmlReviewContent = _htmlReviewContent;
+    doc.PDFBackend = _PDFBackend;
     
     // Deep copy the signatures
     doc.signatures = ORKArrayCopyObjects(_signatures);
@@ -266,7 +359,8 @@
             && ORKEqualObjects(self.signaturePageContent, castObject.signaturePageContent)
             && ORKEqualObjects(self.htmlReviewContent, castObject.htmlReviewContent)
             && ORKEqualObjects(self.signatures, castObject.signatures)
-            && ORKEqualObjects(self.sections, castObject.sections));
+            && ORKEqualObjects(self.sections, castObject.sections)
+            && (self.PDFBackend == castObject.PDFBackend));
 }
 
 - (NSUInteger)hash {
@@ -36,12 +36,14 @@
 NS_ASSUME_NONNULL_BEGIN
 
 @class ORKHTMLPDFWriter;
+@class ORKConsentPDFRenderer;
 @class ORKConsentSectionFormatter;
 @class ORKConsentSignatureFormatter;
 
 @interface ORKConsentDocument ()
 
 @property (nonatomic, strong, nullable) ORKHTMLPDFWriter *writer;
+@property (nonatomic, strong, nullable) ORKConsentPDFRenderer *renderer;
 @property (nonatomic, strong, nullable) ORKConsentSectionFormatter *sectionFormatter;
 @property (nonatomic, strong, nullable) ORKConsentSignatureFormatter *signatureFormatter;
 
@@ -0,0 +1,391 @@
+/*
+ Copyright (c) 2016, Apple Inc. All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+ 
+ 1.  Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ 2.  Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation and/or
+ other materials provided with the distribution.
+ 
+ 3.  Neither the name of the copyright holder(s) nor the names of any contributors
+ may be used to endorse or promote products derived from this software without
+ specific prior written permission. No license is granted to the trademarks of
+ the copyright holders even if such marks are included in this software.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#import "ORKConsentPDFRenderer.h"
+
+#import "ORKConsentDocument.h"
+#import "ORKConsentSection.h"
+#import "ORKConsentSignature.h"
+#import "ORKHTMLPDFWriter.h"
+
+#import "ORKHelpers_Internal.h"
+
+
+static const CGFloat HeaderHeight = 25.0;
+static const CGFloat FooterHeight = 25.0;
+static const CGFloat PageEdge = 72.0 / 4;
+
+static const CGFloat BodyFontSize = 12.0;
+static const CGFloat TitleFontSize = 16.0;
+static const CGFloat SignatureBoxHeight = 100.0;
+static const CGFloat SignatureColumnSpacing = 20.0;
+static const CGFloat SignatureRowSpacing = 24.0;
+
+typedef void (^ORKConsentPDFDrawingBlock)(void);
+
+
+/// One printed name, signature image, or date, above a rule and a caption.
+@interface ORKConsentPDFSignatureElement : NSObject
+
+@property (nonatomic, strong, nullable) id value;
+@property (nonatomic, copy) NSString *caption;
+
+@end
+
+
+@implementation ORKConsentPDFSignatureElement
+
+@end
+
+
+@implementation ORKConsentPDFRenderer
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        _pageSize = [ORKHTMLPDFWriter defaultPageSize];
+        _pageMargins = UIEdgeInsetsMake(PageEdge, PageEdge, PageEdge, PageEdge);
+    }
+    return self;
+}
+
+- (void)writePDFForDocument:(ORKConsentDocument *)document withCompletionBlock:(void (^)(NSData *data, NSError *error))completionBlock {
+    NSParameterAssert(completionBlock);
+    
+    // Capture everything that reads the document, or needs the main thread, up front.
+    NSError *error = nil;
+    NSAttributedString *body = [self bodyForDocument:document error:&error];
+    if (!body) {
+        dispatch_async(dispatch_get_main_queue(), ^{
+            completionBlock(nil, error);
+        });
+        return;
+    }
+    NSAttributedString *signaturePage = [self signaturePageForDocument:document];
+    NSMutableArray<NSArray<ORKConsentPDFSignatureElement *> *> *signatureRows = [NSMutableArray array];
+    for (ORKConsentSignature *signature in document.signatures) {
+        [signatureRows addObject:[[self class] elementsForSignature:signature]];
+    }
+    
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
+        NSData *data = [self PDFDataWithBody:body signaturePage:signaturePage signatureRows:signatureRows];
+        dispatch_async(dispatch_get_main_queue(), ^{
+            completionBlock(data, nil);
+        });
+    });
+}
+
+#pragma mark - Content
+
++ (UIFont *)fontWithSize:(CGFloat)size bold:(BOOL)bold {
+    return [UIFont fontWithName:(bold ? @"Helvetica-Bold" : @"Helvetica") size:size];
+}
+
+- (NSDictionary<NSString *, id> *)attributesWithFontSize:(CGFloat)size bold:(BOOL)bold alignment:(NSTextAlignment)alignment spacingBefore:(CGFloat)spacingBefore {
+    NSMutableParagraphStyle *paragraphStyle = [[NSMutableParagraphStyle alloc] init];
+    paragraphStyle.alignment = alignment;
+    paragraphStyle.paragraphSpacingBefore = spacingBefore;
+    paragraphStyle.paragraphSpacing = size / 2;
+    return @{ NSFontAttributeName: [[self class] fontWithSize:size bold:bold],
+              NSForegroundColorAttributeName: [UIColor blackColor],
+              NSParagraphStyleAttributeName: paragraphStyle };
+}
+
+- (void)appendParagraph:(NSString *)text attributes:(NSDictionary<NSString *, id> *)attributes toString:(NSMutableAttributedString *)string {
+    [string appendAttributedString:[[NSAttributedString alloc] initWithString:[text stringByAppendingString:@"\n"] attributes:attributes]];
+}
+
+- (NSAttributedString *)attributedStringWithHTML:(NSString *)html error:(NSError **)error {
+    NSString *styledHTML = [NSString stringWithFormat:@"<style>body { font-family: Helvetica; font-size: %.0lfpx; }</style>%@", BodyFontSize, html];
+    NSMutableAttributedString *string = [[NSMutableAttributedString alloc] initWithData:[styledHTML dataUsingEncoding:NSUTF8StringEncoding]
+                                                                                 options:@{ NSDocumentTypeDocumentAttribute: NSHTMLTextDocumentType,
+                                                                                            NSCharacterEncodingDocumentAttribute: @(NSUTF8StringEncoding) }
+                                                                      documentAttributes:nil
+                                                                                   error:error];
+    if (string && ![string.string hasSuffix:@"\n"]) {
+        [string appendAttributedString:[[NSAttributedString alloc] initWithString:@"\n"]];
+    }
+    return string;
+}
+
+- (NSAttributedString *)bodyForDocument:(ORKConsentDocument *)document error:(NSError **)error {
+    NSMutableAttributedString *body = [[NSMutableAttributedString alloc] init];
+    NSDictionary *headingAttributes = [self attributesWithFontSize:BodyFontSize bold:YES alignment:NSTextAlignmentNatural spacingBefore:BodyFontSize];
+    NSDictionary *textAttributes = [self attributesWithFontSize:BodyFontSize bold:NO alignment:NSTextAlignmentNatural spacingBefore:0];
+    
+    if (document.title.length > 0) {
+        [self appendParagraph:document.title
+                   attributes:[self attributesWithFontSize:TitleFontSize bold:YES alignment:NSTextAlignmentNatural spacingBefore:0]
+                     toString:body];
+    }
+    
+    for (ORKConsentSection *section in document.sections) {
+        if (section.omitFromDocument) {
+            continue;
+        }
+        [self appendParagraph:(section.formalTitle ? : (section.title ? : @"")) attributes:headingAttributes toString:body];
+        if (section.htmlContent) {
+            NSAttributedString *content = [self attributedStringWithHTML:section.htmlContent error:error];
+            if (!content) {
+                return nil;
+            }
+            [body appendAttributedString:content];
+        } else if (section.content) {
+            [self appendParagraph:section.content attributes:textAttributes toString:body];
+        }
+    }
+    return [body copy];
+}
+
+- (NSAttributedString *)signaturePageForDocument:(ORKConsentDocument *)document {
+    NSMutableAttributedString *page = [[NSMutableAttributedString alloc] init];
+    [self appendParagraph:(document.signaturePageTitle ? : @"")
+               attributes:[self attributesWithFontSize:BodyFontSize bold:YES alignment:NSTextAlignmentNatural spacingBefore:0]
+                 toString:page];
+    [self appendParagraph:(document.signaturePageContent ? : @"")
+               attributes:[self attributesWithFontSize:BodyFontSize bold:NO alignment:NSTextAlignmentNatural spacingBefore:0]
+                 toString:page];
+    return [page copy];
+}
+
+// Matches the elements that ORKConsentSignatureFormatter lays out for the HTML backend.
++ (NSArray<ORKConsentPDFSignatureElement *> *)elementsForSignature:(ORKConsentSignature *)signature {
+    if (signature.title == nil) {
+        @throw [NSException exceptionWithName:NSObjectNotAvailableException reason:@"Signature title is missing" userInfo:nil];
+    }
+    
+    NSMutableArray<ORKConsentPDFSignatureElement *> *elements = [NSMutableArray array];
+    if (signature.requiresName || signature.familyName || signature.givenName) {
+        NSMutableArray *names = [NSMutableArray array];
+        if (signature.givenName) {
+            [names addObject:signature.givenName];
+        }
+        if (signature.familyName) {
+            [names addObject:signature.familyName];
+        }
+        if (ORKCurrentLocalePresentsFamilyNameFirst()) {
+            names = [[[names reverseObjectEnumerator] allObjects] mutableCopy];
+        }
+        ORKConsentPDFSignatureElement *element = [ORKConsentPDFSignatureElement new];
+        element.value = names.count > 0 ? [names componentsJoinedByString:@" "] : nil;
+        element.caption = [NSString stringWithFormat:ORKLocalizedString(@"CONSENT_DOC_LINE_PRINTED_NAME", nil), signature.title];
+        [elements addObject:element];
+    }
+    
+    if (signature.requiresSignatureImage || signature.signatureImage) {
+        ORKConsentPDFSignatureElement *element = [ORKConsentPDFSignatureElement new];
+        element.value = signature.signatureImage;
+        element.caption = [NSString stringWithFormat:ORKLocalizedString(@"CONSENT_DOC_LINE_SIGNATURE", nil), signature.title];
+        [elements addObject:element];
+    }
+    
+    if (elements.count > 0) {
+        ORKConsentPDFSignatureElement *element = [ORKConsentPDFSignatureElement new];
+        element.value = signature.signatureDate;
+        element.caption = ORKLocalizedString(@"CONSENT_DOC_LINE_DATE", nil);
+        [elements addObject:element];
+    }
+    return [elements copy];
+}
+
+#pragma mark - Layout
+
+- (CGRect)paperRect {
+    return (CGRect){CGPointZero, _pageSize};
+}
+
+- (CGRect)printableRect {
+    return UIEdgeInsetsInsetRect([self paperRect], _pageMargins);
+}
+
+- (CGRect)contentRect {
+    return UIEdgeInsetsInsetRect([self printableRect], UIEdgeInsetsMake(HeaderHeight, 0, FooterHeight, 0));
+}
+
+/*
+ Flows `text` into the pages, starting at `*y` on the last page and adding pages as it runs over.
+ On return, `*y` is just below the text. Text storages are added to `storages`, because layout
+ managers do not retain them and they have to outlive the drawing blocks.
+ */
+- (void)layoutText:(NSAttributedString *)text
+           inPages:(NSMutableArray<NSMutableArray<ORKConsentPDFDrawingBlock> *> *)pages
+                 y:(CGFloat *)y
+          storages:(NSMutableArray<NSTextStorage *> *)storages {
+    if (text.length == 0) {
+        return;
+    }
+    
+    CGRect contentRect = [self contentRect];
+    NSTextStorage *storage = [[NSTextStorage alloc] initWithAttributedString:text];
+    NSLayoutManager *layoutManager = [[NSLayoutManager alloc] init];
+    [storage addLayoutManager:layoutManager];
+    [storages addObject:storage];
+    
+    NSUInteger glyphCount = layoutManager.numberOfGlyphs;
+    NSUInteger laidOutGlyphCount = 0;
+    while (laidOutGlyphCount < glyphCount) {
+        BOOL freshPage = (*y <= CGRectGetMinY(contentRect));
+        NSTextContainer *container = [[NSTextContainer alloc] initWithSize:CGSizeMake(CGRectGetWidth(contentRect), CGRectGetMaxY(contentRect) - *y)];
+        container.lineFragmentPadding = 0;
+        [layoutManager addTextContainer:container];
+        
+        NSRange glyphRange = [layoutManager glyphRangeForTextContainer:container];
+        if (glyphRange.length == 0) {
+            [layoutManager removeTextContainerAtIndex:layoutManager.textContainers.count - 1];
+            if (freshPage) {
+                // Nothing fits even on an empty page; drop the remainder rather than loop forever.
+                ORK_Log_Warning(@"Consent PDF content does not fit on a page");
+                break;
+            }
+        } else {
+            CGPoint origin = CGPointMake(CGRectGetMinX(contentRect), *y);
+            [pages.lastObject addObject:^{
+                [layoutManager drawBackgroundForGlyphRange:glyphRange atPoint:origin];
+                [layoutManager drawGlyphsForGlyphRange:glyphRange atPoint:origin];
+            }];
+            laidOutGlyphCount = NSMaxRange(glyphRange);
+            *y += CGRectGetMaxY([layoutManager usedRectForTextContainer:container]);
+            if (laidOutGlyphCount >= glyphCount) {
+                break;
+            }
+        }
+        [pages addObject:[NSMutableArray array]];
+        *y = CGRectGetMinY(contentRect);
+    }
+}
+
+- (void)layoutSignatureRow:(NSArray<ORKConsentPDFSignatureElement *> *)elements
+                   inPages:(NSMutableArray<NSMutableArray<ORKConsentPDFDrawingBlock> *> *)pages
+                         y:(CGFloat *)y {
+    if (elements.count == 0) {
+        return;
+    }
+    
+    CGRect contentRect = [self contentRect];
+    UIFont *captionFont = [[self class] fontWithSize:BodyFontSize - 2 bold:NO];
+    CGFloat rowHeight = SignatureBoxHeight + ceil(captionFont.lineHeight) + 2;
+    if (*y + rowHeight > CGRectGetMaxY(contentRect) && *y > CGRectGetMinY(contentRect)) {
+        [pages addObject:[NSMutableArray array]];
+        *y = CGRectGetMinY(contentRect);
+    }
+    
+    // Three columns, as in the HTML backend's signature grid.
+    CGFloat columnWidth = (CGRectGetWidth(contentRect) - 2 * SignatureColumnSpacing) / 3;
+    CGFloat top = *y;
+    NSDictionary *valueAttributes = @{ NSFontAttributeName: [[self class] fontWithSize:BodyFontSize bold:NO],
+                                       NSForegroundColorAttributeName: [UIColor blackColor] };
+    NSDictionary *captionAttributes = @{ NSFontAttributeName: captionFont,
+                                         NSForegroundColorAttributeName: [UIColor blackColor] };
+    
+    [elements enumerateObjectsUsingBlock:^(ORKConsentPDFSignatureElement *element, NSUInteger idx, BOOL *stop) {
+        CGRect box = CGRectMake(CGRectGetMinX(contentRect) + idx * (columnWidth + SignatureColumnSpacing), top, columnWidth, SignatureBoxHeight);
+        [pages.lastObject addObject:^{
+            UIImage *image = ORKDynamicCast(element.value, UIImage);
+            NSString *string = ORKDynamicCast(element.value, NSString);
+            if (image && image.size.width > 0 && image.size.height > 0) {
+                // Aspect fit, resting on the rule.
+                CGFloat scale = MIN(CGRectGetWidth(box) / image.size.width, (CGRectGetHeight(box) - 2) / image.size.height);
+                CGSize size = CGSizeMake(image.size.width * scale, image.size.height * scale);
+                [image drawInRect:CGRectMake(CGRectGetMinX(box), CGRectGetMaxY(box) - 2 - size.height, size.width, size.height)];
+            } else if (string.length > 0) {
+                CGRect textRect = [string boundingRectWithSize:CGSizeMake(CGRectGetWidth(box), CGRectGetHeight(box))
+                                                       options:NSStringDrawingUsesLineFragmentOrigin
+                                                    attributes:valueAttributes
+                                                       context:nil];
+                [string drawWithRect:CGRectMake(CGRectGetMinX(box), CGRectGetMaxY(box) - 4 - ceil(CGRectGetHeight(textRect)), CGRectGetWidth(box), ceil(CGRectGetHeight(textRect)))
+                             options:NSStringDrawingUsesLineFragmentOrigin
+                          attributes:valueAttributes
+                             context:nil];
+            }
+            
+            UIBezierPath *rule = [UIBezierPath bezierPath];
+            [rule moveToPoint:CGPointMake(CGRectGetMinX(box), CGRectGetMaxY(box))];
+            [rule addLineToPoint:CGPointMake(CGRectGetMaxX(box), CGRectGetMaxY(box))];
+            rule.lineWidth = 1;
+            [[UIColor blackColor] setStroke];
+            [rule stroke];
+            
+            [element.caption drawWithRect:CGRectMake(CGRectGetMinX(box), CGRectGetMaxY(box) + 2, CGRectGetWidth(box), ceil(captionFont.lineHeight))
+                                  options:NSStringDrawingUsesLineFragmentOrigin | NSStringDrawingTruncatesLastVisibleLine
+                               attributes:captionAttributes
+                                  context:nil];
+        }];
+    }];
+    *y += rowHeight + SignatureRowSpacing;
+}
+
+#pragma mark - Drawing
+
+- (NSData *)PDFDataWithBody:(NSAttributedString *)body
+              signaturePage:(NSAttributedString *)signaturePage
+              signatureRows:(NSArray<NSArray<ORKConsentPDFSignatureElement *> *> *)signatureRows {
+    NSMutableArray<NSMutableArray<ORKConsentPDFDrawingBlock> *> *pages = [NSMutableArray arrayWithObject:[NSMutableArray array]];
+    NSMutableArray<NSTextStorage *> *storages = [NSMutableArray array];
+    CGFloat y = CGRectGetMinY([self contentRect]);
+    
+    [self layoutText:body inPages:pages y:&y storages:storages];
+    
+    // The signature page always starts on a page of its own.
+    if (pages.lastObject.count > 0) {
+        [pages addObject:[NSMutableArray array]];
+        y = CGRectGetMinY([self contentRect]);
+    }
+    [self layoutText:signaturePage inPages:pages y:&y storages:storages];
+    for (NSArray<ORKConsentPDFSignatureElement *> *row in signatureRows) {
+        [self layoutSignatureRow:row inPages:pages y:&y];
+    }
+    
+    NSMutableData *data = [NSMutableData data];
+    UIGraphicsBeginPDFContextToData(data, [self paperRect], @{});
+    [pages enumerateObjectsUsingBlock:^(NSArray<ORKConsentPDFDrawingBlock> *page, NSUInteger idx, BOOL *stop) {
+        UIGraphicsBeginPDFPage();
+        for (ORKConsentPDFDrawingBlock block in page) {
+            block();
+        }
+        [self drawFooterForPageAtIndex:idx numberOfPages:pages.count];
+    }];
+    UIGraphicsEndPDFContext();
+    
+    return [data copy];
+}
+
+- (void)drawFooterForPageAtIndex:(NSInteger)pageIndex numberOfPages:(NSInteger)numberOfPages {
+    NSString *footer = [NSString stringWithFormat:ORKLocalizedString(@"CONSENT_PAGE_NUMBER_FORMAT", nil), (long)(pageIndex + 1), (long)numberOfPages];
+    CGRect printableRect = [self printableRect];
+    CGRect footerRect = CGRectMake(CGRectGetMinX(printableRect), CGRectGetMaxY(printableRect) - FooterHeight, CGRectGetWidth(printableRect), FooterHeight);
+    
+    NSDictionary *attributes = @{ NSFontAttributeName: [UIFont fontWithName:@"Helvetica" size:12] };
+    CGSize size = [footer sizeWithAttributes:attributes];
+    CGPoint drawPoint = CGPointMake(CGRectGetMidX(footerRect) - (size.width / 2), CGRectGetMidY(footerRect) - (size.height / 2));
+    [footer drawAtPoint:drawPoint withAttributes:attributes];
+}
+
+@end
@@ -37,7 +37,26 @@
 #import "ORKHelpers_Internal.h"
 
 
-@implementation ORKConsentSignatureFormatter
+@implementation ORKConsentSignatureFormatter {
+    // Signature images are immutable, so each one is PNG-encoded at most once.
+    NSMapTable<UIImage *, NSString *> *_base64ImageCache;
+}
+
+- (NSString *)base64PNGForImage:(UIImage *)image {
+    if (!_base64ImageCache) {
+        _base64ImageCache = [[NSMapTable alloc] initWithKeyOptions:(NSPointerFunctionsWeakMemory | NSPointerFunctionsObjectPointerPersonality)
+                                                      valueOptions:NSPointerFunctionsStrongMemory
+                                                          capacity:0];
+    }
+    NSString *base64 = [_base64ImageCache objectForKey:image];
+    if (!base64) {
+        base64 = [UIImagePNGRepresentation(image) base64EncodedStringWithOptions:NSDataBase64Encoding64CharacterLineLength];
+        if (base64) {
+            [_base64ImageCache setObject:base64 forKey:image];
+        }
+    }
+    return base64;
+}
 
 - (NSString *)HTMLForSignature:(ORKConsentSignature *)signature {
     NSMutableString *body = [NSMutableString new];
@@ -81,7 +100,7 @@
         NSString *imageTag = nil;
 
         if (signature.signatureImage) {
-            NSString *base64 = [UIImagePNGRepresentation(signature.signatureImage) base64EncodedStringWithOptions:NSDataBase64Encoding64CharacterLineLength];
+            NSString *base64 = [self base64PNGForImage:signature.signatureImage];
             imageTag = [NSString stringWithFormat:@"<img width='100%%' alt='star' src='data:image/png;base64,%@' />", base64];
         } else {
             [body appendString:@"<br/>"];
@@ -36,6 +36,7 @@
 // Active step support
 #import <ResearchKit/ORKDataLogger.h>
 #import <ResearchKit/ORKErrors.h>
+#import <ResearchKit/ORKRecorderMetrics.h>
 
 #import <ResearchKit/ORKAnswerFormat_Private.h>
 #import <ResearchKit/ORKConsentSection_Private.h>
@@ -0,0 +1,158 @@
+/*
+ Copyright (c) 2016, Apple Inc. All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+ 
+ 1.  Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ 2.  Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation and/or
+ other materials provided with the distribution.
+ 
+ 3.  Neither the name of the copyright holder(s) nor the names of any contributors
+ may be used to endorse or promote products derived from this software without
+ specific prior written permission. No license is granted to the trademarks of
+ the copyright holders even if such marks are included in this software.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+@import XCTest;
+@import ResearchKit.Private;
+
+#import "ORKActiveTaskClock.h"
+
+
+@interface ORKActiveTaskClockTests : XCTestCase
+
+@end
+
+
+@implementation ORKActiveTaskClockTests
+
+- (void)testMachTimeConversionRoundTrips {
+    NSTimeInterval interval = 1.25;
+    XCTAssertEqualWithAccuracy(ORKTimeIntervalFromMachTime(ORKMachTimeFromTimeInterval(interval)), interval, 1e-6);
+    XCTAssertEqualWithAccuracy(ORKActiveTaskClockNow(), [NSProcessInfo processInfo].systemUptime, 0.05);
+}
+
+- (void)testOneShotTimerFiresOnce {
+    ORKActiveTaskClock *clock = [ORKActiveTaskClock sharedClock];
+    dispatch_queue_t queue = dispatch_queue_create("ORKActiveTaskClockTests", DISPATCH_QUEUE_SERIAL);
+
+    __block NSUInteger fireCount = 0;
+    __block NSTimeInterval firedAt = 0;
+    XCTestExpectation *expectation = [self expectationWithDescription:@"fired"];
+    NSTimeInterval scheduledAt = ORKActiveTaskClockNow();
+    [clock scheduleTimerWithDelay:0.05 interval:0 queue:queue handler:^{
+        fireCount++;
+        firedAt = ORKActiveTaskClockNow();
+        [expectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:2.0 handler:nil];
+
+    // Give a stray second firing the chance to happen.
+    [NSThread sleepForTimeInterval:0.1];
+    dispatch_sync(queue, ^{
+        XCTAssertEqual(fireCount, 1);
+        XCTAssertGreaterThanOrEqual(firedAt - scheduledAt, 0.05);
+    });
+    XCTAssertEqual(clock.pendingTimerCount, 0);
+    XCTAssertTrue(clock.idle);
+}
+
+- (void)testRepeatingTimerStopsWhenCancelled {
+    ORKActiveTaskClock *clock = [ORKActiveTaskClock sharedClock];
+    dispatch_queue_t queue = dispatch_queue_create("ORKActiveTaskClockTests", DISPATCH_QUEUE_SERIAL);
+
+    __block NSUInteger fireCount = 0;
+    __block ORKActiveTaskClockTimer *timer = nil;
+    XCTestExpectation *expectation = [self expectationWithDescription:@"fired three times"];
+    timer = [clock scheduleTimerWithDelay:0.02 interval:0.02 queue:queue handler:^{
+        fireCount++;
+        if (fireCount == 3) {
+            [timer cancel];
+            [expectation fulfill];
+        }
+    }];
+    [self waitForExpectationsWithTimeout:2.0 handler:nil];
+
+    [NSThread sleepForTimeInterval:0.1];
+    dispatch_sync(queue, ^{
+        XCTAssertTrue(timer.cancelled);
+        XCTAssertEqual(fireCount, 3);
+    });
+    XCTAssertTrue(clock.idle);
+}
+
+- (void)testCancelledTimerDoesNotFire {
+    ORKActiveTaskClock *clock = [ORKActiveTaskClock sharedClock];
+    dispatch_queue_t queue = dispatch_queue_create("ORKActiveTaskClockTests", DISPATCH_QUEUE_SERIAL);
+
+    __block BOOL fired = NO;
+    ORKActiveTaskClockTimer *timer = [clock scheduleTimerWithDelay:0.05 interval:0 queue:queue handler:^{
+        fired = YES;
+    }];
+    [timer cancel];
+
+    [NSThread sleepForTimeInterval:0.2];
+    dispatch_sync(queue, ^{
+        XCTAssertFalse(fired);
+    });
+}
+
+- (void)testSourceStopsWhenNoLiveTimerRemains {
+    ORKActiveTaskClock *clock = [ORKActiveTaskClock sharedClock];
+    dispatch_queue_t queue = dispatch_queue_create("ORKActiveTaskClockTests", DISPATCH_QUEUE_SERIAL);
+    XCTAssertTrue(clock.idle);
+    
+    ORKActiveTaskClockTimer *first = [clock scheduleTimerWithDelay:60 interval:0 queue:queue handler:^{}];
+    ORKActiveTaskClockTimer *second = [clock scheduleTimerWithDelay:120 interval:1 queue:queue handler:^{}];
+    XCTAssertEqual(clock.pendingTimerCount, 2);
+    XCTAssertFalse(clock.idle);
+    
+    [first cancel];
+    XCTAssertEqual(clock.pendingTimerCount, 1);
+    XCTAssertFalse(clock.idle);
+    
+    [second cancel];
+    XCTAssertEqual(clock.pendingTimerCount, 0);
+    XCTAssertTrue(clock.idle);
+}
+
+- (void)testEarlierTimerFiresBeforeLaterOne {
+    ORKActiveTaskClock *clock = [ORKActiveTaskClock sharedClock];
+    dispatch_queue_t queue = dispatch_queue_create("ORKActiveTaskClockTests", DISPATCH_QUEUE_SERIAL);
+    
+    // The source is armed for the later timer first, and must be re-armed for the earlier one.
+    __block BOOL laterFired = NO;
+    ORKActiveTaskClockTimer *later = [clock scheduleTimerWithDelay:60 interval:0 queue:queue handler:^{
+        laterFired = YES;
+    }];
+    XCTestExpectation *expectation = [self expectationWithDescription:@"earlier fired"];
+    [clock scheduleTimerWithDelay:0.05 interval:0 queue:queue handler:^{
+        [expectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:2.0 handler:nil];
+    
+    dispatch_sync(queue, ^{
+        XCTAssertFalse(laterFired);
+    });
+    XCTAssertEqual(clock.pendingTimerCount, 1);
+    [later cancel];
+    XCTAssertTrue(clock.idle);
+}
+
+@end
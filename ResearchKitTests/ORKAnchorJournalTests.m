@@ -0,0 +1,181 @@
+/*
+ Copyright (c) 2016, Apple Inc. All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+ 
+ 1.  Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ 2.  Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation and/or
+ other materials provided with the distribution.
+ 
+ 3.  Neither the name of the copyright holder(s) nor the names of any contributors
+ may be used to endorse or promote products derived from this software without
+ specific prior written permission. No license is granted to the trademarks of
+ the copyright holders even if such marks are included in this software.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+
+
+@import XCTest;
+@import HealthKit;
+@import ResearchKit.Private;
+
+#import "ORKAnchorJournal.h"
+#import "ORKCollector_Internal.h"
+#import "ORKDataCollectionManager_Internal.h"
+
+
+@interface ORKAnchorJournalTests : XCTestCase
+
+@end
+
+
+@implementation ORKAnchorJournalTests {
+    NSURL *_directory;
+}
+
+- (void)setUp {
+    [super setUp];
+    
+    _directory = [NSURL fileURLWithPath:[NSTemporaryDirectory() stringByAppendingPathComponent:[NSUUID UUID].UUIDString] isDirectory:YES];
+    BOOL success = [[NSFileManager defaultManager] createDirectoryAtURL:_directory withIntermediateDirectories:YES attributes:nil error:nil];
+    XCTAssertTrue(success, @"Create journal directory");
+}
+
+- (void)tearDown {
+    [[NSFileManager defaultManager] removeItemAtURL:_directory error:nil];
+    _directory = nil;
+    
+    [super tearDown];
+}
+
+- (NSString *)journalPath {
+    return [_directory URLByAppendingPathComponent:@"journal"].path;
+}
+
+- (NSArray<NSArray *> *)recordsInJournal:(ORKAnchorJournal *)journal {
+    NSMutableArray<NSArray *> *records = [NSMutableArray array];
+    [journal enumerateRecordsUsingBlock:^(NSUInteger index, NSString *identifier, HKQueryAnchor *anchor, NSDate *lastDate) {
+        [records addObject:@[@(index), identifier, anchor ? : [NSNull null], lastDate ? : [NSNull null]]];
+    }];
+    return records;
+}
+
+- (void)appendRecordAtIndex:(NSUInteger)index anchorValue:(NSUInteger)anchorValue toJournal:(ORKAnchorJournal *)journal {
+    NSError *error = nil;
+    XCTAssertTrue([journal appendRecordForCollectorAtIndex:index
+                                                identifier:[NSString stringWithFormat:@"collector%lu", (unsigned long)index]
+                                                    anchor:[HKQueryAnchor anchorFromValue:anchorValue]
+                                                  lastDate:nil
+                                                     error:&error], @"%@", error);
+}
+
+- (void)testRecordsReplayAfterReopening {
+    NSDate *lastDate = [NSDate dateWithTimeIntervalSinceReferenceDate:500000000];
+    ORKAnchorJournal *journal = [[ORKAnchorJournal alloc] initWithPath:[self journalPath]];
+    [self appendRecordAtIndex:0 anchorValue:7 toJournal:journal];
+    XCTAssertTrue([journal appendRecordForCollectorAtIndex:1 identifier:@"motion" anchor:nil lastDate:lastDate error:NULL]);
+    [self appendRecordAtIndex:0 anchorValue:9 toJournal:journal];
+    XCTAssertEqual(journal.recordCount, 3);
+    journal = nil;
+    
+    ORKAnchorJournal *reopenedJournal = [[ORKAnchorJournal alloc] initWithPath:[self journalPath]];
+    XCTAssertEqual(reopenedJournal.recordCount, 3);
+    NSArray *expectedRecords = @[@[@0, @"collector0", [HKQueryAnchor anchorFromValue:7], [NSNull null]],
+                                 @[@1, @"motion", [NSNull null], lastDate],
+                                 @[@0, @"collector0", [HKQueryAnchor anchorFromValue:9], [NSNull null]]];
+    XCTAssertEqualObjects([self recordsInJournal:reopenedJournal], expectedRecords);
+    
+    // Appending after reopening adds to the existing records.
+    [self appendRecordAtIndex:2 anchorValue:1 toJournal:reopenedJournal];
+    XCTAssertEqual(reopenedJournal.recordCount, 4);
+    XCTAssertEqual([self recordsInJournal:reopenedJournal].count, 4);
+}
+
+- (void)testTornTailIsIgnoredAndTruncated {
+    ORKAnchorJournal *journal = [[ORKAnchorJournal alloc] initWithPath:[self journalPath]];
+    [self appendRecordAtIndex:0 anchorValue:1 toJournal:journal];
+    [self appendRecordAtIndex:1 anchorValue:2 toJournal:journal];
+    journal = nil;
+    unsigned long long intactLength = [[[NSFileManager defaultManager] attributesOfItemAtPath:[self journalPath] error:NULL] fileSize];
+    
+    // A crash part way through a third record leaves its header and the start of its payload.
+    NSMutableData *journalData = [NSMutableData dataWithContentsOfFile:[self journalPath]];
+    NSData *tornRecord = [journalData subdataWithRange:NSMakeRange(0, journalData.length / 2 - 3)];
+    [journalData appendData:tornRecord];
+    XCTAssertTrue([journalData writeToFile:[self journalPath] atomically:YES]);
+    
+    ORKAnchorJournal *reopenedJournal = [[ORKAnchorJournal alloc] initWithPath:[self journalPath]];
+    XCTAssertEqual(reopenedJournal.recordCount, 2);
+    XCTAssertEqual([self recordsInJournal:reopenedJournal].count, 2);
+    
+    // The next append replaces the torn record rather than following it.
+    [self appendRecordAtIndex:2 anchorValue:3 toJournal:reopenedJournal];
+    NSArray<NSArray *> *records = [self recordsInJournal:reopenedJournal];
+    XCTAssertEqual(records.count, 3);
+    XCTAssertEqualObjects(records.lastObject[2], [HKQueryAnchor anchorFromValue:3]);
+    unsigned long long length = [[[NSFileManager defaultManager] attributesOfItemAtPath:[self journalPath] error:NULL] fileSize];
+    XCTAssertEqual(length, intactLength + (intactLength / 2));
+}
+
+- (void)testTruncate {
+    ORKAnchorJournal *journal = [[ORKAnchorJournal alloc] initWithPath:[self journalPath]];
+    [self appendRecordAtIndex:0 anchorValue:1 toJournal:journal];
+    XCTAssertTrue([journal truncateWithError:NULL]);
+    XCTAssertEqual(journal.recordCount, 0);
+    XCTAssertEqual([self recordsInJournal:journal].count, 0);
+    XCTAssertEqual([[[NSFileManager defaultManager] attributesOfItemAtPath:[self journalPath] error:NULL] fileSize], 0);
+}
+
+- (void)testManagerCompactsJournalIntoSnapshot {
+    ORKDataCollectionManager *manager = [[ORKDataCollectionManager alloc] initWithPersistenceDirectoryURL:_directory];
+    NSDate *startDate = [NSDate dateWithTimeIntervalSinceReferenceDate:500000000];
+    ORKMotionActivityCollector *collector = [manager addMotionActivityCollectorWithStartDate:startDate error:NULL];
+    XCTAssertNotNil(collector);
+    
+    NSString *journalPath = [_directory URLByAppendingPathComponent:@".dataCollection.ork.journal"].path;
+    __block NSDate *lastDate = nil;
+    [manager onWorkQueueSync:^BOOL(ORKDataCollectionManager *manager) {
+        for (NSUInteger count = 1; count < 128; count++) {
+            lastDate = [startDate dateByAddingTimeInterval:count];
+            collector.lastDate = lastDate;
+            [manager persistProgressOfCollector:collector];
+        }
+        return NO;
+    }];
+    ORKAnchorJournal *journal = [[ORKAnchorJournal alloc] initWithPath:journalPath];
+    XCTAssertEqual(journal.recordCount, 127);
+    
+    // Progress survives in the journal alone, until it is replayed over the old snapshot.
+    ORKDataCollectionManager *reloadedManager = [[ORKDataCollectionManager alloc] initWithPersistenceDirectoryURL:_directory];
+    XCTAssertEqualObjects(((ORKMotionActivityCollector *)reloadedManager.collectors.firstObject).lastDate, lastDate);
+    
+    // The record that reaches the threshold writes a new snapshot and empties the journal.
+    [manager onWorkQueueSync:^BOOL(ORKDataCollectionManager *manager) {
+        lastDate = [startDate dateByAddingTimeInterval:128];
+        collector.lastDate = lastDate;
+        [manager persistProgressOfCollector:collector];
+        return NO;
+    }];
+    journal = [[ORKAnchorJournal alloc] initWithPath:journalPath];
+    XCTAssertEqual(journal.recordCount, 0);
+    reloadedManager = [[ORKDataCollectionManager alloc] initWithPersistenceDirectoryURL:_directory];
+    XCTAssertEqualObjects(((ORKMotionActivityCollector *)reloadedManager.collectors.firstObject).lastDate, lastDate);
+}
+
+@end
@@ -0,0 +1,92 @@
+/*
+ Copyright (c) 2016, Apple Inc. All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+ 
+ 1.  Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ 2.  Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation and/or
+ other materials provided with the distribution.
+ 
+ 3.  Neither the name of the copyright holder(s) nor the names of any contributors
+ may be used to endorse or promote products derived from this software without
+ specific prior written permission. No license is granted to the trademarks of
+ the copyright holders even if such marks are included in this software.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+@import XCTest;
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ The measurements of one benchmark run.
+ 
+ Latencies are per iteration, in seconds. Byte counts are read from the malloc zone statistics:
+ `transientBytes` is the memory still in use at the end of an iteration before its autorelease
+ pool drains, and `retainedBytes` is the memory still in use once the whole run has finished.
+ */
+@interface ORKBenchmarkResult : NSObject
+
+@property (nonatomic, copy, readonly) NSString *name;
+
+@property (nonatomic, readonly) NSUInteger iterations;
+
+@property (nonatomic, readonly) double operationsPerSecond;
+
+@property (nonatomic, readonly) NSTimeInterval medianLatency;
+
+@property (nonatomic, readonly) NSTimeInterval p99Latency;
+
+@property (nonatomic, readonly) int64_t transientBytes;
+
+@property (nonatomic, readonly) int64_t retainedBytes;
+
+- (NSDictionary<NSString *, NSNumber *> *)dictionaryRepresentation;
+
+@end
+
+
+/**
+ Base class for benchmark test cases.
+ 
+ Benchmarks only run when the `ORK_BENCHMARK` environment variable is set, as it is in the
+ ResearchKitBenchmarks scheme, so the functional test runs never depend on timing.
+ 
+ Each benchmark is compared with the stored baseline in `ORKBenchmarkBaseline.json`, a resource
+ of the test bundle. A benchmark fails when its median latency is worse than its baseline by more
+ than the baseline's `regressionThreshold` (or the `ORK_BENCHMARK_THRESHOLD` environment
+ variable). A benchmark without a baseline is skipped with a message in the log.
+ 
+ Set the `ORK_BENCHMARK_RECORD` environment variable to write the measured results to
+ `ORKBenchmarkBaseline.json` in the temporary directory instead, and copy that file over the one
+ next to this file. Baselines should be recorded on the reference device, with a release build.
+ */
+@interface ORKBenchmarkTestCase : XCTestCase
+
+/**
+ Runs `block` a few times to warm up, then `iterations` more times, each in its own autorelease
+ pool, and checks the result against the baseline.
+ */
+- (ORKBenchmarkResult *)measureBenchmarkNamed:(NSString *)name
+                                   iterations:(NSUInteger)iterations
+                                        block:(void (^)(NSUInteger iteration))block;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,234 @@
+/*
+ Copyright (c) 2016, Apple Inc. All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+ 
+ 1.  Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ 2.  Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation and/or
+ other materials provided with the distribution.
+ 
+ 3.  Neither the name of the copyright holder(s) nor the names of any contributors
+ may be used to endorse or promote products derived from this software without
+ specific prior written permission. No license is granted to the trademarks of
+ the copyright holders even if such marks are included in this software.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#import "ORKBenchmark.h"
+
+#include <mach/mach_time.h>
+#include <malloc/malloc.h>
+
+
+static NSString *const ORKBenchmarkRunEnvironmentKey = @"ORK_BENCHMARK";
+static NSString *const ORKBenchmarkRecordEnvironmentKey = @"ORK_BENCHMARK_RECORD";
+static NSString *const ORKBenchmarkThresholdEnvironmentKey = @"ORK_BENCHMARK_THRESHOLD";
+static const double ORKBenchmarkDefaultRegressionThreshold = 0.25;
+
+static NSString *ORKBenchmarkBaselinePath(void) {
+    return [[NSBundle bundleForClass:[ORKBenchmarkTestCase class]] pathForResource:@"ORKBenchmarkBaseline" ofType:@"json"];
+}
+
+// The test bundle is read-only on device, so recorded baselines are written here, to be copied over the bundled file.
+static NSString *ORKBenchmarkRecordedBaselinePath(void) {
+    return [NSTemporaryDirectory() stringByAppendingPathComponent:@"ORKBenchmarkBaseline.json"];
+}
+
+static BOOL ORKBenchmarkIsEnabled(void) {
+    NSDictionary<NSString *, NSString *> *environment = [NSProcessInfo processInfo].environment;
+    return environment[ORKBenchmarkRunEnvironmentKey].length > 0 || environment[ORKBenchmarkRecordEnvironmentKey].length > 0;
+}
+
+static BOOL ORKBenchmarkIsRecording(void) {
+    return [NSProcessInfo processInfo].environment[ORKBenchmarkRecordEnvironmentKey].length > 0;
+}
+
+static NSTimeInterval ORKBenchmarkSecondsFromMachTime(uint64_t machTime) {
+    static mach_timebase_info_data_t timebase;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        mach_timebase_info(&timebase);
+    });
+    return (double)machTime * timebase.numer / timebase.denom / NSEC_PER_SEC;
+}
+
+static int64_t ORKBenchmarkBytesInUse(void) {
+    malloc_statistics_t statistics;
+    malloc_zone_statistics(NULL, &statistics);
+    return (int64_t)statistics.size_in_use;
+}
+
+static int ORKBenchmarkCompareTimeIntervals(const void *a, const void *b) {
+    NSTimeInterval lhs = *(const NSTimeInterval *)a;
+    NSTimeInterval rhs = *(const NSTimeInterval *)b;
+    return (lhs > rhs) - (lhs < rhs);
+}
+
+// Nearest-rank percentile of sorted samples.
+static NSTimeInterval ORKBenchmarkPercentile(const NSTimeInterval *sortedSamples, NSUInteger count, double percentile) {
+    NSUInteger rank = (NSUInteger)ceil(percentile * count);
+    return sortedSamples[MAX(rank, 1) - 1];
+}
+
+
+@implementation ORKBenchmarkResult
+
+- (instancetype)initWithName:(NSString *)name
+                  iterations:(NSUInteger)iterations
+         operationsPerSecond:(double)operationsPerSecond
+               medianLatency:(NSTimeInterval)medianLatency
+                  p99Latency:(NSTimeInterval)p99Latency
+              transientBytes:(int64_t)transientBytes
+               retainedBytes:(int64_t)retainedBytes {
+    self = [super init];
+    if (self) {
+        _name = [name copy];
+        _iterations = iterations;
+        _operationsPerSecond = operationsPerSecond;
+        _medianLatency = medianLatency;
+        _p99Latency = p99Latency;
+        _transientBytes = transientBytes;
+        _retainedBytes = retainedBytes;
+    }
+    return self;
+}
+
+- (NSDictionary<NSString *, NSNumber *> *)dictionaryRepresentation {
+    return @{@"iterations": @(_iterations),
+             @"operationsPerSecond": @(_operationsPerSecond),
+             @"p50": @(_medianLatency),
+             @"p99": @(_p99Latency),
+             @"transientBytes": @(_transientBytes),
+             @"retainedBytes": @(_retainedBytes)};
+}
+
+- (NSString *)description {
+    return [NSString stringWithFormat:@"%@: %.0f ops/s, p50 %.3f ms, p99 %.3f ms, transient %lld B, retained %lld B (%lu iterations)",
+            _name, _operationsPerSecond, _medianLatency * 1000, _p99Latency * 1000,
+            (long long)_transientBytes, (long long)_retainedBytes, (unsigned long)_iterations];
+}
+
+@end
+
+
+@implementation ORKBenchmarkTestCase
+
++ (XCTestSuite *)defaultTestSuite {
+    // Timings are only meaningful on the reference device, so the functional test runs leave them out.
+    if (!ORKBenchmarkIsEnabled()) {
+        NSLog(@"Skipping %@: set %@ to run benchmarks", NSStringFromClass(self), ORKBenchmarkRunEnvironmentKey);
+        return [XCTestSuite testSuiteWithName:NSStringFromClass(self)];
+    }
+    return [super defaultTestSuite];
+}
+
++ (NSMutableDictionary *)baseline {
+    // While recording, later benchmarks add to what earlier ones in the run recorded.
+    NSData *data = ORKBenchmarkIsRecording() ? [NSData dataWithContentsOfFile:ORKBenchmarkRecordedBaselinePath()] : nil;
+    NSString *bundledPath = ORKBenchmarkBaselinePath();
+    if (data == nil && bundledPath) {
+        data = [NSData dataWithContentsOfFile:bundledPath];
+    }
+    NSDictionary *baseline = data ? [NSJSONSerialization JSONObjectWithData:data options:0 error:NULL] : nil;
+    NSMutableDictionary *mutableBaseline = [baseline isKindOfClass:[NSDictionary class]] ? [baseline mutableCopy] : [NSMutableDictionary dictionary];
+    NSDictionary *benchmarks = mutableBaseline[@"benchmarks"];
+    mutableBaseline[@"benchmarks"] = [benchmarks isKindOfClass:[NSDictionary class]] ? [benchmarks mutableCopy] : [NSMutableDictionary dictionary];
+    return mutableBaseline;
+}
+
++ (double)regressionThresholdForBaseline:(NSDictionary *)baseline {
+    NSString *threshold = [NSProcessInfo processInfo].environment[ORKBenchmarkThresholdEnvironmentKey];
+    if (threshold.length > 0) {
+        return threshold.doubleValue;
+    }
+    NSNumber *baselineThreshold = baseline[@"regressionThreshold"];
+    return baselineThreshold ? baselineThreshold.doubleValue : ORKBenchmarkDefaultRegressionThreshold;
+}
+
+- (ORKBenchmarkResult *)measureBenchmarkNamed:(NSString *)name
+                                   iterations:(NSUInteger)iterations
+                                        block:(void (^)(NSUInteger iteration))block {
+    NSParameterAssert(iterations > 0);
+    
+    NSUInteger warmUpIterations = MIN(MAX(iterations / 10, 1), 10);
+    for (NSUInteger iteration = 0; iteration < warmUpIterations; iteration++) {
+        @autoreleasepool {
+            block(iteration);
+        }
+    }
+    
+    NSTimeInterval *samples = malloc(iterations * sizeof(NSTimeInterval));
+    NSTimeInterval totalTime = 0;
+    int64_t transientBytes = 0;
+    int64_t initialBytes = ORKBenchmarkBytesInUse();
+    for (NSUInteger iteration = 0; iteration < iterations; iteration++) {
+        @autoreleasepool {
+            int64_t bytesBefore = ORKBenchmarkBytesInUse();
+            uint64_t start = mach_absolute_time();
+            block(warmUpIterations + iteration);
+            samples[iteration] = ORKBenchmarkSecondsFromMachTime(mach_absolute_time() - start);
+            transientBytes = MAX(transientBytes, ORKBenchmarkBytesInUse() - bytesBefore);
+        }
+        totalTime += samples[iteration];
+    }
+    int64_t retainedBytes = ORKBenchmarkBytesInUse() - initialBytes;
+    
+    qsort(samples, iterations, sizeof(NSTimeInterval), ORKBenchmarkCompareTimeIntervals);
+    ORKBenchmarkResult *result = [[ORKBenchmarkResult alloc] initWithName:name
+                                                               iterations:iterations
+                                                      operationsPerSecond:(totalTime > 0) ? iterations / totalTime : 0
+                                                            medianLatency:ORKBenchmarkPercentile(samples, iterations, 0.50)
+                                                               p99Latency:ORKBenchmarkPercentile(samples, iterations, 0.99)
+                                                           transientBytes:transientBytes
+                                                            retainedBytes:retainedBytes];
+    free(samples);
+    NSLog(@"%@", result);
+    
+    [self compareResultWithBaseline:result];
+    return result;
+}
+
+- (void)compareResultWithBaseline:(ORKBenchmarkResult *)result {
+    @synchronized ([ORKBenchmarkTestCase class]) {
+        NSMutableDictionary *baseline = [ORKBenchmarkTestCase baseline];
+        NSMutableDictionary *benchmarks = baseline[@"benchmarks"];
+        
+        if (ORKBenchmarkIsRecording()) {
+            benchmarks[result.name] = [result dictionaryRepresentation];
+            NSData *data = [NSJSONSerialization dataWithJSONObject:baseline options:NSJSONWritingPrettyPrinted error:NULL];
+            XCTAssertTrue([data writeToFile:ORKBenchmarkRecordedBaselinePath() atomically:YES], @"Could not record baseline for %@", result.name);
+            NSLog(@"Recorded baseline for %@ in %@", result.name, ORKBenchmarkRecordedBaselinePath());
+            return;
+        }
+        
+        XCTAssertNotNil(ORKBenchmarkBaselinePath(), @"ORKBenchmarkBaseline.json is missing from the test bundle");
+        NSNumber *baselineMedianLatency = benchmarks[result.name][@"p50"];
+        if (baselineMedianLatency == nil) {
+            NSLog(@"Not comparing %@: it has no baseline. Run the benchmarks with %@ set on the reference device and commit the recorded file.",
+                  result.name, ORKBenchmarkRecordEnvironmentKey);
+            return;
+        }
+        double threshold = [ORKBenchmarkTestCase regressionThresholdForBaseline:baseline];
+        NSTimeInterval allowedMedianLatency = baselineMedianLatency.doubleValue * (1 + threshold);
+        XCTAssertLessThanOrEqual(result.medianLatency, allowedMedianLatency,
+                                 @"%@ regressed: p50 %.3f ms against a baseline of %.3f ms (threshold %.0f%%)",
+                                 result.name, result.medianLatency * 1000, baselineMedianLatency.doubleValue * 1000, threshold * 100);
+    }
+}
+
+@end
@@ -349,4 +349,31 @@
     }
 }
 
+- (void)testSelectedIndexesForAnswerWithManyChoices {
+    NSMutableArray *textChoices = [NSMutableArray new];
+    for (NSUInteger idx = 0; idx < 2000; idx++) {
+        [textChoices addObject:[ORKTextChoice choiceWithText:[NSString stringWithFormat:@"choice %lu", (unsigned long)idx]
+                                                       value:[NSString stringWithFormat:@"c%lu", (unsigned long)idx]]];
+    }
+    // A repeated value maps to its first choice.
+    [textChoices addObject:[ORKTextChoice choiceWithText:@"repeated" value:@"c10"]];
+    
+    ORKAnswerFormat *answerFormat = [ORKAnswerFormat choiceAnswerFormatWithStyle:ORKChoiceAnswerStyleMultipleChoice
+                                                                     textChoices:textChoices];
+    ORKChoiceAnswerFormatHelper *formatHelper = [[ORKChoiceAnswerFormatHelper alloc] initWithAnswerFormat:answerFormat];
+    
+    NSArray *indexes = [formatHelper selectedIndexesForAnswer:@[@"c1999", @"c0", @"c10"]];
+    XCTAssertEqualObjects(indexes, (@[@(1999), @(0), @(10)]));
+    
+    XCTAssertEqualObjects([formatHelper stringForChoiceAnswer:@[@"c5", @"c6"]], @"choice 5\nchoice 6");
+    
+    NSMutableArray *answer = [NSMutableArray new];
+    for (ORKTextChoice *textChoice in textChoices) {
+        [answer addObject:textChoice.value];
+    }
+    [self measureBlock:^{
+        XCTAssertEqual([formatHelper selectedIndexesForAnswer:answer].count, answer.count);
+    }];
+}
+
 @end
@@ -0,0 +1,251 @@
+/*
+ Copyright (c) 2016, Apple Inc. All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+ 
+ 1.  Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ 2.  Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation and/or
+ other materials provided with the distribution.
+ 
+ 3.  Neither the name of the copyright holder(s) nor the names of any contributors
+ may be used to endorse or promote products derived from this software without
+ specific prior written permission. No license is granted to the trademarks of
+ the copyright holders even if such marks are included in this software.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+@import XCTest;
+@import ResearchKit.Private;
+
+#import "ORKAnswerFormat_Internal.h"
+#import "ORKChoiceSearchIndex.h"
+
+
+@interface ORKTestChoiceDataSource : NSObject <ORKSearchableChoiceDataSource>
+
+- (instancetype)initWithTexts:(NSArray<NSString *> *)texts;
+
+@property (nonatomic, readonly) NSUInteger pageRequestCount;
+
+/// The index of the exclusive choice, or `NSNotFound`.
+@property (nonatomic) NSUInteger exclusiveIndex;
+
+/// When set, reads made off the main thread wait for this semaphore, which holds back the index build.
+@property (nonatomic, strong) dispatch_semaphore_t backgroundReadGate;
+
+@end
+
+
+@implementation ORKTestChoiceDataSource {
+    NSArray<NSString *> *_texts;
+}
+
+- (instancetype)initWithTexts:(NSArray<NSString *> *)texts {
+    self = [super init];
+    if (self) {
+        _texts = [texts copy];
+        _exclusiveIndex = NSNotFound;
+    }
+    return self;
+}
+
+- (NSUInteger)numberOfChoices {
+    return _texts.count;
+}
+
+- (NSArray<ORKTextChoice *> *)textChoicesInRange:(NSRange)range {
+    @synchronized (self) {
+        _pageRequestCount++;
+    }
+    if (_backgroundReadGate && ![NSThread isMainThread]) {
+        dispatch_semaphore_wait(_backgroundReadGate, dispatch_time(DISPATCH_TIME_NOW, (int64_t)(10.0 * NSEC_PER_SEC)));
+        dispatch_semaphore_signal(_backgroundReadGate);
+    }
+    NSMutableArray<ORKTextChoice *> *choices = [NSMutableArray arrayWithCapacity:range.length];
+    for (NSUInteger index = range.location; index < NSMaxRange(range); index++) {
+        [choices addObject:[ORKTextChoice choiceWithText:_texts[index]
+                                              detailText:nil
+                                                   value:@(index * 10)
+                                               exclusive:(index == _exclusiveIndex)]];
+    }
+    return choices;
+}
+
+@end
+
+
+@interface ORKChoiceSearchIndexTests : XCTestCase
+
+@end
+
+
+@implementation ORKChoiceSearchIndexTests
+
+- (ORKChoiceSearchIndex *)searchIndexWithTexts:(NSArray<NSString *> *)texts {
+    ORKTestChoiceDataSource *dataSource = [[ORKTestChoiceDataSource alloc] initWithTexts:texts];
+    return [[ORKChoiceSearchIndex alloc] initWithDataSource:dataSource pageSize:2];
+}
+
+- (void)prepareSearchIndex:(ORKChoiceSearchIndex *)searchIndex {
+    XCTestExpectation *expectation = [self expectationWithDescription:@"prepared"];
+    [searchIndex prepareWithCompletion:^{
+        [expectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:10.0 handler:nil];
+    XCTAssertTrue(searchIndex.prepared);
+}
+
+- (void)testTextChoiceAtIndexReadsOnlyItsPage {
+    ORKChoiceSearchIndex *searchIndex = [self searchIndexWithTexts:@[@"Aspirin", @"Ibuprofen", @"Paracetamol", @"Naproxen", @"Codeine"]];
+    ORKTestChoiceDataSource *dataSource = searchIndex.dataSource;
+    
+    XCTAssertEqual(searchIndex.numberOfChoices, 5);
+    XCTAssertEqualObjects([searchIndex textChoiceAtIndex:4].text, @"Codeine");
+    XCTAssertEqualObjects([searchIndex textChoiceAtIndex:3].text, @"Naproxen");
+    XCTAssertEqual(dataSource.pageRequestCount, 2);
+    
+    // Cached
+    XCTAssertEqualObjects([searchIndex textChoiceAtIndex:2].text, @"Paracetamol");
+    XCTAssertEqual(dataSource.pageRequestCount, 2);
+    
+    XCTAssertNil([searchIndex textChoiceAtIndex:5]);
+}
+
+- (void)testQueryMatchesWordPrefixes {
+    ORKChoiceSearchIndex *searchIndex = [self searchIndexWithTexts:@[@"Type 2 diabetes",
+                                                                     @"Type 1 diabetes",
+                                                                     @"Diabetes insipidus",
+                                                                     @"Crohn's disease",
+                                                                     @"Ménière's disease"]];
+    [self prepareSearchIndex:searchIndex];
+    
+    XCTAssertEqualObjects([searchIndex indexesOfChoicesMatchingQuery:@""], [NSIndexSet indexSetWithIndexesInRange:NSMakeRange(0, 5)]);
+    XCTAssertEqualObjects([searchIndex indexesOfChoicesMatchingQuery:@"diab"], [NSIndexSet indexSetWithIndexesInRange:NSMakeRange(0, 3)]);
+    XCTAssertEqualObjects([searchIndex indexesOfChoicesMatchingQuery:@"DIABETES typ"], [NSIndexSet indexSetWithIndexesInRange:NSMakeRange(0, 2)]);
+    XCTAssertEqualObjects([searchIndex indexesOfChoicesMatchingQuery:@"2 diab"], [NSIndexSet indexSetWithIndex:0]);
+    XCTAssertEqualObjects([searchIndex indexesOfChoicesMatchingQuery:@"meniere"], [NSIndexSet indexSetWithIndex:4]);
+    XCTAssertEqualObjects([searchIndex indexesOfChoicesMatchingQuery:@"dis"], [NSIndexSet indexSetWithIndexesInRange:NSMakeRange(3, 2)]);
+    XCTAssertEqual([searchIndex indexesOfChoicesMatchingQuery:@"abetes"].count, 0);
+    XCTAssertEqual([searchIndex indexesOfChoicesMatchingQuery:@"type asthma"].count, 0);
+}
+
+- (void)testQueryBeforePreparingReturnsEveryChoice {
+    ORKChoiceSearchIndex *searchIndex = [self searchIndexWithTexts:@[@"Aspirin", @"Ibuprofen", @"Paracetamol"]];
+    XCTAssertFalse(searchIndex.prepared);
+    
+    // The query does not wait for the build, and starts it.
+    XCTAssertEqualObjects([searchIndex indexesOfChoicesMatchingQuery:@"ibu"], [NSIndexSet indexSetWithIndexesInRange:NSMakeRange(0, 3)]);
+    [self prepareSearchIndex:searchIndex];
+    XCTAssertEqualObjects([searchIndex indexesOfChoicesMatchingQuery:@"ibu"], [NSIndexSet indexSetWithIndex:1]);
+}
+
+- (void)testIndexOfChoiceWithValue {
+    ORKChoiceSearchIndex *searchIndex = [self searchIndexWithTexts:@[@"Aspirin", @"Ibuprofen", @"Paracetamol"]];
+    [self prepareSearchIndex:searchIndex];
+    
+    XCTAssertEqual([searchIndex indexOfChoiceWithValue:@(0)], 0);
+    XCTAssertEqual([searchIndex indexOfChoiceWithValue:@(20)], 2);
+    XCTAssertEqual([searchIndex indexOfChoiceWithValue:@(30)], NSNotFound);
+}
+
+- (void)testIndexOfChoiceWithValueBeforePreparingUsesReadPages {
+    ORKChoiceSearchIndex *searchIndex = [self searchIndexWithTexts:@[@"Aspirin", @"Ibuprofen", @"Paracetamol", @"Naproxen", @"Codeine"]];
+    ORKTestChoiceDataSource *dataSource = searchIndex.dataSource;
+    dataSource.backgroundReadGate = dispatch_semaphore_create(0);
+    
+    XCTAssertEqualObjects([searchIndex textChoiceAtIndex:3].text, @"Naproxen");
+    
+    // Values on a page already read are found without waiting for the build.
+    XCTAssertEqual([searchIndex indexOfChoiceWithValue:@(20)], 2);
+    XCTAssertEqual([searchIndex indexOfChoiceWithValue:@(30)], 3);
+    
+    // Others are not found yet, and start the build.
+    XCTAssertEqual([searchIndex indexOfChoiceWithValue:@(40)], NSNotFound);
+    XCTAssertFalse(searchIndex.prepared);
+    
+    dispatch_semaphore_signal(dataSource.backgroundReadGate);
+    [self prepareSearchIndex:searchIndex];
+    XCTAssertEqual([searchIndex indexOfChoiceWithValue:@(40)], 4);
+}
+
+- (void)testQuestionStepSelectsChoiceBeforePreparing {
+    ORKTestChoiceDataSource *dataSource = [[ORKTestChoiceDataSource alloc] initWithTexts:@[@"None", @"Aspirin", @"Ibuprofen", @"Paracetamol"]];
+    dataSource.exclusiveIndex = 0;
+    dataSource.backgroundReadGate = dispatch_semaphore_create(0);
+    ORKSearchableChoiceAnswerFormat *answerFormat = [ORKAnswerFormat searchableChoiceAnswerFormatWithStyle:ORKChoiceAnswerStyleMultipleChoice
+                                                                                               dataSource:dataSource];
+    ORKQuestionStep *step = [ORKQuestionStep questionStepWithIdentifier:@"medications" title:@"Medications" answer:answerFormat];
+    ORKQuestionStepViewController *viewController = [[ORKQuestionStepViewController alloc] initWithStep:step];
+    viewController.view.frame = CGRectMake(0, 0, 320, 568);
+    UITableView *tableView = [viewController valueForKey:@"tableView"];
+    id<UITableViewDelegate> delegate = (id<UITableViewDelegate>)viewController;
+    XCTAssertNotNil(tableView);
+    
+    // The build is held back, so selecting must not wait for it.
+    ORKChoiceSearchIndex *searchIndex = [viewController valueForKey:@"searchIndex"];
+    [delegate tableView:tableView didSelectRowAtIndexPath:[NSIndexPath indexPathForRow:0 inSection:0]];
+    [delegate tableView:tableView didSelectRowAtIndexPath:[NSIndexPath indexPathForRow:2 inSection:0]];
+    XCTAssertFalse(searchIndex.prepared);
+    
+    // Selecting another choice cleared the exclusive one.
+    ORKChoiceQuestionResult *result = (ORKChoiceQuestionResult *)[viewController.result resultForIdentifier:@"medications"];
+    XCTAssertEqualObjects(result.choiceAnswers, @[@(20)]);
+    
+    dispatch_semaphore_signal(dataSource.backgroundReadGate);
+    [self prepareSearchIndex:searchIndex];
+}
+
+- (void)testAnswerFormat {
+    ORKTestChoiceDataSource *dataSource = [[ORKTestChoiceDataSource alloc] initWithTexts:@[@"Aspirin", @"Ibuprofen", @"Paracetamol"]];
+    ORKSearchableChoiceAnswerFormat *answerFormat = [ORKAnswerFormat searchableChoiceAnswerFormatWithStyle:ORKChoiceAnswerStyleMultipleChoice
+                                                                                               dataSource:dataSource];
+    XCTAssertNoThrow([answerFormat validateParameters]);
+    XCTAssertEqual(answerFormat.questionType, ORKQuestionTypeMultipleChoice);
+    XCTAssertEqualObjects([answerFormat copy], answerFormat);
+    [self prepareSearchIndex:[answerFormat searchIndex]];
+    XCTAssertEqualObjects([answerFormat stringForAnswer:@[@(20), @(0)]], @"Paracetamol\nAspirin");
+    
+    ORKSearchableChoiceAnswerFormat *decodedAnswerFormat = [NSKeyedUnarchiver unarchiveObjectWithData:[NSKeyedArchiver archivedDataWithRootObject:answerFormat]];
+    XCTAssertEqual(decodedAnswerFormat.style, ORKChoiceAnswerStyleMultipleChoice);
+    XCTAssertNil(decodedAnswerFormat.dataSource);
+    XCTAssertThrows([decodedAnswerFormat validateParameters]);
+    
+    ORKFormStep *formStep = [[ORKFormStep alloc] initWithIdentifier:@"form" title:nil text:nil];
+    formStep.formItems = @[[[ORKFormItem alloc] initWithIdentifier:@"item" text:nil answerFormat:answerFormat]];
+    XCTAssertThrows([formStep validateParameters]);
+}
+
+- (void)testQueryPerformance {
+    NSMutableArray<NSString *> *texts = [NSMutableArray array];
+    for (NSUInteger index = 0; index < 20000; index++) {
+        [texts addObject:[NSString stringWithFormat:@"Medication %lu extended release tablet", (unsigned long)index]];
+    }
+    ORKTestChoiceDataSource *dataSource = [[ORKTestChoiceDataSource alloc] initWithTexts:texts];
+    ORKChoiceSearchIndex *searchIndex = [[ORKChoiceSearchIndex alloc] initWithDataSource:dataSource pageSize:200];
+    
+    [self prepareSearchIndex:searchIndex];
+    XCTAssertEqual([searchIndex indexesOfChoicesMatchingQuery:@"medication 1999"].count, 11);
+    
+    [self measureBlock:^{
+        for (NSString *query in @[@"m", @"me", @"med", @"medication 1", @"medication 12", @"medication 123 ext"]) {
+            [searchIndex indexesOfChoicesMatchingQuery:query];
+        }
+    }];
+}
+
+@end
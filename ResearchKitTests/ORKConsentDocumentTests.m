@@ -69,6 +69,23 @@
 @end
 
 
+@interface ORKCountingConsentSectionFormatter : ORKConsentSectionFormatter
+
+@property (nonatomic) NSUInteger callCount;
+
+@end
+
+
+@implementation ORKCountingConsentSectionFormatter
+
+- (NSString *)HTMLForSection:(ORKConsentSection *)section {
+    self.callCount++;
+    return [super HTMLForSection:section];
+}
+
+@end
+
+
 @interface ORKMockConsentSignatureFormatter : ORKConsentSignatureFormatter
 
 @end
@@ -176,4 +193,66 @@
     XCTAssertEqualObjects(passedError, error);
 }
 
+- (void)testMakePDFWithCompletionHandler_withNativeBackend_rendersWithoutWriter {
+    self.document.PDFBackend = ORKConsentDocumentPDFBackendNative;
+    self.document.title = @"A Title";
+    ORKConsentSection *section = [[ORKConsentSection alloc] initWithType:ORKConsentSectionTypeCustom];
+    section.title = @"Section";
+    section.content = [@"" stringByPaddingToLength:20000 withString:@"Lorem ipsum dolor sit amet. " startingAtIndex:0];
+    self.document.sections = @[section];
+    ORKConsentSignature *signature = [ORKConsentSignature signatureForPersonWithTitle:@"Participant" dateFormatString:nil identifier:@"participant"];
+    signature.givenName = @"Jane";
+    signature.familyName = @"Appleseed";
+    signature.signatureDate = @"2016-01-01";
+    self.document.signatures = @[signature];
+    
+    XCTestExpectation *expectation = [self expectationWithDescription:@"PDF"];
+    __block NSData *passedData;
+    [self.document makePDFWithCompletionHandler:^(NSData *data, NSError *error) {
+        XCTAssertTrue([NSThread isMainThread]);
+        XCTAssertNil(error);
+        passedData = data;
+        [expectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:10 handler:nil];
+    
+    XCTAssertNil(self.mockWriter.html);
+    CGDataProviderRef provider = CGDataProviderCreateWithCFData((__bridge CFDataRef)passedData);
+    CGPDFDocumentRef pdf = CGPDFDocumentCreateWithProvider(provider);
+    // The section text runs over several pages, and the signature page follows on a page of its own.
+    XCTAssertTrue(pdf != NULL);
+    XCTAssertGreaterThan(CGPDFDocumentGetNumberOfPages(pdf), 2);
+    CGPDFDocumentRelease(pdf);
+    CGDataProviderRelease(provider);
+}
+
+- (void)testMakePDFWithCompletionHandler_withNativeBackendAndHTMLReviewContent_callsWriter {
+    self.document.PDFBackend = ORKConsentDocumentPDFBackendNative;
+    self.document.htmlReviewContent = @"some content";
+    [self.document makePDFWithCompletionHandler:^(NSData *data, NSError *error) {}];
+    XCTAssertEqualObjects(self.mockWriter.html, [self htmlWithContent:@"some content"]);
+}
+
+- (void)testMobileHTML_reusesSectionHTMLUntilSectionChanges {
+    ORKCountingConsentSectionFormatter *formatter = [[ORKCountingConsentSectionFormatter alloc] init];
+    ORKConsentDocument *document = [[ORKConsentDocument alloc] initWithHTMLPDFWriter:self.mockWriter
+                                                             consentSectionFormatter:formatter
+                                                           consentSignatureFormatter:[[ORKMockConsentSignatureFormatter alloc] init]];
+    ORKConsentSection *first = [[ORKConsentSection alloc] initWithType:ORKConsentSectionTypeCustom];
+    first.title = @"First";
+    ORKConsentSection *second = [[ORKConsentSection alloc] initWithType:ORKConsentSectionTypeCustom];
+    second.title = @"Second";
+    document.sections = @[first, second];
+    
+    NSString *html = [document mobileHTMLWithTitle:nil detail:nil];
+    XCTAssertEqual(formatter.callCount, 2);
+    XCTAssertEqualObjects([document mobileHTMLWithTitle:nil detail:nil], html);
+    XCTAssertEqual(formatter.callCount, 2);
+    
+    second.content = @"Changed";
+    html = [document mobileHTMLWithTitle:nil detail:nil];
+    XCTAssertEqual(formatter.callCount, 3);
+    XCTAssertTrue([html containsString:@"Changed"]);
+}
+
 @end
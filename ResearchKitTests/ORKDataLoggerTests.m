@@ -120,6 +120,24 @@
     XCTAssertEqualObjects(jsonOut[@"items"][0], jsonObject);
 }
 
+- (void)testJSONFormattingEscapesAndNumbers {
+    NSDictionary *jsonObject = @{@"text": @"quote \" backslash \\ newline \n tab \t bell \a é 😀",
+                                 @"double": @(0.1),
+                                 @"large": @(1.0e300),
+                                 @"negative": @(-42),
+                                 @"bool": @YES,
+                                 @"null": [NSNull null],
+                                 @"nested": @{@"array": @[@(1.5), @"x", @{}]} };
+
+    [self logJsonObjectAndRolloverAndWaitOnce:jsonObject];
+
+    NSError *error = nil;
+    NSDictionary *jsonOut = [NSJSONSerialization JSONObjectWithData:[NSData dataWithContentsOfURL:_finishedLogFiles[0]] options:(NSJSONReadingOptions)0 error:&error];
+    XCTAssertNil(error);
+    XCTAssertEqualObjects(jsonOut[@"items"][0], jsonObject);
+    XCTAssertEqual([jsonOut[@"items"][0][@"double"] doubleValue], 0.1);
+}
+
 - (void)testContinuesExistingLog {
     // Test that if you create a logger, and then kill it and create a new logger, the new one
     // continues from the right place without forcing a roll-over
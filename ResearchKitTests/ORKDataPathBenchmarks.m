@@ -0,0 +1,271 @@
+/*
+ Copyright (c) 2016, Apple Inc. All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+ 
+ 1.  Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ 2.  Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation and/or
+ other materials provided with the distribution.
+ 
+ 3.  Neither the name of the copyright holder(s) nor the names of any contributors
+ may be used to endorse or promote products derived from this software without
+ specific prior written permission. No license is granted to the trademarks of
+ the copyright holders even if such marks are included in this software.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+@import XCTest;
+@import ResearchKit.Private;
+
+#import "ORKBenchmark.h"
+
+
+static const NSUInteger ORKBenchmarkStepCount = 200;
+
+// Fixtures are built from fixed values only, so that every run measures the same work.
+static NSDate *ORKBenchmarkDate(NSTimeInterval offset) {
+    return [NSDate dateWithTimeIntervalSinceReferenceDate:500000000 + offset];
+}
+
+static NSDictionary *ORKBenchmarkLogObject(NSUInteger index) {
+    return @{@"timestamp": @(index * 0.01),
+             @"x": @(sin(index * 0.1)),
+             @"y": @(cos(index * 0.1)),
+             @"z": @(index % 7 - 3.0),
+             @"label": [NSString stringWithFormat:@"sample-%lu", (unsigned long)index]};
+}
+
+
+@interface ORKDataPathBenchmarks : ORKBenchmarkTestCase
+
+@end
+
+
+@implementation ORKDataPathBenchmarks {
+    NSURL *_directory;
+}
+
+- (void)setUp {
+    [super setUp];
+    
+    _directory = [NSURL fileURLWithPath:[NSTemporaryDirectory() stringByAppendingPathComponent:[NSUUID UUID].UUIDString] isDirectory:YES];
+    BOOL success = [[NSFileManager defaultManager] createDirectoryAtURL:_directory withIntermediateDirectories:YES attributes:nil error:nil];
+    XCTAssertTrue(success, @"Create benchmark directory");
+}
+
+- (void)tearDown {
+    [[NSFileManager defaultManager] removeItemAtURL:_directory error:nil];
+    _directory = nil;
+    
+    [super tearDown];
+}
+
+- (NSArray *)logObjectsWithCount:(NSUInteger)count {
+    NSMutableArray *objects = [NSMutableArray arrayWithCapacity:count];
+    for (NSUInteger index = 0; index < count; index++) {
+        [objects addObject:ORKBenchmarkLogObject(index)];
+    }
+    return objects;
+}
+
+- (ORKTaskResult *)taskResultWithStepCount:(NSUInteger)stepCount {
+    NSMutableArray<ORKStepResult *> *stepResults = [NSMutableArray arrayWithCapacity:stepCount];
+    for (NSUInteger stepIndex = 0; stepIndex < stepCount; stepIndex++) {
+        NSString *stepIdentifier = [NSString stringWithFormat:@"step%lu", (unsigned long)stepIndex];
+        
+        ORKNumericQuestionResult *numericResult = [[ORKNumericQuestionResult alloc] initWithIdentifier:stepIdentifier];
+        numericResult.numericAnswer = @(stepIndex % 10);
+        numericResult.startDate = ORKBenchmarkDate(stepIndex);
+        numericResult.endDate = ORKBenchmarkDate(stepIndex + 0.5);
+        
+        ORKTextQuestionResult *textResult = [[ORKTextQuestionResult alloc] initWithIdentifier:[stepIdentifier stringByAppendingString:@".text"]];
+        textResult.textAnswer = [NSString stringWithFormat:@"Answer to question %lu", (unsigned long)stepIndex];
+        
+        ORKChoiceQuestionResult *choiceResult = [[ORKChoiceQuestionResult alloc] initWithIdentifier:[stepIdentifier stringByAppendingString:@".choice"]];
+        choiceResult.choiceAnswers = @[@(stepIndex % 3), @"other"];
+        
+        ORKStepResult *stepResult = [[ORKStepResult alloc] initWithStepIdentifier:stepIdentifier results:@[numericResult, textResult, choiceResult]];
+        stepResult.startDate = ORKBenchmarkDate(stepIndex);
+        stepResult.endDate = ORKBenchmarkDate(stepIndex + 1);
+        [stepResults addObject:stepResult];
+    }
+    
+    ORKTaskResult *taskResult = [[ORKTaskResult alloc] initWithTaskIdentifier:@"benchmark"
+                                                                  taskRunUUID:[[NSUUID alloc] initWithUUIDString:@"1B5B4B8C-2B7C-4C5A-9A5E-3F1D2E6A7B80"]
+                                                              outputDirectory:_directory];
+    taskResult.results = stepResults;
+    return taskResult;
+}
+
+- (NSArray<ORKStep *> *)questionStepsWithCount:(NSUInteger)stepCount {
+    NSMutableArray<ORKStep *> *steps = [NSMutableArray arrayWithCapacity:stepCount];
+    for (NSUInteger stepIndex = 0; stepIndex < stepCount; stepIndex++) {
+        NSString *stepIdentifier = [NSString stringWithFormat:@"step%lu", (unsigned long)stepIndex];
+        [steps addObject:[ORKQuestionStep questionStepWithIdentifier:stepIdentifier
+                                                               title:stepIdentifier
+                                                              answer:[ORKNumericAnswerFormat integerAnswerFormatWithUnit:nil]]];
+    }
+    return steps;
+}
+
+#pragma mark - Data logging
+
+- (void)testDataLoggerAppend {
+    ORKDataLogger *dataLogger = [ORKDataLogger JSONDataLoggerWithDirectory:_directory logName:@"append" delegate:nil];
+    [self measureBenchmarkNamed:@"ORKDataLogger.append" iterations:2000 block:^(NSUInteger iteration) {
+        [dataLogger append:ORKBenchmarkLogObject(iteration) error:NULL];
+    }];
+    [dataLogger finishCurrentLog];
+}
+
+- (void)testDataLoggerAppendWithRollover {
+    ORKDataLogger *dataLogger = [ORKDataLogger JSONDataLoggerWithDirectory:_directory logName:@"rollover" delegate:nil];
+    dataLogger.maximumCurrentLogFileSize = 16 * 1024;
+    NSArray *objects = [self logObjectsWithCount:50];
+    
+    [self measureBenchmarkNamed:@"ORKDataLogger.appendObjects.rollover" iterations:500 block:^(NSUInteger iteration) {
+        [dataLogger appendObjects:objects error:NULL];
+    }];
+    [dataLogger finishCurrentLog];
+    
+    __block NSUInteger logCount = 0;
+    [dataLogger enumerateLogs:^(NSURL *logFileUrl, BOOL *stop) {
+        logCount++;
+    } error:NULL];
+    XCTAssertGreaterThan(logCount, 1);
+}
+
+- (void)testJSONLogFormatter {
+    NSURL *fileURL = [_directory URLByAppendingPathComponent:@"formatter.json"];
+    [[NSFileManager defaultManager] createFileAtPath:fileURL.path contents:nil attributes:nil];
+    NSFileHandle *fileHandle = [NSFileHandle fileHandleForWritingToURL:fileURL error:NULL];
+    ORKJSONLogFormatter *formatter = [[ORKJSONLogFormatter alloc] init];
+    XCTAssertTrue([formatter beginLogWithFileHandle:fileHandle error:NULL]);
+    NSArray *objects = [self logObjectsWithCount:100];
+    
+    [self measureBenchmarkNamed:@"ORKJSONLogFormatter.appendObjects" iterations:500 block:^(NSUInteger iteration) {
+        [formatter appendObjects:objects fileHandle:fileHandle error:NULL];
+    }];
+    [fileHandle closeFile];
+}
+
+- (void)testDataLoggerManagerEnumeration {
+    const NSUInteger loggerCount = 20;
+    const NSUInteger logsPerLogger = 50;
+    
+    ORKDataLoggerManager *manager = [[ORKDataLoggerManager alloc] initWithDirectory:_directory delegate:nil];
+    for (NSUInteger loggerIndex = 0; loggerIndex < loggerCount; loggerIndex++) {
+        ORKDataLogger *dataLogger = [manager addJSONDataLoggerForLogName:[NSString stringWithFormat:@"logger%lu", (unsigned long)loggerIndex]];
+        for (NSUInteger logIndex = 0; logIndex < logsPerLogger; logIndex++) {
+            [dataLogger append:ORKBenchmarkLogObject(logIndex) error:NULL];
+            [dataLogger finishCurrentLog];
+        }
+    }
+    
+    [self measureBenchmarkNamed:@"ORKDataLoggerManager.enumerateLogsNeedingUpload" iterations:50 block:^(NSUInteger iteration) {
+        __block NSUInteger logCount = 0;
+        [manager enumerateLogsNeedingUpload:^(ORKDataLogger *dataLogger, NSURL *logFileUrl, BOOL *stop) {
+            logCount++;
+        } error:NULL];
+        XCTAssertEqual(logCount, loggerCount * logsPerLogger);
+    }];
+}
+
+#pragma mark - Results
+
+- (void)testTaskResultArchive {
+    ORKTaskResult *taskResult = [self taskResultWithStepCount:ORKBenchmarkStepCount];
+    [self measureBenchmarkNamed:@"ORKTaskResult.archive" iterations:100 block:^(NSUInteger iteration) {
+        [NSKeyedArchiver archivedDataWithRootObject:taskResult];
+    }];
+}
+
+- (void)testTaskResultUnarchive {
+    ORKTaskResult *taskResult = [self taskResultWithStepCount:ORKBenchmarkStepCount];
+    NSData *data = [NSKeyedArchiver archivedDataWithRootObject:taskResult];
+    
+    [self measureBenchmarkNamed:@"ORKTaskResult.unarchive" iterations:100 block:^(NSUInteger iteration) {
+        NSKeyedUnarchiver *unarchiver = [[NSKeyedUnarchiver alloc] initForReadingWithData:data];
+        unarchiver.requiresSecureCoding = YES;
+        [unarchiver decodeObjectOfClass:[ORKTaskResult class] forKey:NSKeyedArchiveRootObjectKey];
+        [unarchiver finishDecoding];
+    }];
+}
+
+#pragma mark - Task navigation
+
+- (void)testOrderedTaskNavigation {
+    ORKOrderedTask *task = [[ORKOrderedTask alloc] initWithIdentifier:@"benchmark" steps:[self questionStepsWithCount:ORKBenchmarkStepCount]];
+    ORKTaskResult *taskResult = [self taskResultWithStepCount:ORKBenchmarkStepCount];
+    
+    [self measureBenchmarkNamed:@"ORKOrderedTask.stepAfterStep" iterations:200 block:^(NSUInteger iteration) {
+        NSUInteger stepCount = 0;
+        for (ORKStep *step = [task stepAfterStep:nil withResult:taskResult]; step; step = [task stepAfterStep:step withResult:taskResult]) {
+            [task progressOfCurrentStep:step withResult:taskResult];
+            stepCount++;
+        }
+        XCTAssertEqual(stepCount, ORKBenchmarkStepCount);
+    }];
+}
+
+- (void)testNavigableOrderedTaskNavigation {
+    NSArray<ORKStep *> *steps = [self questionStepsWithCount:ORKBenchmarkStepCount];
+    ORKNavigableOrderedTask *task = [[ORKNavigableOrderedTask alloc] initWithIdentifier:@"benchmark" steps:steps];
+    
+    // Every step with an answer of 5 or more skips the step after it.
+    for (NSUInteger stepIndex = 0; stepIndex + 2 < steps.count; stepIndex++) {
+        NSString *stepIdentifier = steps[stepIndex].identifier;
+        NSPredicate *predicate = [ORKResultPredicate predicateForNumericQuestionResultWithResultSelector:[ORKResultSelector selectorWithResultIdentifier:stepIdentifier]
+                                                                             minimumExpectedAnswerValue:5];
+        ORKPredicateStepNavigationRule *rule = [[ORKPredicateStepNavigationRule alloc] initWithResultPredicates:@[predicate]
+                                                                                    destinationStepIdentifiers:@[steps[stepIndex + 2].identifier]];
+        [task setNavigationRule:rule forTriggerStepIdentifier:stepIdentifier];
+    }
+    ORKTaskResult *taskResult = [self taskResultWithStepCount:ORKBenchmarkStepCount];
+    
+    [self measureBenchmarkNamed:@"ORKNavigableOrderedTask.stepAfterStep" iterations:50 block:^(NSUInteger iteration) {
+        NSUInteger stepCount = 0;
+        for (ORKStep *step = [task stepAfterStep:nil withResult:taskResult]; step; step = [task stepAfterStep:step withResult:taskResult]) {
+            stepCount++;
+        }
+        XCTAssertGreaterThan(stepCount, 0);
+        XCTAssertLessThan(stepCount, ORKBenchmarkStepCount);
+    }];
+}
+
+- (void)testPredicateStepNavigationRuleEvaluation {
+    NSMutableArray<NSPredicate *> *predicates = [NSMutableArray array];
+    NSMutableArray<NSString *> *destinations = [NSMutableArray array];
+    for (NSUInteger stepIndex = 0; stepIndex < 20; stepIndex++) {
+        NSString *stepIdentifier = [NSString stringWithFormat:@"step%lu", (unsigned long)(ORKBenchmarkStepCount - 1 - stepIndex)];
+        ORKResultSelector *resultSelector = [[ORKResultSelector alloc] initWithStepIdentifier:stepIdentifier resultIdentifier:stepIdentifier];
+        // Never matches, so that every predicate is evaluated.
+        [predicates addObject:[ORKResultPredicate predicateForNumericQuestionResultWithResultSelector:resultSelector expectedAnswer:100]];
+        [destinations addObject:stepIdentifier];
+    }
+    ORKPredicateStepNavigationRule *rule = [[ORKPredicateStepNavigationRule alloc] initWithResultPredicates:predicates
+                                                                                destinationStepIdentifiers:destinations
+                                                                                     defaultStepIdentifier:@"step0"];
+    ORKTaskResult *taskResult = [self taskResultWithStepCount:ORKBenchmarkStepCount];
+    
+    [self measureBenchmarkNamed:@"ORKPredicateStepNavigationRule.evaluate" iterations:200 block:^(NSUInteger iteration) {
+        XCTAssertEqualObjects([rule identifierForDestinationStepWithTaskResult:taskResult], @"step0");
+    }];
+}
+
+@end
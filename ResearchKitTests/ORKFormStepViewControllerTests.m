@@ -0,0 +1,222 @@
+/*
+ Copyright (c) 2016, Apple Inc. All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+ 
+ 1.  Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ 2.  Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation and/or
+ other materials provided with the distribution.
+ 
+ 3.  Neither the name of the copyright holder(s) nor the names of any contributors
+ may be used to endorse or promote products derived from this software without
+ specific prior written permission. No license is granted to the trademarks of
+ the copyright holders even if such marks are included in this software.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+@import XCTest;
+@import ResearchKit.Private;
+
+#import "ORKChoiceViewCell.h"
+#import "ORKFormItemCell.h"
+#import "ORKNavigationContainerView.h"
+#import "ORKSelectionTitleLabel.h"
+
+
+@interface ORKFormStepViewControllerTests : XCTestCase
+
+@end
+
+
+@implementation ORKFormStepViewControllerTests {
+    ORKFormStep *_step;
+    ORKFormStepViewController *_viewController;
+    id<UITableViewDataSource> _dataSource;
+    UITableView *_tableView;
+}
+
+- (ORKFormStep *)formStepWithLastItemText:(NSString *)lastItemText {
+    ORKFormStep *step = [[ORKFormStep alloc] initWithIdentifier:@"form" title:@"Form" text:nil];
+    ORKTextChoiceAnswerFormat *choiceFormat = [ORKAnswerFormat choiceAnswerFormatWithStyle:ORKChoiceAnswerStyleSingleChoice
+                                                                               textChoices:@[[ORKTextChoice choiceWithText:@"Yes" value:@1],
+                                                                                             [ORKTextChoice choiceWithText:@"No" value:@0]]];
+    ORKTextAnswerFormat *nameFormat = [ORKAnswerFormat textAnswerFormat];
+    nameFormat.multipleLines = NO;
+    step.formItems = @[[[ORKFormItem alloc] initWithSectionTitle:@"Personal"],
+                       [[ORKFormItem alloc] initWithIdentifier:@"age" text:@"Age" answerFormat:[ORKAnswerFormat integerAnswerFormatWithUnit:nil]],
+                       [[ORKFormItem alloc] initWithIdentifier:@"name" text:@"Name" answerFormat:nameFormat],
+                       [[ORKFormItem alloc] initWithIdentifier:@"smoker" text:@"Smoker" answerFormat:choiceFormat],
+                       [[ORKFormItem alloc] initWithIdentifier:@"weight" text:lastItemText answerFormat:[ORKAnswerFormat decimalAnswerFormatWithUnit:@"kg"]]];
+    return step;
+}
+
+- (void)setUp {
+    [super setUp];
+    _step = [self formStepWithLastItemText:@"Weight"];
+    _viewController = [[ORKFormStepViewController alloc] initWithStep:_step];
+    _viewController.view.frame = CGRectMake(0, 0, 320, 568);
+    _dataSource = (id<UITableViewDataSource>)_viewController;
+    _tableView = [[UITableView alloc] init];
+}
+
+- (UITableViewCell *)cellAtRow:(NSInteger)row section:(NSInteger)section {
+    return [_dataSource tableView:_tableView cellForRowAtIndexPath:[NSIndexPath indexPathForRow:row inSection:section]];
+}
+
+- (void)testSectionsGroupFormItems {
+    XCTAssertEqual([_dataSource numberOfSectionsInTableView:_tableView], 3);
+    
+    // The section title starts a section holding the inline items.
+    XCTAssertEqual([_dataSource tableView:_tableView numberOfRowsInSection:0], 2);
+    XCTAssertEqualObjects([(ORKFormItemCell *)[self cellAtRow:0 section:0] formItem].identifier, @"age");
+    XCTAssertEqualObjects([(ORKFormItemCell *)[self cellAtRow:1 section:0] formItem].identifier, @"name");
+    
+    // A choice item gets its own section with a row per choice.
+    XCTAssertEqual([_dataSource tableView:_tableView numberOfRowsInSection:1], 2);
+    XCTAssertEqualObjects([(ORKChoiceViewCell *)[self cellAtRow:0 section:1] shortLabel].text, @"Yes");
+    XCTAssertEqualObjects([(ORKChoiceViewCell *)[self cellAtRow:1 section:1] shortLabel].text, @"No");
+    
+    // Items after it start a new section.
+    XCTAssertEqual([_dataSource tableView:_tableView numberOfRowsInSection:2], 1);
+    XCTAssertEqualObjects([(ORKFormItemCell *)[self cellAtRow:0 section:2] formItem].identifier, @"weight");
+}
+
+- (void)testReuseIdentifiersFollowCellType {
+    UITableViewCell *ageCell = [self cellAtRow:0 section:0];
+    UITableViewCell *weightCell = [self cellAtRow:0 section:2];
+    XCTAssertTrue([ageCell isKindOfClass:[ORKFormItemNumericCell class]]);
+    XCTAssertTrue([weightCell isKindOfClass:[ORKFormItemNumericCell class]]);
+    XCTAssertEqualObjects(ageCell.reuseIdentifier, NSStringFromClass([ORKFormItemNumericCell class]));
+    XCTAssertEqualObjects(weightCell.reuseIdentifier, ageCell.reuseIdentifier);
+    XCTAssertNotEqual(ageCell, weightCell);
+    
+    XCTAssertEqualObjects([self cellAtRow:1 section:0].reuseIdentifier, NSStringFromClass([ORKFormItemTextFieldCell class]));
+    XCTAssertEqualObjects([self cellAtRow:0 section:1].reuseIdentifier, NSStringFromClass([ORKChoiceViewCell class]));
+    XCTAssertEqualObjects([self cellAtRow:1 section:1].reuseIdentifier, NSStringFromClass([ORKChoiceViewCell class]));
+}
+
+- (void)testCellsAreKeptPerFormItem {
+    UITableViewCell *ageCell = [self cellAtRow:0 section:0];
+    UITableViewCell *yesCell = [self cellAtRow:0 section:1];
+    UITableViewCell *weightCell = [self cellAtRow:0 section:2];
+    XCTAssertEqual([self cellAtRow:0 section:0], ageCell);
+    XCTAssertEqual([self cellAtRow:0 section:1], yesCell);
+    
+    // Only the section whose form item changed gets new cells.
+    _viewController.step = [self formStepWithLastItemText:@"Body weight"];
+    XCTAssertEqual([self cellAtRow:0 section:0], ageCell);
+    XCTAssertEqual([self cellAtRow:0 section:1], yesCell);
+    ORKFormItemCell *newWeightCell = (ORKFormItemCell *)[self cellAtRow:0 section:2];
+    XCTAssertNotEqual(newWeightCell, weightCell);
+    XCTAssertEqualObjects(newWeightCell.formItem.text, @"Body weight");
+}
+
+- (ORKFormStepViewController *)viewControllerWithRequiredAgeStep {
+    ORKFormStep *step = [[ORKFormStep alloc] initWithIdentifier:@"required" title:@"Required" text:nil];
+    ORKNumericAnswerFormat *ageFormat = [ORKAnswerFormat integerAnswerFormatWithUnit:nil];
+    ageFormat.minimum = @0;
+    ageFormat.maximum = @120;
+    ORKTextAnswerFormat *nicknameFormat = [ORKAnswerFormat textAnswerFormatWithMaximumLength:5];
+    nicknameFormat.multipleLines = NO;
+    step.formItems = @[[[ORKFormItem alloc] initWithIdentifier:@"age" text:@"Age" answerFormat:ageFormat optional:NO],
+                       [[ORKFormItem alloc] initWithIdentifier:@"nickname" text:@"Nickname" answerFormat:nicknameFormat optional:YES]];
+    
+    ORKFormStepViewController *viewController = [[ORKFormStepViewController alloc] initWithStep:step];
+    viewController.view.frame = CGRectMake(0, 0, 320, 568);
+    return viewController;
+}
+
+- (BOOL)isContinueEnabledInViewController:(ORKFormStepViewController *)viewController {
+    return [(ORKNavigationContainerView *)[viewController valueForKey:@"continueSkipView"] continueEnabled];
+}
+
+// Answers the form item in `row` the way its cell does when the user edits it.
+- (void)answerRow:(NSInteger)row with:(id)answer inViewController:(ORKFormStepViewController *)viewController {
+    id<UITableViewDataSource> dataSource = (id<UITableViewDataSource>)viewController;
+    ORKFormItemCell *cell = (ORKFormItemCell *)[dataSource tableView:_tableView cellForRowAtIndexPath:[NSIndexPath indexPathForRow:row inSection:0]];
+    [(id<ORKFormItemCellDelegate>)viewController formItemCell:cell answerDidChangeTo:answer];
+}
+
+- (void)testContinueFollowsAnswerChanges {
+    ORKFormStepViewController *viewController = [self viewControllerWithRequiredAgeStep];
+    XCTAssertFalse([self isContinueEnabledInViewController:viewController]);
+    
+    // An optional answer alone does not complete the form.
+    [self answerRow:1 with:@"Sam" inViewController:viewController];
+    XCTAssertFalse([self isContinueEnabledInViewController:viewController]);
+    
+    [self answerRow:0 with:@30 inViewController:viewController];
+    XCTAssertTrue([self isContinueEnabledInViewController:viewController]);
+    
+    // Clearing the required answer disables continue again.
+    [self answerRow:0 with:nil inViewController:viewController];
+    XCTAssertFalse([self isContinueEnabledInViewController:viewController]);
+    XCTAssertNil([viewController valueForKey:@"savedAnswers"][@"age"]);
+    
+    [self answerRow:0 with:@31 inViewController:viewController];
+    XCTAssertTrue([self isContinueEnabledInViewController:viewController]);
+    
+    // Clearing an optional answer leaves the form complete.
+    [self answerRow:1 with:nil inViewController:viewController];
+    XCTAssertTrue([self isContinueEnabledInViewController:viewController]);
+}
+
+- (void)testContinueDisabledByInvalidAnswers {
+    ORKFormStepViewController *viewController = [self viewControllerWithRequiredAgeStep];
+    [self answerRow:0 with:@30 inViewController:viewController];
+    XCTAssertTrue([self isContinueEnabledInViewController:viewController]);
+    
+    // An invalid optional answer blocks continue until it is fixed.
+    [self answerRow:1 with:@"Samantha" inViewController:viewController];
+    XCTAssertFalse([self isContinueEnabledInViewController:viewController]);
+    [self answerRow:1 with:@"Sam" inViewController:viewController];
+    XCTAssertTrue([self isContinueEnabledInViewController:viewController]);
+    
+    // An out of range required answer does not count as answered.
+    [self answerRow:0 with:@150 inViewController:viewController];
+    XCTAssertFalse([self isContinueEnabledInViewController:viewController]);
+    [self answerRow:0 with:@45 inViewController:viewController];
+    XCTAssertTrue([self isContinueEnabledInViewController:viewController]);
+}
+
+- (void)testContinueStateSurvivesStateRestoration {
+    ORKFormStepViewController *viewController = [self viewControllerWithRequiredAgeStep];
+    [self answerRow:0 with:@30 inViewController:viewController];
+    XCTAssertTrue([self isContinueEnabledInViewController:viewController]);
+    
+    NSMutableData *data = [NSMutableData data];
+    NSKeyedArchiver *archiver = [[NSKeyedArchiver alloc] initForWritingWithMutableData:data];
+    [viewController encodeRestorableStateWithCoder:archiver];
+    [archiver finishEncoding];
+    
+    ORKFormStepViewController *restoredViewController = [self viewControllerWithRequiredAgeStep];
+    XCTAssertFalse([self isContinueEnabledInViewController:restoredViewController]);
+    NSKeyedUnarchiver *unarchiver = [[NSKeyedUnarchiver alloc] initForReadingWithData:data];
+    [restoredViewController decodeRestorableStateWithCoder:unarchiver];
+    [unarchiver finishDecoding];
+    XCTAssertEqualObjects([restoredViewController valueForKey:@"savedAnswers"][@"age"], @30);
+    XCTAssertTrue([self isContinueEnabledInViewController:restoredViewController]);
+    
+    // The restored answers keep being tracked as they change.
+    [self answerRow:0 with:nil inViewController:restoredViewController];
+    XCTAssertFalse([self isContinueEnabledInViewController:restoredViewController]);
+    [self answerRow:0 with:@30 inViewController:restoredViewController];
+    XCTAssertTrue([self isContinueEnabledInViewController:restoredViewController]);
+}
+
+@end
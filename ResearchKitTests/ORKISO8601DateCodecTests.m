@@ -0,0 +1,180 @@
+/*
+ Copyright (c) 2016, Apple Inc. All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+ 
+ 1.  Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ 2.  Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation and/or
+ other materials provided with the distribution.
+ 
+ 3.  Neither the name of the copyright holder(s) nor the names of any contributors
+ may be used to endorse or promote products derived from this software without
+ specific prior written permission. No license is granted to the trademarks of
+ the copyright holders even if such marks are included in this software.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+
+
+@import XCTest;
+@import ResearchKit.Private;
+
+#import "ORKISO8601DateCodec.h"
+
+
+@interface ORKISO8601DateCodecTests : XCTestCase
+
+@end
+
+
+@implementation ORKISO8601DateCodecTests {
+    NSTimeZone *_savedDefaultTimeZone;
+}
+
+- (void)setUp {
+    [super setUp];
+    _savedDefaultTimeZone = [NSTimeZone defaultTimeZone];
+}
+
+- (void)tearDown {
+    [NSTimeZone setDefaultTimeZone:_savedDefaultTimeZone];
+    [super tearDown];
+}
+
+- (NSDateFormatter *)referenceFormatter {
+    NSDateFormatter *formatter = [[NSDateFormatter alloc] init];
+    [formatter setDateFormat:@"yyyy-MM-dd'T'HH:mm:ssZ"];
+    [formatter setLocale:[NSLocale localeWithLocaleIdentifier:@"en_US_POSIX"]];
+    return formatter;
+}
+
+- (NSArray<NSDate *> *)testDates {
+    NSMutableArray *dates = [NSMutableArray array];
+    // Every 7 hours and a bit over two years, crossing daylight saving transitions and a leap day.
+    NSTimeInterval start = 1451606400; // 2016-01-01T00:00:00Z
+    for (NSTimeInterval t = start; t < start + 2 * 366 * 86400; t += 7 * 3600 + 0.75) {
+        [dates addObject:[NSDate dateWithTimeIntervalSince1970:t]];
+    }
+    [dates addObject:[NSDate dateWithTimeIntervalSince1970:0]];
+    [dates addObject:[NSDate dateWithTimeIntervalSince1970:-1.5]];
+    [dates addObject:[NSDate dateWithTimeIntervalSince1970:951782400]]; // 2000-02-29
+    return dates;
+}
+
+- (void)testFormattingMatchesDateFormatter {
+    for (NSString *name in @[@"UTC", @"America/Los_Angeles", @"Asia/Kolkata", @"Australia/Lord_Howe", @"Pacific/Chatham"]) {
+        [NSTimeZone setDefaultTimeZone:[NSTimeZone timeZoneWithName:name]];
+        NSDateFormatter *formatter = [self referenceFormatter];
+        for (NSDate *date in [self testDates]) {
+            XCTAssertEqualObjects(ORKStringFromDateISO8601(date), [formatter stringFromDate:date], @"%@ %@", name, date);
+        }
+    }
+}
+
+- (void)testRoundTrip {
+    for (NSString *name in @[@"UTC", @"America/New_York", @"Asia/Kathmandu"]) {
+        [NSTimeZone setDefaultTimeZone:[NSTimeZone timeZoneWithName:name]];
+        for (NSDate *date in [self testDates]) {
+            NSDate *parsed = ORKDateFromStringISO8601(ORKStringFromDateISO8601(date));
+            XCTAssertEqual(parsed.timeIntervalSince1970, floor(date.timeIntervalSince1970), @"%@ %@", name, date);
+        }
+    }
+}
+
+- (void)testParsing {
+    NSDate *expected = [NSDate dateWithTimeIntervalSince1970:1451703845]; // 2016-01-02T03:04:05Z
+    XCTAssertEqualObjects(ORKDateFromStringISO8601(@"2016-01-02T03:04:05+0000"), expected);
+    XCTAssertEqualObjects(ORKDateFromStringISO8601(@"2016-01-02T03:04:05Z"), expected);
+    XCTAssertEqualObjects(ORKDateFromStringISO8601(@"2016-01-02T08:34:05+05:30"), expected);
+    XCTAssertEqualObjects(ORKDateFromStringISO8601(@"2016-01-01T22:04:05-05"), expected);
+    
+    const char *invalid[] = { "2016-02-30T00:00:00+0000", "2015-02-29T00:00:00+0000", "2016-01-02T24:00:00+0000",
+                              "2016-01-02 03:04:05+0000", "2016-01-02T03:04:05", "2016-01-02T03:04:05+00:0" };
+    for (size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++) {
+        XCTAssertNil(ORKISO8601ParseDate(invalid[i], strlen(invalid[i])), @"%s", invalid[i]);
+    }
+}
+
+- (void)testFormattingFollowsDefaultTimeZoneChanges {
+    NSDate *date = [NSDate dateWithTimeIntervalSince1970:1451703845]; // 2016-01-02T03:04:05Z
+    [NSTimeZone setDefaultTimeZone:[NSTimeZone timeZoneWithName:@"Asia/Tokyo"]];
+    XCTAssertEqualObjects(ORKStringFromDateISO8601(date), @"2016-01-02T12:04:05+0900");
+    [NSTimeZone setDefaultTimeZone:[NSTimeZone timeZoneWithName:@"America/Chicago"]];
+    XCTAssertEqualObjects(ORKStringFromDateISO8601(date), @"2016-01-01T21:04:05-0600");
+    
+    // Short-lived zones replacing each other must not be mistaken for the cached one.
+    for (NSInteger hours = -11; hours <= 12; hours++) {
+        @autoreleasepool {
+            [NSTimeZone setDefaultTimeZone:[NSTimeZone timeZoneForSecondsFromGMT:hours * 3600]];
+            NSString *expected = [[self referenceFormatter] stringFromDate:date];
+            XCTAssertEqualObjects(ORKStringFromDateISO8601(date), expected, @"%ld", (long)hours);
+        }
+    }
+}
+
+- (void)testConcurrentFormatting {
+    [NSTimeZone setDefaultTimeZone:[NSTimeZone timeZoneWithName:@"Europe/London"]];
+    NSArray<NSDate *> *dates = [self testDates];
+    NSDateFormatter *formatter = [self referenceFormatter];
+    NSMutableArray<NSString *> *expected = [NSMutableArray arrayWithCapacity:dates.count];
+    for (NSDate *date in dates) {
+        [expected addObject:[formatter stringFromDate:date]];
+    }
+    
+    // Each iteration only writes its own slots.
+    NSMutableData *matches = [NSMutableData dataWithLength:dates.count];
+    uint8_t *matchBytes = matches.mutableBytes;
+    dispatch_apply(8, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t iteration) {
+        for (NSUInteger i = iteration; i < dates.count; i += 8) {
+            matchBytes[i] = [ORKStringFromDateISO8601(dates[i]) isEqualToString:expected[i]];
+        }
+    });
+    for (NSUInteger i = 0; i < dates.count; i++) {
+        XCTAssertTrue(matchBytes[i], @"%@", dates[i]);
+    }
+}
+
+- (void)testFormattingPerformance {
+    NSArray<NSDate *> *dates = [self testDates];
+    [self measureBlock:^{
+        for (NSUInteger repeat = 0; repeat < 20; repeat++) {
+            for (NSDate *date in dates) {
+                @autoreleasepool {
+                    ORKStringFromDateISO8601(date);
+                }
+            }
+        }
+    }];
+}
+
+- (void)testDateFormatterPerformance {
+    // Baseline for testFormattingPerformance.
+    NSArray<NSDate *> *dates = [self testDates];
+    NSDateFormatter *formatter = [self referenceFormatter];
+    [self measureBlock:^{
+        for (NSUInteger repeat = 0; repeat < 20; repeat++) {
+            for (NSDate *date in dates) {
+                @autoreleasepool {
+                    [formatter stringFromDate:date];
+                }
+            }
+        }
+    }];
+}
+
+@end
@@ -0,0 +1,228 @@
+/*
+ Copyright (c) 2016, Apple Inc. All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+ 
+ 1.  Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ 2.  Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation and/or
+ other materials provided with the distribution.
+ 
+ 3.  Neither the name of the copyright holder(s) nor the names of any contributors
+ may be used to endorse or promote products derived from this software without
+ specific prior written permission. No license is granted to the trademarks of
+ the copyright holders even if such marks are included in this software.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+
+
+@import XCTest;
+@import ResearchKit.Private;
+
+#import "ORKImageCaptureView.h"
+#import "ORKStepViewController_Internal.h"
+
+
+@interface ORKImageCaptureStepViewControllerTests : XCTestCase <ORKStepViewControllerDelegate>
+
+@end
+
+
+@implementation ORKImageCaptureStepViewControllerTests {
+    NSURL *_directory;
+    ORKImageCaptureStepViewController *_viewController;
+    ORKImageCaptureView *_imageCaptureView;
+    NSError *_initialError;
+    XCTestExpectation *_finishExpectation;
+    BOOL _fileExistedWhenFinished;
+}
+
+- (void)setUp {
+    [super setUp];
+    
+    _directory = [NSURL fileURLWithPath:[NSTemporaryDirectory() stringByAppendingPathComponent:[NSUUID UUID].UUIDString] isDirectory:YES];
+    BOOL success = [[NSFileManager defaultManager] createDirectoryAtURL:_directory withIntermediateDirectories:YES attributes:nil error:nil];
+    XCTAssertTrue(success, @"Create output directory");
+    
+    ORKImageCaptureStep *step = [[ORKImageCaptureStep alloc] initWithIdentifier:@"image"];
+    _viewController = [[ORKImageCaptureStepViewController alloc] initWithStep:step];
+    _viewController.delegate = self;
+    _imageCaptureView = [_viewController valueForKey:@"imageCaptureView"];
+    
+    // Let capture session setup finish; without a camera, it reports an error on the main queue.
+    XCTestExpectation *expectation = [self expectationWithDescription:@"session set up"];
+    dispatch_async([_viewController valueForKey:@"sessionQueue"], ^{
+        dispatch_async(dispatch_get_main_queue(), ^{
+            [expectation fulfill];
+        });
+    });
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+    _initialError = _imageCaptureView.error;
+}
+
+- (void)tearDown {
+    _viewController.delegate = nil;
+    _viewController = nil;
+    [[NSFileManager defaultManager] removeItemAtURL:_directory error:nil];
+    _directory = nil;
+    
+    [super tearDown];
+}
+
+#pragma mark Helpers
+
+- (NSURL *)expectedFileURL {
+    return [_directory URLByAppendingPathComponent:@"image.jpg"];
+}
+
+- (NSData *)dataWithString:(NSString *)string {
+    return [string dataUsingEncoding:NSUTF8StringEncoding];
+}
+
+- (void)captureData:(NSData *)data {
+    [_viewController setValue:data forKey:@"capturedImageData"];
+}
+
+- (ORKFileResult *)fileResult {
+    return (ORKFileResult *)[_viewController.result resultForIdentifier:@"image"];
+}
+
+// Holds the persistence queue until the returned semaphore is signaled.
+- (dispatch_semaphore_t)blockPersistence {
+    dispatch_semaphore_t semaphore = dispatch_semaphore_create(0);
+    dispatch_group_async([_viewController valueForKey:@"persistenceGroup"], [_viewController valueForKey:@"persistenceQueue"], ^{
+        dispatch_semaphore_wait(semaphore, DISPATCH_TIME_FOREVER);
+    });
+    return semaphore;
+}
+
+// Waits for pending writes, and for any errors they reported on the main queue.
+- (void)waitForPersistence {
+    XCTestExpectation *expectation = [self expectationWithDescription:@"persisted"];
+    dispatch_group_notify([_viewController valueForKey:@"persistenceGroup"], dispatch_get_main_queue(), ^{
+        [expectation fulfill];
+    });
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+}
+
+#pragma mark ORKStepViewControllerDelegate
+
+- (void)stepViewController:(ORKStepViewController *)stepViewController didFinishWithNavigationDirection:(ORKStepViewControllerNavigationDirection)direction {
+    _fileExistedWhenFinished = [[NSFileManager defaultManager] fileExistsAtPath:[self expectedFileURL].path];
+    [_finishExpectation fulfill];
+}
+
+- (void)stepViewControllerResultDidChange:(ORKStepViewController *)stepViewController {
+}
+
+- (void)stepViewControllerDidFail:(ORKStepViewController *)stepViewController withError:(NSError *)error {
+}
+
+- (BOOL)stepViewControllerHasNextStep:(ORKStepViewController *)stepViewController {
+    return NO;
+}
+
+- (BOOL)stepViewControllerHasPreviousStep:(ORKStepViewController *)stepViewController {
+    return NO;
+}
+
+- (void)stepViewController:(ORKStepViewController *)stepViewController recorder:(ORKRecorder *)recorder didFailWithError:(NSError *)error {
+}
+
+#pragma mark Tests
+
+- (void)testCaptureIsWrittenInBackground {
+    _viewController.outputDirectory = _directory;
+    NSData *data = [self dataWithString:@"capture"];
+    
+    // The result has the file URL straight away, before the file is written.
+    dispatch_semaphore_t semaphore = [self blockPersistence];
+    [self captureData:data];
+    XCTAssertEqualObjects([self fileResult].fileURL, [self expectedFileURL]);
+    XCTAssertFalse([[NSFileManager defaultManager] fileExistsAtPath:[self expectedFileURL].path]);
+    
+    dispatch_semaphore_signal(semaphore);
+    [self waitForPersistence];
+    XCTAssertEqualObjects([NSData dataWithContentsOfURL:[self expectedFileURL]], data);
+    XCTAssertEqual(_imageCaptureView.error, _initialError);
+}
+
+- (void)testCaptureIsWrittenOnceOutputDirectoryIsSet {
+    NSData *data = [self dataWithString:@"capture"];
+    [self captureData:data];
+    [self waitForPersistence];
+    XCTAssertNil([self fileResult].fileURL);
+    XCTAssertEqual(_imageCaptureView.error, _initialError);
+    
+    _viewController.outputDirectory = _directory;
+    XCTAssertEqualObjects([self fileResult].fileURL, [self expectedFileURL]);
+    [self waitForPersistence];
+    XCTAssertEqualObjects([NSData dataWithContentsOfURL:[self expectedFileURL]], data);
+}
+
+- (void)testGoForwardWaitsForPendingWrite {
+    _viewController.outputDirectory = _directory;
+    dispatch_semaphore_t semaphore = [self blockPersistence];
+    [self captureData:[self dataWithString:@"capture"]];
+    
+    _finishExpectation = [self expectationWithDescription:@"finished"];
+    [_viewController goForward];
+    [[NSRunLoop currentRunLoop] runUntilDate:[NSDate dateWithTimeIntervalSinceNow:0.2]];
+    XCTAssertFalse([[NSFileManager defaultManager] fileExistsAtPath:[self expectedFileURL].path]);
+    
+    dispatch_semaphore_signal(semaphore);
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+    XCTAssertTrue(_fileExistedWhenFinished);
+}
+
+- (void)testWriteErrorForReplacedCaptureIsIgnored {
+    _viewController.outputDirectory = [_directory URLByAppendingPathComponent:@"missing" isDirectory:YES];
+    
+    // The capture is retaken before its write fails.
+    dispatch_semaphore_t semaphore = [self blockPersistence];
+    [self captureData:[self dataWithString:@"first"]];
+    [self captureData:nil];
+    dispatch_semaphore_signal(semaphore);
+    [self waitForPersistence];
+    XCTAssertEqual(_imageCaptureView.error, _initialError);
+    
+    // A failed write of the current capture is reported.
+    [self captureData:[self dataWithString:@"second"]];
+    [self waitForPersistence];
+    XCTAssertNotNil(_imageCaptureView.error);
+    XCTAssertNotEqual(_imageCaptureView.error, _initialError);
+    XCTAssertNil([self fileResult].fileURL);
+}
+
+- (void)testRetakeRemovesOldFileBeforeWritingNewOne {
+    _viewController.outputDirectory = _directory;
+    [self captureData:[self dataWithString:@"first"]];
+    [self waitForPersistence];
+    XCTAssertEqualObjects([NSData dataWithContentsOfURL:[self expectedFileURL]], [self dataWithString:@"first"]);
+    
+    // Both captures use the same file name, so the removal must run before the second write.
+    dispatch_semaphore_t semaphore = [self blockPersistence];
+    [self captureData:nil];
+    [self captureData:[self dataWithString:@"second"]];
+    dispatch_semaphore_signal(semaphore);
+    [self waitForPersistence];
+    XCTAssertEqualObjects([NSData dataWithContentsOfURL:[self expectedFileURL]], [self dataWithString:@"second"]);
+    XCTAssertEqualObjects([self fileResult].fileURL, [self expectedFileURL]);
+}
+
+@end
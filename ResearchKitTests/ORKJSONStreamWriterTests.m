@@ -0,0 +1,126 @@
+/*
+ Copyright (c) 2016, Apple Inc. All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+ 
+ 1.  Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ 2.  Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation and/or
+ other materials provided with the distribution.
+ 
+ 3.  Neither the name of the copyright holder(s) nor the names of any contributors
+ may be used to endorse or promote products derived from this software without
+ specific prior written permission. No license is granted to the trademarks of
+ the copyright holders even if such marks are included in this software.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+
+
+@import XCTest;
+@import HealthKit;
+@import ResearchKit.Private;
+
+#import "CLLocation+ORKJSONDictionary.h"
+#import "HKSample+ORKJSONDictionary.h"
+#import "ORKJSONStreamWriter.h"
+#import "UITouch+ORKJSONDictionary.h"
+
+
+@interface ORKJSONStreamWriterTests : XCTestCase
+
+@end
+
+
+@implementation ORKJSONStreamWriterTests
+
+- (NSString *)streamedJSONObject:(id)object {
+    ORKJSONStreamWriter *writer = [ORKJSONStreamWriter new];
+    XCTAssertTrue([writer writeJSONObject:object]);
+    XCTAssertTrue([writer finishWithError:NULL]);
+    return [[NSString alloc] initWithData:writer.data encoding:NSUTF8StringEncoding];
+}
+
+- (NSString *)serializedJSONObject:(id)object {
+    NSData *data = [NSJSONSerialization dataWithJSONObject:object options:0 error:NULL];
+    return [[NSString alloc] initWithData:data encoding:NSUTF8StringEncoding];
+}
+
+- (void)assertStreamedBytesMatchSerialization:(id)object {
+    XCTAssertEqualObjects([self streamedJSONObject:object], [self serializedJSONObject:object]);
+}
+
+- (void)testNumbers {
+    XCTAssertEqualObjects([self streamedJSONObject:@[@YES, @NO, @(-3), @(ULLONG_MAX), @(0.5), @(0.25f)]],
+                          @"[true,false,-3,18446744073709551615,0.5,0.25]");
+    XCTAssertEqualObjects([self streamedJSONObject:@[[NSDecimalNumber decimalNumberWithString:@"1234.5678901234567890123"],
+                                                     [NSDecimalNumber decimalNumberWithString:@"-42"]]],
+                          @"[1234.5678901234567890123,-42]");
+    
+    ORKJSONStreamWriter *writer = [ORKJSONStreamWriter new];
+    XCTAssertFalse([writer writeJSONObject:@[[NSDecimalNumber notANumber]]]);
+    XCTAssertFalse([writer finishWithError:NULL]);
+}
+
+- (void)testTouchMatchesSerialization {
+    ORKTouchSample sample = {
+        .timestamp = 183642.40871025,
+        .phase = UITouchPhaseMoved,
+        .index = 2,
+        .location = CGPointMake(120.5, 48.25),
+        .viewSize = CGSizeMake(375, 667)
+    };
+    [self assertStreamedBytesMatchSerialization:ORKJSONDictionaryFromTouchSample(sample)];
+}
+
+- (void)testLocationMatchesSerialization {
+    CLLocation *location = [[CLLocation alloc] initWithCoordinate:CLLocationCoordinate2DMake(37.33182, -122.03118)
+                                                         altitude:61.3
+                                               horizontalAccuracy:5
+                                                 verticalAccuracy:3.5
+                                                           course:271.2
+                                                            speed:1.42
+                                                        timestamp:[NSDate dateWithTimeIntervalSinceReferenceDate:500000000.125]];
+    [self assertStreamedBytesMatchSerialization:[location ork_JSONDictionary]];
+}
+
+- (void)testHealthSampleMatchesSerialization {
+    HKQuantityType *type = [HKQuantityType quantityTypeForIdentifier:HKQuantityTypeIdentifierHeartRate];
+    HKUnit *unit = [[HKUnit countUnit] unitDividedByUnit:[HKUnit minuteUnit]];
+    NSDate *startDate = [NSDate dateWithTimeIntervalSinceReferenceDate:500000000];
+    HKQuantitySample *sample = [HKQuantitySample quantitySampleWithType:type
+                                                               quantity:[HKQuantity quantityWithUnit:unit doubleValue:72.5]
+                                                              startDate:startDate
+                                                                endDate:[startDate dateByAddingTimeInterval:5]
+                                                               metadata:@{@"reading": [NSDecimalNumber decimalNumberWithString:@"0.1"],
+                                                                          HKMetadataKeyWasUserEntered: @YES}];
+    ORKSampleJSONOptions options = ORKSampleIncludeMetadata | ORKSampleIncludeUUID;
+    NSDictionary *dictionary = [sample ork_JSONDictionaryWithOptions:options unit:unit];
+    [self assertStreamedBytesMatchSerialization:dictionary];
+    
+    // The sample's own writer orders its keys differently, so compare what it reads back as.
+    ORKJSONStreamWriter *writer = [ORKJSONStreamWriter new];
+    [sample ork_writeJSONWithOptions:options unit:unit writer:writer];
+    XCTAssertTrue([writer finishWithError:NULL]);
+    NSDictionary *streamed = [NSJSONSerialization JSONObjectWithData:writer.data options:0 error:NULL];
+    NSDictionary *serialized = [NSJSONSerialization JSONObjectWithData:[NSJSONSerialization dataWithJSONObject:dictionary options:0 error:NULL]
+                                                               options:0
+                                                                 error:NULL];
+    XCTAssertEqualObjects(streamed, serialized);
+}
+
+@end
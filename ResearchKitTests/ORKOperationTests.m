@@ -0,0 +1,102 @@
+/*
+ Copyright (c) 2016, Apple Inc. All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+ 
+ 1.  Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ 2.  Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation and/or
+ other materials provided with the distribution.
+ 
+ 3.  Neither the name of the copyright holder(s) nor the names of any contributors
+ may be used to endorse or promote products derived from this software without
+ specific prior written permission. No license is granted to the trademarks of
+ the copyright holders even if such marks are included in this software.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+@import XCTest;
+@import ResearchKit.Private;
+
+#import "ORKOperation.h"
+
+
+@interface ORKOperationTests : XCTestCase
+
+@end
+
+
+@implementation ORKOperationTests
+
+/*
+ Mirrors a query operation's first query: the start block runs under the operation's lock and
+ waits synchronously on the work queue, while the watchdog fires on that same queue.
+ */
+- (void)testWatchdogDoesNotDeadlockWithOperationWaitingOnWorkQueue {
+    dispatch_queue_t workQueue = dispatch_queue_create("ORKOperationTests.work", DISPATCH_QUEUE_SERIAL);
+    dispatch_semaphore_t startBlockHoldsLock = dispatch_semaphore_create(0);
+    dispatch_semaphore_t watchdogFired = dispatch_semaphore_create(0);
+    
+    ORKOperation *operation = [[ORKOperation alloc] init];
+    operation.startBlock = ^(ORKOperation *op) {
+        op.deadline = CFAbsoluteTimeGetCurrent() - 1;
+        dispatch_semaphore_signal(startBlockHoldsLock);
+        dispatch_semaphore_wait(watchdogFired, DISPATCH_TIME_FOREVER);
+        dispatch_sync(workQueue, ^{
+        });
+    };
+    
+    dispatch_async(workQueue, ^{
+        dispatch_semaphore_wait(startBlockHoldsLock, DISPATCH_TIME_FOREVER);
+        dispatch_semaphore_signal(watchdogFired);
+        // The lock is held by the start block, which is about to wait on this queue.
+        [operation timeoutIfPastDeadline:CFAbsoluteTimeGetCurrent()];
+    });
+    
+    XCTestExpectation *started = [self expectationWithDescription:@"start returned"];
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
+        [operation start];
+        [started fulfill];
+    });
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+    XCTAssertTrue(operation.isExecuting);
+    
+    // Once the lock is free, the next watchdog tick times the operation out.
+    dispatch_sync(workQueue, ^{
+        [operation timeoutIfPastDeadline:CFAbsoluteTimeGetCurrent()];
+    });
+    XCTAssertTrue(operation.isFinished);
+    XCTAssertNotNil(operation.error);
+}
+
+- (void)testTimeoutIgnoresOperationWithoutDeadline {
+    ORKOperation *operation = [[ORKOperation alloc] init];
+    operation.startBlock = ^(ORKOperation *op) {
+    };
+    [operation start];
+    [operation timeoutIfPastDeadline:CFAbsoluteTimeGetCurrent()];
+    XCTAssertTrue(operation.isExecuting);
+    
+    operation.deadline = CFAbsoluteTimeGetCurrent() + 60;
+    [operation timeoutIfPastDeadline:CFAbsoluteTimeGetCurrent()];
+    XCTAssertTrue(operation.isExecuting);
+    
+    [operation timeoutIfPastDeadline:operation.deadline];
+    XCTAssertTrue(operation.isFinished);
+}
+
+@end
@@ -0,0 +1,158 @@
+/*
+ Copyright (c) 2016, Apple Inc. All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+ 
+ 1.  Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ 2.  Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation and/or
+ other materials provided with the distribution.
+ 
+ 3.  Neither the name of the copyright holder(s) nor the names of any contributors
+ may be used to endorse or promote products derived from this software without
+ specific prior written permission. No license is granted to the trademarks of
+ the copyright holders even if such marks are included in this software.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+@import XCTest;
+@import ResearchKit.Private;
+@import HealthKit;
+
+#import "ORKCollector_Internal.h"
+#import "ORKHealthQuantityTypeRecorder.h"
+#import "ORKQueryPageSizer.h"
+
+
+@interface ORKQueryPageSizerTests : XCTestCase
+
+@end
+
+
+@implementation ORKQueryPageSizerTests
+
+- (ORKQueryPageSizer *)sizerWithInitialLimit:(NSUInteger)initialLimit {
+    return [[ORKQueryPageSizer alloc] initWithInitialLimit:initialLimit minimumLimit:100 maximumLimit:20000];
+}
+
+- (void)testInitialLimitIsClamped {
+    XCTAssertEqual([self sizerWithInitialLimit:1000].limit, 1000);
+    XCTAssertEqual([self sizerWithInitialLimit:10].limit, 100);
+    XCTAssertEqual([self sizerWithInitialLimit:1000000].limit, 20000);
+    
+    XCTAssertThrows([[ORKQueryPageSizer alloc] initWithInitialLimit:100 minimumLimit:0 maximumLimit:100]);
+    XCTAssertThrows([[ORKQueryPageSizer alloc] initWithInitialLimit:100 minimumLimit:200 maximumLimit:100]);
+}
+
+- (void)testFastFullPagesGrowAtMostTwofold {
+    ORKQueryPageSizer *sizer = [self sizerWithInitialLimit:1000];
+    
+    // 0.5 s worth of samples at this rate would be 5000, but growth is capped at double.
+    [sizer recordPageWithCount:1000 limit:1000 queryDuration:0.05 processingDuration:0.05];
+    XCTAssertEqual(sizer.limit, 2000);
+    
+    [sizer recordPageWithCount:2000 limit:2000 queryDuration:0.2 processingDuration:0.05];
+    XCTAssertEqual(sizer.limit, 4000);
+    
+    // A page that took no measurable time doubles the limit.
+    [sizer recordPageWithCount:4000 limit:4000 queryDuration:0 processingDuration:0];
+    XCTAssertEqual(sizer.limit, 8000);
+}
+
+- (void)testSlowPagesShrinkAtMostTwofold {
+    ORKQueryPageSizer *sizer = [self sizerWithInitialLimit:1000];
+    
+    [sizer recordPageWithCount:1000 limit:1000 queryDuration:0.5 processingDuration:0.5];
+    XCTAssertEqual(sizer.limit, 500);
+    
+    // 0.5 s worth would be 125, but shrinking is capped at half.
+    [sizer recordPageWithCount:500 limit:500 queryDuration:1.0 processingDuration:1.0];
+    XCTAssertEqual(sizer.limit, 250);
+}
+
+- (void)testShortPagesNeverGrowTheLimit {
+    ORKQueryPageSizer *sizer = [self sizerWithInitialLimit:1000];
+    
+    [sizer recordPageWithCount:10 limit:1000 queryDuration:0.001 processingDuration:0];
+    XCTAssertEqual(sizer.limit, 1000);
+    
+    // A slow short page still shrinks it.
+    [sizer recordPageWithCount:500 limit:1000 queryDuration:1.0 processingDuration:1.0];
+    XCTAssertEqual(sizer.limit, 500);
+}
+
+- (void)testLimitIsClampedToRange {
+    ORKQueryPageSizer *sizer = [self sizerWithInitialLimit:15000];
+    [sizer recordPageWithCount:15000 limit:15000 queryDuration:0.01 processingDuration:0];
+    XCTAssertEqual(sizer.limit, 20000);
+    
+    sizer = [self sizerWithInitialLimit:150];
+    [sizer recordPageWithCount:150 limit:150 queryDuration:5.0 processingDuration:5.0];
+    XCTAssertEqual(sizer.limit, 100);
+}
+
+- (void)testEmptyPagesAreIgnored {
+    ORKQueryPageSizer *sizer = [self sizerWithInitialLimit:1000];
+    [sizer recordPageWithCount:0 limit:1000 queryDuration:10.0 processingDuration:0];
+    XCTAssertEqual(sizer.limit, 1000);
+    XCTAssertEqual(sizer.samplesPerSecond, 0);
+}
+
+- (void)testSamplesPerSecondIsSmoothed {
+    ORKQueryPageSizer *sizer = [self sizerWithInitialLimit:1000];
+    [sizer recordPageWithCount:1000 limit:1000 queryDuration:0.25 processingDuration:0.25];
+    XCTAssertEqualWithAccuracy(sizer.samplesPerSecond, 2000, 1e-9);
+    
+    [sizer recordPageWithCount:1000 limit:1000 queryDuration:0.5 processingDuration:0.5];
+    XCTAssertEqualWithAccuracy(sizer.samplesPerSecond, 0.3 * 1000 + 0.7 * 2000, 1e-9);
+}
+
+- (void)testHealthCollectorQueriesWithItsSizersLimit {
+    HKQuantityType *type = [HKQuantityType quantityTypeForIdentifier:HKQuantityTypeIdentifierStepCount];
+    ORKHealthCollector *collector = [[ORKHealthCollector alloc] initWithSampleType:type unit:[HKUnit countUnit] startDate:[NSDate date]];
+    
+    // The query operation requests `pageSizer.limit` for each page and records the page back.
+    ORKQueryPageSizer *sizer = collector.pageSizer;
+    XCTAssertEqual(sizer.minimumLimit, 100);
+    XCTAssertEqual(sizer.maximumLimit, 20000);
+    XCTAssertEqual(collector.queryLimit, 1000);
+    
+    [sizer recordPageWithCount:1000 limit:1000 queryDuration:0.05 processingDuration:0.05];
+    XCTAssertEqual(collector.queryLimit, 2000);
+    
+    // Copies start sizing afresh.
+    ORKHealthCollector *copy = [collector copy];
+    XCTAssertNotEqual(copy.pageSizer, sizer);
+    XCTAssertEqual(copy.queryLimit, 1000);
+}
+
+- (void)testHealthQuantityTypeRecorderStartsWithSmallPages {
+    HKQuantityType *type = [HKQuantityType quantityTypeForIdentifier:HKQuantityTypeIdentifierHeartRate];
+    HKUnit *unit = [[HKUnit countUnit] unitDividedByUnit:[HKUnit minuteUnit]];
+    ORKHealthQuantityTypeRecorder *recorder = [[ORKHealthQuantityTypeRecorder alloc] initWithIdentifier:@"heartRate"
+                                                                                       healthQuantityType:type
+                                                                                                     unit:unit
+                                                                                                     step:nil
+                                                                                          outputDirectory:nil];
+    
+    ORKQueryPageSizer *sizer = [recorder valueForKey:@"pageSizer"];
+    XCTAssertEqual(sizer.limit, 100);
+    XCTAssertEqual(sizer.minimumLimit, 100);
+    XCTAssertEqual(sizer.maximumLimit, 5000);
+}
+
+@end
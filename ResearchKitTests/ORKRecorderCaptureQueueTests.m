@@ -0,0 +1,127 @@
+/*
+ Copyright (c) 2016, Apple Inc. All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+ 
+ 1.  Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ 2.  Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation and/or
+ other materials provided with the distribution.
+ 
+ 3.  Neither the name of the copyright holder(s) nor the names of any contributors
+ may be used to endorse or promote products derived from this software without
+ specific prior written permission. No license is granted to the trademarks of
+ the copyright holders even if such marks are included in this software.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+@import XCTest;
+@import ResearchKit.Private;
+
+#import "ORKRecorderCaptureQueue.h"
+
+
+@interface ORKRecorderCaptureQueueTests : XCTestCase
+
+@end
+
+
+@implementation ORKRecorderCaptureQueueTests
+
+- (void)testCapacityForFrequency {
+    XCTAssertEqual([ORKRecorderCaptureQueue capacityForFrequency:100], 3000);
+    XCTAssertEqual([ORKRecorderCaptureQueue capacityForFrequency:10], 1000);
+    XCTAssertEqual([ORKRecorderCaptureQueue capacityForFrequency:0], 1000);
+    XCTAssertEqual([ORKRecorderCaptureQueue capacityForFrequency:-5], 1000);
+    
+    ORKRecorderCaptureQueue *queue = [[ORKRecorderCaptureQueue alloc] initWithLabel:@"test" capacity:0 handler:^(NSArray *samples) {}];
+    XCTAssertEqual(queue.capacity, 1);
+}
+
+- (void)testOverflowAndOutOfOrderSamplesAreDroppedAndCounted {
+    // Only the handler, on the capture queue, touches the batches until flush returns.
+    NSMutableArray<NSArray *> *batches = [NSMutableArray array];
+    dispatch_semaphore_t handlerStarted = dispatch_semaphore_create(0);
+    dispatch_semaphore_t handlerGate = dispatch_semaphore_create(0);
+    ORKRecorderCaptureQueue *queue = [[ORKRecorderCaptureQueue alloc] initWithLabel:@"test" capacity:4 handler:^(NSArray *samples) {
+        [batches addObject:samples];
+        if (batches.count == 1) {
+            dispatch_semaphore_signal(handlerStarted);
+            dispatch_semaphore_wait(handlerGate, DISPATCH_TIME_FOREVER);
+        }
+    }];
+    XCTAssertEqual(queue.capacity, 4);
+    
+    // Hold the handler on the first sample so the next ones stay pending.
+    XCTAssertTrue([queue enqueueSample:@0 timestamp:0]);
+    XCTAssertEqual(dispatch_semaphore_wait(handlerStarted, dispatch_time(DISPATCH_TIME_NOW, 5 * NSEC_PER_SEC)), 0);
+    
+    for (NSInteger i = 1; i <= 4; i++) {
+        XCTAssertTrue([queue enqueueSample:@(i) timestamp:i]);
+    }
+    XCTAssertFalse([queue enqueueSample:@5 timestamp:5]);
+    XCTAssertFalse([queue enqueueSample:@6 timestamp:6]);
+    XCTAssertFalse([queue enqueueSample:@3.5 timestamp:3.5]);
+    XCTAssertEqual(queue.capturedSampleCount, 5);
+    XCTAssertEqual(queue.overflowCount, 2);
+    XCTAssertEqual(queue.outOfOrderCount, 1);
+    XCTAssertEqual(queue.maximumDepth, 4);
+    
+    dispatch_semaphore_signal(handlerGate);
+    [queue flush];
+    XCTAssertEqualObjects(batches, (@[@[@0], @[@1, @2, @3, @4]]));
+    
+    // Draining frees the buffer again; an equal timestamp is still in order.
+    XCTAssertTrue([queue enqueueSample:@7 timestamp:4]);
+    XCTAssertFalse([queue enqueueSample:@8 timestamp:3]);
+    [queue flush];
+    XCTAssertEqualObjects(batches.lastObject, (@[@7]));
+    
+    XCTAssertEqualObjects([queue statistics], (@{@"capturedSampleCount": @6,
+                                                  @"overflowCount": @2,
+                                                  @"outOfOrderCount": @2,
+                                                  @"maximumQueueDepth": @4}));
+}
+
+- (void)testConcurrentProducersAccountForEverySample {
+    static const NSUInteger producerCount = 4;
+    static const NSUInteger samplesPerProducer = 5000;
+    NSMutableArray<NSNumber *> *handledTimestamps = [NSMutableArray array];
+    ORKRecorderCaptureQueue *queue = [[ORKRecorderCaptureQueue alloc] initWithLabel:@"test" capacity:256 handler:^(NSArray<NSNumber *> *samples) {
+        [handledTimestamps addObjectsFromArray:samples];
+    }];
+    
+    dispatch_apply(producerCount, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t producer) {
+        for (NSUInteger i = 0; i < samplesPerProducer; i++) {
+            NSTimeInterval timestamp = i + producer / (double)producerCount;
+            [queue enqueueSample:@(timestamp) timestamp:timestamp];
+        }
+    });
+    [queue flush];
+    
+    // Every sample is either handled or counted as dropped, and handled samples never go backwards.
+    XCTAssertEqual(queue.capturedSampleCount + queue.overflowCount + queue.outOfOrderCount, producerCount * samplesPerProducer);
+    XCTAssertEqual(handledTimestamps.count, queue.capturedSampleCount);
+    XCTAssertLessThanOrEqual(queue.maximumDepth, queue.capacity);
+    double previousTimestamp = -1;
+    for (NSNumber *timestamp in handledTimestamps) {
+        XCTAssertGreaterThanOrEqual(timestamp.doubleValue, previousTimestamp);
+        previousTimestamp = timestamp.doubleValue;
+    }
+}
+
+@end
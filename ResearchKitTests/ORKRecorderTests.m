@@ -35,6 +35,10 @@
 @import CoreLocation;
 @import CoreMotion;
 
+#import "ORKRangeOfMotionAnalyzer.h"
+#import "ORKReactionTimeDetector.h"
+#import "ORKSensorReplay.h"
+
 
 @interface ORKMockLocationManager : CLLocationManager
 
@@ -303,6 +307,46 @@
 @end
 
 
+@interface ORKMockWalkingDeviceMotion : CMDeviceMotion
+
+- (instancetype)initWithTimestamp:(NSTimeInterval)timestamp verticalAcceleration:(double)verticalAcceleration;
+
+@end
+
+
+@implementation ORKMockWalkingDeviceMotion {
+    NSTimeInterval _mockTimestamp;
+    double _verticalAcceleration;
+}
+
+- (instancetype)initWithTimestamp:(NSTimeInterval)timestamp verticalAcceleration:(double)verticalAcceleration {
+    self = [super init];
+    if (self) {
+        _mockTimestamp = timestamp;
+        _verticalAcceleration = verticalAcceleration;
+    }
+    return self;
+}
+
+- (NSTimeInterval)timestamp {
+    return _mockTimestamp;
+}
+
+- (CMAttitude *)attitude {
+    return [ORKMockAttitude new];
+}
+
+- (CMAcceleration)gravity {
+    return (CMAcceleration){.x=0, .y=-1.0, .z=0};
+}
+
+- (CMAcceleration)userAcceleration {
+    return (CMAcceleration){.x=0, .y=-_verticalAcceleration, .z=0};
+}
+
+@end
+
+
 static BOOL ork_doubleEqual(double x, double y) {
     static double K = 1;
     return (fabs(x-y) < K * DBL_EPSILON * fabs(x+y) || fabs(x-y) < DBL_MIN);
@@ -311,6 +355,31 @@ static BOOL ork_doubleEqual(double x, double y) {
 #pragma mark - ORKRecorderTests
 #pragma mark -
 
+@interface ORKMockHealthStore : HKHealthStore
+
+@end
+
+
+@implementation ORKMockHealthStore
+
+- (void)executeQuery:(HKQuery *)query {
+    
+}
+
+- (void)stopQuery:(HKQuery *)query {
+    
+}
+
+@end
+
+
+@interface ORKHealthQuantityTypeRecorder (ORKRecorderTests)
+
+- (void)query_logResults:(NSArray *)results withAnchor:(HKQueryAnchor *)newAnchor anchorValue:(NSUInteger)anchorValue limit:(NSUInteger)limit queryDuration:(NSTimeInterval)queryDuration;
+
+@end
+
+
 @interface ORKRecorderTests : XCTestCase <ORKRecorderDelegate>
 
 @end
@@ -320,6 +389,8 @@ static BOOL ork_doubleEqual(double x, double y) {
     NSString  *_outputPath;
     ORKRecorder *_recorder;
     ORKResult *_result;
+    ORKGaitSummaryResult *_gaitSummaryResult;
+    NSDictionary *_metrics;
     NSArray   *_items;
 }
 
@@ -342,6 +413,8 @@ static const NSInteger kNumberOfSamples = 5;
     
     _recorder = nil;
     _result = nil;
+    _gaitSummaryResult = nil;
+    _metrics = nil;
     _items = nil;
 }
 
@@ -352,9 +425,20 @@ static const NSInteger kNumberOfSamples = 5;
 - (void)recorder:(ORKRecorder *)recorder didCompleteWithResult:(ORKResult *)result {
      NSLog(@"didCompleteWithResult: %@", result);
     _recorder = recorder;
+    XCTAssertNil(_result, @"A recording must complete only once");
     _result = result;
 }
 
+- (void)recorder:(ORKRecorder *)recorder didReportAdditionalResult:(ORKResult *)result {
+    XCTAssertNil(_result, @"Additional results must be reported before the recording completes");
+    XCTAssertTrue([result isKindOfClass:[ORKGaitSummaryResult class]]);
+    _gaitSummaryResult = (ORKGaitSummaryResult *)result;
+}
+
+- (void)recorder:(ORKRecorder *)recorder didReportMetrics:(NSDictionary<NSString *, id> *)metrics {
+    _metrics = metrics;
+}
+
 - (void)recorder:(ORKRecorder *)recorder didFailWithError:(NSError *)error {
     NSLog(@"didFailWithError: %@", error);
     _recorder = nil;
@@ -470,6 +554,289 @@ static const NSInteger kNumberOfSamples = 5;
         XCTAssertTrue(ork_doubleEqual(data.acceleration.y, ((NSNumber *)sample[@"y"]).doubleValue), @"");
         XCTAssertTrue(ork_doubleEqual(data.acceleration.z, ((NSNumber *)sample[@"z"]).doubleValue), @"");
     }
+    
+    NSDictionary *userInfo = ((ORKFileResult *)_result).userInfo;
+    XCTAssertEqualObjects(userInfo[@"capturedSampleCount"], @(kNumberOfSamples));
+    XCTAssertEqualObjects(userInfo[@"overflowCount"], @(0));
+    XCTAssertEqualObjects(userInfo[@"outOfOrderCount"], @(0));
+    
+    NSDictionary *metrics = userInfo[@"metrics"];
+    XCTAssertEqualObjects(metrics, _metrics);
+    XCTAssertEqualObjects(metrics[@"samplesReceived"], @(kNumberOfSamples));
+    XCTAssertEqualObjects(metrics[@"samplesDropped"], @(0));
+    XCTAssertEqualObjects(metrics[@"appendErrors"], @(0));
+    XCTAssertGreaterThan(((NSNumber *)metrics[@"bytesWritten"]).longLongValue, 0);
+    XCTAssertGreaterThan(((NSNumber *)metrics[@"appendLatency"][@"count"]).longLongValue, 0);
+}
+
+- (void)testAccelerometerRecorderReplay {
+    NSArray<ORKReplayAccelerometerData *> *samples = [ORKReplayAccelerometerData walkingSamplesWithFrequency:100.0 duration:2.0];
+    ORKSensorReplaySource *sampleSource = [ORKSensorReplaySource new];
+    sampleSource.motionManager = [[ORKReplayMotionManager alloc] initWithAccelerometerSamples:samples deviceMotionSamples:nil rate:10.0];
+
+    ORKAccelerometerRecorder *recorder = (ORKAccelerometerRecorder *)[self createRecorder:[[ORKAccelerometerRecorderConfiguration alloc] initWithIdentifier:@"accelerometer" frequency:100.0]];
+    recorder.sampleSource = sampleSource;
+
+    [recorder start];
+    XCTAssertTrue([sampleSource.motionManager.accelerometerReplayer waitUntilFinishedWithTimeout:10.0]);
+    XCTAssertEqual(sampleSource.motionManager.accelerometerReplayer.deliveredSampleCount, samples.count);
+    [recorder stop];
+
+    XCTAssertNotNil(_result);
+    NSArray *items = [ORKSensorReplayer JSONItemsWithContentsOfURL:((ORKFileResult *)_result).fileURL error:NULL];
+    NSNumber *samplesDropped = _metrics[@"samplesDropped"];
+    XCTAssertEqual(items.count + samplesDropped.unsignedIntegerValue, samples.count);
+
+    // A recorded stream can be replayed again.
+    NSArray<ORKReplayAccelerometerData *> *recordedSamples = [ORKReplayAccelerometerData samplesWithJSONItems:items];
+    XCTAssertEqual(recordedSamples.count, items.count);
+    XCTAssertTrue(ork_doubleEqual(recordedSamples.firstObject.timestamp, samples.firstObject.timestamp));
+    XCTAssertTrue(ork_doubleEqual(recordedSamples.firstObject.acceleration.z, samples.firstObject.acceleration.z));
+    
+    // Replaying faster than real time keeps the capture timestamps.
+    NSTimeInterval previousTimestamp = 0;
+    for (ORKReplayAccelerometerData *sample in recordedSamples) {
+        XCTAssertGreaterThanOrEqual(sample.timestamp, previousTimestamp);
+        previousTimestamp = sample.timestamp;
+    }
+    XCTAssertLessThanOrEqual(recordedSamples.lastObject.timestamp, samples.lastObject.timestamp);
+    if (samplesDropped.unsignedIntegerValue == 0) {
+        XCTAssertTrue(ork_doubleEqual(recordedSamples.lastObject.timestamp, samples.lastObject.timestamp));
+    }
+}
+
+// Replayers on the main queue hand their last samples over asynchronously.
+- (void)waitForMainQueue {
+    XCTestExpectation *expectation = [self expectationWithDescription:@"main queue"];
+    dispatch_async(dispatch_get_main_queue(), ^{
+        [expectation fulfill];
+    });
+    [self waitForExpectationsWithTimeout:10.0 handler:nil];
+}
+
+- (void)testDeviceMotionRecorderReplay {
+    NSArray<ORKReplayDeviceMotion *> *samples = [ORKReplayDeviceMotion walkingSamplesWithFrequency:100.0 duration:2.0];
+    ORKSensorReplaySource *sampleSource = [ORKSensorReplaySource new];
+    sampleSource.motionManager = [[ORKReplayMotionManager alloc] initWithAccelerometerSamples:nil deviceMotionSamples:samples rate:10.0];
+    
+    ORKDeviceMotionRecorder *recorder = (ORKDeviceMotionRecorder *)[self createRecorder:[[ORKDeviceMotionRecorderConfiguration alloc] initWithIdentifier:@"deviceMotion" frequency:100.0]];
+    recorder.sampleSource = sampleSource;
+    
+    [recorder start];
+    XCTAssertTrue([sampleSource.motionManager.deviceMotionReplayer waitUntilFinishedWithTimeout:10.0]);
+    XCTAssertEqual(sampleSource.motionManager.deviceMotionReplayer.deliveredSampleCount, samples.count);
+    [recorder stop];
+    
+    XCTAssertNotNil(_result);
+    NSArray *items = [ORKSensorReplayer JSONItemsWithContentsOfURL:((ORKFileResult *)_result).fileURL error:NULL];
+    NSNumber *samplesDropped = _metrics[@"samplesDropped"];
+    XCTAssertEqual(items.count + samplesDropped.unsignedIntegerValue, samples.count);
+    
+    NSArray<ORKReplayDeviceMotion *> *recordedSamples = [ORKReplayDeviceMotion samplesWithJSONItems:items];
+    XCTAssertEqual(recordedSamples.count, items.count);
+    XCTAssertTrue(ork_doubleEqual(recordedSamples.firstObject.timestamp, samples.firstObject.timestamp));
+    XCTAssertTrue(ork_doubleEqual(recordedSamples.firstObject.gravity.z, samples.firstObject.gravity.z));
+    XCTAssertTrue(ork_doubleEqual(recordedSamples.firstObject.userAcceleration.y, samples.firstObject.userAcceleration.y));
+    XCTAssertTrue(ork_doubleEqual(recordedSamples.firstObject.rotationRate.x, samples.firstObject.rotationRate.x));
+    
+    NSTimeInterval previousTimestamp = 0;
+    for (ORKReplayDeviceMotion *sample in recordedSamples) {
+        XCTAssertGreaterThan(sample.timestamp, previousTimestamp);
+        previousTimestamp = sample.timestamp;
+    }
+}
+
+- (void)testPedometerRecorderReplay {
+    NSArray<ORKReplayPedometerData *> *samples = [ORKReplayPedometerData walkingSamplesWithInterval:1.0 duration:5.0];
+    ORKSensorReplaySource *sampleSource = [ORKSensorReplaySource new];
+    sampleSource.pedometer = [[ORKReplayPedometer alloc] initWithSamples:samples rate:0];
+    
+    ORKPedometerRecorder *recorder = (ORKPedometerRecorder *)[self createRecorder:[[ORKPedometerRecorderConfiguration alloc] initWithIdentifier:@"pedometer"]];
+    recorder.sampleSource = sampleSource;
+    
+    [recorder start];
+    XCTAssertTrue([sampleSource.pedometer.replayer waitUntilFinishedWithTimeout:10.0]);
+    XCTAssertEqual(sampleSource.pedometer.replayer.deliveredSampleCount, samples.count);
+    [self waitForMainQueue];
+    XCTAssertEqual(recorder.totalNumberOfSteps, samples.lastObject.numberOfSteps.integerValue);
+    XCTAssertEqualObjects(recorder.lastUpdateDate, samples.lastObject.endDate);
+    [recorder stop];
+    
+    XCTAssertNotNil(_result);
+    NSArray *items = [ORKSensorReplayer JSONItemsWithContentsOfURL:((ORKFileResult *)_result).fileURL error:NULL];
+    NSArray<ORKReplayPedometerData *> *recordedSamples = [ORKReplayPedometerData samplesWithJSONItems:items];
+    XCTAssertEqual(recordedSamples.count, samples.count);
+    [recordedSamples enumerateObjectsUsingBlock:^(ORKReplayPedometerData *sample, NSUInteger idx, BOOL *stop) {
+        XCTAssertEqualObjects(sample.numberOfSteps, samples[idx].numberOfSteps);
+        XCTAssertTrue(ork_doubleEqual(sample.distance.doubleValue, samples[idx].distance.doubleValue));
+        XCTAssertEqualObjects(ORKStringFromDateISO8601(sample.endDate), ORKStringFromDateISO8601(samples[idx].endDate));
+    }];
+}
+
+- (void)testLocationRecorderReplay {
+    NSArray<CLLocation *> *locations = [ORKReplayLocationManager walkingLocationsFromCoordinate:CLLocationCoordinate2DMake(37.33182, -122.03118) duration:5.0];
+    ORKSensorReplaySource *sampleSource = [ORKSensorReplaySource new];
+    sampleSource.locationManager = [[ORKReplayLocationManager alloc] initWithLocations:locations rate:0];
+    
+    ORKLocationRecorder *recorder = (ORKLocationRecorder *)[self createRecorder:[[ORKLocationRecorderConfiguration alloc] initWithIdentifier:@"location"]];
+    recorder.sampleSource = sampleSource;
+    
+    [recorder start];
+    XCTAssertTrue([sampleSource.locationManager.replayer waitUntilFinishedWithTimeout:10.0]);
+    [self waitForMainQueue];
+    [recorder stop];
+    
+    XCTAssertNotNil(_result);
+    NSArray *items = [ORKSensorReplayer JSONItemsWithContentsOfURL:((ORKFileResult *)_result).fileURL error:NULL];
+    NSArray<CLLocation *> *recordedLocations = [ORKReplayLocationManager locationsWithJSONItems:items];
+    XCTAssertEqual(recordedLocations.count, locations.count);
+    [recordedLocations enumerateObjectsUsingBlock:^(CLLocation *location, NSUInteger idx, BOOL *stop) {
+        XCTAssertTrue(ork_doubleEqual(location.coordinate.latitude, locations[idx].coordinate.latitude));
+        XCTAssertTrue(ork_doubleEqual(location.coordinate.longitude, locations[idx].coordinate.longitude));
+        XCTAssertTrue(ork_doubleEqual(location.speed, locations[idx].speed));
+        XCTAssertEqualObjects(ORKStringFromDateISO8601(location.timestamp), ORKStringFromDateISO8601(locations[idx].timestamp));
+    }];
+}
+
+- (void)testTouchRecorderReplay {
+    NSArray<ORKReplayTouchSample *> *samples = [ORKReplayTouchSample swipeSamplesFromPoint:CGPointMake(20, 200) toPoint:CGPointMake(280, 200) duration:0.5 frequency:60.0];
+    ORKSensorReplaySource *sampleSource = [ORKSensorReplaySource new];
+    sampleSource.touchView = [[ORKReplayTouchView alloc] initWithFrame:CGRectMake(0, 0, 300, 400) touchSamples:samples rate:0];
+    
+    // No view is handed over by a step view controller, so the recorder asks the sample source.
+    ORKTouchRecorder *recorder = (ORKTouchRecorder *)[self createRecorder:[[ORKTouchRecorderConfiguration alloc] initWithIdentifier:@"touch"]];
+    recorder.sampleSource = sampleSource;
+    
+    [recorder start];
+    XCTAssertEqual(recorder.touchView, sampleSource.touchView);
+    XCTAssertTrue([sampleSource.touchView.replayer waitUntilFinishedWithTimeout:10.0]);
+    [self waitForMainQueue];
+    [recorder stop];
+    
+    XCTAssertNotNil(_result);
+    NSArray *items = [ORKSensorReplayer JSONItemsWithContentsOfURL:((ORKFileResult *)_result).fileURL error:NULL];
+    NSArray<ORKReplayTouchSample *> *recordedSamples = [ORKReplayTouchSample samplesWithJSONItems:items];
+    XCTAssertEqual(recordedSamples.count, samples.count);
+    [recordedSamples enumerateObjectsUsingBlock:^(ORKReplayTouchSample *sample, NSUInteger idx, BOOL *stop) {
+        XCTAssertEqual(sample.touchIndex, 0);
+        XCTAssertEqual(sample.phase, samples[idx].phase);
+        XCTAssertTrue(ork_doubleEqual(sample.timestamp, samples[idx].timestamp));
+        XCTAssertTrue(ork_doubleEqual(sample.location.x, samples[idx].location.x));
+        XCTAssertTrue(ork_doubleEqual(sample.location.y, samples[idx].location.y));
+    }];
+    XCTAssertEqual(recordedSamples.firstObject.phase, UITouchPhaseBegan);
+    XCTAssertEqual(recordedSamples.lastObject.phase, UITouchPhaseEnded);
+}
+
+- (ORKTouchRecorder *)startTouchRecorderWithSamples:(NSArray<ORKReplayTouchSample *> *)samples {
+    ORKSensorReplaySource *sampleSource = [ORKSensorReplaySource new];
+    sampleSource.touchView = [[ORKReplayTouchView alloc] initWithFrame:CGRectMake(0, 0, 300, 400) touchSamples:samples rate:0];
+    
+    ORKTouchRecorder *recorder = (ORKTouchRecorder *)[self createRecorder:[[ORKTouchRecorderConfiguration alloc] initWithIdentifier:@"touch"]];
+    recorder.sampleSource = sampleSource;
+    [recorder start];
+    XCTAssertTrue([sampleSource.touchView.replayer waitUntilFinishedWithTimeout:10.0]);
+    [self waitForMainQueue];
+    return recorder;
+}
+
+- (void)testTouchRecorderFlushesFullBatches {
+    NSArray<ORKReplayTouchSample *> *samples = [ORKReplayTouchSample swipeSamplesFromPoint:CGPointMake(20, 20) toPoint:CGPointMake(280, 380) duration:1.0 frequency:69.0];
+    XCTAssertEqual(samples.count, 70);
+    
+    // The first 64 samples go to the logging queue as one batch; the rest wait for more.
+    ORKTouchRecorder *recorder = [self startTouchRecorderWithSamples:samples];
+    XCTAssertEqual([[recorder valueForKey:@"batchCount"] unsignedIntegerValue], 6);
+    
+    [recorder stop];
+    XCTAssertEqual([[recorder valueForKey:@"batchCount"] unsignedIntegerValue], 0);
+    NSArray *items = [ORKSensorReplayer JSONItemsWithContentsOfURL:((ORKFileResult *)_result).fileURL error:NULL];
+    NSArray<ORKReplayTouchSample *> *recordedSamples = [ORKReplayTouchSample samplesWithJSONItems:items];
+    XCTAssertEqual(recordedSamples.count, samples.count);
+    [recordedSamples enumerateObjectsUsingBlock:^(ORKReplayTouchSample *sample, NSUInteger idx, BOOL *stop) {
+        XCTAssertTrue(ork_doubleEqual(sample.timestamp, samples[idx].timestamp));
+        XCTAssertEqual(sample.phase, samples[idx].phase);
+    }];
+}
+
+- (void)testTouchRecorderFlushesPartialBatchAfterDelay {
+    NSArray<ORKReplayTouchSample *> *samples = [ORKReplayTouchSample swipeSamplesFromPoint:CGPointMake(20, 20) toPoint:CGPointMake(40, 20) duration:0.02 frequency:100.0];
+    XCTAssertEqual(samples.count, 3);
+    
+    NSDate *startDate = [NSDate date];
+    ORKTouchRecorder *recorder = [self startTouchRecorderWithSamples:samples];
+    NSUInteger generation = [[recorder valueForKey:@"batchGeneration"] unsignedIntegerValue];
+    XCTAssertEqual([[recorder valueForKey:@"batchCount"] unsignedIntegerValue], 3);
+    
+    // Sparse touches are handed over once the batch has waited long enough, without waiting for stop.
+    [self expectationForPredicate:[NSPredicate predicateWithFormat:@"batchCount == 0"] evaluatedWithObject:recorder handler:nil];
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+    XCTAssertGreaterThanOrEqual([[NSDate date] timeIntervalSinceDate:startDate], 0.5);
+    XCTAssertEqual([[recorder valueForKey:@"batchGeneration"] unsignedIntegerValue], generation + 1);
+    
+    [recorder stop];
+    NSArray *items = [ORKSensorReplayer JSONItemsWithContentsOfURL:((ORKFileResult *)_result).fileURL error:NULL];
+    XCTAssertEqual(items.count, samples.count);
+}
+
+- (void)testTouchRecorderIndexesOverlappingTouches {
+    NSTimeInterval start = [NSProcessInfo processInfo].systemUptime;
+    ORKReplayTouchSample *(^sample)(NSUInteger, NSTimeInterval, UITouchPhase) = ^(NSUInteger touchIndex, NSTimeInterval offset, UITouchPhase phase) {
+        return [[ORKReplayTouchSample alloc] initWithTouchIndex:touchIndex timestamp:start + offset location:CGPointMake(100 + 50 * touchIndex, 100 + 100 * offset) phase:phase];
+    };
+    // Two fingers overlap; the first lifts, and a new finger lands in its replay slot while the second is still down.
+    NSArray<ORKReplayTouchSample *> *samples = @[sample(0, 0.00, UITouchPhaseBegan),
+                                                 sample(1, 0.01, UITouchPhaseBegan),
+                                                 sample(0, 0.02, UITouchPhaseMoved),
+                                                 sample(1, 0.03, UITouchPhaseMoved),
+                                                 sample(0, 0.04, UITouchPhaseEnded),
+                                                 sample(0, 0.05, UITouchPhaseBegan),
+                                                 sample(1, 0.06, UITouchPhaseEnded),
+                                                 sample(0, 0.07, UITouchPhaseMoved),
+                                                 sample(0, 0.08, UITouchPhaseEnded)];
+    NSArray<NSNumber *> *expectedIndexes = @[@0, @1, @0, @1, @0, @2, @1, @2, @2];
+    
+    ORKTouchRecorder *recorder = [self startTouchRecorderWithSamples:samples];
+    
+    // Every touch has ended, so none is still tracked.
+    XCTAssertEqual([(NSMapTable *)[recorder valueForKey:@"touchIndexes"] count], 0);
+    XCTAssertEqual([[recorder valueForKey:@"nextTouchIndex"] unsignedIntegerValue], 3);
+    
+    [recorder stop];
+    NSArray *items = [ORKSensorReplayer JSONItemsWithContentsOfURL:((ORKFileResult *)_result).fileURL error:NULL];
+    NSArray<ORKReplayTouchSample *> *recordedSamples = [ORKReplayTouchSample samplesWithJSONItems:items];
+    XCTAssertEqual(recordedSamples.count, samples.count);
+    [recordedSamples enumerateObjectsUsingBlock:^(ORKReplayTouchSample *recordedSample, NSUInteger idx, BOOL *stop) {
+        XCTAssertEqual(recordedSample.touchIndex, expectedIndexes[idx].unsignedIntegerValue);
+        XCTAssertEqual(recordedSample.phase, samples[idx].phase);
+        XCTAssertTrue(ork_doubleEqual(recordedSample.location.x, samples[idx].location.x));
+    }];
+}
+
+- (void)testRecorderMetrics {
+    ORKRecorderMetrics *metrics = [[ORKRecorderMetrics alloc] init];
+    
+    for (NSInteger i = 0; i < 100; i++) {
+        [metrics recordSampleWithTimestamp:1000.0 + i * 0.01];
+    }
+    [metrics incrementCounter:ORKRecorderCounterSamplesDropped by:3];
+    [metrics recordDuration:0.001 inHistogram:ORKRecorderHistogramAppendLatency];
+    [metrics recordDuration:0.003 inHistogram:ORKRecorderHistogramAppendLatency];
+    
+    XCTAssertEqual([metrics valueOfCounter:ORKRecorderCounterSamplesReceived], 100);
+    XCTAssertEqual([metrics countOfHistogram:ORKRecorderHistogramSampleInterval], 99);
+    
+    NSDictionary *summary = [metrics summary];
+    XCTAssertEqualObjects(summary[@"samplesDropped"], @(3));
+    XCTAssertEqualWithAccuracy(((NSNumber *)summary[@"achievedSampleRate"]).doubleValue, 100.0, 0.01);
+    XCTAssertEqualWithAccuracy(((NSNumber *)summary[@"appendLatency"][@"mean"]).doubleValue, 0.002, 1e-6);
+    XCTAssertEqualWithAccuracy(((NSNumber *)summary[@"appendLatency"][@"max"]).doubleValue, 0.003, 1e-6);
+    XCTAssertLessThanOrEqual(((NSNumber *)summary[@"sampleInterval"][@"p50"]).doubleValue, 0.016384);
+    XCTAssertGreaterThanOrEqual(((NSNumber *)summary[@"sampleInterval"][@"p50"]).doubleValue, 0.01);
+    
+    [metrics reset];
+    XCTAssertEqual([metrics valueOfCounter:ORKRecorderCounterSamplesReceived], 0);
+    XCTAssertNil([metrics summary][@"appendLatency"]);
 }
 
 - (void)testDeviceMotionRecorder {
@@ -522,6 +889,182 @@ static const NSInteger kNumberOfSamples = 5;
     }
 }
 
+- (void)testDeviceMotionRecorderDropsOutOfOrderSamples {
+    
+    ORKDeviceMotionRecorder *recorder = [[ORKMockDeviceMotionRecorder alloc] initWithIdentifier:@"deviceMotion" frequency:60.0 step:nil outputDirectory:[NSURL fileURLWithPath:_outputPath]];
+    recorder.delegate = self;
+    ORKMockMotionManager *manager = [ORKMockMotionManager new];
+    [(ORKMockDeviceMotionRecorder *)recorder setMockManager:manager];
+    
+    [recorder start];
+    
+    NSArray<NSNumber *> *timestamps = @[@1000.0, @1000.5, @999.5, @1001.0];
+    for (NSNumber *timestamp in timestamps) {
+        [manager injectMotion:[[ORKMockWalkingDeviceMotion alloc] initWithTimestamp:timestamp.doubleValue verticalAcceleration:0]];
+    }
+    
+    [recorder stop];
+    
+    ORKFileResult *fileResult = (ORKFileResult *)_result;
+    XCTAssertTrue([fileResult isKindOfClass:[ORKFileResult class]]);
+    XCTAssertEqualObjects(fileResult.userInfo[@"capturedSampleCount"], @(3));
+    XCTAssertEqualObjects(fileResult.userInfo[@"outOfOrderCount"], @(1));
+    XCTAssertEqualObjects(fileResult.userInfo[@"overflowCount"], @(0));
+    
+    NSDictionary *dict = [NSJSONSerialization JSONObjectWithData:[NSData dataWithContentsOfURL:fileResult.fileURL] options:(NSJSONReadingOptions)0 error:NULL];
+    NSArray *loggedTimestamps = [dict[@"items"] valueForKey:@"timestamp"];
+    XCTAssertEqualObjects(loggedTimestamps, (@[@1000.0, @1000.5, @1001.0]));
+}
+
+- (void)testDeviceMotionRecorderGaitSummary {
+    
+    ORKDeviceMotionRecorderConfiguration *recorderConfiguration = [[ORKDeviceMotionRecorderConfiguration alloc] initWithIdentifier:@"deviceMotion" frequency:100.0];
+    recorderConfiguration.includesGaitSummary = YES;
+    ORKDeviceMotionRecorder *recorder = (ORKDeviceMotionRecorder *)[self createRecorder:recorderConfiguration];
+    XCTAssertTrue(recorder.includesGaitSummary);
+    
+    recorder = [[ORKMockDeviceMotionRecorder alloc] initWithIdentifier:@"deviceMotion" frequency:recorder.frequency step:recorder.step outputDirectory:recorder.outputDirectory];
+    recorder.includesGaitSummary = YES;
+    recorder.delegate = self;
+    ORKMockMotionManager *manager = [ORKMockMotionManager new];
+    [(ORKMockDeviceMotionRecorder *)recorder setMockManager:manager];
+    
+    [recorder start];
+    
+    // Ten seconds of walking at two steps per second.
+    const double frequency = 100.0;
+    const double stepFrequency = 2.0;
+    for (NSInteger i = 0; i < 10 * frequency; i++) {
+        NSTimeInterval timestamp = 1000.0 + i / frequency;
+        double verticalAcceleration = 0.3 * sin(2 * M_PI * stepFrequency * i / frequency);
+        [manager injectMotion:[[ORKMockWalkingDeviceMotion alloc] initWithTimestamp:timestamp verticalAcceleration:verticalAcceleration]];
+    }
+    
+    [recorder stop];
+    
+    XCTAssertTrue([_result isKindOfClass:[ORKFileResult class]]);
+    XCTAssertNotNil(_gaitSummaryResult);
+    XCTAssertEqualObjects(_gaitSummaryResult.identifier, @"deviceMotion_gait");
+    XCTAssertEqualWithAccuracy(_gaitSummaryResult.numberOfSteps, 20, 1);
+    XCTAssertEqualWithAccuracy(_gaitSummaryResult.cadence, 120.0, 2.0);
+    XCTAssertEqualWithAccuracy(_gaitSummaryResult.meanStrideDuration, 1.0, 0.05);
+    XCTAssertLessThan(_gaitSummaryResult.strideDurationVariability, 0.05);
+    XCTAssertGreaterThan(_gaitSummaryResult.verticalAccelerationRMS, 0.15);
+    XCTAssertLessThan(_gaitSummaryResult.horizontalAccelerationRMS, 0.05);
+    XCTAssertEqualWithAccuracy(_gaitSummaryResult.duration, 9.99, 0.01);
+}
+
+- (void)testAccelerometerRecorderGaitSummaryReplay {
+    // Ten seconds of walking at 1.8 steps per second, with only the accelerometer recording.
+    NSArray<ORKReplayAccelerometerData *> *samples = [ORKReplayAccelerometerData walkingSamplesWithFrequency:100.0 duration:10.0];
+    ORKSensorReplaySource *sampleSource = [ORKSensorReplaySource new];
+    sampleSource.motionManager = [[ORKReplayMotionManager alloc] initWithAccelerometerSamples:samples deviceMotionSamples:nil rate:10.0];
+    
+    ORKAccelerometerRecorderConfiguration *recorderConfiguration = [[ORKAccelerometerRecorderConfiguration alloc] initWithIdentifier:@"accelerometer" frequency:100.0];
+    recorderConfiguration.includesGaitSummary = YES;
+    ORKAccelerometerRecorder *recorder = (ORKAccelerometerRecorder *)[self createRecorder:recorderConfiguration];
+    XCTAssertTrue(recorder.includesGaitSummary);
+    recorder.sampleSource = sampleSource;
+    
+    [recorder start];
+    XCTAssertTrue([sampleSource.motionManager.accelerometerReplayer waitUntilFinishedWithTimeout:10.0]);
+    [recorder stop];
+    
+    XCTAssertTrue([_result isKindOfClass:[ORKFileResult class]]);
+    XCTAssertNotNil(_gaitSummaryResult);
+    XCTAssertEqualObjects(_gaitSummaryResult.identifier, @"accelerometer_gait");
+    XCTAssertEqualWithAccuracy(_gaitSummaryResult.numberOfSteps, 18, 1);
+    XCTAssertEqualWithAccuracy(_gaitSummaryResult.cadence, 108.0, 3.0);
+    XCTAssertEqualWithAccuracy(_gaitSummaryResult.meanStrideDuration, 2 / 1.8, 0.05);
+    XCTAssertGreaterThan(_gaitSummaryResult.verticalAccelerationRMS, 0.15);
+    XCTAssertLessThan(_gaitSummaryResult.horizontalAccelerationRMS, 0.1);
+    XCTAssertEqualWithAccuracy(_gaitSummaryResult.duration, 9.99, 0.05);
+}
+
+- (void)testRangeOfMotionAnalyzerTracksAnglesFromReference {
+    // 100 attitudes tilting forward about the x axis from 30 to 129 degrees, spanning two blocks.
+    const NSUInteger count = 100;
+    CMQuaternion quaternions[count];
+    for (NSUInteger i = 0; i < count; i++) {
+        double angle = (30.0 + i) * M_PI / 180.0;
+        quaternions[i] = (CMQuaternion){ .x = sin(angle / 2), .y = 0, .z = 0, .w = cos(angle / 2) };
+    }
+    
+    ORKRangeOfMotionAnalyzer *analyzer = [[ORKRangeOfMotionAnalyzer alloc] initWithLandscapeOrientation:NO];
+    [analyzer appendAttitudeQuaternions:quaternions count:60];
+    [analyzer appendAttitudeQuaternions:quaternions + 60 count:count - 60];
+    
+    ORKRangeOfMotionSummary summary = analyzer.summary;
+    XCTAssertEqual(summary.sampleCount, count);
+    XCTAssertEqualWithAccuracy(summary.referenceAngle, 30.0, 1e-6);
+    XCTAssertEqualWithAccuracy(summary.lowestAngle, 0.0, 1e-6);
+    XCTAssertEqualWithAccuracy(summary.highestAngle, 99.0, 1e-6);
+    XCTAssertEqualWithAccuracy(summary.lastAngle, 99.0, 1e-6);
+    
+    [analyzer reset];
+    XCTAssertEqual(analyzer.summary.sampleCount, 0);
+}
+
+// Composes yaw, pitch and roll, in radians, in CoreMotion's Z-X-Y order.
+static CMQuaternion ORKQuaternionFromEulerAngles(double yaw, double pitch, double roll) {
+    CMQuaternion qz = { .x = 0, .y = 0, .z = sin(yaw / 2), .w = cos(yaw / 2) };
+    CMQuaternion qx = { .x = sin(pitch / 2), .y = 0, .z = 0, .w = cos(pitch / 2) };
+    CMQuaternion qy = { .x = 0, .y = sin(roll / 2), .z = 0, .w = cos(roll / 2) };
+    CMQuaternion (^multiply)(CMQuaternion, CMQuaternion) = ^CMQuaternion(CMQuaternion a, CMQuaternion b) {
+        return (CMQuaternion){
+            .x = a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y,
+            .y = a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x,
+            .z = a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w,
+            .w = a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z
+        };
+    };
+    return multiply(multiply(qz, qx), qy);
+}
+
+- (void)testRangeOfMotionAnalyzerLandscapeAngleIsRoll {
+    // Samples turning about the vertical axis while rolling, so the yaw must not leak into the angle.
+    const NSUInteger count = 70;
+    CMQuaternion quaternions[count];
+    quaternions[0] = ORKQuaternionFromEulerAngles(0, 0, 0);
+    for (NSUInteger i = 1; i < count; i++) {
+        quaternions[i] = ORKQuaternionFromEulerAngles(i * 1.3 * M_PI / 180.0, 0, i * M_PI / 180.0);
+    }
+    
+    ORKRangeOfMotionAnalyzer *analyzer = [[ORKRangeOfMotionAnalyzer alloc] initWithLandscapeOrientation:YES];
+    [analyzer appendAttitudeQuaternions:quaternions count:count];
+    ORKRangeOfMotionSummary summary = analyzer.summary;
+    XCTAssertEqualWithAccuracy(summary.referenceAngle, 0.0, 1e-6);
+    XCTAssertEqualWithAccuracy(summary.lowestAngle, 0.0, 1e-6);
+    XCTAssertEqualWithAccuracy(summary.highestAngle, 69.0, 1e-6);
+    XCTAssertEqualWithAccuracy(summary.lastAngle, 69.0, 1e-6);
+    
+    // A yawed and pitched reference reports its roll.
+    CMQuaternion reference = ORKQuaternionFromEulerAngles(75.0 * M_PI / 180.0, 20.0 * M_PI / 180.0, -35.0 * M_PI / 180.0);
+    analyzer = [[ORKRangeOfMotionAnalyzer alloc] initWithLandscapeOrientation:YES];
+    [analyzer appendAttitudeQuaternions:&reference count:1];
+    XCTAssertEqualWithAccuracy(analyzer.summary.referenceAngle, -35.0, 1e-6);
+}
+
+- (void)testReactionTimeDetectorInterpolatesThresholdCrossing {
+    ORKReactionTimeDetector *detector = [[ORKReactionTimeDetector alloc] initWithThresholdAcceleration:0.5];
+    
+    XCTAssertFalse([detector addSampleWithTimestamp:10.00 userAcceleration:(CMAcceleration){0, 0, 0.1}]);
+    XCTAssertFalse([detector addSampleWithTimestamp:10.01 userAcceleration:(CMAcceleration){0, 0, 0.3}]);
+    XCTAssertTrue([detector addSampleWithTimestamp:10.02 userAcceleration:(CMAcceleration){0, 0.7, 0}]);
+    XCTAssertTrue(detector.crossedThreshold);
+    XCTAssertEqualWithAccuracy(detector.crossingSampleTimestamp, 10.02, 1e-9);
+    XCTAssertEqualWithAccuracy(detector.crossingTimestamp, 10.015, 1e-9);
+    
+    // Only the first crossing counts.
+    XCTAssertFalse([detector addSampleWithTimestamp:10.03 userAcceleration:(CMAcceleration){0, 0, 0.9}]);
+    XCTAssertEqualWithAccuracy(detector.crossingSampleTimestamp, 10.02, 1e-9);
+    
+    [detector reset];
+    XCTAssertFalse(detector.crossedThreshold);
+    XCTAssertTrue([detector addSampleWithTimestamp:20.0 userAcceleration:(CMAcceleration){0.6, 0, 0}]);
+    XCTAssertEqualWithAccuracy(detector.crossingTimestamp, 20.0, 1e-9);
+}
+
 - (void)testPedometerRecorder {
     
     Class recorderClass = [ORKPedometerRecorder class];
@@ -613,4 +1156,68 @@ static const NSInteger kNumberOfSamples = 5;
     XCTAssertTrue([recorder isKindOfClass:recorderClass], @"");
 }
 
+- (void)testHealthQuantityTypeRecorderWritesFloodedPagesInOrder {
+    if (![HKHealthStore isHealthDataAvailable]) {
+        // The recorder finishes immediately on devices without HealthKit.
+        return;
+    }
+    
+    HKUnit *bpmUnit = [[HKUnit countUnit] unitDividedByUnit:[HKUnit minuteUnit]];
+    HKQuantityType *hbQuantityType = [HKQuantityType quantityTypeForIdentifier:HKQuantityTypeIdentifierHeartRate];
+    ORKHealthQuantityTypeRecorderConfiguration *recorderConfiguration = [[ORKHealthQuantityTypeRecorderConfiguration alloc] initWithIdentifier:@"heartRate" healthQuantityType:hbQuantityType unit:bpmUnit];
+    ORKHealthQuantityTypeRecorder *recorder = (ORKHealthQuantityTypeRecorder *)[self createRecorder:recorderConfiguration];
+    
+    // Pages are handed to the recorder directly rather than by HealthKit queries.
+    [recorder setValue:[ORKMockHealthStore new] forKey:@"healthStore"];
+    [recorder start];
+    XCTAssertTrue(recorder.isRecording);
+    
+    // Hold the logging queue so every page is pending at once.
+    dispatch_queue_t loggingQueue = [recorder valueForKey:@"loggingQueue"];
+    dispatch_semaphore_t loggingGate = dispatch_semaphore_create(0);
+    dispatch_async(loggingQueue, ^{
+        dispatch_semaphore_wait(loggingGate, DISPATCH_TIME_FOREVER);
+    });
+    
+    static const NSUInteger pageCount = 50;
+    static const NSUInteger pageSize = 20;
+    NSDate *startDate = [NSDate date];
+    NSMutableArray<HKQuantitySample *> *samples = [NSMutableArray array];
+    HKQueryAnchor *lastAnchor = nil;
+    for (NSUInteger pageIndex = 0; pageIndex < pageCount; pageIndex++) {
+        NSMutableArray<HKQuantitySample *> *page = [NSMutableArray arrayWithCapacity:pageSize];
+        for (NSUInteger index = 0; index < pageSize; index++) {
+            NSDate *date = [startDate dateByAddingTimeInterval:samples.count];
+            HKQuantity *quantity = [HKQuantity quantityWithUnit:bpmUnit doubleValue:60 + samples.count];
+            HKQuantitySample *sample = [HKQuantitySample quantitySampleWithType:hbQuantityType quantity:quantity startDate:date endDate:date];
+            [page addObject:sample];
+            [samples addObject:sample];
+        }
+        lastAnchor = [HKQueryAnchor anchorFromValue:pageIndex + 1];
+        // Pages smaller than the limit do not trigger a follow-up query.
+        [recorder query_logResults:page withAnchor:lastAnchor anchorValue:pageIndex + 1 limit:pageSize * 5 queryDuration:0.01];
+    }
+    
+    dispatch_semaphore_signal(loggingGate);
+    dispatch_sync(loggingQueue, ^{});
+    XCTAssertEqualObjects([recorder valueForKey:@"anchor"], lastAnchor);
+    XCTAssertEqual([[recorder valueForKey:@"anchorValue"] unsignedIntegerValue], pageCount);
+    
+    // Only the most recent sample is reported, on the main queue.
+    [self waitForMainQueue];
+    XCTAssertEqualObjects(recorder.lastSample, samples.lastObject);
+    
+    [recorder stop];
+    
+    XCTAssertNotNil(_result);
+    ORKFileResult *fileResult = (ORKFileResult *)_result;
+    XCTAssertEqualObjects(fileResult.userInfo[@"maximumPendingWriteCount"], @(pageCount));
+    NSArray *items = [ORKSensorReplayer JSONItemsWithContentsOfURL:fileResult.fileURL error:NULL];
+    XCTAssertEqual(items.count, samples.count);
+    [items enumerateObjectsUsingBlock:^(NSDictionary *item, NSUInteger idx, BOOL *stop) {
+        XCTAssertEqualObjects(item[@"startDate"], ORKStringFromDateISO8601(samples[idx].startDate));
+        XCTAssertTrue(ork_doubleEqual(((NSNumber *)item[@"value"]).doubleValue, 60 + idx));
+    }];
+}
+
 @end
@@ -32,6 +32,8 @@
 @import XCTest;
 @import ResearchKit.Private;
 
+#import "ORKSignatureView.h"
+
 
 @interface ORKResultTests : XCTestCase
 
@@ -194,4 +196,40 @@
     XCTAssertEqualObjects(inputResult.results, flattedResults);
 }
 
+- (void)testSignatureStrokeDataRoundTrip {
+    // Two strokes: three points, then a single-point dot
+    float points[] = { 10, 20, 1, 30, 25, 1.25f, 50, 22, 1.5f, 80, 40, 1 };
+    uint32_t firstCount = CFSwapInt32HostToLittle(3);
+    uint32_t secondCount = CFSwapInt32HostToLittle(1);
+    NSMutableData *strokeData = [NSMutableData data];
+    [strokeData appendBytes:&firstCount length:sizeof(firstCount)];
+    [strokeData appendBytes:points length:9 * sizeof(float)];
+    [strokeData appendBytes:&secondCount length:sizeof(secondCount)];
+    [strokeData appendBytes:points + 9 length:3 * sizeof(float)];
+    
+    ORKSignatureView *signatureView = [[ORKSignatureView alloc] init];
+    signatureView.frame = CGRectMake(0, 0, 200, 100);
+    signatureView.signatureStrokeData = strokeData;
+    XCTAssertTrue(signatureView.signatureExists);
+    XCTAssertEqualObjects(signatureView.signatureStrokeData, strokeData);
+    // The width steps twice within the first stroke, so it takes three paths; the dot takes one
+    XCTAssertEqual(signatureView.signaturePath.count, 4);
+    UIImage *signatureImage = signatureView.signatureImage;
+    XCTAssertEqualWithAccuracy(signatureImage.size.width, 200, 0.001);
+    XCTAssertEqual(signatureImage.scale, 1);
+    XCTAssertEqual(CGImageGetWidth(signatureImage.CGImage), 200);
+    XCTAssertEqual(CGImageGetHeight(signatureImage.CGImage), 100);
+    
+    ORKSignatureResult *result = [[ORKSignatureResult alloc] initWithSignatureImage:signatureImage
+                                                                       signaturePath:signatureView.signaturePath];
+    result.signatureStrokeData = signatureView.signatureStrokeData;
+    NSData *archive = [NSKeyedArchiver archivedDataWithRootObject:result];
+    ORKSignatureResult *decodedResult = [NSKeyedUnarchiver unarchiveObjectWithData:archive];
+    XCTAssertEqualObjects(decodedResult.signatureStrokeData, strokeData);
+    
+    // Truncated data is ignored
+    signatureView.signatureStrokeData = [strokeData subdataWithRange:NSMakeRange(0, strokeData.length - 1)];
+    XCTAssertEqualObjects(signatureView.signatureStrokeData, strokeData);
+}
+
 @end
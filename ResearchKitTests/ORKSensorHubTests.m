@@ -0,0 +1,173 @@
+/*
+ Copyright (c) 2016, Apple Inc. All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+ 
+ 1.  Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ 2.  Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation and/or
+ other materials provided with the distribution.
+ 
+ 3.  Neither the name of the copyright holder(s) nor the names of any contributors
+ may be used to endorse or promote products derived from this software without
+ specific prior written permission. No license is granted to the trademarks of
+ the copyright holders even if such marks are included in this software.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+
+
+@import XCTest;
+@import ResearchKit.Private;
+
+#import "ORKSensorHub.h"
+#import "ORKSensorReplay.h"
+
+
+@interface ORKSensorHubTests : XCTestCase
+
+@end
+
+
+@implementation ORKSensorHubTests
+
+// Holds deliveries until `resumeHub:`, so every consumer added before then sees the whole stream.
+- (void)suspendHub:(ORKSensorHub *)hub {
+    ((NSOperationQueue *)[hub valueForKey:@"queue"]).suspended = YES;
+}
+
+- (void)resumeHub:(ORKSensorHub *)hub afterReplayer:(ORKSensorReplayer *)replayer {
+    XCTAssertTrue([replayer waitUntilFinishedWithTimeout:10.0]);
+    NSOperationQueue *queue = [hub valueForKey:@"queue"];
+    queue.suspended = NO;
+    [queue waitUntilAllOperationsAreFinished];
+}
+
+- (void)testAccelerometerConsumersGetSamplesAtTheirOwnFrequency {
+    NSArray *samples = [ORKReplayAccelerometerData walkingSamplesWithFrequency:100 duration:1];
+    ORKReplayMotionManager *motionManager = [[ORKReplayMotionManager alloc] initWithAccelerometerSamples:samples deviceMotionSamples:nil rate:0];
+    ORKSensorHub *hub = [[ORKSensorHub alloc] initWithMotionManager:motionManager];
+    [self suspendHub:hub];
+    
+    __block NSUInteger fastCount = 0;
+    __block NSUInteger mediumCount = 0;
+    NSMutableArray<NSNumber *> *slowTimestamps = [NSMutableArray array];
+    id slowConsumer = [hub addAccelerometerConsumerWithFrequency:25 handler:^(CMAccelerometerData *data, NSError *error) {
+        [slowTimestamps addObject:@(data.timestamp)];
+    }];
+    XCTAssertEqualWithAccuracy(motionManager.accelerometerUpdateInterval, 0.04, 1e-9);
+    id fastConsumer = [hub addAccelerometerConsumerWithFrequency:100 handler:^(CMAccelerometerData *data, NSError *error) {
+        fastCount++;
+    }];
+    id mediumConsumer = [hub addAccelerometerConsumerWithFrequency:50 handler:^(CMAccelerometerData *data, NSError *error) {
+        mediumCount++;
+    }];
+    XCTAssertNotNil(slowConsumer);
+    XCTAssertNotNil(fastConsumer);
+    XCTAssertNotNil(mediumConsumer);
+    
+    // The stream runs at the highest frequency asked for, and each consumer is decimated to its own.
+    XCTAssertEqualWithAccuracy(motionManager.accelerometerUpdateInterval, 0.01, 1e-9);
+    [self resumeHub:hub afterReplayer:motionManager.accelerometerReplayer];
+    XCTAssertEqual(fastCount, 100);
+    XCTAssertEqual(mediumCount, 50);
+    XCTAssertEqual(slowTimestamps.count, 25);
+    for (NSUInteger index = 1; index < slowTimestamps.count; index++) {
+        XCTAssertEqualWithAccuracy(slowTimestamps[index].doubleValue - slowTimestamps[index - 1].doubleValue, 0.04, 0.001);
+    }
+    
+    [hub removeConsumer:slowConsumer];
+    [hub removeConsumer:fastConsumer];
+    [hub removeConsumer:mediumConsumer];
+}
+
+- (void)testDeviceMotionFansOutToEachConsumer {
+    NSArray *samples = [ORKReplayDeviceMotion walkingSamplesWithFrequency:100 duration:1];
+    ORKReplayMotionManager *motionManager = [[ORKReplayMotionManager alloc] initWithAccelerometerSamples:nil deviceMotionSamples:samples rate:0];
+    ORKSensorHub *hub = [[ORKSensorHub alloc] initWithMotionManager:motionManager];
+    XCTAssertNil([hub addAccelerometerConsumerWithFrequency:100 handler:^(CMAccelerometerData *data, NSError *error) {
+    }]);
+    [self suspendHub:hub];
+    
+    NSMutableArray<CMDeviceMotion *> *firstMotions = [NSMutableArray array];
+    NSMutableArray<CMDeviceMotion *> *secondMotions = [NSMutableArray array];
+    id firstConsumer = [hub addDeviceMotionConsumerWithFrequency:100 handler:^(CMDeviceMotion *motion, NSError *error) {
+        [firstMotions addObject:motion];
+    }];
+    id secondConsumer = [hub addDeviceMotionConsumerWithFrequency:100 handler:^(CMDeviceMotion *motion, NSError *error) {
+        [secondMotions addObject:motion];
+    }];
+    [self resumeHub:hub afterReplayer:motionManager.deviceMotionReplayer];
+    
+    // Both consumers get the same samples, in order.
+    XCTAssertEqualObjects(firstMotions, samples);
+    XCTAssertEqualObjects(secondMotions, samples);
+    
+    [hub removeConsumer:firstConsumer];
+    [hub removeConsumer:secondConsumer];
+}
+
+- (void)testRemovedConsumerGetsNoMoreSamplesAndLowersTheRate {
+    NSArray *samples = [ORKReplayAccelerometerData walkingSamplesWithFrequency:100 duration:1];
+    ORKReplayMotionManager *motionManager = [[ORKReplayMotionManager alloc] initWithAccelerometerSamples:samples deviceMotionSamples:nil rate:0];
+    ORKSensorHub *hub = [[ORKSensorHub alloc] initWithMotionManager:motionManager];
+    [self suspendHub:hub];
+    
+    __block NSUInteger slowCount = 0;
+    __block NSUInteger fastCount = 0;
+    id slowConsumer = [hub addAccelerometerConsumerWithFrequency:25 handler:^(CMAccelerometerData *data, NSError *error) {
+        slowCount++;
+    }];
+    id fastConsumer = [hub addAccelerometerConsumerWithFrequency:100 handler:^(CMAccelerometerData *data, NSError *error) {
+        fastCount++;
+    }];
+    XCTAssertEqualWithAccuracy(motionManager.accelerometerUpdateInterval, 0.01, 1e-9);
+    
+    // Samples already queued for the removed consumer are not delivered to it.
+    XCTAssertTrue([motionManager.accelerometerReplayer waitUntilFinishedWithTimeout:10.0]);
+    [hub removeConsumer:fastConsumer];
+    XCTAssertEqualWithAccuracy(motionManager.accelerometerUpdateInterval, 0.04, 1e-9);
+    [self resumeHub:hub afterReplayer:motionManager.accelerometerReplayer];
+    XCTAssertEqual(fastCount, 0);
+    XCTAssertGreaterThan(slowCount, 0);
+    
+    [hub removeConsumer:slowConsumer];
+}
+
+- (void)testRemovingLastConsumerStopsTheStream {
+    NSArray *samples = [ORKReplayAccelerometerData walkingSamplesWithFrequency:100 duration:10];
+    ORKReplayMotionManager *motionManager = [[ORKReplayMotionManager alloc] initWithAccelerometerSamples:samples deviceMotionSamples:nil rate:1];
+    ORKSensorHub *hub = [[ORKSensorHub alloc] initWithMotionManager:motionManager];
+    
+    __block NSUInteger count = 0;
+    XCTestExpectation *expectation = [self expectationWithDescription:@"first sample"];
+    id consumer = [hub addAccelerometerConsumerWithFrequency:100 handler:^(CMAccelerometerData *data, NSError *error) {
+        if (++count == 1) {
+            [expectation fulfill];
+        }
+    }];
+    XCTAssertTrue(motionManager.accelerometerActive);
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+    
+    [hub removeConsumer:consumer];
+    XCTAssertFalse(motionManager.accelerometerActive);
+    NSUInteger countAtRemoval = count;
+    [[NSRunLoop currentRunLoop] runUntilDate:[NSDate dateWithTimeIntervalSinceNow:0.2]];
+    XCTAssertEqual(count, countAtRemoval);
+}
+
+@end
@@ -0,0 +1,266 @@
+/*
+ Copyright (c) 2016, Apple Inc. All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+ 
+ 1.  Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ 2.  Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation and/or
+ other materials provided with the distribution.
+ 
+ 3.  Neither the name of the copyright holder(s) nor the names of any contributors
+ may be used to endorse or promote products derived from this software without
+ specific prior written permission. No license is granted to the trademarks of
+ the copyright holders even if such marks are included in this software.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+@import UIKit;
+@import CoreLocation;
+@import CoreMotion;
+@import ResearchKit.Private;
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ The `ORKSensorReplayer` class plays back a stream of samples, in timestamp order, at a
+ multiple of the rate at which they were captured.
+
+ A rate of 1 replays the stream in real time, a rate of 10 replays it ten times faster, and a
+ rate of 0 delivers the samples as fast as the handler takes them. Samples are delivered on
+ the replayer's own serial queue.
+
+ The replay sources in this file use a replayer to stand in for the device's sensors, so that
+ recorders can be driven headlessly by recorded or synthetic streams.
+ */
+@interface ORKSensorReplayer : NSObject
+
+/**
+ Reads the items of a log file written by an `ORKDataLogger` object with a JSON formatter,
+ such as the files produced by the recorders.
+ */
++ (nullable NSArray<NSDictionary *> *)JSONItemsWithContentsOfURL:(NSURL *)url error:(NSError * _Nullable *)error;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/**
+ Returns a replayer for the specified samples.
+
+ @param samples         The samples to replay. They are sorted by timestamp.
+ @param timestampBlock  A block that returns the capture time of a sample, in seconds.
+ */
+- (instancetype)initWithSamples:(NSArray *)samples timestampBlock:(NSTimeInterval (^)(id sample))timestampBlock NS_DESIGNATED_INITIALIZER;
+
+@property (nonatomic, copy, readonly) NSArray *samples;
+
+/// The playback rate, relative to real time. The default is 1. Set it before starting playback.
+@property (nonatomic) double rate;
+
+@property (readonly, getter=isReplaying) BOOL replaying;
+
+/// The number of samples handed to the handler since playback last started.
+@property (readonly) NSUInteger deliveredSampleCount;
+
+/**
+ Starts playback from the first sample.
+
+ @param handler     The block to call with each sample, on the replayer's queue.
+ @param completion  The block to call on the replayer's queue after the last sample, unless
+                        playback is stopped first.
+ */
+- (void)startWithHandler:(void (^)(id sample))handler completion:(nullable void (^)(void))completion;
+
+/// Stops playback. When called outside the handler, no sample is delivered after it returns.
+- (void)stop;
+
+/**
+ Blocks until playback finishes or is stopped.
+
+ @return `NO` if playback was still running after `timeout` seconds.
+ */
+- (BOOL)waitUntilFinishedWithTimeout:(NSTimeInterval)timeout;
+
+@end
+
+
+/// An accelerometer sample that can be created outside CoreMotion.
+@interface ORKReplayAccelerometerData : CMAccelerometerData
+
+/// Reads samples written by `ORKAccelerometerRecorder`.
++ (NSArray<ORKReplayAccelerometerData *> *)samplesWithJSONItems:(NSArray<NSDictionary *> *)items;
+
+/// Synthesizes the vertical bounce of a phone carried while walking, starting now.
++ (NSArray<ORKReplayAccelerometerData *> *)walkingSamplesWithFrequency:(double)frequency duration:(NSTimeInterval)duration;
+
+- (instancetype)initWithTimestamp:(NSTimeInterval)timestamp acceleration:(CMAcceleration)acceleration;
+
+@end
+
+
+/// A device motion sample that can be created outside CoreMotion.
+@interface ORKReplayDeviceMotion : CMDeviceMotion
+
+/// Reads samples written by `ORKDeviceMotionRecorder`.
++ (NSArray<ORKReplayDeviceMotion *> *)samplesWithJSONItems:(NSArray<NSDictionary *> *)items;
+
+/// Synthesizes the motion of a phone carried upright while walking, starting now.
++ (NSArray<ORKReplayDeviceMotion *> *)walkingSamplesWithFrequency:(double)frequency duration:(NSTimeInterval)duration;
+
+- (instancetype)initWithTimestamp:(NSTimeInterval)timestamp
+                         attitude:(CMQuaternion)attitude
+                     rotationRate:(CMRotationRate)rotationRate
+                          gravity:(CMAcceleration)gravity
+                 userAcceleration:(CMAcceleration)userAcceleration
+                    magneticField:(CMCalibratedMagneticField)magneticField;
+
+@end
+
+
+/// A pedometer sample that can be created outside CoreMotion.
+@interface ORKReplayPedometerData : CMPedometerData
+
+/// Reads samples written by `ORKPedometerRecorder`.
++ (NSArray<ORKReplayPedometerData *> *)samplesWithJSONItems:(NSArray<NSDictionary *> *)items;
+
+/// Synthesizes cumulative step counts for a steady walk, starting now, one sample per `interval`.
++ (NSArray<ORKReplayPedometerData *> *)walkingSamplesWithInterval:(NSTimeInterval)interval duration:(NSTimeInterval)duration;
+
+- (instancetype)initWithStartDate:(NSDate *)startDate
+                          endDate:(NSDate *)endDate
+                    numberOfSteps:(NSNumber *)numberOfSteps
+                         distance:(nullable NSNumber *)distance;
+
+@end
+
+
+/// One phase of a touch, replayed by an `ORKReplayTouchView` object.
+@interface ORKReplayTouchSample : NSObject
+
+/// Reads samples written by `ORKTouchRecorder`.
++ (NSArray<ORKReplayTouchSample *> *)samplesWithJSONItems:(NSArray<NSDictionary *> *)items;
+
+/// Synthesizes a one-finger swipe, starting now.
++ (NSArray<ORKReplayTouchSample *> *)swipeSamplesFromPoint:(CGPoint)startPoint
+                                                   toPoint:(CGPoint)endPoint
+                                                  duration:(NSTimeInterval)duration
+                                                 frequency:(double)frequency;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/**
+ Returns a touch sample.
+
+ @param touchIndex  Identifies the touch. Samples with the same index belong to the same touch
+                        until a sample ends or cancels it.
+ */
+- (instancetype)initWithTouchIndex:(NSUInteger)touchIndex
+                         timestamp:(NSTimeInterval)timestamp
+                          location:(CGPoint)location
+                             phase:(UITouchPhase)phase NS_DESIGNATED_INITIALIZER;
+
+@property (nonatomic, readonly) NSUInteger touchIndex;
+
+@property (nonatomic, readonly) NSTimeInterval timestamp;
+
+@property (nonatomic, readonly) CGPoint location;
+
+@property (nonatomic, readonly) UITouchPhase phase;
+
+@end
+
+
+/**
+ A motion manager that replays accelerometer and device motion samples instead of reading
+ the device's sensors. Updates are delivered to the queue passed when starting them.
+ */
+@interface ORKReplayMotionManager : CMMotionManager
+
+- (instancetype)initWithAccelerometerSamples:(nullable NSArray<CMAccelerometerData *> *)accelerometerSamples
+                         deviceMotionSamples:(nullable NSArray<CMDeviceMotion *> *)deviceMotionSamples
+                                        rate:(double)rate;
+
+/// The accelerometer replayer, or `nil` if the accelerometer is unavailable.
+@property (nonatomic, strong, readonly, nullable) ORKSensorReplayer *accelerometerReplayer;
+
+/// The device motion replayer, or `nil` if device motion is unavailable.
+@property (nonatomic, strong, readonly, nullable) ORKSensorReplayer *deviceMotionReplayer;
+
+@end
+
+
+/// A pedometer that replays pedometer samples instead of counting steps.
+@interface ORKReplayPedometer : CMPedometer
+
+- (instancetype)initWithSamples:(NSArray<CMPedometerData *> *)samples rate:(double)rate;
+
+@property (nonatomic, strong, readonly) ORKSensorReplayer *replayer;
+
+@end
+
+
+/**
+ A location manager that replays locations instead of using location services.
+ Authorization requests are ignored, and the delegate is called on the main queue.
+ */
+@interface ORKReplayLocationManager : CLLocationManager
+
+/// Reads locations written by `ORKLocationRecorder`.
++ (NSArray<CLLocation *> *)locationsWithJSONItems:(NSArray<NSDictionary *> *)items;
+
+/// Synthesizes a walk heading north from `coordinate`, starting now, one location per second.
++ (NSArray<CLLocation *> *)walkingLocationsFromCoordinate:(CLLocationCoordinate2D)coordinate duration:(NSTimeInterval)duration;
+
+- (instancetype)initWithLocations:(NSArray<CLLocation *> *)locations rate:(double)rate;
+
+@property (nonatomic, strong, readonly) ORKSensorReplayer *replayer;
+
+@end
+
+
+/**
+ A view that replays touches into its gesture recognizers on the main queue.
+
+ Playback starts when the first gesture recognizer is added, which `ORKTouchRecorder` does when
+ it starts, and stops when the last one is removed.
+ */
+@interface ORKReplayTouchView : UIView
+
+- (instancetype)initWithFrame:(CGRect)frame touchSamples:(NSArray<ORKReplayTouchSample *> *)touchSamples rate:(double)rate;
+
+@property (nonatomic, strong, readonly) ORKSensorReplayer *replayer;
+
+@end
+
+
+/**
+ A recorder sample source that hands out replay sources. Assign it to the `sampleSource`
+ property of one or more recorders before starting them.
+ */
+@interface ORKSensorReplaySource : NSObject <ORKRecorderSampleSource>
+
+@property (nonatomic, strong, nullable) ORKReplayMotionManager *motionManager;
+
+@property (nonatomic, strong, nullable) ORKReplayPedometer *pedometer;
+
+@property (nonatomic, strong, nullable) ORKReplayLocationManager *locationManager;
+
+@property (nonatomic, strong, nullable) ORKReplayTouchView *touchView;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,853 @@
+/*
+ Copyright (c) 2016, Apple Inc. All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+ 
+ 1.  Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ 2.  Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation and/or
+ other materials provided with the distribution.
+ 
+ 3.  Neither the name of the copyright holder(s) nor the names of any contributors
+ may be used to endorse or promote products derived from this software without
+ specific prior written permission. No license is granted to the trademarks of
+ the copyright holders even if such marks are included in this software.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#import "ORKSensorReplay.h"
+
+#import "ORKHelpers_Internal.h"
+
+#import <UIKit/UIGestureRecognizerSubclass.h>
+
+
+// Samples delivered per turn of the replayer's queue when replaying as fast as possible.
+static const NSUInteger ORKSensorReplayerUnlimitedBatchSize = 256;
+
+static double ORKReplayDouble(id object) {
+    return [object respondsToSelector:@selector(doubleValue)] ? [object doubleValue] : 0;
+}
+
+static CMAcceleration ORKReplayAccelerationFromJSONDictionary(NSDictionary *dictionary) {
+    return (CMAcceleration){ORKReplayDouble(dictionary[@"x"]), ORKReplayDouble(dictionary[@"y"]), ORKReplayDouble(dictionary[@"z"])};
+}
+
+static const void *ORKSensorReplayerQueueKey = &ORKSensorReplayerQueueKey;
+
+
+@implementation ORKSensorReplayer {
+    dispatch_queue_t _queue;
+    dispatch_group_t _group;
+    dispatch_source_t _timer;
+
+    NSData *_offsets;
+    NSUInteger _deliveredSampleCount;
+
+    // Only accessed on _queue.
+    void (^_handler)(id sample);
+    void (^_completion)(void);
+    NSTimeInterval _startUptime;
+    double _playbackRate;
+    NSUInteger _nextIndex;
+}
+
++ (NSArray<NSDictionary *> *)JSONItemsWithContentsOfURL:(NSURL *)url error:(NSError **)error {
+    NSData *data = [NSData dataWithContentsOfURL:url options:NSDataReadingMappedIfSafe error:error];
+    if (!data) {
+        return nil;
+    }
+    NSDictionary *log = ORKDynamicCast([NSJSONSerialization JSONObjectWithData:data options:0 error:error], NSDictionary);
+    NSArray *items = ORKDynamicCast(log[@"items"], NSArray);
+    if (!items && error && !*error) {
+        *error = [NSError errorWithDomain:NSCocoaErrorDomain code:NSFileReadCorruptFileError userInfo:@{NSURLErrorKey: url}];
+    }
+    return items;
+}
+
+- (instancetype)init {
+    ORKThrowMethodUnavailableException();
+}
+
+- (instancetype)initWithSamples:(NSArray *)samples timestampBlock:(NSTimeInterval (^)(id))timestampBlock {
+    self = [super init];
+    if (self) {
+        ORKThrowInvalidArgumentExceptionIfNil(samples);
+        ORKThrowInvalidArgumentExceptionIfNil(timestampBlock);
+
+        _samples = [samples sortedArrayWithOptions:NSSortStable usingComparator:^NSComparisonResult(id sample1, id sample2) {
+            NSTimeInterval timestamp1 = timestampBlock(sample1);
+            NSTimeInterval timestamp2 = timestampBlock(sample2);
+            return (timestamp1 < timestamp2) ? NSOrderedAscending : ((timestamp1 > timestamp2) ? NSOrderedDescending : NSOrderedSame);
+        }];
+
+        NSMutableData *offsets = [NSMutableData dataWithLength:_samples.count * sizeof(NSTimeInterval)];
+        NSTimeInterval *offsetBytes = offsets.mutableBytes;
+        NSTimeInterval firstTimestamp = _samples.count > 0 ? timestampBlock(_samples.firstObject) : 0;
+        [_samples enumerateObjectsUsingBlock:^(id sample, NSUInteger index, BOOL *stop) {
+            offsetBytes[index] = timestampBlock(sample) - firstTimestamp;
+        }];
+        _offsets = offsets;
+
+        _rate = 1;
+        _queue = dispatch_queue_create("org.researchkit.sensorreplay", DISPATCH_QUEUE_SERIAL);
+        dispatch_queue_set_specific(_queue, ORKSensorReplayerQueueKey, (__bridge void *)self, NULL);
+        _group = dispatch_group_create();
+    }
+    return self;
+}
+
+- (void)dealloc {
+    if (_timer) {
+        dispatch_source_cancel(_timer);
+        dispatch_group_leave(_group);
+    }
+}
+
+- (BOOL)isReplaying {
+    @synchronized (self) {
+        return (_timer != nil);
+    }
+}
+
+- (NSUInteger)deliveredSampleCount {
+    @synchronized (self) {
+        return _deliveredSampleCount;
+    }
+}
+
+- (void)startWithHandler:(void (^)(id))handler completion:(void (^)(void))completion {
+    ORKThrowInvalidArgumentExceptionIfNil(handler);
+    [self stop];
+
+    dispatch_group_enter(_group);
+    dispatch_source_t timer = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, _queue);
+    @synchronized (self) {
+        _timer = timer;
+        _deliveredSampleCount = 0;
+    }
+
+    double rate = _rate;
+    ORKWeakTypeOf(self) weakSelf = self;
+    dispatch_async(_queue, ^{
+        ORKStrongTypeOf(self) strongSelf = weakSelf;
+        if (!strongSelf) {
+            // Cancelled in dealloc; a source must be resumed before it is released.
+            dispatch_resume(timer);
+            return;
+        }
+        strongSelf->_handler = [handler copy];
+        strongSelf->_completion = [completion copy];
+        strongSelf->_playbackRate = rate;
+        strongSelf->_nextIndex = 0;
+        strongSelf->_startUptime = [NSProcessInfo processInfo].systemUptime;
+
+        dispatch_source_set_event_handler(timer, ^{
+            [weakSelf queue_deliverDueSamples];
+        });
+        dispatch_source_set_timer(timer, DISPATCH_TIME_NOW, DISPATCH_TIME_FOREVER, 0);
+        dispatch_resume(timer);
+    });
+}
+
+- (void)queue_deliverDueSamples {
+    void (^handler)(id) = _handler;
+    if (!handler) {
+        return;
+    }
+
+    const NSTimeInterval *offsets = _offsets.bytes;
+    NSUInteger count = _samples.count;
+    NSUInteger delivered = 0;
+    NSTimeInterval elapsed = 0;
+    if (_playbackRate <= 0) {
+        NSUInteger end = MIN(_nextIndex + ORKSensorReplayerUnlimitedBatchSize, count);
+        for (; _nextIndex < end && _handler; _nextIndex++, delivered++) {
+            handler(_samples[_nextIndex]);
+        }
+    } else {
+        elapsed = ([NSProcessInfo processInfo].systemUptime - _startUptime) * _playbackRate;
+        for (; _nextIndex < count && offsets[_nextIndex] <= elapsed && _handler; _nextIndex++, delivered++) {
+            handler(_samples[_nextIndex]);
+        }
+    }
+
+    dispatch_source_t timer = nil;
+    @synchronized (self) {
+        _deliveredSampleCount += delivered;
+        timer = _timer;
+    }
+    if (!timer || !_handler) {
+        // Stopped from within the handler.
+        return;
+    }
+
+    if (_nextIndex == count) {
+        void (^completion)(void) = _completion;
+        [self queue_finish];
+        if (completion) {
+            completion();
+        }
+        return;
+    }
+
+    NSTimeInterval delay = (_playbackRate <= 0) ? 0 : (offsets[_nextIndex] - elapsed) / _playbackRate;
+    uint64_t leeway = (uint64_t)MIN(delay * NSEC_PER_SEC / 10, NSEC_PER_MSEC);
+    dispatch_source_set_timer(timer, dispatch_time(DISPATCH_TIME_NOW, (int64_t)(delay * NSEC_PER_SEC)), DISPATCH_TIME_FOREVER, leeway);
+}
+
+- (void)queue_finish {
+    dispatch_source_t timer = nil;
+    @synchronized (self) {
+        timer = _timer;
+        _timer = nil;
+    }
+    _handler = nil;
+    _completion = nil;
+    if (timer) {
+        dispatch_source_cancel(timer);
+        dispatch_group_leave(_group);
+    }
+}
+
+- (void)stop {
+    if (dispatch_get_specific(ORKSensorReplayerQueueKey) == (__bridge void *)self) {
+        [self queue_finish];
+    } else {
+        dispatch_sync(_queue, ^{
+            [self queue_finish];
+        });
+    }
+}
+
+- (BOOL)waitUntilFinishedWithTimeout:(NSTimeInterval)timeout {
+    return dispatch_group_wait(_group, dispatch_time(DISPATCH_TIME_NOW, (int64_t)(timeout * NSEC_PER_SEC))) == 0;
+}
+
+@end
+
+
+@implementation ORKReplayAccelerometerData {
+    NSTimeInterval _replayTimestamp;
+    CMAcceleration _replayAcceleration;
+}
+
++ (NSArray<ORKReplayAccelerometerData *> *)samplesWithJSONItems:(NSArray<NSDictionary *> *)items {
+    NSMutableArray *samples = [NSMutableArray arrayWithCapacity:items.count];
+    for (NSDictionary *item in items) {
+        [samples addObject:[[ORKReplayAccelerometerData alloc] initWithTimestamp:ORKReplayDouble(item[@"timestamp"])
+                                                                    acceleration:ORKReplayAccelerationFromJSONDictionary(item)]];
+    }
+    return samples;
+}
+
++ (NSArray<ORKReplayAccelerometerData *> *)walkingSamplesWithFrequency:(double)frequency duration:(NSTimeInterval)duration {
+    NSTimeInterval start = [NSProcessInfo processInfo].systemUptime;
+    NSUInteger count = (NSUInteger)(MAX(frequency, 0) * MAX(duration, 0));
+    NSMutableArray *samples = [NSMutableArray arrayWithCapacity:count];
+    for (NSUInteger index = 0; index < count; index++) {
+        NSTimeInterval time = index / frequency;
+        double phase = 2 * M_PI * 1.8 * time;
+        CMAcceleration acceleration = {0.05 * sin(phase / 2), 0.1 * cos(phase), -1 + 0.3 * sin(phase)};
+        [samples addObject:[[ORKReplayAccelerometerData alloc] initWithTimestamp:start + time acceleration:acceleration]];
+    }
+    return samples;
+}
+
+- (instancetype)initWithTimestamp:(NSTimeInterval)timestamp acceleration:(CMAcceleration)acceleration {
+    self = [super init];
+    if (self) {
+        _replayTimestamp = timestamp;
+        _replayAcceleration = acceleration;
+    }
+    return self;
+}
+
+- (NSTimeInterval)timestamp {
+    return _replayTimestamp;
+}
+
+- (CMAcceleration)acceleration {
+    return _replayAcceleration;
+}
+
+@end
+
+
+@interface ORKReplayAttitude : CMAttitude
+
+- (instancetype)initWithQuaternion:(CMQuaternion)quaternion;
+
+@end
+
+
+@implementation ORKReplayAttitude {
+    CMQuaternion _replayQuaternion;
+}
+
+- (instancetype)initWithQuaternion:(CMQuaternion)quaternion {
+    self = [super init];
+    if (self) {
+        _replayQuaternion = quaternion;
+    }
+    return self;
+}
+
+- (CMQuaternion)quaternion {
+    return _replayQuaternion;
+}
+
+@end
+
+
+@implementation ORKReplayDeviceMotion {
+    NSTimeInterval _replayTimestamp;
+    ORKReplayAttitude *_replayAttitude;
+    CMRotationRate _replayRotationRate;
+    CMAcceleration _replayGravity;
+    CMAcceleration _replayUserAcceleration;
+    CMCalibratedMagneticField _replayMagneticField;
+}
+
++ (NSArray<ORKReplayDeviceMotion *> *)samplesWithJSONItems:(NSArray<NSDictionary *> *)items {
+    NSMutableArray *samples = [NSMutableArray arrayWithCapacity:items.count];
+    for (NSDictionary *item in items) {
+        NSDictionary *attitude = item[@"attitude"];
+        NSDictionary *rotationRate = item[@"rotationRate"];
+        NSDictionary *magneticField = item[@"magneticField"];
+        CMAcceleration field = ORKReplayAccelerationFromJSONDictionary(magneticField);
+        [samples addObject:[[ORKReplayDeviceMotion alloc] initWithTimestamp:ORKReplayDouble(item[@"timestamp"])
+                                                                   attitude:(CMQuaternion){ORKReplayDouble(attitude[@"x"]), ORKReplayDouble(attitude[@"y"]), ORKReplayDouble(attitude[@"z"]), ORKReplayDouble(attitude[@"w"])}
+                                                               rotationRate:(CMRotationRate){ORKReplayDouble(rotationRate[@"x"]), ORKReplayDouble(rotationRate[@"y"]), ORKReplayDouble(rotationRate[@"z"])}
+                                                                    gravity:ORKReplayAccelerationFromJSONDictionary(item[@"gravity"])
+                                                           userAcceleration:ORKReplayAccelerationFromJSONDictionary(item[@"userAcceleration"])
+                                                              magneticField:(CMCalibratedMagneticField){{field.x, field.y, field.z}, (CMMagneticFieldCalibrationAccuracy)ORKReplayDouble(magneticField[@"accuracy"])}]];
+    }
+    return samples;
+}
+
++ (NSArray<ORKReplayDeviceMotion *> *)walkingSamplesWithFrequency:(double)frequency duration:(NSTimeInterval)duration {
+    NSTimeInterval start = [NSProcessInfo processInfo].systemUptime;
+    NSUInteger count = (NSUInteger)(MAX(frequency, 0) * MAX(duration, 0));
+    NSMutableArray *samples = [NSMutableArray arrayWithCapacity:count];
+    for (NSUInteger index = 0; index < count; index++) {
+        NSTimeInterval time = index / frequency;
+        double phase = 2 * M_PI * 1.8 * time;
+        // Upright, with gravity along -y.
+        [samples addObject:[[ORKReplayDeviceMotion alloc] initWithTimestamp:start + time
+                                                                   attitude:(CMQuaternion){sin(M_PI_4), 0, 0, cos(M_PI_4)}
+                                                               rotationRate:(CMRotationRate){0.2 * sin(phase), 0.1 * cos(phase / 2), 0}
+                                                                    gravity:(CMAcceleration){0, -1, 0}
+                                                           userAcceleration:(CMAcceleration){0.05 * sin(phase / 2), 0.3 * sin(phase), 0.1 * cos(phase)}
+                                                              magneticField:(CMCalibratedMagneticField){{0, 20, -40}, CMMagneticFieldCalibrationAccuracyHigh}]];
+    }
+    return samples;
+}
+
+- (instancetype)initWithTimestamp:(NSTimeInterval)timestamp
+                         attitude:(CMQuaternion)attitude
+                     rotationRate:(CMRotationRate)rotationRate
+                          gravity:(CMAcceleration)gravity
+                 userAcceleration:(CMAcceleration)userAcceleration
+                    magneticField:(CMCalibratedMagneticField)magneticField {
+    self = [super init];
+    if (self) {
+        _replayTimestamp = timestamp;
+        _replayAttitude = [[ORKReplayAttitude alloc] initWithQuaternion:attitude];
+        _replayRotationRate = rotationRate;
+        _replayGravity = gravity;
+        _replayUserAcceleration = userAcceleration;
+        _replayMagneticField = magneticField;
+    }
+    return self;
+}
+
+- (NSTimeInterval)timestamp {
+    return _replayTimestamp;
+}
+
+- (CMAttitude *)attitude {
+    return _replayAttitude;
+}
+
+- (CMRotationRate)rotationRate {
+    return _replayRotationRate;
+}
+
+- (CMAcceleration)gravity {
+    return _replayGravity;
+}
+
+- (CMAcceleration)userAcceleration {
+    return _replayUserAcceleration;
+}
+
+- (CMCalibratedMagneticField)magneticField {
+    return _replayMagneticField;
+}
+
+@end
+
+
+@implementation ORKReplayPedometerData {
+    NSDate *_replayStartDate;
+    NSDate *_replayEndDate;
+    NSNumber *_replayNumberOfSteps;
+    NSNumber *_replayDistance;
+}
+
++ (NSArray<ORKReplayPedometerData *> *)samplesWithJSONItems:(NSArray<NSDictionary *> *)items {
+    NSMutableArray *samples = [NSMutableArray arrayWithCapacity:items.count];
+    for (NSDictionary *item in items) {
+        NSDate *startDate = ORKDateFromStringISO8601(ORKDynamicCast(item[@"startDate"], NSString));
+        NSDate *endDate = ORKDateFromStringISO8601(ORKDynamicCast(item[@"endDate"], NSString));
+        NSNumber *numberOfSteps = ORKDynamicCast(item[@"numberOfSteps"], NSNumber);
+        if (!startDate || !endDate || !numberOfSteps) {
+            continue;
+        }
+        [samples addObject:[[ORKReplayPedometerData alloc] initWithStartDate:startDate
+                                                                     endDate:endDate
+                                                               numberOfSteps:numberOfSteps
+                                                                    distance:ORKDynamicCast(item[@"distance"], NSNumber)]];
+    }
+    return samples;
+}
+
++ (NSArray<ORKReplayPedometerData *> *)walkingSamplesWithInterval:(NSTimeInterval)interval duration:(NSTimeInterval)duration {
+    NSDate *startDate = [NSDate date];
+    NSUInteger count = (interval > 0) ? (NSUInteger)(MAX(duration, 0) / interval) : 0;
+    NSMutableArray *samples = [NSMutableArray arrayWithCapacity:count];
+    for (NSUInteger index = 1; index <= count; index++) {
+        NSTimeInterval elapsed = index * interval;
+        NSInteger steps = (NSInteger)(1.8 * elapsed);
+        [samples addObject:[[ORKReplayPedometerData alloc] initWithStartDate:startDate
+                                                                     endDate:[startDate dateByAddingTimeInterval:elapsed]
+                                                               numberOfSteps:@(steps)
+                                                                    distance:@(0.7 * steps)]];
+    }
+    return samples;
+}
+
+- (instancetype)initWithStartDate:(NSDate *)startDate endDate:(NSDate *)endDate numberOfSteps:(NSNumber *)numberOfSteps distance:(NSNumber *)distance {
+    self = [super init];
+    if (self) {
+        _replayStartDate = [startDate copy];
+        _replayEndDate = [endDate copy];
+        _replayNumberOfSteps = numberOfSteps;
+        _replayDistance = distance;
+    }
+    return self;
+}
+
+- (NSDate *)startDate {
+    return _replayStartDate;
+}
+
+- (NSDate *)endDate {
+    return _replayEndDate;
+}
+
+- (NSNumber *)numberOfSteps {
+    return _replayNumberOfSteps;
+}
+
+- (NSNumber *)distance {
+    return _replayDistance;
+}
+
+- (NSNumber *)floorsAscended {
+    return nil;
+}
+
+- (NSNumber *)floorsDescended {
+    return nil;
+}
+
+@end
+
+
+@implementation ORKReplayTouchSample
+
++ (NSArray<ORKReplayTouchSample *> *)samplesWithJSONItems:(NSArray<NSDictionary *> *)items {
+    NSMutableArray *samples = [NSMutableArray arrayWithCapacity:items.count];
+    for (NSDictionary *item in items) {
+        [samples addObject:[[ORKReplayTouchSample alloc] initWithTouchIndex:(NSUInteger)ORKReplayDouble(item[@"index"])
+                                                                  timestamp:ORKReplayDouble(item[@"timestamp"])
+                                                                   location:CGPointMake(ORKReplayDouble(item[@"x"]), ORKReplayDouble(item[@"y"]))
+                                                                      phase:(UITouchPhase)ORKReplayDouble(item[@"phase"])]];
+    }
+    return samples;
+}
+
++ (NSArray<ORKReplayTouchSample *> *)swipeSamplesFromPoint:(CGPoint)startPoint toPoint:(CGPoint)endPoint duration:(NSTimeInterval)duration frequency:(double)frequency {
+    NSTimeInterval start = [NSProcessInfo processInfo].systemUptime;
+    NSUInteger steps = MAX((NSUInteger)(MAX(frequency, 0) * MAX(duration, 0)), 1);
+    NSMutableArray *samples = [NSMutableArray arrayWithCapacity:steps + 1];
+    for (NSUInteger step = 0; step <= steps; step++) {
+        double progress = (double)step / steps;
+        UITouchPhase phase = (step == 0) ? UITouchPhaseBegan : ((step == steps) ? UITouchPhaseEnded : UITouchPhaseMoved);
+        [samples addObject:[[ORKReplayTouchSample alloc] initWithTouchIndex:0
+                                                                  timestamp:start + progress * duration
+                                                                   location:CGPointMake(startPoint.x + (endPoint.x - startPoint.x) * progress,
+                                                                                        startPoint.y + (endPoint.y - startPoint.y) * progress)
+                                                                      phase:phase]];
+    }
+    return samples;
+}
+
+- (instancetype)init {
+    ORKThrowMethodUnavailableException();
+}
+
+- (instancetype)initWithTouchIndex:(NSUInteger)touchIndex timestamp:(NSTimeInterval)timestamp location:(CGPoint)location phase:(UITouchPhase)phase {
+    self = [super init];
+    if (self) {
+        _touchIndex = touchIndex;
+        _timestamp = timestamp;
+        _location = location;
+        _phase = phase;
+    }
+    return self;
+}
+
+@end
+
+
+@implementation ORKReplayMotionManager
+
+- (instancetype)initWithAccelerometerSamples:(NSArray<CMAccelerometerData *> *)accelerometerSamples
+                         deviceMotionSamples:(NSArray<CMDeviceMotion *> *)deviceMotionSamples
+                                        rate:(double)rate {
+    self = [super init];
+    if (self) {
+        NSTimeInterval (^timestampBlock)(id) = ^NSTimeInterval(CMLogItem *sample) {
+            return sample.timestamp;
+        };
+        if (accelerometerSamples) {
+            _accelerometerReplayer = [[ORKSensorReplayer alloc] initWithSamples:accelerometerSamples timestampBlock:timestampBlock];
+            _accelerometerReplayer.rate = rate;
+        }
+        if (deviceMotionSamples) {
+            _deviceMotionReplayer = [[ORKSensorReplayer alloc] initWithSamples:deviceMotionSamples timestampBlock:timestampBlock];
+            _deviceMotionReplayer.rate = rate;
+        }
+    }
+    return self;
+}
+
+- (BOOL)isAccelerometerAvailable {
+    return (_accelerometerReplayer != nil);
+}
+
+- (BOOL)isAccelerometerActive {
+    return _accelerometerReplayer.replaying;
+}
+
+- (void)startAccelerometerUpdatesToQueue:(NSOperationQueue *)queue withHandler:(CMAccelerometerHandler)handler {
+    [_accelerometerReplayer startWithHandler:^(CMAccelerometerData *data) {
+        [queue addOperationWithBlock:^{
+            handler(data, nil);
+        }];
+    } completion:nil];
+}
+
+- (void)stopAccelerometerUpdates {
+    [_accelerometerReplayer stop];
+}
+
+- (BOOL)isDeviceMotionAvailable {
+    return (_deviceMotionReplayer != nil);
+}
+
+- (BOOL)isDeviceMotionActive {
+    return _deviceMotionReplayer.replaying;
+}
+
+- (void)startDeviceMotionUpdatesToQueue:(NSOperationQueue *)queue withHandler:(CMDeviceMotionHandler)handler {
+    [_deviceMotionReplayer startWithHandler:^(CMDeviceMotion *motion) {
+        [queue addOperationWithBlock:^{
+            handler(motion, nil);
+        }];
+    } completion:nil];
+}
+
+- (void)stopDeviceMotionUpdates {
+    [_deviceMotionReplayer stop];
+}
+
+@end
+
+
+@implementation ORKReplayPedometer
+
++ (BOOL)isStepCountingAvailable {
+    return YES;
+}
+
++ (BOOL)isDistanceAvailable {
+    return YES;
+}
+
+- (instancetype)initWithSamples:(NSArray<CMPedometerData *> *)samples rate:(double)rate {
+    self = [super init];
+    if (self) {
+        _replayer = [[ORKSensorReplayer alloc] initWithSamples:samples timestampBlock:^NSTimeInterval(CMPedometerData *sample) {
+            return sample.endDate.timeIntervalSinceReferenceDate;
+        }];
+        _replayer.rate = rate;
+    }
+    return self;
+}
+
+- (void)startPedometerUpdatesFromDate:(NSDate *)start withHandler:(CMPedometerHandler)handler {
+    [_replayer startWithHandler:^(CMPedometerData *data) {
+        handler(data, nil);
+    } completion:nil];
+}
+
+- (void)stopPedometerUpdates {
+    [_replayer stop];
+}
+
+@end
+
+
+@implementation ORKReplayLocationManager
+
++ (NSArray<CLLocation *> *)locationsWithJSONItems:(NSArray<NSDictionary *> *)items {
+    NSMutableArray *locations = [NSMutableArray arrayWithCapacity:items.count];
+    for (NSDictionary *item in items) {
+        NSDate *timestamp = ORKDateFromStringISO8601(ORKDynamicCast(item[@"timestamp"], NSString));
+        NSDictionary *coordinate = ORKDynamicCast(item[@"coordinate"], NSDictionary);
+        if (!timestamp) {
+            continue;
+        }
+        // Missing values were invalid when recorded.
+        [locations addObject:[[CLLocation alloc] initWithCoordinate:CLLocationCoordinate2DMake(ORKReplayDouble(coordinate[@"latitude"]), ORKReplayDouble(coordinate[@"longitude"]))
+                                                           altitude:ORKReplayDouble(item[@"altitude"])
+                                                 horizontalAccuracy:coordinate ? ORKReplayDouble(item[@"horizontalAccuracy"]) : -1
+                                                   verticalAccuracy:item[@"verticalAccuracy"] ? ORKReplayDouble(item[@"verticalAccuracy"]) : -1
+                                                             course:item[@"course"] ? ORKReplayDouble(item[@"course"]) : -1
+                                                              speed:item[@"speed"] ? ORKReplayDouble(item[@"speed"]) : -1
+                                                          timestamp:timestamp]];
+    }
+    return locations;
+}
+
++ (NSArray<CLLocation *> *)walkingLocationsFromCoordinate:(CLLocationCoordinate2D)coordinate duration:(NSTimeInterval)duration {
+    static const CLLocationSpeed speed = 1.4;
+    static const CLLocationDistance metersPerDegreeOfLatitude = 111320;
+    NSDate *start = [NSDate date];
+    NSUInteger count = (NSUInteger)MAX(duration, 0);
+    NSMutableArray *locations = [NSMutableArray arrayWithCapacity:count];
+    for (NSUInteger second = 0; second < count; second++) {
+        CLLocationCoordinate2D position = CLLocationCoordinate2DMake(coordinate.latitude + speed * second / metersPerDegreeOfLatitude, coordinate.longitude);
+        [locations addObject:[[CLLocation alloc] initWithCoordinate:position
+                                                           altitude:10
+                                                 horizontalAccuracy:5
+                                                   verticalAccuracy:10
+                                                             course:0
+                                                              speed:speed
+                                                          timestamp:[start dateByAddingTimeInterval:second]]];
+    }
+    return locations;
+}
+
+- (instancetype)initWithLocations:(NSArray<CLLocation *> *)locations rate:(double)rate {
+    self = [super init];
+    if (self) {
+        _replayer = [[ORKSensorReplayer alloc] initWithSamples:locations timestampBlock:^NSTimeInterval(CLLocation *location) {
+            return location.timestamp.timeIntervalSinceReferenceDate;
+        }];
+        _replayer.rate = rate;
+    }
+    return self;
+}
+
+- (void)requestWhenInUseAuthorization {
+}
+
+- (void)requestAlwaysAuthorization {
+}
+
+- (void)setPausesLocationUpdatesAutomatically:(BOOL)pausesLocationUpdatesAutomatically {
+}
+
+- (void)startUpdatingLocation {
+    ORKWeakTypeOf(self) weakSelf = self;
+    [_replayer startWithHandler:^(CLLocation *location) {
+        dispatch_async(dispatch_get_main_queue(), ^{
+            ORKStrongTypeOf(self) strongSelf = weakSelf;
+            id<CLLocationManagerDelegate> delegate = strongSelf.delegate;
+            if ([delegate respondsToSelector:@selector(locationManager:didUpdateLocations:)]) {
+                [delegate locationManager:strongSelf didUpdateLocations:@[location]];
+            }
+        });
+    } completion:nil];
+}
+
+- (void)stopUpdatingLocation {
+    [_replayer stop];
+}
+
+@end
+
+
+@interface ORKReplayTouch : UITouch
+
+@property (nonatomic) NSTimeInterval replayTimestamp;
+
+@property (nonatomic) CGPoint replayLocation;
+
+@property (nonatomic) CGPoint replayPreviousLocation;
+
+@property (nonatomic) UITouchPhase replayPhase;
+
+@property (nonatomic, weak) UIView *replayView;
+
+@end
+
+
+@implementation ORKReplayTouch
+
+- (NSTimeInterval)timestamp {
+    return _replayTimestamp;
+}
+
+- (UITouchPhase)phase {
+    return _replayPhase;
+}
+
+- (UIView *)view {
+    return _replayView;
+}
+
+- (CGPoint)locationInView:(UIView *)view {
+    return [_replayView convertPoint:_replayLocation toView:view];
+}
+
+- (CGPoint)previousLocationInView:(UIView *)view {
+    return [_replayView convertPoint:_replayPreviousLocation toView:view];
+}
+
+@end
+
+
+@implementation ORKReplayTouchView {
+    // Only accessed on the main queue.
+    NSMutableDictionary<NSNumber *, ORKReplayTouch *> *_touches;
+}
+
+- (instancetype)initWithFrame:(CGRect)frame touchSamples:(NSArray<ORKReplayTouchSample *> *)touchSamples rate:(double)rate {
+    self = [super initWithFrame:frame];
+    if (self) {
+        _replayer = [[ORKSensorReplayer alloc] initWithSamples:touchSamples timestampBlock:^NSTimeInterval(ORKReplayTouchSample *sample) {
+            return sample.timestamp;
+        }];
+        _replayer.rate = rate;
+        _touches = [NSMutableDictionary dictionary];
+    }
+    return self;
+}
+
+- (void)addGestureRecognizer:(UIGestureRecognizer *)gestureRecognizer {
+    [super addGestureRecognizer:gestureRecognizer];
+    if (self.gestureRecognizers.count == 1) {
+        ORKWeakTypeOf(self) weakSelf = self;
+        [_replayer startWithHandler:^(ORKReplayTouchSample *sample) {
+            dispatch_async(dispatch_get_main_queue(), ^{
+                [weakSelf replayTouchSample:sample];
+            });
+        } completion:nil];
+    }
+}
+
+- (void)removeGestureRecognizer:(UIGestureRecognizer *)gestureRecognizer {
+    [super removeGestureRecognizer:gestureRecognizer];
+    if (self.gestureRecognizers.count == 0) {
+        [_replayer stop];
+        [_touches removeAllObjects];
+    }
+}
+
+- (void)replayTouchSample:(ORKReplayTouchSample *)sample {
+    NSArray<UIGestureRecognizer *> *gestureRecognizers = self.gestureRecognizers;
+    if (gestureRecognizers.count == 0) {
+        return;
+    }
+
+    // A touch keeps its identity from the phase that begins it to the phase that ends it.
+    ORKReplayTouch *touch = _touches[@(sample.touchIndex)];
+    if (!touch || sample.phase == UITouchPhaseBegan) {
+        touch = [[ORKReplayTouch alloc] init];
+        touch.replayView = self;
+        touch.replayPreviousLocation = sample.location;
+        _touches[@(sample.touchIndex)] = touch;
+    } else {
+        touch.replayPreviousLocation = touch.replayLocation;
+    }
+    touch.replayTimestamp = sample.timestamp;
+    touch.replayLocation = sample.location;
+    touch.replayPhase = sample.phase;
+
+    NSSet *touches = [NSSet setWithObject:touch];
+    UIEvent *event = [UIEvent new];
+    for (UIGestureRecognizer *gestureRecognizer in gestureRecognizers) {
+        switch (sample.phase) {
+            case UITouchPhaseBegan:
+                [gestureRecognizer touchesBegan:touches withEvent:event];
+                break;
+            case UITouchPhaseMoved:
+            case UITouchPhaseStationary:
+                [gestureRecognizer touchesMoved:touches withEvent:event];
+                break;
+            case UITouchPhaseEnded:
+                [gestureRecognizer touchesEnded:touches withEvent:event];
+                break;
+            case UITouchPhaseCancelled:
+                [gestureRecognizer touchesCancelled:touches withEvent:event];
+                break;
+        }
+    }
+
+    if (sample.phase == UITouchPhaseEnded || sample.phase == UITouchPhaseCancelled) {
+        [_touches removeObjectForKey:@(sample.touchIndex)];
+    }
+}
+
+@end
+
+
+@implementation ORKSensorReplaySource
+
+- (CMMotionManager *)motionManagerForRecorder:(ORKRecorder *)recorder {
+    return _motionManager;
+}
+
+- (CMPedometer *)pedometerForRecorder:(ORKRecorder *)recorder {
+    return _pedometer;
+}
+
+- (CLLocationManager *)locationManagerForRecorder:(ORKRecorder *)recorder {
+    return _locationManager;
+}
+
+- (UIView *)touchViewForRecorder:(ORKRecorder *)recorder {
+    return _touchView;
+}
+
+@end
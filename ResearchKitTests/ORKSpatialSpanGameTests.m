@@ -0,0 +1,102 @@
+/*
+ Copyright (c) 2016, Apple Inc. All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+ 
+ 1.  Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ 2.  Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation and/or
+ other materials provided with the distribution.
+ 
+ 3.  Neither the name of the copyright holder(s) nor the names of any contributors
+ may be used to endorse or promote products derived from this software without
+ specific prior written permission. No license is granted to the trademarks of
+ the copyright holders even if such marks are included in this software.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+@import XCTest;
+@import ResearchKit.Private;
+
+#import "ORKSpatialSpanGame.h"
+
+
+@interface ORKSpatialSpanGameTests : XCTestCase
+
+@end
+
+
+@implementation ORKSpatialSpanGameTests
+
+- (NSArray<NSNumber *> *)sequenceOfGame:(ORKSpatialSpanGame *)game {
+    NSMutableArray *sequence = [NSMutableArray array];
+    for (NSInteger step = 0; step < game.sequenceLength; step++) {
+        [sequence addObject:@([game tileIndexForStep:step])];
+    }
+    return sequence;
+}
+
+- (void)testSeedProducesKnownSequence {
+    // Sequences are part of the stored results, so they must not change between releases or devices.
+    ORKSpatialSpanGame *game = [[ORKSpatialSpanGame alloc] initWithGameSize:9 sequenceLength:5 seed:42];
+    XCTAssertEqualObjects([self sequenceOfGame:game], (@[@2, @7, @3, @4, @8]));
+    
+    game = [[ORKSpatialSpanGame alloc] initWithGameSize:16 sequenceLength:7 seed:1];
+    XCTAssertEqualObjects([self sequenceOfGame:game], (@[@11, @15, @4, @12, @13, @14, @7]));
+}
+
+- (void)testSequenceIsPartOfPermutation {
+    for (uint32_t seed = 1; seed <= 200; seed++) {
+        ORKSpatialSpanGame *game = [[ORKSpatialSpanGame alloc] initWithGameSize:36 sequenceLength:15 seed:seed];
+        NSArray<NSNumber *> *sequence = [self sequenceOfGame:game];
+        XCTAssertEqual([NSSet setWithArray:sequence].count, sequence.count);
+        for (NSNumber *tileIndex in sequence) {
+            XCTAssertGreaterThanOrEqual(tileIndex.integerValue, 0);
+            XCTAssertLessThan(tileIndex.integerValue, 36);
+        }
+    }
+}
+
+- (void)testPoolMatchesGamesGeneratedOneByOne {
+    NSMutableArray *gameSizes = [NSMutableArray array];
+    NSMutableArray *sequenceLengths = [NSMutableArray array];
+    NSMutableArray *seeds = [NSMutableArray array];
+    for (NSInteger span = 2; span <= 15; span++) {
+        [gameSizes addObject:@(36)];
+        [sequenceLengths addObject:@(span)];
+        [seeds addObject:@(1000 + span)];
+    }
+    
+    NSArray<ORKSpatialSpanGame *> *games = [ORKSpatialSpanGame gamesWithGameSizes:gameSizes sequenceLengths:sequenceLengths seeds:seeds];
+    XCTAssertEqual(games.count, gameSizes.count);
+    [games enumerateObjectsUsingBlock:^(ORKSpatialSpanGame *game, NSUInteger index, BOOL *stop) {
+        ORKSpatialSpanGame *expected = [[ORKSpatialSpanGame alloc] initWithGameSize:36
+                                                                      sequenceLength:[sequenceLengths[index] integerValue]
+                                                                                seed:[seeds[index] unsignedIntValue]];
+        XCTAssertEqual(game.seed, expected.seed);
+        XCTAssertEqualObjects([self sequenceOfGame:game], [self sequenceOfGame:expected]);
+    }];
+    
+    // Without seeds, each game gets its own random seed.
+    games = [ORKSpatialSpanGame gamesWithGameSizes:gameSizes sequenceLengths:sequenceLengths seeds:nil];
+    XCTAssertEqual(games.count, gameSizes.count);
+    for (ORKSpatialSpanGame *game in games) {
+        XCTAssertNotEqual(game.seed, 0);
+    }
+}
+
+@end
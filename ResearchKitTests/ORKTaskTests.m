@@ -1512,6 +1512,50 @@ static ORKStepResult *(^getConsentStepResult)(NSString *, NSString *, BOOL) = ^O
     
 }
 
+- (NSDictionary<NSString *, NSNumber *> *)gaitSummaryFlagsOfStep:(ORKStep *)step {
+    NSMutableDictionary<NSString *, NSNumber *> *flags = [NSMutableDictionary dictionary];
+    for (ORKRecorderConfiguration *configuration in ((ORKActiveStep *)step).recorderConfigurations) {
+        if ([configuration isKindOfClass:[ORKAccelerometerRecorderConfiguration class]]) {
+            flags[configuration.identifier] = @(((ORKAccelerometerRecorderConfiguration *)configuration).includesGaitSummary);
+        } else if ([configuration isKindOfClass:[ORKDeviceMotionRecorderConfiguration class]]) {
+            flags[configuration.identifier] = @(((ORKDeviceMotionRecorderConfiguration *)configuration).includesGaitSummary);
+        }
+    }
+    return flags;
+}
+
+- (void)testWalkingTasksIncludeGaitSummaryOnWalkingStepsOnly {
+    NSArray<ORKOrderedTask *> *tasks = @[[ORKOrderedTask shortWalkTaskWithIdentifier:@"walking" intendedUseDescription:nil numberOfStepsPerLeg:20 restDuration:30 options:ORKPredefinedTaskOptionIncludeGaitSummary],
+                                         [ORKOrderedTask walkBackAndForthTaskWithIdentifier:@"walking" intendedUseDescription:nil walkDuration:30 restDuration:30 options:ORKPredefinedTaskOptionIncludeGaitSummary]];
+    for (ORKOrderedTask *task in tasks) {
+        for (ORKStep *step in task.steps) {
+            if ([step isKindOfClass:[ORKWalkingTaskStep class]]) {
+                XCTAssertEqualObjects([self gaitSummaryFlagsOfStep:step], (@{ORKAccelerometerRecorderIdentifier: @NO, ORKDeviceMotionRecorderIdentifier: @YES}), @"%@", step.identifier);
+            } else if ([step isKindOfClass:[ORKActiveStep class]] && ((ORKActiveStep *)step).recorderConfigurations.count > 0) {
+                // The participant stands still during the rest step, so there is no gait to summarize.
+                XCTAssertEqualObjects(step.identifier, ORKShortWalkRestStepIdentifier);
+                XCTAssertEqualObjects([self gaitSummaryFlagsOfStep:step], (@{ORKAccelerometerRecorderIdentifier: @NO, ORKDeviceMotionRecorderIdentifier: @NO}));
+            }
+        }
+    }
+    
+    // Without the option, no recorder computes a gait summary.
+    ORKOrderedTask *task = [ORKOrderedTask shortWalkTaskWithIdentifier:@"walking" intendedUseDescription:nil numberOfStepsPerLeg:20 restDuration:30 options:0];
+    XCTAssertEqualObjects([self gaitSummaryFlagsOfStep:[task stepWithIdentifier:ORKShortWalkOutboundStepIdentifier]], (@{ORKAccelerometerRecorderIdentifier: @NO, ORKDeviceMotionRecorderIdentifier: @NO}));
+}
+
+- (void)testWalkingTasksComputeGaitSummaryFromAccelerometerWithoutDeviceMotion {
+    ORKPredefinedTaskOption options = ORKPredefinedTaskOptionIncludeGaitSummary | ORKPredefinedTaskOptionExcludeDeviceMotion;
+    ORKOrderedTask *task = [ORKOrderedTask shortWalkTaskWithIdentifier:@"walking" intendedUseDescription:nil numberOfStepsPerLeg:20 restDuration:30 options:options];
+    XCTAssertEqualObjects([self gaitSummaryFlagsOfStep:[task stepWithIdentifier:ORKShortWalkOutboundStepIdentifier]], (@{ORKAccelerometerRecorderIdentifier: @YES}));
+    XCTAssertEqualObjects([self gaitSummaryFlagsOfStep:[task stepWithIdentifier:ORKShortWalkReturnStepIdentifier]], (@{ORKAccelerometerRecorderIdentifier: @YES}));
+    XCTAssertEqualObjects([self gaitSummaryFlagsOfStep:[task stepWithIdentifier:ORKShortWalkRestStepIdentifier]], (@{ORKAccelerometerRecorderIdentifier: @NO}));
+    
+    task = [ORKOrderedTask walkBackAndForthTaskWithIdentifier:@"walking" intendedUseDescription:nil walkDuration:30 restDuration:30 options:options];
+    XCTAssertEqualObjects([self gaitSummaryFlagsOfStep:[task stepWithIdentifier:ORKShortWalkOutboundStepIdentifier]], (@{ORKAccelerometerRecorderIdentifier: @YES}));
+    XCTAssertEqualObjects([self gaitSummaryFlagsOfStep:[task stepWithIdentifier:ORKShortWalkRestStepIdentifier]], (@{ORKAccelerometerRecorderIdentifier: @NO}));
+}
+
 #pragma mark - two-finger tapping with both hands
 
 - (void)testTwoFingerTappingIntervalTaskWithIdentifier_TapHandOptionUndefined {
@@ -38,28 +38,6 @@
 @import MapKit;
 
 
-static NSString *ORKEStringFromDateISO8601(NSDate *date) {
-    static NSDateFormatter *formatter = nil;
-    static dispatch_once_t onceToken;
-    dispatch_once(&onceToken, ^{
-        formatter = [[NSDateFormatter alloc] init];
-        [formatter setDateFormat:@"yyyy-MM-dd'T'HH:mm:ssZ"];
-        [formatter setLocale:[NSLocale localeWithLocaleIdentifier:@"en_US_POSIX"]];
-    });
-    return [formatter stringFromDate:date];
-}
-
-static NSDate *ORKEDateFromStringISO8601(NSString *string) {
-    static NSDateFormatter *formatter = nil;
-    static dispatch_once_t onceToken;
-    dispatch_once(&onceToken, ^{
-        formatter = [[NSDateFormatter alloc] init];
-        [formatter setDateFormat:@"yyyy-MM-dd'T'HH:mm:ssZ"];
-        [formatter setLocale:[NSLocale localeWithLocaleIdentifier:@"en_US_POSIX"]];
-    });
-    return [formatter dateFromString:string];
-}
-
 static NSArray *ORKNumericAnswerStyleTable() {
     static NSArray *table = nil;
     static dispatch_once_t onceToken;
@@ -704,6 +682,7 @@ encondingTable =
         },
         (@{
           PROPERTY(frequency, NSNumber, NSObject, NO, nil, nil),
+          PROPERTY(includesGaitSummary, NSNumber, NSObject, YES, nil, nil),
           })),
   ENTRY(ORKAudioRecorderConfiguration,
         ^id(NSDictionary *dict, ORKESerializationPropertyGetter getter) {
@@ -721,6 +700,7 @@ encondingTable =
           PROPERTY(signaturePageContent, NSString, NSObject, NO, nil, nil),
           PROPERTY(signatures, ORKConsentSignature, NSArray, NO, nil, nil),
           PROPERTY(htmlReviewContent, NSString, NSObject, NO, nil, nil),
+          PROPERTY(PDFBackend, NSNumber, NSObject, YES, nil, nil),
           })),
   ENTRY(ORKConsentSharingStep,
         ^(NSDictionary *dict, ORKESerializationPropertyGetter getter) {
@@ -803,6 +783,7 @@ encondingTable =
         },
         (@{
           PROPERTY(frequency, NSNumber, NSObject, NO, nil, nil),
+          PROPERTY(includesGaitSummary, NSNumber, NSObject, YES, nil, nil),
           })),
   ENTRY(ORKFormStep,
         ^id(NSDictionary *dict, ORKESerializationPropertyGetter getter) {
@@ -848,14 +829,14 @@ encondingTable =
                    ^id(id type) { return [(HKCharacteristicType *)type identifier]; },
                    ^id(id string) { return [HKCharacteristicType characteristicTypeForIdentifier:string]; }),
           PROPERTY(defaultDate, NSDate, NSObject, YES,
-                   ^id(id date) { return [ORKResultDateTimeFormatter() stringFromDate:date]; },
-                   ^id(id string) { return [ORKResultDateTimeFormatter() dateFromString:string]; }),
+                   ^id(id date) { return ORKStringFromDateISO8601(date); },
+                   ^id(id string) { return ORKDateFromStringISO8601(string); }),
           PROPERTY(minimumDate, NSDate, NSObject, YES,
-                   ^id(id date) { return [ORKResultDateTimeFormatter() stringFromDate:date]; },
-                   ^id(id string) { return [ORKResultDateTimeFormatter() dateFromString:string]; }),
+                   ^id(id date) { return ORKStringFromDateISO8601(date); },
+                   ^id(id string) { return ORKDateFromStringISO8601(string); }),
           PROPERTY(maximumDate, NSDate, NSObject, YES,
-                   ^id(id date) { return [ORKResultDateTimeFormatter() stringFromDate:date]; },
-                   ^id(id string) { return [ORKResultDateTimeFormatter() dateFromString:string]; }),
+                   ^id(id date) { return ORKStringFromDateISO8601(date); },
+                   ^id(id string) { return ORKDateFromStringISO8601(string); }),
           PROPERTY(calendar, NSCalendar, NSObject, YES,
                    ^id(id calendar) { return [(NSCalendar *)calendar calendarIdentifier]; },
                    ^id(id string) { return [NSCalendar calendarWithIdentifier:string]; }),
@@ -950,14 +931,14 @@ encondingTable =
                    ^id(id calendar) { return [(NSCalendar *)calendar calendarIdentifier]; },
                    ^id(id string) { return [NSCalendar calendarWithIdentifier:string]; }),
           PROPERTY(minimumDate, NSDate, NSObject, NO,
-                   ^id(id date) { return [ORKResultDateTimeFormatter() stringFromDate:date]; },
-                   ^id(id string) { return [ORKResultDateTimeFormatter() dateFromString:string]; }),
+                   ^id(id date) { return ORKStringFromDateISO8601(date); },
+                   ^id(id string) { return ORKDateFromStringISO8601(string); }),
           PROPERTY(maximumDate, NSDate, NSObject, NO,
-                   ^id(id date) { return [ORKResultDateTimeFormatter() stringFromDate:date]; },
-                   ^id(id string) { return [ORKResultDateTimeFormatter() dateFromString:string]; }),
+                   ^id(id date) { return ORKStringFromDateISO8601(date); },
+                   ^id(id string) { return ORKDateFromStringISO8601(string); }),
           PROPERTY(defaultDate, NSDate, NSObject, NO,
-                   ^id(id date) { return [ORKResultDateTimeFormatter() stringFromDate:date]; },
-                   ^id(id string) { return [ORKResultDateTimeFormatter() dateFromString:string]; }),
+                   ^id(id date) { return ORKStringFromDateISO8601(date); },
+                   ^id(id string) { return ORKDateFromStringISO8601(string); }),
           })),
   ENTRY(ORKNumericAnswerFormat,
         ^id(NSDictionary *dict, ORKESerializationPropertyGetter getter) {
@@ -1096,11 +1077,11 @@ encondingTable =
         (@{
            PROPERTY(identifier, NSString, NSObject, NO, nil, nil),
            PROPERTY(startDate, NSDate, NSObject, YES,
-                    ^id(id date) { return ORKEStringFromDateISO8601(date); },
-                    ^id(id string) { return ORKEDateFromStringISO8601(string); }),
+                    ^id(id date) { return ORKStringFromDateISO8601(date); },
+                    ^id(id string) { return ORKDateFromStringISO8601(string); }),
            PROPERTY(endDate, NSDate, NSObject, YES,
-                    ^id(id date) { return ORKEStringFromDateISO8601(date); },
-                    ^id(id string) { return ORKEDateFromStringISO8601(string); }),
+                    ^id(id date) { return ORKStringFromDateISO8601(date); },
+                    ^id(id string) { return ORKDateFromStringISO8601(string); }),
            PROPERTY(userInfo, NSDictionary, NSObject, YES, nil, nil)
            })),
   ENTRY(ORKTappingSample,
@@ -1200,7 +1181,10 @@ encondingTable =
          nil,
          (@{
             PROPERTY(timestamp, NSNumber, NSObject, NO, nil, nil),
-            PROPERTY(fileResult, ORKResult, NSObject, NO, nil, nil)
+            PROPERTY(fileResult, ORKResult, NSObject, NO, nil, nil),
+            PROPERTY(stimulusPresentationTimestamp, NSNumber, NSObject, NO, nil, nil),
+            PROPERTY(rawReactionTime, NSNumber, NSObject, NO, nil, nil),
+            PROPERTY(correctedReactionTime, NSNumber, NSObject, NO, nil, nil)
             })),
    ENTRY(ORKTimedWalkResult,
          nil,
@@ -1209,6 +1193,17 @@ encondingTable =
             PROPERTY(timeLimit, NSNumber, NSObject, NO, nil, nil),
             PROPERTY(duration, NSNumber, NSObject, NO, nil, nil),
            })),
+   ENTRY(ORKGaitSummaryResult,
+         nil,
+         (@{
+            PROPERTY(numberOfSteps, NSNumber, NSObject, NO, nil, nil),
+            PROPERTY(cadence, NSNumber, NSObject, NO, nil, nil),
+            PROPERTY(meanStrideDuration, NSNumber, NSObject, NO, nil, nil),
+            PROPERTY(strideDurationVariability, NSNumber, NSObject, NO, nil, nil),
+            PROPERTY(verticalAccelerationRMS, NSNumber, NSObject, NO, nil, nil),
+            PROPERTY(horizontalAccelerationRMS, NSNumber, NSObject, NO, nil, nil),
+            PROPERTY(duration, NSNumber, NSObject, NO, nil, nil),
+           })),
    ENTRY(ORKPSATSample,
          nil,
          (@{
@@ -1334,8 +1329,8 @@ encondingTable =
          nil,
          (@{
             PROPERTY(dateAnswer, NSDate, NSObject, NO,
-                     ^id(id date) { return ORKEStringFromDateISO8601(date); },
-                     ^id(id string) { return ORKEDateFromStringISO8601(string); }),
+                     ^id(id date) { return ORKStringFromDateISO8601(date); },
+                     ^id(id string) { return ORKDateFromStringISO8601(string); }),
             PROPERTY(calendar, NSCalendar, NSObject, NO,
                      ^id(id calendar) { return [(NSCalendar *)calendar calendarIdentifier]; },
                      ^id(id string) { return [NSCalendar calendarWithIdentifier:string]; }),
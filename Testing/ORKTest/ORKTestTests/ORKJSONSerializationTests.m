@@ -287,7 +287,34 @@ ORK_MAKE_TEST_INIT(CLCircularRegion, (^{
     NSDictionary *dict2 = [ORKESerializer JSONObjectForObject:task2 error:nil];
     
     XCTAssertTrue([dict1 isEqualToDictionary:dict2], @"Should be equal");
-    
+
+}
+
+- (void)testTaskModelRoundTripPerformance {
+    NSMutableArray<ORKStep *> *steps = [NSMutableArray array];
+    for (NSUInteger index = 0; index < 100; index++) {
+        NSString *identifier = [NSString stringWithFormat:@"id%lu", (unsigned long)index];
+        ORKAnswerFormat *answerFormat = nil;
+        switch (index % 3) {
+            case 0:
+                answerFormat = [ORKAnswerFormat choiceAnswerFormatWithStyle:ORKChoiceAnswerStyleSingleChoice textChoices:@[[ORKTextChoice choiceWithText:@"Yes" value:@(1)], [ORKTextChoice choiceWithText:@"No" value:@(0)]]];
+                break;
+            case 1:
+                answerFormat = [ORKNumericAnswerFormat decimalAnswerFormatWithUnit:@"kg"];
+                break;
+            default:
+                answerFormat = [ORKScaleAnswerFormat scaleAnswerFormatWithMaximumValue:10.0 minimumValue:1.0 defaultValue:5.0 step:1.0 vertical:NO maximumValueDescription:@"High value" minimumValueDescription:@"Low value"];
+                break;
+        }
+        [steps addObject:[ORKQuestionStep questionStepWithIdentifier:identifier title:@"question" answer:answerFormat]];
+    }
+    ORKOrderedTask *task = [[ORKOrderedTask alloc] initWithIdentifier:@"id" steps:steps];
+
+    [self measureBlock:^{
+        NSData *data = [ORKESerializer JSONDataForObject:task error:NULL];
+        ORKOrderedTask *task2 = [ORKESerializer objectFromJSONData:data error:NULL];
+        XCTAssertEqual(task2.steps.count, steps.count);
+    }];
 }
 
 - (NSArray<Class> *)classesWithSecureCoding {
@@ -336,7 +363,8 @@ ORK_MAKE_TEST_INIT(CLCircularRegion, (^{
                                                      [ORKCollector class], // ORKCollector doesn't support JSON serialzation
                                                      [ORKHealthCollector class],
                                                      [ORKHealthCorrelationCollector class],
-                                                     [ORKMotionActivityCollector class]
+                                                     [ORKMotionActivityCollector class],
+                                                     [ORKSearchableChoiceAnswerFormat class] // Its data source doesn't support JSON serialization
                                                      ];
     
     if ((classesExcludedForORKESerialization.count + classesWithORKSerialization.count) != classesWithSecureCoding.count) {
@@ -374,6 +402,7 @@ ORK_MAKE_TEST_INIT(CLCircularRegion, (^{
                                               @"ORKConsentDocument.writer",
                                               @"ORKConsentDocument.signatureFormatter",
                                               @"ORKConsentDocument.sectionFormatter",
+                                              @"ORKConsentDocument.renderer",
                                               @"ORKConsentDocument.sections",
                                               @"ORKConsentDocument.signatures",
                                               @"ORKContinuousScaleAnswerFormat.numberFormatter",
@@ -414,6 +443,7 @@ ORK_MAKE_TEST_INIT(CLCircularRegion, (^{
                                               @"ORKRegistrationStep.passcodeInvalidMessage",
                                               @"ORKSignatureResult.signatureImage",
                                               @"ORKSignatureResult.signaturePath",
+                                              @"ORKSignatureResult.signatureStrokeData",
                                               @"ORKPageStep.steps",
                                               @"ORKNavigablePageStep.steps",
                                               ];
@@ -620,10 +650,12 @@ ORK_MAKE_TEST_INIT(CLCircularRegion, (^{
                                        @"unit",
                                        @"ORKPageStep.steps",
                                        @"ORKNavigablePageStep.steps",
+                                       @"ORKSearchableChoiceAnswerFormat.dataSource", // not archived
                                        ];
     NSArray *knownNotSerializedProperties = @[@"ORKConsentDocument.writer", // created on demand
                                               @"ORKConsentDocument.signatureFormatter", // created on demand
                                               @"ORKConsentDocument.sectionFormatter", // created on demand
+                                              @"ORKConsentDocument.renderer", // created on demand
                                               @"ORKStep.task", // weak ref - object will be nil
                                               @"ORKFormItem.step",  // weak ref - object will be nil
                                               
@@ -657,6 +689,7 @@ ORK_MAKE_TEST_INIT(CLCircularRegion, (^{
                                               @"ORKContinuousScaleAnswerFormat.maximumImage",
                                               @"ORKSignatureResult.signatureImage",
                                               @"ORKSignatureResult.signaturePath",
+                                              @"ORKSignatureResult.signatureStrokeData",
                                               @"ORKPageStep.steps",
                                               @"ORKNavigablePageStep.steps",
                                               ];
@@ -849,6 +882,7 @@ ORK_MAKE_TEST_INIT(CLCircularRegion, (^{
                                        @"ORKPageStep.steps",
                                        @"ORKResult.saveable",
                                        @"ORKReviewStep.isStandalone",
+                                       @"ORKSearchableChoiceAnswerFormat.dataSource",
                                        @"ORKStep.allowsBackNavigation",
                                        @"ORKStep.restorable",
                                        @"ORKStep.showsProgress",